@@ -6,16 +6,18 @@
 // Used to access topology functions
 #include <BroncoDeployment/Top/BroncoDeploymentTopologyAc.hpp>
 #include <BroncoDeployment/Top/BroncoDeploymentTopology.hpp>
-// Used for Task Runner
-#include <Os/Baremetal/TaskRunner/TaskRunner.hpp>
 
 // Used for logging
 #include <Os/Log.hpp>
-#include <Arduino/Os/StreamLog.hpp>
 
 // Instantiate a system logger that will handle Fw::Logger::logMsg calls
 Os::Log logger;
 
+#ifdef ARDUINO
+// Used for Task Runner
+#include <Os/Baremetal/TaskRunner/TaskRunner.hpp>
+#include <Arduino/Os/StreamLog.hpp>
+
 // Task Runner
 Os::TaskRunner taskrunner;
 
@@ -30,7 +32,6 @@ void setup()
     // Setup Serial
     Serial.begin(115200);
     Os::setArduinoStreamLogHandler(&Serial);
-    delay(1000);
     Fw::Logger::logMsg("Program Started\n");
 
     // Object for communicating state to the reference topology
@@ -50,8 +51,134 @@ void setup()
  */
 void loop()
 {
+    const U32 start = micros();
 #ifdef USE_BASIC_TIMER
     rateDriver.cycle();
 #endif
     taskrunner.run();
-}
\ No newline at end of file
+    radioCoreLink.recordMainLoop(micros() - start);
+}
+
+#ifdef BRONCO_RADIO_CORE1
+#ifndef ARDUINO_ARCH_RP2040
+#error "BRONCO_RADIO_CORE1 needs the RP2040's second core"
+#endif
+/**
+ * \brief run the hub radio
+ *
+ * This is the arduino-pico core 1 loop. It sleeps until radioCoreLink has work for the radio side.
+ *
+ */
+void loop1()
+{
+    radioCoreLink.serviceRadioCore();
+}
+#endif
+#else
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+#include <thread>
+
+/**
+ * \brief print command line help message
+ *
+ * This will print a command line help message including the available command line arguments.
+ *
+ * @param app: name of application
+ */
+static void print_usage(const char* app)
+{
+    (void) printf("Usage: ./%s [options]\n"
+                  "-d\tground link device; a pseudo-terminal is created when omitted\n"
+                  "-b\tground link baud rate\n"
+                  "-r\tloopback port the simulated radio receives on\n"
+                  "-p\tloopback port of the other node's simulated radio\n",
+                  app);
+}
+
+/**
+ * \brief shutdown topology cycling on signal
+ *
+ * The reference topology allows for a simulated cycling of the rate groups. This simulated cycling needs to be stopped
+ * in order for the program to shutdown. This is done via handling signals such that it is performed via Ctrl-C
+ *
+ * @param signum
+ */
+static void signalHandler(int signum)
+{
+    rateDriver.quit();
+}
+
+/**
+ * \brief run the program on the host
+ *
+ * Runs the flight topology with the ground link on a pseudo-terminal and the hub radio on the loopback interface.
+ * Two instances with swapped radio ports form a link.
+ */
+int main(int argc, char* argv[])
+{
+    BroncoDeployment::TopologyState inputs;
+    inputs.uartNumber = 0;
+    inputs.uartBaud = 115200;
+    inputs.uartDevice = nullptr;
+    inputs.radioPort = 0;
+    inputs.radioPeerPort = 0;
+
+    int option = 0;
+    while ((option = getopt(argc, argv, "hd:b:r:p:")) != -1) {
+        switch (option) {
+            case 'd':
+                inputs.uartDevice = optarg;
+                break;
+            case 'b':
+                inputs.uartBaud = static_cast<PlatformIntType>(atoi(optarg));
+                break;
+            case 'r':
+                inputs.radioPort = static_cast<U16>(atoi(optarg));
+                break;
+            case 'p':
+                inputs.radioPeerPort = static_cast<U16>(atoi(optarg));
+                break;
+            case 'h':
+            case '?':
+            default:
+                print_usage(argv[0]);
+                return (option == 'h') ? 0 : 1;
+        }
+    }
+
+    Fw::Logger::logMsg("Program Started\n");
+
+    // Setup program shutdown via Ctrl-C
+    signal(SIGINT, signalHandler);
+    signal(SIGTERM, signalHandler);
+
+    BroncoDeployment::setupTopology(inputs);
+
+#ifdef BRONCO_RADIO_CORE1
+    // A thread stands in for the second core
+    std::atomic<bool> radioCoreRunning(true);
+    std::thread radioCore([&radioCoreRunning]() {
+        while (radioCoreRunning.load()) {
+            radioCoreLink.serviceRadioCore();
+        }
+    });
+#endif
+
+    // Cycles the rate groups every millisecond until a signal stops it
+    rateDriver.startTimer(1);
+
+#ifdef BRONCO_RADIO_CORE1
+    radioCoreRunning.store(false);
+    radioCoreLink.wake();
+    radioCore.join();
+#endif
+
+    BroncoDeployment::teardownTopology(inputs);
+    Fw::Logger::logMsg("Exiting...\n");
+    return 0;
+}
+#endif
@@ -9,20 +9,77 @@
 #include <config/FppConstantsAc.hpp>
 
 // Necessary project-specified types
+#include <Fw/Dp/DpContainer.hpp>
 #include <Fw/Types/MallocAllocator.hpp>
 #include <Svc/FramingProtocol/FprimeProtocol.hpp>
+#include <Components/FlashPrmDb/FlashStore.hpp>
+#include <Components/Framing/FastFprimeProtocol.hpp>
+
+// With BRONCO_RADIO_CORE1 the hub radio and its deframer run on the RP2040's second core, which main() starts
+#ifdef BRONCO_RADIO_CORE1
+static const bool RADIO_CORE_SEPARATE = true;
+#else
+static const bool RADIO_CORE_SEPARATE = false;
+#endif
 
 // Allows easy reference to objects in FPP/autocoder required namespaces
 using namespace BroncoDeployment;
 
+// The health beacon's schema names its channels by hand-kept ids, since the beacon decoder builds it off target
+// without the components; these check them against the generated ids, which the component bases keep protected
+namespace {
+    using namespace Components::HealthBeaconFields;
+
+    struct RadioBeaconChannels : Radio::RFM69ComponentBase {
+        static_assert(BaseIds::hubComDriver == Components::HealthBeaconCfg::RADIO_ID_BASE, "hubComDriver moved");
+        static_assert(RadioStatus::CHANNEL == BaseIds::hubComDriver + CHANNELID_STATUS, "radio_status channel");
+        static_assert(PacketsSent::CHANNEL == BaseIds::hubComDriver + CHANNELID_NUMPACKETSSENT, "packets_sent channel");
+        static_assert(PacketsReceived::CHANNEL == BaseIds::hubComDriver + CHANNELID_NUMPACKETSRECEIVED,
+                      "packets_received channel");
+        static_assert(PacketsLost::CHANNEL == BaseIds::hubComDriver + CHANNELID_PACKETSLOST, "packets_lost channel");
+        static_assert(Airtime::CHANNEL == BaseIds::hubComDriver + CHANNELID_AIRTIMEUTILIZATION,
+                      "airtime_permille channel");
+        static_assert(Rssi::CHANNEL == BaseIds::hubComDriver + CHANNELID_RSSI, "rssi_dbm channel");
+    };
+
+    struct SystemBeaconChannels : Svc::SystemResourcesComponentBase {
+        static_assert(BaseIds::systemResources == Components::HealthBeaconCfg::SYSTEM_RESOURCES_ID_BASE,
+                      "systemResources moved");
+        static_assert(Cpu::CHANNEL == BaseIds::systemResources + CHANNELID_CPU, "cpu_percent channel");
+        static_assert(MemoryUsed::CHANNEL == BaseIds::systemResources + CHANNELID_MEMORY_USED,
+                      "memory_used_kb channel");
+        static_assert(NonVolatileFree::CHANNEL == BaseIds::systemResources + CHANNELID_NON_VOLATILE_FREE,
+                      "nonvolatile_free_kb channel");
+    };
+
+    struct TimeBeaconChannels : Components::DisciplinedTimeComponentBase {
+        static_assert(BaseIds::disciplinedTime == Components::HealthBeaconCfg::TIME_ID_BASE, "disciplinedTime moved");
+        static_assert(ClockOffset::CHANNEL == BaseIds::disciplinedTime + CHANNELID_CLOCKOFFSET,
+                      "clock_offset_us channel");
+    };
+}
+
 // The reference topology uses a malloc-based allocator for components that need to allocate memory during the
 // initialization phase.
 Fw::MallocAllocator mallocator;
 
-// The reference topology uses the F´ packet protocol when communicating with the ground and therefore uses the F´
-// framing and deframing implementations.
-Svc::FprimeFraming framing;
-Svc::FprimeDeframing deframing;
+// The ground and hub links both use the F´ packet protocol. The project implementation is wire compatible with
+// Svc::FprimeFraming/Svc::FprimeDeframing but computes the frame CRC with the fastest engine for the target. Each
+// framer/deframer needs its own protocol object.
+Framing::FastFprimeFraming framing;
+Framing::FastFprimeDeframing deframing;
+Framing::FastFprimeFraming hubFraming;
+#ifdef BRONCO_RADIO_CORE1
+// The hub deframer runs on the radio core, which must not share core 0's CRC engine: on the RP2040 that is the DMA
+// sniffer, a single hardware unit
+Framing::FastFprimeDeframing hubDeframing(Framing::softwareCrc32Engine());
+#else
+Framing::FastFprimeDeframing hubDeframing;
+#endif
+Framing::FastFprimeFraming hubComFraming;
+
+// Flash region holding the parameter log
+Components::FlashStore paramFlash;
 
 // The reference topology divides the incoming clock signal (1Hz) into sub-signals: 1/100Hz, 1/200Hz, and 1/1000Hz
 Svc::RateGroupDriver::DividerSet rateGroupDivisors{{{100, 0}, {200, 0}, {1000, 0}}};
@@ -36,18 +93,28 @@ enum TopologyConstants {
     CMD_SEQ_BUFFER_SIZE = 5 * 1024,
     FILE_DOWNLINK_TIMEOUT = 1000,
     FILE_DOWNLINK_COOLDOWN = 1000,
-    FILE_DOWNLINK_CYCLE_TIME = 1000,
+    // fileDownlink runs in rate group 1, every 100 ms
+    FILE_DOWNLINK_CYCLE_TIME = 100,
     FILE_DOWNLINK_FILE_QUEUE_DEPTH = 10,
     HEALTH_WATCHDOG_CODE = 0x123,
     COMM_PRIORITY = 100,
     // bufferManager constants
     FRAMER_BUFFER_SIZE = FW_MAX(FW_COM_BUFFER_MAX_SIZE, FW_FILE_BUFFER_MAX_SIZE + sizeof(U32)) + sizeof(U32) + Svc::FpFrameHeader::SIZE,
-    FRAMER_BUFFER_COUNT = 30,
+    // The hub file transfer keeps up to HubFileTransferCfg::MAX_QUEUED_CHUNKS frames waiting for the radio
+    FRAMER_BUFFER_COUNT = 60,
     DEFRAMER_BUFFER_SIZE = FW_MAX(FW_COM_BUFFER_MAX_SIZE, FW_FILE_BUFFER_MAX_SIZE + sizeof(U32)),
     DEFRAMER_BUFFER_COUNT = 30,
+    DP_BUFFER_SIZE = FW_MAX(Components::BroncoOreMessageHandler::MESSAGE_LOG_DATA_SIZE,
+                            Radio::RFM69Cfg::CAPTURE_CONTAINER_DATA_SIZE) + Fw::DpContainer::MIN_PACKET_SIZE,
+    DP_BUFFER_COUNT = 4,
     COM_DRIVER_BUFFER_SIZE = 3000,
     COM_DRIVER_BUFFER_COUNT = 30,
-    BUFFER_MANAGER_ID = 200
+    BUFFER_MANAGER_ID = 200,
+    // radioBufferManager constants: packets as the radio receives them, and the packets deframed from them
+    RADIO_PACKET_SIZE = 64,
+    RADIO_PACKET_COUNT = 16,
+    RADIO_DEFRAMER_BUFFER_COUNT = 16,
+    RADIO_BUFFER_MANAGER_ID = 201
 };
 /**
  * \brief configure/setup components in project-specific way
@@ -70,13 +137,40 @@ void configureTopology() {
     upBuffMgrBins.bins[0].numBuffers = FRAMER_BUFFER_COUNT;
     upBuffMgrBins.bins[1].bufferSize = DEFRAMER_BUFFER_SIZE;
     upBuffMgrBins.bins[1].numBuffers = DEFRAMER_BUFFER_COUNT;
-    upBuffMgrBins.bins[2].bufferSize = COM_DRIVER_BUFFER_SIZE;
-    upBuffMgrBins.bins[2].numBuffers = COM_DRIVER_BUFFER_COUNT;
+    // Data product containers come before the larger com driver bin so they do not take com driver buffers
+    upBuffMgrBins.bins[2].bufferSize = DP_BUFFER_SIZE;
+    upBuffMgrBins.bins[2].numBuffers = DP_BUFFER_COUNT;
+    upBuffMgrBins.bins[3].bufferSize = COM_DRIVER_BUFFER_SIZE;
+    upBuffMgrBins.bins[3].numBuffers = COM_DRIVER_BUFFER_COUNT;
     bufferManager.setup(BUFFER_MANAGER_ID, 0, mallocator, upBuffMgrBins);
 
+    // The radio side allocates from its own buffer manager, so neither core ever calls the other's
+    Svc::BufferManager::BufferBins radioBuffMgrBins;
+    memset(&radioBuffMgrBins, 0, sizeof(radioBuffMgrBins));
+    radioBuffMgrBins.bins[0].bufferSize = RADIO_PACKET_SIZE;
+    radioBuffMgrBins.bins[0].numBuffers = RADIO_PACKET_COUNT;
+    radioBuffMgrBins.bins[1].bufferSize = DEFRAMER_BUFFER_SIZE;
+    radioBuffMgrBins.bins[1].numBuffers = RADIO_DEFRAMER_BUFFER_COUNT;
+    radioBufferManager.setup(RADIO_BUFFER_MANAGER_ID, 0, mallocator, radioBuffMgrBins);
+
+    // File downlink carries data product files to the ground as they are written
+    fileDownlink.configure(FILE_DOWNLINK_TIMEOUT, FILE_DOWNLINK_COOLDOWN, FILE_DOWNLINK_CYCLE_TIME,
+                           FILE_DOWNLINK_FILE_QUEUE_DEPTH);
+
     // Framer and Deframer components need to be passed a protocol handler
     framer.setup(framing);
     deframer.setup(deframing);
+    hubFramer.setup(hubFraming);
+    hubDeframer.setup(hubDeframing);
+    hubComFramer.setup(hubComFraming);
+
+    // The parameter database must be loaded before components load their parameters from it
+#ifndef ARDUINO
+    // Off target the parameter log is kept in a file in the working directory
+    (void) paramFlash.open("PrmDbFlash.bin");
+#endif
+    prmDb.configure(paramFlash);
+    prmDb.load();
 }
 
 // Public functions for use in main program are namespaced with deployment name BroncoDeployment
@@ -88,19 +182,35 @@ void setupTopology(const TopologyState& state) {
     setBaseIds();
     // Autocoded connection wiring. Function provided by autocoder.
     connectComponents();
+    // Boot phases are timed from here, the first point the time port is connected
+    bootMonitor.start();
     // Autocoded command registration. Function provided by autocoder.
     regCommands();
     // Project-specific component configuration. Function provided above. May be inlined, if desired.
     configureTopology();
     // Autocoded parameter loading. Function provided by autocoder.
-    // loadParameters();
+    loadParameters();
     // Autocoded task kick-off (active components). Function provided by autocoder.
     startTasks(state);
+    // The radio core waits for this, as its components are only now connected and set up. The rate driver is not
+    // yet running, so the main core is not servicing the radio side itself.
+    radioCoreLink.configure(RADIO_CORE_SEPARATE);
     
+#ifdef ARDUINO
     rateDriver.configure(1);
     commDriver.configure(&Serial);
     rateDriver.start();
+#else
+    // The rate driver is started by main, since its timer loop runs on the calling thread
+    if (state.uartDevice != nullptr) {
+        (void) commDriver.open(state.uartDevice, state.uartBaud);
+    } else {
+        (void) commDriver.openPty();
+    }
+    hubComDriver.configureLink(state.radioPort, state.radioPeerPort);
+#endif
     hubComDriver.init(9600);
+    bootMonitor.topologyReady();
 }
 
 void teardownTopology(const TopologyState& state) {
@@ -24,6 +24,11 @@ namespace BroncoDeployment {
 struct TopologyState {
     FwIndexType uartNumber;
     PlatformIntType uartBaud;
+#ifndef ARDUINO
+    const char* uartDevice;  //!< Ground link device, or nullptr to create a pseudo-terminal
+    U16 radioPort;           //!< Loopback port the simulated radio receives on
+    U16 radioPeerPort;       //!< Loopback port of the other node's simulated radio
+#endif
 };
 
 /**
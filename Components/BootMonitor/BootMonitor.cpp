@@ -0,0 +1,116 @@
+// ======================================================================
+// \title  BootMonitor.cpp
+// \brief  cpp file for BootMonitor component implementation class
+// ======================================================================
+
+#include "Components/BootMonitor/BootMonitor.hpp"
+#include "FpConfig.hpp"
+
+namespace Components {
+
+  // ----------------------------------------------------------------------
+  // Component construction and destruction
+  // ----------------------------------------------------------------------
+
+  BootMonitor ::
+    BootMonitor(const char* const compName) :
+      BootMonitorComponentBase(compName),
+      m_complete(false)
+  {
+    for (U32 phase = 0; phase < NUM_PHASES; phase++) {
+      m_phaseMs[phase] = 0;
+      m_reached[phase] = false;
+      m_published[phase] = false;
+    }
+  }
+
+  BootMonitor ::
+    ~BootMonitor()
+  {
+
+  }
+
+  void BootMonitor ::
+    start()
+  {
+    m_start = this->getTime();
+  }
+
+  void BootMonitor ::
+    topologyReady()
+  {
+    this->mark(PHASE_TOPOLOGY);
+  }
+
+  // ----------------------------------------------------------------------
+  // Handler implementations for user-defined typed input ports
+  // ----------------------------------------------------------------------
+
+  void BootMonitor ::
+    radioStatus_handler(
+        FwIndexType portNum,
+        Fw::Success& condition
+    )
+  {
+    if (condition == Fw::Success::SUCCESS) {
+      this->mark(PHASE_RADIO);
+    }
+  }
+
+  void BootMonitor ::
+    comIn_handler(
+        FwIndexType portNum,
+        Fw::ComBuffer& data,
+        U32 context
+    )
+  {
+    this->comOut_out(0, data, context);
+    this->mark(PHASE_TELEMETRY);
+  }
+
+  void BootMonitor ::
+    run_handler(
+        FwIndexType portNum,
+        NATIVE_UINT_TYPE context
+    )
+  {
+    if (m_complete) {
+      return;
+    }
+    // Published from the rate group, since telemetry written while a packet is passing through would re-enter tlmSend
+    if (m_reached[PHASE_TOPOLOGY] && not m_published[PHASE_TOPOLOGY]) {
+      this->tlmWrite_TopologySetupTime(m_phaseMs[PHASE_TOPOLOGY]);
+      m_published[PHASE_TOPOLOGY] = true;
+    }
+    if (m_reached[PHASE_RADIO] && not m_published[PHASE_RADIO]) {
+      this->tlmWrite_RadioReadyTime(m_phaseMs[PHASE_RADIO]);
+      m_published[PHASE_RADIO] = true;
+    }
+    if (m_reached[PHASE_TELEMETRY] && not m_published[PHASE_TELEMETRY]) {
+      this->tlmWrite_FirstTelemetryTime(m_phaseMs[PHASE_TELEMETRY]);
+      m_published[PHASE_TELEMETRY] = true;
+    }
+    if (m_published[PHASE_TOPOLOGY] && m_published[PHASE_RADIO] && m_published[PHASE_TELEMETRY]) {
+      this->log_ACTIVITY_HI_BootComplete(m_phaseMs[PHASE_TOPOLOGY], m_phaseMs[PHASE_RADIO],
+                                         m_phaseMs[PHASE_TELEMETRY]);
+      m_complete = true;
+    }
+  }
+
+  // ----------------------------------------------------------------------
+  // Helpers
+  // ----------------------------------------------------------------------
+
+  void BootMonitor ::
+    mark(Phase phase)
+  {
+    FW_ASSERT(phase < NUM_PHASES, phase);
+    if (m_reached[phase]) {
+      return;
+    }
+    const Fw::Time elapsed = Fw::Time::sub(this->getTime(), m_start);
+    m_phaseMs[phase] = elapsed.getSeconds() * 1000 + elapsed.getUSeconds() / 1000;
+    m_reached[phase] = true;
+  }
+
+}
@@ -0,0 +1,95 @@
+// ======================================================================
+// \title  BootMonitor.hpp
+// \brief  hpp file for BootMonitor component implementation class
+// ======================================================================
+
+#ifndef Components_BootMonitor_HPP
+#define Components_BootMonitor_HPP
+
+#include "Components/BootMonitor/BootMonitorComponentAc.hpp"
+
+namespace Components {
+
+  //! Records how long each phase of boot takes, measured from start(), so time to first packet can be tracked
+  class BootMonitor :
+    public BootMonitorComponentBase
+  {
+
+    public:
+
+      // ----------------------------------------------------------------------
+      // Component construction and destruction
+      // ----------------------------------------------------------------------
+
+      //! Construct BootMonitor object
+      BootMonitor(
+          const char* const compName //!< The component name
+      );
+
+      //! Destroy BootMonitor object
+      ~BootMonitor();
+
+      //! Mark the start of boot; call as soon as the time port is connected
+      void start();
+
+      //! Mark the end of topology setup
+      void topologyReady();
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Handler implementations for user-defined typed input ports
+      // ----------------------------------------------------------------------
+
+      //! Handler implementation for radioStatus
+      void radioStatus_handler(
+          FwIndexType portNum, //!< The port number
+          Fw::Success& condition //!< Condition success/failure
+      ) override;
+
+      //! Handler implementation for comIn
+      void comIn_handler(
+          FwIndexType portNum, //!< The port number
+          Fw::ComBuffer& data, //!< Buffer containing packet data
+          U32 context //!< Call context value; meaning chosen by user
+      ) override;
+
+      //! Handler implementation for run
+      void run_handler(
+          FwIndexType portNum, //!< The port number
+          NATIVE_UINT_TYPE context //!< The call order
+      ) override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Helpers
+      // ----------------------------------------------------------------------
+
+      //! Boot phases
+      enum Phase {
+        PHASE_TOPOLOGY, //!< Topology set up
+        PHASE_RADIO, //!< Radio ready
+        PHASE_TELEMETRY, //!< First telemetry packet sent
+        NUM_PHASES
+      };
+
+      //! Record the time a phase was first reached
+      void mark(Phase phase);
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Member variables
+      // ----------------------------------------------------------------------
+
+      Fw::Time m_start; //!< Start of boot
+      U32 m_phaseMs[NUM_PHASES]; //!< Milliseconds from the start of boot to each phase
+      bool m_reached[NUM_PHASES]; //!< Whether each phase was reached
+      bool m_published[NUM_PHASES]; //!< Whether each phase time was published
+      bool m_complete; //!< Whether every phase was reached and reported
+  };
+
+}
+
+#endif
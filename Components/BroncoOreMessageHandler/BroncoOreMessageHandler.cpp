@@ -7,6 +7,8 @@
 #include "Components/BroncoOreMessageHandler/BroncoOreMessageHandler.hpp"
 #include "FpConfig.hpp"
 
+#include <cstring>
+
 namespace Components {
 
   // ----------------------------------------------------------------------
@@ -15,7 +17,25 @@ namespace Components {
 
   BroncoOreMessageHandler ::
     BroncoOreMessageHandler(const char* const compName) :
-      BroncoOreMessageHandlerComponentBase(compName)
+      BroncoOreMessageHandlerComponentBase(compName),
+      m_messagesRecorded(0),
+      m_resultsWritten(0),
+      m_resultsContainers(0),
+      m_resultsCut(false),
+      m_sendSeq(0),
+      m_probing(false),
+      m_probeRun(0),
+      m_probeTarget(0),
+      m_probeSize(0),
+      m_probeInterval(0),
+      m_probeCount(0),
+      m_probesSent(0),
+      m_probeEchoes(0),
+      m_probeTicks(0),
+      m_forwardUs(0),
+      m_returnUs(0),
+      m_echoHead(0),
+      m_echoCount(0)
   {
 
   }
@@ -37,34 +57,46 @@ namespace Components {
         U32 context
     )
   {
-      // Fw::String message(data.getBuffAddr());
-      printf("%s\n", data.getBuffAddr());
-      // this->log_ACTIVITY_HI_ReportMessage(message);
-
-    // Fw::SerializeBufferBase& incoming = fwBuffer.getSerializeRepr();
-    // Fw::SerializeStatus status = Fw::FW_SERIALIZE_OK;
-    // Fw::CmdStringArg message;
-    // FW_ASSERT(fwBuffer.getSize() != 0);
-    // status = incoming.setBuffLen(fwBuffer.getSize());
-    // FW_ASSERT(fwBuffer.isValid());
-    // U8* bufferptr = fwBuffer.getData();
-    // U32 size = fwBuffer.getSize();
-    // char messageCopy[size];
-    // printf("Recv Size: %u\n", size);
-    // FW_ASSERT(bufferptr != nullptr);
-    // printf("POtiner Address: %p\n", bufferptr);
-    // printf("First 4 chars: %c \n", bufferptr[0]);
-    // Fw::String stringMessage(bufferptr)
-    // memcpy(messageCopy, bufferptr, size);
-    // this->log_ACTIVITY_HI_ReportMessage(Fw::String("Doing the thing"));
-    // Fw::String messageString(messageCopy);
-    // U8* rawData = fwBuffer.getData() + sizeof(FwBuffSizeType);
-    // U32 rawSize = static_cast<U32>(fwBuffer.getSize() - sizeof(FwBuffSizeType));
-    // FW_ASSERT(rawSize == static_cast<U32>)
-    // FW_ASSERT(status == Fw::FW_SERIALIZE_OK, static_cast<NATIVE_INT_TYPE>(status));
-    // status = incoming.deserialize(bufferptr, size);
-    // this->log_ACTIVITY_HI_ReportMessage();
-    // deallocate_message_buffer_out(0, fwBuffer);
+    // Probes and echoes are not messages, so they are neither logged nor kept
+    if ((data.getBuffLength() > 0) && (data.getBuffAddr()[0] == PROBE_MARKER)) {
+      this->receiveProbe(data);
+      return;
+    }
+    this->recordMessage(data.getBuffAddr(), data.getBuffLength());
+
+    U8 sender = 0;
+    U16 seq = 0;
+    data.resetDeser();
+    if ((data.deserialize(sender) != Fw::FW_SERIALIZE_OK) || (data.deserialize(seq) != Fw::FW_SERIALIZE_OK)) {
+      this->log_WARNING_LO_MessageMalformed(data.getBuffLength());
+      return;
+    }
+    const Fw::Time now = this->getTime();
+    (void) m_inbox.insert(sender, seq, now.getSeconds(), now.getUSeconds(), data.getBuffAddr() + MESSAGE_HEADER_SIZE,
+                          data.getBuffLength() - MESSAGE_HEADER_SIZE);
+    this->writeInboxTelemetry();
+  }
+
+  void BroncoOreMessageHandler ::
+    run_handler(
+        FwIndexType portNum,
+        U32 context
+    )
+  {
+    this->sendEchoes();
+    if (not m_probing) {
+      return;
+    }
+    m_probeTicks++;
+    if (m_probesSent < m_probeCount) {
+      if (m_probeTicks >= m_probeInterval) {
+        this->sendProbe();
+      }
+    } else if (m_probeTicks >= LatencyProbeCfg::ECHO_WAIT_TICKS) {
+      // Echoes still on their way after this are counted, but the run is over
+      m_probing = false;
+      this->reportProbes();
+    }
   }
 
   // ----------------------------------------------------------------------
@@ -78,26 +110,418 @@ namespace Components {
         const Fw::CmdStringArg& message
     )
   {
-    const U8* messageBuff;
-    U32 size = message.length();
+    Fw::ParamValid valid;
+    const U8 address = this->paramGet_NODE_ADDRESS(valid);
 
+    // The receiving inbox indexes messages by the sender and sequence number ahead of the text
+    Fw::ComBuffer comBuffer;
+    Fw::SerializeStatus status = comBuffer.serialize(address);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = comBuffer.serialize(m_sendSeq);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = comBuffer.serialize(reinterpret_cast<const U8*>(message.toChar()), message.length(), true);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    m_sendSeq++;
 
+    send_message_out(0, comBuffer, 0);
+    this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::OK);
+  }
 
-    Fw::ComBuffer comBuffer(reinterpret_cast<const U8*>(message.toChar()), size);
+  void BroncoOreMessageHandler ::
+    FLUSH_MESSAGE_LOG_cmdHandler(
+        FwOpcodeType opCode,
+        U32 cmdSeq
+    )
+  {
+    this->sendMessageLog();
+    this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::OK);
+  }
 
-    // FW_ASSERT(message != nullptr);
-    // Fw::SerializeStatus status;
-    // printf("Message Length: %u \n", size);
+  void BroncoOreMessageHandler ::
+    INBOX_LIST_cmdHandler(
+        FwOpcodeType opCode,
+        U32 cmdSeq,
+        U8 sender,
+        U32 startTime,
+        U32 endTime
+    )
+  {
+    U32 matched = 0;
+    InboxMessage message;
+    if (sender == 0) {
+      // Every sender: the inbox is in time order, so the range starts where a search puts it
+      for (U32 id = m_inbox.firstAtOrAfter(startTime, 0); m_inbox.get(id, message) && (message.seconds <= endTime);
+           id++) {
+        matched++;
+        this->writeResult(message, false);
+      }
+    } else {
+      // One sender: its own chain, which is in time order too
+      for (U32 id = m_inbox.firstFrom(sender); m_inbox.get(id, message) && (message.seconds <= endTime);
+           id = m_inbox.nextFromSender(id)) {
+        if (message.seconds >= startTime) {
+          matched++;
+          this->writeResult(message, false);
+        }
+      }
+    }
+    this->finishQuery(matched);
+    this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::OK);
+  }
 
-    // U8* outgoingBuffer = outgoing.getData();
-    // memcpy(outgoingBuffer, message.toChar(), size);
-    // printf("POtiner Address: %p\n", outgoingBuffer);
-    // printf("First 4 chars: %c%c%c%c \n", outgoingBuffer[0], outgoingBuffer[1], outgoingBuffer[2], outgoingBuffer[3]);
-    // // Fw::SerializeBufferBase& serialize = outgoing.getSerializeRepr();
-    // // status = serialize.serialize(messageBuff, size);
-  
-    // // FW_ASSERT(status == Fw::FW_SERIALIZE_OK, static_cast<NATIVE_INT_TYPE>(status));
-    // // outgoing.setSize(serialize.getBuffLength());
-    send_message_out(0, comBuffer, 0);
+  void BroncoOreMessageHandler ::
+    INBOX_FETCH_cmdHandler(
+        FwOpcodeType opCode,
+        U32 cmdSeq,
+        U32 firstId,
+        U32 lastId
+    )
+  {
+    if (firstId > lastId) {
+      this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::VALIDATION_ERROR);
+      return;
+    }
+    U32 matched = 0;
+    InboxMessage message;
+    // Ids are given in arrival order, so the messages held in the range are found by number
+    const U32 first = FW_MAX(firstId, m_inbox.firstId());
+    const U32 last = FW_MIN(lastId, m_inbox.nextId() - 1);
+    for (U32 id = first; (m_inbox.count() > 0) && (id <= last) && m_inbox.get(id, message); id++) {
+      matched++;
+      this->writeResult(message, true);
+    }
+    this->finishQuery(matched);
+    this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::OK);
+  }
+
+  void BroncoOreMessageHandler ::
+    INBOX_FETCH_FROM_cmdHandler(
+        FwOpcodeType opCode,
+        U32 cmdSeq,
+        U8 sender,
+        U16 firstSeq,
+        U16 lastSeq
+    )
+  {
+    U32 matched = 0;
+    InboxMessage message;
+    const U16 span = static_cast<U16>(lastSeq - firstSeq);
+    for (U32 id = m_inbox.firstFrom(sender); m_inbox.get(id, message); id = m_inbox.nextFromSender(id)) {
+      if (static_cast<U16>(message.seq - firstSeq) <= span) {
+        matched++;
+        this->writeResult(message, true);
+      }
+    }
+    this->finishQuery(matched);
+    this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::OK);
+  }
+
+  void BroncoOreMessageHandler ::
+    PROBE_START_cmdHandler(
+        FwOpcodeType opCode,
+        U32 cmdSeq,
+        U8 target,
+        U16 count,
+        U16 size,
+        U16 interval
+    )
+  {
+    if ((target == PROBE_MARKER) || (count == 0) || (interval == 0) || (size < PROBE_HEADER_SIZE) ||
+        (size > FW_COM_BUFFER_MAX_SIZE)) {
+      this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::VALIDATION_ERROR);
+      return;
+    }
+    if (m_probing) {
+      this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::BUSY);
+      return;
+    }
+    m_probing = true;
+    m_probeRun++;
+    m_probeTarget = target;
+    m_probeSize = size;
+    m_probeInterval = interval;
+    m_probeCount = count;
+    m_probesSent = 0;
+    m_probeEchoes = 0;
+    m_forwardUs = 0;
+    m_returnUs = 0;
+    m_roundTrips.reset();
+    this->writeProbeTelemetry();
+    // The first probe goes out now; the rest follow every interval
+    this->sendProbe();
+    this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::OK);
+  }
+
+  void BroncoOreMessageHandler ::
+    PROBE_STOP_cmdHandler(
+        FwOpcodeType opCode,
+        U32 cmdSeq
+    )
+  {
+    if (m_probing) {
+      m_probing = false;
+      this->reportProbes();
+    }
+    this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::OK);
+  }
+
+  void BroncoOreMessageHandler ::
+    PROBE_REPORT_cmdHandler(
+        FwOpcodeType opCode,
+        U32 cmdSeq
+    )
+  {
+    this->reportProbes();
+    this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::OK);
+  }
+
+  // ----------------------------------------------------------------------
+  // Helpers
+  // ----------------------------------------------------------------------
+
+  void BroncoOreMessageHandler ::
+    recordMessage(const U8* message, FwSizeType size)
+  {
+    if (not m_messageLog.getBuffer().isValid() && not this->openMessageLog()) {
+      return;
+    }
+    // Records are serialized directly into the container buffer that DpWriter will write out
+    Fw::SerializeStatus status = m_messageLog.serializeRecord_Message(message, size);
+    if (status == Fw::FW_SERIALIZE_NO_ROOM_LEFT) {
+      this->sendMessageLog();
+      if (not this->openMessageLog()) {
+        return;
+      }
+      status = m_messageLog.serializeRecord_Message(message, size);
+    }
+    if (status == Fw::FW_SERIALIZE_OK) {
+      m_messagesRecorded++;
+      this->tlmWrite_MessagesRecorded(m_messagesRecorded);
+    }
+  }
+
+  bool BroncoOreMessageHandler ::
+    openMessageLog()
+  {
+    if (this->dpGet_MessageLog(MESSAGE_LOG_DATA_SIZE, m_messageLog) != Fw::Success::SUCCESS) {
+      this->log_WARNING_LO_MessageLogUnavailable();
+      return false;
+    }
+    m_messageLog.setProcTypes(MESSAGE_LOG_PROC_TYPES);
+    return true;
+  }
+
+  void BroncoOreMessageHandler ::
+    sendMessageLog()
+  {
+    if (not m_messageLog.getBuffer().isValid() || (m_messageLog.getDataSize() == 0)) {
+      return;
+    }
+    this->dpSend(m_messageLog, this->getTime());
+    m_messageLog = DpContainer();
+  }
+
+  void BroncoOreMessageHandler ::
+    writeResult(const InboxMessage& message, bool withText)
+  {
+    if (m_resultsCut) {
+      return;
+    }
+    // A message's entry and text go in the same container, so check there is room for both before writing either
+    FwSizeType needed = sizeof(FwDpIdType) + InboxEntry::SERIALIZED_SIZE;
+    if (withText) {
+      needed += sizeof(FwDpIdType) + sizeof(FwSizeType) + message.size;
+    }
+    if (m_results.getBuffer().isValid() && (INBOX_RESULTS_DATA_SIZE - m_results.getDataSize() < needed)) {
+      this->dpSend(m_results, this->getTime());
+      m_results = DpContainer();
+      m_resultsContainers++;
+    }
+    if (not m_results.getBuffer().isValid()) {
+      if (this->dpGet_InboxResults(INBOX_RESULTS_DATA_SIZE, m_results) != Fw::Success::SUCCESS) {
+        this->log_WARNING_LO_InboxResultsUnavailable();
+        m_resultsCut = true;
+        return;
+      }
+    }
+
+    const InboxEntry entry(message.id, message.sender, message.seq, message.seconds, message.useconds, message.size);
+    Fw::SerializeStatus status = m_results.serializeRecord_Entry(entry);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    if (withText) {
+      status = m_results.serializeRecord_Message(message.text, message.size);
+      FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    }
+    m_resultsWritten++;
+  }
+
+  void BroncoOreMessageHandler ::
+    finishQuery(U32 matched)
+  {
+    if (m_results.getBuffer().isValid()) {
+      this->dpSend(m_results, this->getTime());
+      m_results = DpContainer();
+      m_resultsContainers++;
+    }
+    this->log_ACTIVITY_LO_InboxQueried(matched, m_resultsWritten, m_resultsContainers);
+    m_resultsWritten = 0;
+    m_resultsContainers = 0;
+    m_resultsCut = false;
+  }
+
+  void BroncoOreMessageHandler ::
+    writeInboxTelemetry()
+  {
+    this->tlmWrite_InboxMessages(m_inbox.count());
+    this->tlmWrite_InboxBytes(m_inbox.bytesUsed());
+    this->tlmWrite_InboxEvictions(m_inbox.evictions());
+  }
+
+  void BroncoOreMessageHandler ::
+    sendProbe()
+  {
+    Fw::ParamValid valid;
+    const U8 address = this->paramGet_NODE_ADDRESS(valid);
+
+    Fw::ComBuffer probe;
+    Fw::SerializeStatus status = probe.serialize(PROBE_MARKER);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = probe.serialize(static_cast<U8>(PROBE_REQUEST));
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = probe.serialize(address);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = probe.serialize(m_probeTarget);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = probe.serialize(m_probeRun);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = probe.serialize(m_probesSent);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = probe.serialize(this->nowUs());
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    // Filled in by the target as it echoes the probe
+    status = probe.serialize(static_cast<U64>(0));
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    // Padding to the probe size, which is what the size measures
+    U8 padding[FW_COM_BUFFER_MAX_SIZE];
+    memset(padding, 0, sizeof(padding));
+    status = probe.serialize(padding, m_probeSize - PROBE_HEADER_SIZE, true);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+
+    m_probesSent++;
+    m_probeTicks = 0;
+    this->tlmWrite_ProbesSent(m_probesSent);
+    this->send_message_out(0, probe, 0);
+  }
+
+  void BroncoOreMessageHandler ::
+    receiveProbe(Fw::ComBuffer& data)
+  {
+    if (data.getBuffLength() < PROBE_HEADER_SIZE) {
+      this->log_WARNING_LO_MessageMalformed(data.getBuffLength());
+      return;
+    }
+    const U64 receivedUs = this->nowUs();
+    U8 marker = 0;
+    U8 kind = 0;
+    U8 origin = 0;
+    U8 target = 0;
+    U8 run = 0;
+    U16 seq = 0;
+    U64 sentUs = 0;
+    U64 echoedUs = 0;
+    data.resetDeser();
+    Fw::SerializeStatus status = data.deserialize(marker);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = data.deserialize(kind);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = data.deserialize(origin);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = data.deserialize(target);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = data.deserialize(run);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = data.deserialize(seq);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = data.deserialize(sentUs);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = data.deserialize(echoedUs);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+
+    Fw::ParamValid valid;
+    const U8 address = this->paramGet_NODE_ADDRESS(valid);
+    if (kind == PROBE_REQUEST) {
+      if (target != address) {
+        return;
+      }
+      // The probe came up through the radio's receive path, which still holds the radio, so the echo waits for run
+      if (m_echoCount == LatencyProbeCfg::ECHO_QUEUE_DEPTH) {
+        return;
+      }
+      // Echoed whole, so the echo is as large as the probe, with the time it arrived here stamped in
+      Fw::ComBuffer& echo = m_echoes[(m_echoHead + m_echoCount) % LatencyProbeCfg::ECHO_QUEUE_DEPTH];
+      echo.resetSer();
+      status = echo.serialize(data.getBuffAddr(), data.getBuffLength(), true);
+      FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+      m_echoCount++;
+      U8* const bytes = echo.getBuffAddr();
+      bytes[1] = PROBE_ECHO;
+      const U32 echoedOffset = PROBE_HEADER_SIZE - sizeof(U64);
+      for (U32 i = 0; i < sizeof(U64); i++) {
+        bytes[echoedOffset + i] = static_cast<U8>(receivedUs >> (8 * (sizeof(U64) - 1 - i)));
+      }
+      return;
+    }
+    // An echo of this node's current run; an earlier run's echoes, or any sent before the clock stepped back, are
+    // not round trips of it
+    if ((kind != PROBE_ECHO) || (origin != address) || (run != m_probeRun) || (seq >= m_probesSent) ||
+        (receivedUs < sentUs)) {
+      return;
+    }
+    m_probeEchoes++;
+    m_roundTrips.add(static_cast<U32>(FW_MIN(receivedUs - sentUs, static_cast<U64>(0xFFFFFFFF))));
+    m_forwardUs = static_cast<I32>(static_cast<I64>(echoedUs - sentUs));
+    m_returnUs = static_cast<I32>(static_cast<I64>(receivedUs - echoedUs));
+    this->writeProbeTelemetry();
+  }
+
+  void BroncoOreMessageHandler ::
+    sendEchoes()
+  {
+    while (m_echoCount > 0) {
+      Fw::ComBuffer& echo = m_echoes[m_echoHead];
+      m_echoHead = (m_echoHead + 1) % LatencyProbeCfg::ECHO_QUEUE_DEPTH;
+      m_echoCount--;
+      this->send_message_out(0, echo, 0);
+    }
+  }
+
+  void BroncoOreMessageHandler ::
+    reportProbes()
+  {
+    this->writeProbeTelemetry();
+    this->log_ACTIVITY_HI_ProbeReport(m_probeTarget, m_probeSize, m_probesSent, m_probeEchoes, m_roundTrips.min(),
+                                      m_roundTrips.mean(), m_roundTrips.p95(), m_roundTrips.max(),
+                                      m_roundTrips.jitter());
+  }
+
+  void BroncoOreMessageHandler ::
+    writeProbeTelemetry()
+  {
+    this->tlmWrite_ProbesSent(m_probesSent);
+    this->tlmWrite_ProbeEchoes(m_probeEchoes);
+    this->tlmWrite_ProbeRttMin(m_roundTrips.min());
+    this->tlmWrite_ProbeRttMean(m_roundTrips.mean());
+    this->tlmWrite_ProbeRttP95(m_roundTrips.p95());
+    this->tlmWrite_ProbeRttMax(m_roundTrips.max());
+    this->tlmWrite_ProbeJitter(m_roundTrips.jitter());
+    this->tlmWrite_ProbeForwardLatency(m_forwardUs);
+    this->tlmWrite_ProbeReturnLatency(m_returnUs);
+  }
+
+  U64 BroncoOreMessageHandler ::
+    nowUs()
+  {
+    const Fw::Time now = this->getTime();
+    return static_cast<U64>(now.getSeconds()) * 1000000 + now.getUSeconds();
   }
 }
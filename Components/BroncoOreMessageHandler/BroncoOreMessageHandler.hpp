@@ -8,6 +8,8 @@
 #define Components_BroncoOreMessageHandler_HPP
 
 #include "Components/BroncoOreMessageHandler/BroncoOreMessageHandlerComponentAc.hpp"
+#include "Components/BroncoOreMessageHandler/LatencyHistogram.hpp"
+#include "Components/BroncoOreMessageHandler/MessageInbox.hpp"
 
 namespace Components {
 
@@ -17,6 +19,26 @@ namespace Components {
 
     public:
 
+      //! Data bytes in each message log container
+      static const FwSizeType MESSAGE_LOG_DATA_SIZE = 1024;
+
+      //! Processing applied to message log containers before they are written
+      static const Fw::DpCfg::ProcType::SerialType MESSAGE_LOG_PROC_TYPES =
+          Fw::DpCfg::ProcType::COMPRESS | Fw::DpCfg::ProcType::CHECKSUM;
+
+      //! Data bytes in each inbox results container
+      static const FwSizeType INBOX_RESULTS_DATA_SIZE = 1024;
+
+      //! Bytes ahead of the text of every message sent between satellites: the sender's address and sequence number
+      static const U32 MESSAGE_HEADER_SIZE = sizeof(U8) + sizeof(U16);
+
+      //! Sender address that marks a probe or echo rather than a message; no node has address 0
+      static const U8 PROBE_MARKER = 0;
+
+      //! Bytes of a probe's header: the marker, its kind, origin, target, run and sequence number, the time it was
+      //! sent and the time it was echoed
+      static const U32 PROBE_HEADER_SIZE = 5 * sizeof(U8) + sizeof(U16) + 2 * sizeof(U64);
+
       // ----------------------------------------------------------------------
       // Component construction and destruction
       // ----------------------------------------------------------------------
@@ -44,6 +66,12 @@ namespace Components {
           U32 context //!< Call context value; meaning chosen by user
       ) override;
 
+      //! Handler implementation for run
+      void run_handler(
+          FwIndexType portNum, //!< The port number
+          U32 context //!< The call order
+      ) override;
+
     PRIVATE:
 
       // ----------------------------------------------------------------------
@@ -59,6 +87,165 @@ namespace Components {
           const Fw::CmdStringArg& message
       ) override;
 
+      //! Handler implementation for command FLUSH_MESSAGE_LOG
+      //!
+      //! Command to send the message log container now instead of when it fills
+      void FLUSH_MESSAGE_LOG_cmdHandler(
+          FwOpcodeType opCode, //!< The opcode
+          U32 cmdSeq //!< The command sequence number
+      ) override;
+
+      //! Handler implementation for command INBOX_LIST
+      //!
+      //! List the messages in the inbox that arrived in a time range, without their text
+      void INBOX_LIST_cmdHandler(
+          FwOpcodeType opCode, //!< The opcode
+          U32 cmdSeq, //!< The command sequence number
+          U8 sender, //!< Address of the sending node, 0 for every sender
+          U32 startTime, //!< Earliest arrival time, seconds
+          U32 endTime //!< Latest arrival time, seconds
+      ) override;
+
+      //! Handler implementation for command INBOX_FETCH
+      //!
+      //! Fetch the messages in the inbox with ids in a range
+      void INBOX_FETCH_cmdHandler(
+          FwOpcodeType opCode, //!< The opcode
+          U32 cmdSeq, //!< The command sequence number
+          U32 firstId, //!< First id fetched
+          U32 lastId //!< Last id fetched
+      ) override;
+
+      //! Handler implementation for command INBOX_FETCH_FROM
+      //!
+      //! Fetch the messages in the inbox from one sender with sequence numbers in a range
+      void INBOX_FETCH_FROM_cmdHandler(
+          FwOpcodeType opCode, //!< The opcode
+          U32 cmdSeq, //!< The command sequence number
+          U8 sender, //!< Address of the sending node
+          U16 firstSeq, //!< First sequence number fetched
+          U16 lastSeq //!< Last sequence number fetched, which may have wrapped past 0xFFFF
+      ) override;
+
+      //! Handler implementation for command PROBE_START
+      //!
+      //! Send timestamped probes to a node, which echoes them back, and measure the round trips
+      void PROBE_START_cmdHandler(
+          FwOpcodeType opCode, //!< The opcode
+          U32 cmdSeq, //!< The command sequence number
+          U8 target, //!< Address of the node that echoes the probes
+          U16 count, //!< Probes to send
+          U16 size, //!< Bytes of each probe and its echo, header included
+          U16 interval //!< Rate group calls between probes
+      ) override;
+
+      //! Handler implementation for command PROBE_STOP
+      //!
+      //! Stop sending probes and report the run so far
+      void PROBE_STOP_cmdHandler(
+          FwOpcodeType opCode, //!< The opcode
+          U32 cmdSeq //!< The command sequence number
+      ) override;
+
+      //! Handler implementation for command PROBE_REPORT
+      //!
+      //! Report the round trips measured so far
+      void PROBE_REPORT_cmdHandler(
+          FwOpcodeType opCode, //!< The opcode
+          U32 cmdSeq //!< The command sequence number
+      ) override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Helpers
+      // ----------------------------------------------------------------------
+
+      //! Write a message straight into the message log container, getting a new container when it is full
+      void recordMessage(const U8* message, FwSizeType size);
+
+      //! Get an empty message log container
+      //!
+      //! \return false if none is available
+      bool openMessageLog();
+
+      //! Send the message log container if it holds anything
+      void sendMessageLog();
+
+      //! Write one message of an inbox query to the results container, getting a new container when it is full
+      //!
+      //! Once no container is available the rest of the query's messages are dropped.
+      void writeResult(
+          const InboxMessage& message, //!< The message
+          bool withText //!< Whether to write the message text after its entry
+      );
+
+      //! Send the results container if it holds anything and report the query
+      void finishQuery(
+          U32 matched //!< Messages the query matched
+      );
+
+      //! Publish the inbox telemetry
+      void writeInboxTelemetry();
+
+      //! Kinds of probe message
+      enum ProbeKind : U8 {
+        PROBE_REQUEST = 1, //!< A probe, to be echoed by its target
+        PROBE_ECHO = 2 //!< A probe echoed back to its origin
+      };
+
+      //! Send the next probe of the run
+      void sendProbe();
+
+      //! Queue the echo of a probe addressed to this node, or measure an echo of one of this node's probes
+      void receiveProbe(
+          Fw::ComBuffer& data //!< The probe, marker included
+      );
+
+      //! Send the queued echoes
+      void sendEchoes();
+
+      //! Report the probe run and publish its telemetry
+      void reportProbes();
+
+      //! Publish the probe telemetry
+      void writeProbeTelemetry();
+
+      //! Current time in microseconds
+      U64 nowUs();
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Member variables
+      // ----------------------------------------------------------------------
+
+      DpContainer m_messageLog; //!< Container being filled, invalid buffer if none
+      U32 m_messagesRecorded; //!< Messages recorded
+      MessageInbox m_inbox; //!< Messages received, for inbox queries
+      DpContainer m_results; //!< Inbox results container being filled, invalid buffer if none
+      U32 m_resultsWritten; //!< Messages written by the current inbox query
+      U32 m_resultsContainers; //!< Containers sent by the current inbox query
+      bool m_resultsCut; //!< Whether the current inbox query ran out of containers
+      U16 m_sendSeq; //!< Sequence number of the next message sent
+
+      bool m_probing; //!< Whether a probe run is sending or waiting for echoes
+      U8 m_probeRun; //!< Number of the current probe run, carried in its probes so late echoes of others are ignored
+      U8 m_probeTarget; //!< Address of the node echoing the probes
+      U16 m_probeSize; //!< Bytes of each probe
+      U16 m_probeInterval; //!< Rate group calls between probes
+      U16 m_probeCount; //!< Probes to send
+      U16 m_probesSent; //!< Probes sent
+      U32 m_probeEchoes; //!< Echoes received
+      U32 m_probeTicks; //!< Rate group calls since the last probe was sent
+      I32 m_forwardUs; //!< Forward latency of the last echo
+      I32 m_returnUs; //!< Return latency of the last echo
+      LatencyHistogram m_roundTrips; //!< Round trips of the current run
+
+      Fw::ComBuffer m_echoes[LatencyProbeCfg::ECHO_QUEUE_DEPTH]; //!< Echoes waiting for run, oldest at m_echoHead
+      U32 m_echoHead; //!< Index of the oldest queued echo
+      U32 m_echoCount; //!< Echoes queued
+
   };
 
 }
@@ -0,0 +1,73 @@
+// ======================================================================
+// \title  LatencyHistogram.cpp
+// \brief  Fixed-memory summary of round trip times: extremes, mean, 95th percentile and jitter
+// ======================================================================
+
+#include "Components/BroncoOreMessageHandler/LatencyHistogram.hpp"
+
+#include <cstring>
+
+namespace Components {
+
+  LatencyHistogram ::
+    LatencyHistogram()
+  {
+    this->reset();
+  }
+
+  void LatencyHistogram ::
+    reset()
+  {
+    memset(m_bins, 0, sizeof(m_bins));
+    m_count = 0;
+    m_sumUs = 0;
+    m_min = 0;
+    m_max = 0;
+    m_last = 0;
+    m_jitterScaled = 0;
+  }
+
+  void LatencyHistogram ::
+    add(U32 us)
+  {
+    const U32 bin = FW_MIN(us / LatencyProbeCfg::HISTOGRAM_BIN_US, LatencyProbeCfg::HISTOGRAM_BINS - 1);
+    m_bins[bin]++;
+    if (m_count > 0) {
+      // J += (|D| - J) / 16, with J kept 16 times larger
+      const U32 change = (us > m_last) ? (us - m_last) : (m_last - us);
+      m_jitterScaled = m_jitterScaled + change - (m_jitterScaled >> LatencyProbeCfg::JITTER_GAIN_SHIFT);
+    }
+    m_min = (m_count == 0) ? us : FW_MIN(m_min, us);
+    m_max = FW_MAX(m_max, us);
+    m_last = us;
+    m_sumUs += us;
+    m_count++;
+  }
+
+  U32 LatencyHistogram ::
+    mean() const
+  {
+    return (m_count == 0) ? 0 : static_cast<U32>(m_sumUs / m_count);
+  }
+
+  U32 LatencyHistogram ::
+    p95() const
+  {
+    if (m_count == 0) {
+      return 0;
+    }
+    // Nearest rank: the smallest bin by which at least 95% of the samples are counted
+    const U64 rank = (static_cast<U64>(m_count) * 95 + 99) / 100;
+    U64 counted = 0;
+    U32 bin = 0;
+    for (; bin < LatencyProbeCfg::HISTOGRAM_BINS - 1; bin++) {
+      counted += m_bins[bin];
+      if (counted >= rank) {
+        break;
+      }
+    }
+    const U64 top = static_cast<U64>(bin + 1) * LatencyProbeCfg::HISTOGRAM_BIN_US;
+    return static_cast<U32>(FW_MIN(top, static_cast<U64>(m_max)));
+  }
+
+}
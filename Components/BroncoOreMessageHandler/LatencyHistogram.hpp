@@ -0,0 +1,60 @@
+// ======================================================================
+// \title  LatencyHistogram.hpp
+// \brief  Fixed-memory summary of round trip times: extremes, mean, 95th percentile and jitter
+//
+// Samples are counted in bins of LatencyProbeCfg::HISTOGRAM_BIN_US, so the percentile is read off the bins without
+// keeping the samples. Jitter is the smoothed difference between consecutive samples, as RFC 3550 computes it for
+// interarrival times.
+// ======================================================================
+
+#ifndef Components_LatencyHistogram_HPP
+#define Components_LatencyHistogram_HPP
+
+#include <FpConfig.hpp>
+#include <config/LatencyProbeCfg.hpp>
+
+namespace Components {
+
+  class LatencyHistogram {
+    public:
+      LatencyHistogram();
+
+      //! Forget every sample
+      void reset();
+
+      //! Count one round trip
+      void add(
+          U32 us //!< The round trip in microseconds
+      );
+
+      //! Samples counted
+      U32 count() const { return m_count; }
+
+      //! Shortest sample in microseconds, 0 if there are none
+      U32 min() const { return m_min; }
+
+      //! Longest sample in microseconds
+      U32 max() const { return m_max; }
+
+      //! Mean of the samples in microseconds, 0 if there are none
+      U32 mean() const;
+
+      //! 95th percentile in microseconds: the top of the bin holding it, or the longest sample if that is less
+      U32 p95() const;
+
+      //! Jitter in microseconds
+      U32 jitter() const { return m_jitterScaled >> LatencyProbeCfg::JITTER_GAIN_SHIFT; }
+
+    private:
+      U32 m_bins[LatencyProbeCfg::HISTOGRAM_BINS]; //!< Samples in each bin
+      U32 m_count; //!< Samples counted
+      U64 m_sumUs; //!< Sum of the samples
+      U32 m_min; //!< Shortest sample
+      U32 m_max; //!< Longest sample
+      U32 m_last; //!< Last sample, for the jitter
+      U32 m_jitterScaled; //!< Jitter times 2^JITTER_GAIN_SHIFT, kept scaled so the smoothing does not round away
+  };
+
+}
+
+#endif
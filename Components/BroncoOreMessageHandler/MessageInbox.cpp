@@ -0,0 +1,179 @@
+// ======================================================================
+// \title  MessageInbox.cpp
+// \brief  Fixed-memory store of the messages received from other satellites
+// ======================================================================
+
+#include "Components/BroncoOreMessageHandler/MessageInbox.hpp"
+#include <Fw/Types/Assert.hpp>
+
+#include <cstring>
+
+namespace Components {
+
+  namespace {
+    //! Arrival time as one number, for ordering
+    U64 stamp(U32 seconds, U32 useconds) {
+      return static_cast<U64>(seconds) * 1000000 + useconds;
+    }
+  }
+
+  MessageInbox ::
+    MessageInbox() :
+      m_first(0),
+      m_count(0),
+      m_firstId(0),
+      m_bytesUsed(0),
+      m_evictions(0)
+  {
+    memset(m_arena, 0, sizeof(m_arena));
+    memset(m_entries, 0, sizeof(m_entries));
+    memset(m_oldestFrom, NO_ENTRY, sizeof(m_oldestFrom));
+    memset(m_newestFrom, NO_ENTRY, sizeof(m_newestFrom));
+  }
+
+  bool MessageInbox ::
+    insert(U8 sender, U16 seq, U32 seconds, U32 useconds, const U8* text, U32 size)
+  {
+    // An empty message would share its offset with its neighbour and hide where the text wraps
+    if ((size == 0) || (size > MessageInboxCfg::ARENA_BYTES)) {
+      return false;
+    }
+    if (m_count == MessageInboxCfg::CAPACITY) {
+      this->evict();
+    }
+    I32 offset = this->placement(size);
+    while (offset < 0) {
+      this->evict();
+      offset = this->placement(size);
+    }
+
+    if (m_count > 0) {
+      const Entry& newest = m_entries[this->slotOf(this->nextId() - 1)];
+      if (stamp(seconds, useconds) < stamp(newest.seconds, newest.useconds)) {
+        seconds = newest.seconds;
+        useconds = newest.useconds;
+      }
+    }
+
+    const U8 slot = this->slotOf(this->nextId());
+    Entry& entry = m_entries[slot];
+    entry.offset = static_cast<U16>(offset);
+    entry.size = static_cast<U16>(size);
+    entry.seconds = seconds;
+    entry.useconds = useconds;
+    entry.seq = seq;
+    entry.sender = sender;
+    entry.nextFromSender = NO_ENTRY;
+    memcpy(&m_arena[offset], text, size);
+
+    if (m_newestFrom[sender] == NO_ENTRY) {
+      m_oldestFrom[sender] = slot;
+    } else {
+      m_entries[m_newestFrom[sender]].nextFromSender = slot;
+    }
+    m_newestFrom[sender] = slot;
+    m_count++;
+    m_bytesUsed += size;
+    return true;
+  }
+
+  bool MessageInbox ::
+    get(U32 id, InboxMessage& message) const
+  {
+    if (not this->holds(id)) {
+      return false;
+    }
+    const Entry& entry = m_entries[this->slotOf(id)];
+    message.id = id;
+    message.sender = entry.sender;
+    message.seq = entry.seq;
+    message.seconds = entry.seconds;
+    message.useconds = entry.useconds;
+    message.text = &m_arena[entry.offset];
+    message.size = entry.size;
+    return true;
+  }
+
+  U32 MessageInbox ::
+    firstAtOrAfter(U32 seconds, U32 useconds) const
+  {
+    // Entries are in time order, so the first one at or after the time is found by bisection
+    const U64 target = stamp(seconds, useconds);
+    U32 low = 0;
+    U32 high = m_count;
+    while (low < high) {
+      const U32 middle = low + (high - low) / 2;
+      const Entry& entry = m_entries[this->slotOf(m_firstId + middle)];
+      if (stamp(entry.seconds, entry.useconds) < target) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    return (low < m_count) ? m_firstId + low : NO_ID;
+  }
+
+  U32 MessageInbox ::
+    firstFrom(U8 sender) const
+  {
+    const U8 slot = m_oldestFrom[sender];
+    if (slot == NO_ENTRY) {
+      return NO_ID;
+    }
+    return m_firstId + (slot + MessageInboxCfg::CAPACITY - m_first) % MessageInboxCfg::CAPACITY;
+  }
+
+  U32 MessageInbox ::
+    nextFromSender(U32 id) const
+  {
+    FW_ASSERT(this->holds(id), id, m_firstId, m_count);
+    const U8 slot = m_entries[this->slotOf(id)].nextFromSender;
+    if (slot == NO_ENTRY) {
+      return NO_ID;
+    }
+    return m_firstId + (slot + MessageInboxCfg::CAPACITY - m_first) % MessageInboxCfg::CAPACITY;
+  }
+
+  I32 MessageInbox ::
+    placement(U32 size) const
+  {
+    if (m_count == 0) {
+      return 0;
+    }
+    const Entry& oldest = m_entries[m_first];
+    const Entry& newest = m_entries[this->slotOf(this->nextId() - 1)];
+    const U32 end = newest.offset + newest.size;
+    if (newest.offset >= oldest.offset) {
+      // Text runs from the oldest message to the newest: room after it, or at the start of the arena
+      if (end + size <= MessageInboxCfg::ARENA_BYTES) {
+        return static_cast<I32>(end);
+      }
+      if (size <= oldest.offset) {
+        return 0;
+      }
+    } else if (end + size <= oldest.offset) {
+      // Text has wrapped: the only room is between the newest message and the oldest
+      return static_cast<I32>(end);
+    }
+    return -1;
+  }
+
+  void MessageInbox ::
+    evict()
+  {
+    FW_ASSERT(m_count > 0);
+    const Entry& oldest = m_entries[m_first];
+    // The oldest message is also the oldest from its sender
+    FW_ASSERT(m_oldestFrom[oldest.sender] == m_first, m_oldestFrom[oldest.sender], m_first);
+    m_oldestFrom[oldest.sender] = oldest.nextFromSender;
+    if (oldest.nextFromSender == NO_ENTRY) {
+      m_newestFrom[oldest.sender] = NO_ENTRY;
+    }
+    m_bytesUsed -= oldest.size;
+    m_first = static_cast<U8>((m_first + 1) % MessageInboxCfg::CAPACITY);
+    m_count--;
+    m_firstId++;
+    m_evictions++;
+  }
+
+}
@@ -0,0 +1,126 @@
+// ======================================================================
+// \title  MessageInbox.hpp
+// \brief  Fixed-memory store of the messages received from other satellites
+//
+// Message text lives in a ring arena, one message after another, and is evicted oldest first. Entries are numbered
+// in the order they arrive, kept in time order, and chained by sender, so a range of any of the three is found
+// without scanning the whole inbox.
+// ======================================================================
+
+#ifndef Components_MessageInbox_HPP
+#define Components_MessageInbox_HPP
+
+#include <FpConfig.hpp>
+#include <config/MessageInboxCfg.hpp>
+
+namespace Components {
+
+  //! A message held by the inbox
+  struct InboxMessage {
+    U32 id; //!< Number given to the message as it arrived, counting up from 0 since startup
+    U8 sender; //!< Address of the sending node
+    U16 seq; //!< Sender's sequence number
+    U32 seconds; //!< Arrival time, seconds
+    U32 useconds; //!< Arrival time, microseconds
+    const U8* text; //!< Message text, valid until the next insert
+    U16 size; //!< Bytes of text
+  };
+
+  class MessageInbox {
+    public:
+      //! Id returned when no message matches
+      static const U32 NO_ID = 0xFFFFFFFF;
+
+      MessageInbox();
+
+      //! Store a message, evicting the oldest ones until there is room for it
+      //!
+      //! A message stamped earlier than the newest one, as after the clock is stepped back, is stamped with the
+      //! newest one's time so the inbox stays in time order.
+      //!
+      //! \return false if the message is empty or larger than the arena and was not stored
+      bool insert(
+          U8 sender, //!< Address of the sending node
+          U16 seq, //!< Sender's sequence number
+          U32 seconds, //!< Arrival time, seconds
+          U32 useconds, //!< Arrival time, microseconds
+          const U8* text, //!< Message text
+          U32 size //!< Bytes of text
+      );
+
+      //! Look up a message by id
+      //!
+      //! \return false if the message was never stored or has been evicted
+      bool get(U32 id, InboxMessage& message) const;
+
+      //! Id of the oldest message that arrived at or after a time, NO_ID if none did
+      U32 firstAtOrAfter(U32 seconds, U32 useconds) const;
+
+      //! Id of the oldest message held from a sender, NO_ID if none is
+      U32 firstFrom(U8 sender) const;
+
+      //! Id of the next message from the same sender as a held message, NO_ID if there is none
+      U32 nextFromSender(U32 id) const;
+
+      //! Id of the oldest message held, which is the next id to be stored when the inbox is empty
+      U32 firstId() const { return m_firstId; }
+
+      //! Id the next message stored will be given
+      U32 nextId() const { return m_firstId + m_count; }
+
+      //! Messages held
+      U32 count() const { return m_count; }
+
+      //! Bytes of the arena holding message text
+      U32 bytesUsed() const { return m_bytesUsed; }
+
+      //! Messages evicted to make room since startup
+      U32 evictions() const { return m_evictions; }
+
+    PRIVATE:
+      //! Index of no entry, in a sender chain or the sender table
+      static const U8 NO_ENTRY = 0xFF;
+
+      //! Senders have U8 addresses, each with a chain of its messages
+      static const U32 SENDERS = 256;
+
+      static_assert(MessageInboxCfg::CAPACITY < NO_ENTRY, "inbox entries are indexed by a U8");
+      static_assert(MessageInboxCfg::ARENA_BYTES < 0x10000, "arena offsets are U16");
+
+      //! Where a held message is and what it is
+      struct Entry {
+        U16 offset; //!< Start of the text in the arena
+        U16 size; //!< Bytes of text
+        U32 seconds; //!< Arrival time, seconds
+        U32 useconds; //!< Arrival time, microseconds
+        U16 seq; //!< Sender's sequence number
+        U8 sender; //!< Address of the sending node
+        U8 nextFromSender; //!< Entry of the next message from the same sender, NO_ENTRY if none
+      };
+
+      //! Entry holding a message, which must be held
+      U8 slotOf(U32 id) const { return static_cast<U8>((m_first + (id - m_firstId)) % MessageInboxCfg::CAPACITY); }
+
+      //! Whether a message is held
+      bool holds(U32 id) const { return (id - m_firstId) < m_count; }
+
+      //! Offset in the arena where a message of a given size would go without evicting anything, or -1 if none
+      I32 placement(U32 size) const;
+
+      //! Evict the oldest message
+      void evict();
+
+      U8 m_arena[MessageInboxCfg::ARENA_BYTES]; //!< Message text
+      Entry m_entries[MessageInboxCfg::CAPACITY]; //!< Held messages, a ring in arrival order
+      U8 m_oldestFrom[SENDERS]; //!< Entry of each sender's oldest held message
+      U8 m_newestFrom[SENDERS]; //!< Entry of each sender's newest held message
+      U8 m_first; //!< Entry of the oldest held message
+      U32 m_count; //!< Messages held
+      U32 m_firstId; //!< Id of the oldest held message
+      U32 m_bytesUsed; //!< Bytes of text held
+      U32 m_evictions; //!< Messages evicted since startup
+  };
+
+}
+
+#endif
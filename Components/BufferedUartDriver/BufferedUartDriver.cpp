@@ -0,0 +1,198 @@
+// ======================================================================
+// \title  BufferedUartDriver.cpp
+// \brief  cpp file for BufferedUartDriver component implementation class
+// ======================================================================
+
+#include "Components/BufferedUartDriver/BufferedUartDriver.hpp"
+#include "FpConfig.hpp"
+
+namespace Components {
+
+  // ----------------------------------------------------------------------
+  // Component construction and destruction
+  // ----------------------------------------------------------------------
+
+  BufferedUartDriver ::
+    BufferedUartDriver(const char* const compName) :
+      BufferedUartDriverComponentBase(compName),
+#ifdef ARDUINO
+      m_stream(nullptr),
+#ifdef ARDUINO_ARCH_RP2040
+      m_uart(nullptr),
+#endif
+#else
+      m_fd(-1),
+#endif
+      m_rxActive(0),
+      m_rxFill(0),
+      m_rxIdlePolls(0),
+      m_txHead(0),
+      m_txCount(0),
+      m_txOffset(0),
+      m_rxOverruns(0),
+      m_txOverruns(0),
+      m_rxWindowBytes(0),
+      m_txWindowBytes(0),
+      m_windowStarted(false)
+  {
+
+  }
+
+  BufferedUartDriver ::
+    ~BufferedUartDriver()
+  {
+    this->close();
+  }
+
+  // ----------------------------------------------------------------------
+  // Handler implementations for user-defined typed input ports
+  // ----------------------------------------------------------------------
+
+  void BufferedUartDriver ::
+    schedIn_handler(
+        FwIndexType portNum,
+        NATIVE_UINT_TYPE context
+    )
+  {
+    if (not this->isOpen()) {
+      return;
+    }
+    this->pollReceive();
+
+    this->lock();
+    this->pollTransmit();
+    this->unLock();
+
+    this->updateRates();
+  }
+
+  Drv::SendStatus BufferedUartDriver ::
+    send_handler(
+        FwIndexType portNum,
+        Fw::Buffer& sendBuffer
+    )
+  {
+    // Guarded port: the component lock is already held
+    if (m_txCount == BufferedUartDriverCfg::TX_QUEUE_DEPTH) {
+      m_txOverruns++;
+      this->deallocate_out(0, sendBuffer);
+      return Drv::SendStatus::SEND_ERROR;
+    }
+    m_txQueue[(m_txHead + m_txCount) % BufferedUartDriverCfg::TX_QUEUE_DEPTH] = sendBuffer;
+    m_txCount++;
+
+    // Start writing right away; whatever the UART does not accept now goes out on the next poll
+    if (this->isOpen()) {
+      this->pollTransmit();
+    }
+    return Drv::SendStatus::SEND_OK;
+  }
+
+  // ----------------------------------------------------------------------
+  // Helpers
+  // ----------------------------------------------------------------------
+
+  bool BufferedUartDriver ::
+    refill(U32 slot)
+  {
+    if (not m_rxBuffers[slot].isValid()) {
+      m_rxBuffers[slot] = this->allocate_out(0, BufferedUartDriverCfg::RX_CHUNK_SIZE);
+    }
+    return m_rxBuffers[slot].isValid() && (m_rxBuffers[slot].getSize() > 0);
+  }
+
+  void BufferedUartDriver ::
+    pollReceive()
+  {
+    if (this->rxOverflowed()) {
+      // The device buffer filled between polls and dropped bytes, which the deframer resynchronizes past
+      m_rxOverruns++;
+    }
+    while (true) {
+      if (not this->refill(m_rxActive)) {
+        if (this->rxAvailable() > 0) {
+          m_rxOverruns++;
+        }
+        return;
+      }
+      Fw::Buffer& active = m_rxBuffers[m_rxActive];
+      const U32 capacity = active.getSize();
+      const U32 received = static_cast<U32>(this->rxRead(active.getData() + m_rxFill, capacity - m_rxFill));
+      m_rxFill += received;
+      m_rxWindowBytes += received;
+
+      if (m_rxFill == capacity) {
+        // Buffer full: swap to the spare and keep draining the device
+        this->handOff();
+        continue;
+      }
+      if (received > 0) {
+        m_rxIdlePolls = 0;
+      } else if ((m_rxFill > 0) && (++m_rxIdlePolls >= BufferedUartDriverCfg::RX_IDLE_POLLS)) {
+        // Line went idle: deliver the partial chunk instead of waiting for it to fill
+        this->handOff();
+      }
+      return;
+    }
+  }
+
+  void BufferedUartDriver ::
+    handOff()
+  {
+    Fw::Buffer filled = m_rxBuffers[m_rxActive];
+    m_rxBuffers[m_rxActive] = Fw::Buffer();
+    filled.setSize(m_rxFill);
+    m_rxFill = 0;
+    m_rxIdlePolls = 0;
+
+    // Swap first so the spare keeps filling while the consumer works on this chunk
+    const U32 handed = m_rxActive;
+    m_rxActive = 1 - m_rxActive;
+    this->recv_out(0, filled, Drv::RecvStatus::RECV_OK);
+    (void) this->refill(handed);
+  }
+
+  void BufferedUartDriver ::
+    pollTransmit()
+  {
+    while (m_txCount > 0) {
+      Fw::Buffer& head = m_txQueue[m_txHead];
+      const U32 remaining = head.getSize() - m_txOffset;
+      const U32 written = static_cast<U32>(this->txWrite(head.getData() + m_txOffset, remaining));
+      m_txOffset += written;
+      m_txWindowBytes += written;
+      if (written < remaining) {
+        return;
+      }
+      this->deallocate_out(0, head);
+      head = Fw::Buffer();
+      m_txHead = (m_txHead + 1) % BufferedUartDriverCfg::TX_QUEUE_DEPTH;
+      m_txCount--;
+      m_txOffset = 0;
+    }
+  }
+
+  void BufferedUartDriver ::
+    updateRates()
+  {
+    const Fw::Time now = this->getTime();
+    if (not m_windowStarted) {
+      m_windowStart = now;
+      m_windowStarted = true;
+      return;
+    }
+    const Fw::Time elapsed = Fw::Time::sub(now, m_windowStart);
+    const U64 elapsedUs = static_cast<U64>(elapsed.getSeconds()) * 1000000 + elapsed.getUSeconds();
+    if (elapsedUs < BufferedUartDriverCfg::RATE_WINDOW_US) {
+      return;
+    }
+    this->tlmWrite_RxBytesPerSecond(static_cast<U32>((static_cast<U64>(m_rxWindowBytes) * 1000000) / elapsedUs));
+    this->tlmWrite_TxBytesPerSecond(static_cast<U32>((static_cast<U64>(m_txWindowBytes) * 1000000) / elapsedUs));
+    this->tlmWrite_RxOverruns(m_rxOverruns);
+    this->tlmWrite_TxOverruns(m_txOverruns);
+    m_rxWindowBytes = 0;
+    m_txWindowBytes = 0;
+    m_windowStart = now;
+  }
+
+}
@@ -0,0 +1,178 @@
+// ======================================================================
+// \title  BufferedUartDriver.hpp
+// \brief  hpp file for BufferedUartDriver component implementation class
+// ======================================================================
+
+#ifndef Components_BufferedUartDriver_HPP
+#define Components_BufferedUartDriver_HPP
+
+#include "Components/BufferedUartDriver/BufferedUartDriverComponentAc.hpp"
+#include <config/BufferedUartDriverCfg.hpp>
+
+#ifdef ARDUINO
+#include <FprimeArduino.hpp>
+#endif
+
+namespace Components {
+
+  class BufferedUartDriver :
+    public BufferedUartDriverComponentBase
+  {
+
+    public:
+
+      // ----------------------------------------------------------------------
+      // Component construction and destruction
+      // ----------------------------------------------------------------------
+
+      //! Construct BufferedUartDriver object
+      BufferedUartDriver(
+          const char* const compName //!< The component name
+      );
+
+      //! Destroy BufferedUartDriver object
+      ~BufferedUartDriver();
+
+#ifdef ARDUINO
+      //! Attach the driver to an Arduino stream (e.g. Serial)
+      void configure(
+          Stream* stream //!< The stream to read and write
+      );
+
+#ifdef ARDUINO_ARCH_RP2040
+      //! Start a hardware UART (e.g. Serial1) with a receive FIFO of BufferedUartDriverCfg::RX_FIFO_SIZE bytes and
+      //! attach the driver to it. Bytes the FIFO drops are counted in RxOverruns.
+      void configure(
+          SerialUART* uart, //!< The UART, not yet started
+          const U32 baud //!< Baud rate
+      );
+#endif
+#else
+      //! Open a serial device (e.g. one side of a pseudo-terminal pair) in raw, non-blocking mode
+      //!
+      //! \return true if the device was opened
+      bool open(
+          const char* const device, //!< Path to the device
+          const U32 baud //!< Baud rate, ignored by pseudo-terminals
+      );
+
+      //! Create a pseudo-terminal and attach to its master side. The GDS connects to the slave device, whose path is
+      //! logged.
+      //!
+      //! \return true if the pseudo-terminal was created
+      bool openPty();
+#endif
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Handler implementations for user-defined typed input ports
+      // ----------------------------------------------------------------------
+
+      //! Handler implementation for schedIn
+      //!
+      //! Polls the UART for received data and drains the transmit queue
+      void schedIn_handler(
+          FwIndexType portNum, //!< The port number
+          NATIVE_UINT_TYPE context //!< The call order
+      ) override;
+
+      //! Handler implementation for send
+      //!
+      //! Queues data to transmit out the UART device
+      Drv::SendStatus send_handler(
+          FwIndexType portNum, //!< The port number
+          Fw::Buffer& sendBuffer //!< Data to send
+      ) override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Helpers
+      // ----------------------------------------------------------------------
+
+      //! Move received bytes into the filling buffer, handing buffers off when full or idle
+      void pollReceive();
+
+      //! Hand the filling buffer to the consumer and swap to the spare buffer
+      void handOff();
+
+      //! Ensure the receive buffer in the given slot is allocated
+      bool refill(U32 slot);
+
+      //! Write as much of the transmit queue as the UART accepts without blocking
+      void pollTransmit();
+
+      //! Publish throughput once per measurement window
+      void updateRates();
+
+      // ----------------------------------------------------------------------
+      // Platform backend, implemented in BufferedUartDriver<Platform>.cpp
+      // ----------------------------------------------------------------------
+
+      //! Whether the backend is attached to a device
+      bool isOpen() const;
+
+      //! Number of bytes waiting in the device receive buffer
+      FwSizeType rxAvailable();
+
+      //! Read up to capacity bytes without blocking
+      //!
+      //! \return number of bytes read
+      FwSizeType rxRead(U8* data, FwSizeType capacity);
+
+      //! Whether the device dropped received bytes since the last call, which clears the condition
+      bool rxOverflowed();
+
+      //! Write up to size bytes without blocking
+      //!
+      //! \return number of bytes accepted by the device
+      FwSizeType txWrite(const U8* data, FwSizeType size);
+
+      //! Release the backend
+      void close();
+
+#ifndef ARDUINO
+      //! Put an open device in raw, non-blocking mode and attach to it
+      void attach(
+          NATIVE_INT_TYPE fd, //!< Device file descriptor
+          const U32 baud //!< Baud rate
+      );
+#endif
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Member variables
+      // ----------------------------------------------------------------------
+
+#ifdef ARDUINO
+      Stream* m_stream; //!< Attached Arduino stream
+#ifdef ARDUINO_ARCH_RP2040
+      SerialUART* m_uart; //!< Attached hardware UART, if the stream is one
+#endif
+#else
+      NATIVE_INT_TYPE m_fd; //!< Attached device file descriptor
+#endif
+
+      Fw::Buffer m_rxBuffers[2]; //!< Filling and spare receive buffers
+      U32 m_rxActive; //!< Index of the filling receive buffer
+      U32 m_rxFill; //!< Bytes in the filling receive buffer
+      U32 m_rxIdlePolls; //!< Polls since the last received byte
+
+      Fw::Buffer m_txQueue[BufferedUartDriverCfg::TX_QUEUE_DEPTH]; //!< Ring of buffers waiting to be written
+      U32 m_txHead; //!< Index of the buffer being written
+      U32 m_txCount; //!< Number of queued buffers
+      U32 m_txOffset; //!< Bytes of the head buffer already written
+
+      U32 m_rxOverruns; //!< Polls with pending data and no receive buffer, and overflows of the device buffer
+      U32 m_txOverruns; //!< Buffers dropped on a full transmit queue
+      U32 m_rxWindowBytes; //!< Bytes received in the current window
+      U32 m_txWindowBytes; //!< Bytes transmitted in the current window
+      bool m_windowStarted; //!< Whether the first measurement window has begun
+      Fw::Time m_windowStart; //!< Start of the current measurement window
+  };
+
+}
+
+#endif
@@ -0,0 +1,92 @@
+// ======================================================================
+// \title  BufferedUartDriverArduino.cpp
+// \brief  Arduino Stream backend for the BufferedUartDriver component
+// ======================================================================
+
+#include "Components/BufferedUartDriver/BufferedUartDriver.hpp"
+#include "FpConfig.hpp"
+
+namespace Components {
+
+  void BufferedUartDriver ::
+    configure(Stream* stream)
+  {
+    FW_ASSERT(stream != nullptr);
+    m_stream = stream;
+#ifdef ARDUINO_ARCH_RP2040
+    m_uart = nullptr;
+#endif
+    if (this->isConnected_ready_OutputPort(0)) {
+      this->ready_out(0);
+    }
+  }
+
+#ifdef ARDUINO_ARCH_RP2040
+  void BufferedUartDriver ::
+    configure(SerialUART* uart, const U32 baud)
+  {
+    FW_ASSERT(uart != nullptr);
+    // The FIFO is allocated by begin, so it is sized first
+    uart->end();
+    (void) uart->setFIFOSize(BufferedUartDriverCfg::RX_FIFO_SIZE);
+    uart->begin(baud);
+    this->configure(static_cast<Stream*>(uart));
+    m_uart = uart;
+  }
+#endif
+
+  bool BufferedUartDriver ::
+    isOpen() const
+  {
+    return m_stream != nullptr;
+  }
+
+  FwSizeType BufferedUartDriver ::
+    rxAvailable()
+  {
+    const int available = m_stream->available();
+    return (available > 0) ? static_cast<FwSizeType>(available) : 0;
+  }
+
+  FwSizeType BufferedUartDriver ::
+    rxRead(U8* data, FwSizeType capacity)
+  {
+    // Only ask for what is already buffered so readBytes never waits on its timeout
+    FwSizeType count = FW_MIN(this->rxAvailable(), capacity);
+    if (count == 0) {
+      return 0;
+    }
+    return static_cast<FwSizeType>(m_stream->readBytes(reinterpret_cast<char*>(data), count));
+  }
+
+  bool BufferedUartDriver ::
+    rxOverflowed()
+  {
+#ifdef ARDUINO_ARCH_RP2040
+    // Reading the flag clears it. A USB serial port has no FIFO to overflow.
+    return (m_uart != nullptr) && m_uart->overflow();
+#else
+    return false;
+#endif
+  }
+
+  FwSizeType BufferedUartDriver ::
+    txWrite(const U8* data, FwSizeType size)
+  {
+    const int room = m_stream->availableForWrite();
+    if (room <= 0) {
+      return 0;
+    }
+    return static_cast<FwSizeType>(m_stream->write(data, FW_MIN(static_cast<FwSizeType>(room), size)));
+  }
+
+  void BufferedUartDriver ::
+    close()
+  {
+    m_stream = nullptr;
+#ifdef ARDUINO_ARCH_RP2040
+    m_uart = nullptr;
+#endif
+  }
+
+}
@@ -0,0 +1,140 @@
+// ======================================================================
+// \title  BufferedUartDriverLinux.cpp
+// \brief  Linux serial/pseudo-terminal backend for the BufferedUartDriver component
+// ======================================================================
+
+#include "Components/BufferedUartDriver/BufferedUartDriver.hpp"
+#include "FpConfig.hpp"
+#include <Fw/Logger/Logger.hpp>
+
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace Components {
+
+  namespace {
+    speed_t toSpeed(const U32 baud) {
+      switch (baud) {
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 921600: return B921600;
+        default: return B115200;
+      }
+    }
+  }
+
+  bool BufferedUartDriver ::
+    open(const char* const device, const U32 baud)
+  {
+    FW_ASSERT(device != nullptr);
+    this->close();
+
+    const int fd = ::open(device, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0) {
+      Fw::Logger::logMsg("[ERROR] Failed to open %s: %d\n", reinterpret_cast<POINTER_CAST>(device), errno);
+      return false;
+    }
+    this->attach(fd, baud);
+    return true;
+  }
+
+  bool BufferedUartDriver ::
+    openPty()
+  {
+    this->close();
+
+    const int fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if ((fd < 0) || (grantpt(fd) != 0) || (unlockpt(fd) != 0)) {
+      Fw::Logger::logMsg("[ERROR] Failed to create a pseudo-terminal: %d\n", errno);
+      if (fd >= 0) {
+        (void) ::close(fd);
+      }
+      return false;
+    }
+    // Until the GDS opens the slave side, reads fail and writes fill the pseudo-terminal buffer
+    Fw::Logger::logMsg("[INFO] Ground link on %s\n", reinterpret_cast<POINTER_CAST>(ptsname(fd)));
+    // Terminal settings made on the master side apply to the slave side
+    this->attach(fd, 115200);
+    return true;
+  }
+
+  void BufferedUartDriver ::
+    attach(NATIVE_INT_TYPE fd, const U32 baud)
+  {
+    struct termios options;
+    if (tcgetattr(fd, &options) == 0) {
+      cfmakeraw(&options);
+      cfsetispeed(&options, toSpeed(baud));
+      cfsetospeed(&options, toSpeed(baud));
+      options.c_cc[VMIN] = 0;
+      options.c_cc[VTIME] = 0;
+      (void) tcsetattr(fd, TCSANOW, &options);
+    }
+    m_fd = fd;
+
+    if (this->isConnected_ready_OutputPort(0)) {
+      this->ready_out(0);
+    }
+  }
+
+  bool BufferedUartDriver ::
+    isOpen() const
+  {
+    return m_fd >= 0;
+  }
+
+  FwSizeType BufferedUartDriver ::
+    rxAvailable()
+  {
+    int available = 0;
+    if (ioctl(m_fd, FIONREAD, &available) != 0) {
+      return 0;
+    }
+    return (available > 0) ? static_cast<FwSizeType>(available) : 0;
+  }
+
+  FwSizeType BufferedUartDriver ::
+    rxRead(U8* data, FwSizeType capacity)
+  {
+    if (capacity == 0) {
+      return 0;
+    }
+    const ssize_t count = ::read(m_fd, data, capacity);
+    return (count > 0) ? static_cast<FwSizeType>(count) : 0;
+  }
+
+  bool BufferedUartDriver ::
+    rxOverflowed()
+  {
+    // The kernel buffers the tty for the driver and does not report what it drops
+    return false;
+  }
+
+  FwSizeType BufferedUartDriver ::
+    txWrite(const U8* data, FwSizeType size)
+  {
+    if (size == 0) {
+      return 0;
+    }
+    const ssize_t count = ::write(m_fd, data, size);
+    return (count > 0) ? static_cast<FwSizeType>(count) : 0;
+  }
+
+  void BufferedUartDriver ::
+    close()
+  {
+    if (m_fd >= 0) {
+      (void) ::close(m_fd);
+      m_fd = -1;
+    }
+  }
+
+}
@@ -0,0 +1,227 @@
+// ======================================================================
+// \title  CommandBatcher.cpp
+// \brief  cpp file for CommandBatcher component implementation class
+// ======================================================================
+
+#include "Components/CommandBatcher/CommandBatcher.hpp"
+#include "FpConfig.hpp"
+#include <Fw/Com/ComBuffer.hpp>
+
+namespace Components {
+
+  // ----------------------------------------------------------------------
+  // Component construction and destruction
+  // ----------------------------------------------------------------------
+
+  CommandBatcher ::
+    CommandBatcher(const char* const compName) :
+      CommandBatcherComponentBase(compName),
+      m_active(false),
+      m_offset(0),
+      m_flags(0),
+      m_batchId(0),
+      m_total(0),
+      m_dispatched(0),
+      m_pendingOpcode(0),
+      m_pendingTicks(0),
+      m_succeeded(0),
+      m_failedIndex(0),
+      m_failedOpcode(0),
+      m_failedResponse(Fw::CmdResponse::OK),
+      m_batchesCompleted(0)
+  {
+
+  }
+
+  CommandBatcher ::
+    ~CommandBatcher()
+  {
+
+  }
+
+  // ----------------------------------------------------------------------
+  // Handler implementations for user-defined typed input ports
+  // ----------------------------------------------------------------------
+
+  void CommandBatcher ::
+    batchIn_handler(
+        FwIndexType portNum,
+        Fw::Buffer& fwBuffer
+    )
+  {
+    const U8* const data = fwBuffer.getData();
+    const U32 size = fwBuffer.getSize();
+    if (size < HEADER_SIZE) {
+      this->log_WARNING_HI_BatchMalformed(size, 0);
+      this->bufferDeallocate_out(0, fwBuffer);
+      return;
+    }
+
+    const U16 batchId = static_cast<U16>((data[0] << 8) | data[1]);
+    if (m_active) {
+      this->log_WARNING_HI_BatchBusy(batchId, m_batchId);
+      this->bufferDeallocate_out(0, fwBuffer);
+      return;
+    }
+
+    const U8 count = data[3];
+    const U32 end = validate(data, size, count);
+    if (end != size) {
+      this->log_WARNING_HI_BatchMalformed(size, end);
+      this->bufferDeallocate_out(0, fwBuffer);
+      return;
+    }
+
+    m_active = true;
+    m_batch = fwBuffer;
+    m_offset = HEADER_SIZE;
+    m_flags = data[2];
+    m_batchId = batchId;
+    m_total = count;
+    m_dispatched = 0;
+    m_succeeded = 0;
+    m_failedIndex = count;
+    m_failedOpcode = 0;
+    m_failedResponse = Fw::CmdResponse::OK;
+    this->dispatchNext();
+  }
+
+  void CommandBatcher ::
+    seqCmdStatus_handler(
+        FwIndexType portNum,
+        FwOpcodeType opCode,
+        U32 cmdSeq,
+        const Fw::CmdResponse& response
+    )
+  {
+    // Only the command last dispatched can be outstanding; anything else belongs to an aborted batch
+    if (not m_active || (m_dispatched == 0) || (cmdSeq != this->context(static_cast<U8>(m_dispatched - 1)))) {
+      return;
+    }
+    this->completeCommand(opCode, response);
+  }
+
+  void CommandBatcher ::
+    run_handler(
+        FwIndexType portNum,
+        U32 context
+    )
+  {
+    if (not m_active) {
+      return;
+    }
+    m_pendingTicks++;
+    if (m_pendingTicks < CommandBatcherCfg::COMMAND_TIMEOUT_TICKS) {
+      return;
+    }
+    // Its status, if it ever comes, carries this command's context and is ignored once the batch has moved on
+    this->log_WARNING_HI_CommandTimedOut(m_batchId, static_cast<U8>(m_dispatched - 1), m_pendingOpcode);
+    this->completeCommand(m_pendingOpcode, Fw::CmdResponse::EXECUTION_ERROR);
+  }
+
+  // ----------------------------------------------------------------------
+  // Handler implementations for commands
+  // ----------------------------------------------------------------------
+
+  void CommandBatcher ::
+    ABORT_BATCH_cmdHandler(
+        FwOpcodeType opCode,
+        U32 cmdSeq
+    )
+  {
+    if (m_active) {
+      this->log_WARNING_LO_BatchAborted(m_batchId, m_dispatched);
+      this->finish();
+    }
+    this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::OK);
+  }
+
+  // ----------------------------------------------------------------------
+  // Helpers
+  // ----------------------------------------------------------------------
+
+  U32 CommandBatcher ::
+    validate(const U8* data, U32 size, U8 count)
+  {
+    U32 offset = HEADER_SIZE;
+    for (U32 command = 0; command < count; command++) {
+      if ((size - offset) < COMMAND_SIZE_SIZE) {
+        return offset;
+      }
+      const U32 commandSize = static_cast<U32>((data[offset] << 8) | data[offset + 1]);
+      if ((commandSize == 0) || (commandSize > FW_COM_BUFFER_MAX_SIZE) ||
+          (commandSize > (size - offset - COMMAND_SIZE_SIZE))) {
+        return offset;
+      }
+      offset += COMMAND_SIZE_SIZE + commandSize;
+    }
+    return offset;
+  }
+
+  void CommandBatcher ::
+    completeCommand(FwOpcodeType opCode, const Fw::CmdResponse& response)
+  {
+    if (response.e == Fw::CmdResponse::OK) {
+      m_succeeded++;
+    } else if (m_failedIndex == m_total) {
+      m_failedIndex = static_cast<U8>(m_dispatched - 1);
+      m_failedOpcode = opCode;
+      m_failedResponse = response;
+      if (m_flags & FLAG_STOP_ON_ERROR) {
+        this->finish();
+        return;
+      }
+    }
+    this->dispatchNext();
+  }
+
+  void CommandBatcher ::
+    dispatchNext()
+  {
+    FW_ASSERT(m_active);
+    if (m_dispatched == m_total) {
+      this->finish();
+      return;
+    }
+
+    const U8* const data = m_batch.getData();
+    const U32 commandSize = static_cast<U32>((data[m_offset] << 8) | data[m_offset + 1]);
+    Fw::ComBuffer com(data + m_offset + COMMAND_SIZE_SIZE, commandSize);
+    m_offset += COMMAND_SIZE_SIZE + commandSize;
+
+    // The opcode follows the packet type; a command too short to hold one is refused by the dispatcher
+    FwPacketDescriptorType packetType = 0;
+    m_pendingOpcode = 0;
+    if (com.deserialize(packetType) == Fw::FW_SERIALIZE_OK) {
+      (void) com.deserialize(m_pendingOpcode);
+    }
+    com.resetDeser();
+    m_pendingTicks = 0;
+
+    const U8 index = m_dispatched++;
+    this->seqCmdOut_out(0, com, this->context(index));
+  }
+
+  U32 CommandBatcher ::
+    context(U8 index) const
+  {
+    return (static_cast<U32>(m_batchId) << 16) | index;
+  }
+
+  void CommandBatcher ::
+    finish()
+  {
+    FW_ASSERT(m_active);
+    m_active = false;
+    this->bufferDeallocate_out(0, m_batch);
+
+    m_batchesCompleted++;
+    this->log_ACTIVITY_HI_BatchCompleted(m_batchId, m_total, m_succeeded, m_failedIndex, m_failedOpcode,
+                                         m_failedResponse);
+    const CommandBatchStatus status(m_batchId, m_total, m_dispatched, m_succeeded, m_failedIndex, m_failedOpcode,
+                                    m_failedResponse);
+    this->tlmWrite_BatchesCompleted(m_batchesCompleted);
+    this->tlmWrite_LastBatch(status);
+  }
+
+}
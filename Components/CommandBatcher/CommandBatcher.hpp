@@ -0,0 +1,139 @@
+// ======================================================================
+// \title  CommandBatcher.hpp
+// \brief  hpp file for CommandBatcher component implementation class
+// ======================================================================
+
+#ifndef Components_CommandBatcher_HPP
+#define Components_CommandBatcher_HPP
+
+#include "Components/CommandBatcher/CommandBatcherComponentAc.hpp"
+#include <config/CommandBatcherCfg.hpp>
+
+namespace Components {
+
+  //! Dispatches the commands of a batch packet in order, waiting for each status before sending the next
+  //!
+  //! A batch packet, after the deframer strips its packet type, is:
+  //!
+  //!     U16 batch id | U8 flags | U8 count | count x (U16 size | command packet)
+  //!
+  //! where each command packet is exactly what the ground would uplink on its own, packet type included.
+  class CommandBatcher :
+    public CommandBatcherComponentBase
+  {
+
+    public:
+
+      //! Bytes ahead of the first command
+      static const U32 HEADER_SIZE = sizeof(U16) + sizeof(U8) + sizeof(U8);
+
+      //! Bytes of the size ahead of each command
+      static const U32 COMMAND_SIZE_SIZE = sizeof(U16);
+
+      //! Flag bit asking to stop at the first command that does not return OK
+      static const U8 FLAG_STOP_ON_ERROR = 0x01;
+
+      // ----------------------------------------------------------------------
+      // Component construction and destruction
+      // ----------------------------------------------------------------------
+
+      //! Construct CommandBatcher object
+      CommandBatcher(
+          const char* const compName //!< The component name
+      );
+
+      //! Destroy CommandBatcher object
+      ~CommandBatcher();
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Handler implementations for user-defined typed input ports
+      // ----------------------------------------------------------------------
+
+      //! Handler implementation for batchIn
+      void batchIn_handler(
+          FwIndexType portNum, //!< The port number
+          Fw::Buffer& fwBuffer //!< The batch packet
+      ) override;
+
+      //! Handler implementation for seqCmdStatus
+      void seqCmdStatus_handler(
+          FwIndexType portNum, //!< The port number
+          FwOpcodeType opCode, //!< Command Op Code
+          U32 cmdSeq, //!< Command Sequence, the context the command was sent with
+          const Fw::CmdResponse& response //!< The command response argument
+      ) override;
+
+      //! Handler implementation for run
+      //!
+      //! Counts the dispatched command as failed once it has gone CommandBatcherCfg::COMMAND_TIMEOUT_TICKS calls
+      //! without a status
+      void run_handler(
+          FwIndexType portNum, //!< The port number
+          U32 context //!< The call order
+      ) override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Handler implementations for commands
+      // ----------------------------------------------------------------------
+
+      //! Handler implementation for command ABORT_BATCH
+      void ABORT_BATCH_cmdHandler(
+          FwOpcodeType opCode, //!< The opcode
+          U32 cmdSeq //!< The command sequence number
+      ) override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Helpers
+      // ----------------------------------------------------------------------
+
+      //! Check that the commands of a batch exactly fill the packet
+      //!
+      //! \return the offset of the first bad byte, or the packet size if the batch is well formed
+      static U32 validate(const U8* data, U32 size, U8 count);
+
+      //! Count the outcome of the command last dispatched and go on to the next, or finish the batch
+      void completeCommand(
+          FwOpcodeType opCode, //!< Opcode of the command
+          const Fw::CmdResponse& response //!< Its response
+      );
+
+      //! Send the next command of the batch, or finish the batch if none remain
+      void dispatchNext();
+
+      //! Context a command is dispatched with, so a late status from an aborted batch is not mistaken for this one
+      U32 context(U8 index) const;
+
+      //! Report the batch outcome and release the packet
+      void finish();
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Member variables
+      // ----------------------------------------------------------------------
+
+      bool m_active; //!< Whether a batch is being dispatched
+      Fw::Buffer m_batch; //!< Batch packet being dispatched
+      U32 m_offset; //!< Offset of the next command size in m_batch
+      U8 m_flags; //!< Flags of the batch
+      U16 m_batchId; //!< Identifier of the batch
+      U8 m_total; //!< Commands in the batch
+      U8 m_dispatched; //!< Commands sent to the dispatcher
+      FwOpcodeType m_pendingOpcode; //!< Opcode of the command last dispatched
+      U32 m_pendingTicks; //!< run calls since the command last dispatched was sent
+      U8 m_succeeded; //!< Commands that returned OK
+      U8 m_failedIndex; //!< First command that did not return OK, m_total if none
+      FwOpcodeType m_failedOpcode; //!< Opcode of the first failed command
+      Fw::CmdResponse m_failedResponse; //!< Response of the first failed command
+      U32 m_batchesCompleted; //!< Batches finished
+  };
+
+}
+
+#endif
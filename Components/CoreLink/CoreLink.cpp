@@ -0,0 +1,535 @@
+// ======================================================================
+// \title  CoreLink.cpp
+// \brief  cpp file for CoreLink component implementation class
+// ======================================================================
+
+#include "Components/CoreLink/CoreLink.hpp"
+#include "FpConfig.hpp"
+
+namespace Components {
+
+  // ----------------------------------------------------------------------
+  // Component construction and destruction
+  // ----------------------------------------------------------------------
+
+  CoreLink ::
+    CoreLink(const char* const compName) :
+      CoreLinkComponentBase(compName),
+      m_radioCore(false),
+      m_ticks(0),
+      m_radioStatus(Fw::Success::FAILURE),
+      m_radioStatusReports(0),
+      m_radioBusyUs(0),
+      m_radioTotalUs(0),
+      m_mainQueuePeak(0),
+      m_radioOverflows(0),
+      m_linkUp(false),
+      m_linkQueued(0),
+      m_linkBitRate(0),
+      m_linkLossPerMille(0),
+      m_linkAirtimePerMille(0),
+      m_radioQueuePeak(0),
+      m_frameOverflows(0),
+      m_radioStatusSeen(0),
+      m_mainBusyUs(0),
+      m_mainTotalUs(0),
+      m_mainPassUs(0xFFFFFFFF),
+      m_mainBusyReported(0),
+      m_mainTotalReported(0),
+      m_radioBusyReported(0),
+      m_radioTotalReported(0),
+      m_telemetryCountdown(0),
+      m_ticksRun(0),
+      m_containerAsked(false)
+#ifndef ARDUINO
+      ,
+      m_doorbellRung(false)
+#endif
+  {
+
+  }
+
+  CoreLink ::
+    ~CoreLink()
+  {
+
+  }
+
+  void CoreLink ::
+    configure(bool radioCore)
+  {
+    m_radioCore.store(radioCore, std::memory_order_release);
+  }
+
+  void CoreLink ::
+    serviceRadioCore()
+  {
+    // The RP2040 starts core 1 alongside core 0's setup, before the radio side's components are connected
+    if (not m_radioCore.load(std::memory_order_acquire)) {
+      return;
+    }
+    const U32 waitStart = nowUs();
+    this->waitForDoorbell();
+    const U32 workStart = nowUs();
+    this->serviceRadioSide();
+    const U32 end = nowUs();
+    // The total is published first, so the main core never reads more work than time
+    add(m_radioTotalUs, end - waitStart);
+    m_radioBusyUs.store(m_radioBusyUs.load(std::memory_order_relaxed) + (end - workStart), std::memory_order_release);
+  }
+
+  void CoreLink ::
+    wake()
+  {
+    this->ringDoorbell();
+  }
+
+  void CoreLink ::
+    recordMainLoop(U32 elapsedUs)
+  {
+    m_mainPassUs = FW_MIN(m_mainPassUs, elapsedUs);
+    m_mainBusyUs += elapsedUs - m_mainPassUs;
+    m_mainTotalUs += elapsedUs;
+  }
+
+  void CoreLink ::
+    serviceMainCore()
+  {
+    BufferHandle* handle = nullptr;
+    while ((handle = m_packets.front()) != nullptr) {
+      Fw::Buffer packet = bufferOf(*handle);
+      m_packets.release();
+      this->bufferOut_out(0, packet);
+    }
+    // Each call is made straight from its slot, which is not handed back until the call returns
+    ComCall* call = nullptr;
+    while ((call = m_coms.front()) != nullptr) {
+      this->comOut_out(0, call->data, call->context);
+      m_coms.release();
+    }
+
+    this->serviceRadioServices();
+
+    const U32 reports = m_radioStatusReports.load(std::memory_order_acquire);
+    if ((reports != m_radioStatusSeen) && this->isConnected_radioStatus_OutputPort(0)) {
+      Fw::Success status = static_cast<Fw::Success::T>(m_radioStatus.load(std::memory_order_relaxed));
+      this->radioStatus_out(0, status);
+    }
+    m_radioStatusSeen = reports;
+  }
+
+  // ----------------------------------------------------------------------
+  // Handler implementations for user-defined typed input ports
+  // ----------------------------------------------------------------------
+
+  Drv::SendStatus CoreLink ::
+    framedIn_handler(
+        FwIndexType portNum,
+        Fw::Buffer& sendBuffer
+    )
+  {
+    // Returned frames are released as new ones arrive, so the pool refills at the rate it drains
+    this->releaseFrames();
+
+    m_frameLock.lock();
+    const bool queued = m_frames.push(handleOf(sendBuffer));
+    if (queued) {
+      m_radioQueuePeak = FW_MAX(m_radioQueuePeak, m_frames.size());
+    } else {
+      m_frameOverflows++;
+    }
+    m_frameLock.unLock();
+
+    if (not queued) {
+      // As the radio does with a frame it has no room for
+      this->framedDeallocate_out(0, sendBuffer);
+      return Drv::SendStatus::SEND_OK;
+    }
+    this->notifyRadioSide();
+    return Drv::SendStatus::SEND_OK;
+  }
+
+  void CoreLink ::
+    bufferReturn_handler(
+        FwIndexType portNum,
+        Fw::Buffer& fwBuffer
+    )
+  {
+    m_returnLock.lock();
+    const bool returned = m_packetReturns.push(handleOf(fwBuffer));
+    m_returnLock.unLock();
+    FW_ASSERT(returned, m_packetReturns.size());
+  }
+
+  void CoreLink ::
+    schedIn_handler(
+        FwIndexType portNum,
+        NATIVE_UINT_TYPE context
+    )
+  {
+    add(m_ticks, 1);
+    this->notifyRadioSide();
+    this->releaseFrames();
+    this->serviceMainCore();
+
+    if (m_telemetryCountdown == 0) {
+      m_telemetryCountdown = CoreLinkCfg::TELEMETRY_PERIOD_TICKS;
+      this->updateTelemetry();
+    }
+    m_telemetryCountdown--;
+  }
+
+  Radio::LinkLoad CoreLink ::
+    linkLoadIn_handler(FwIndexType portNum)
+  {
+    // Fields written at neighbouring passes may be mixed, which only matters to a reader wanting them to the frame.
+    // Frames popped but not yet queued by the radio are missed until its pass ends.
+    const bool up = m_linkUp.load(std::memory_order_acquire);
+    return Radio::LinkLoad(up, m_linkQueued.load(std::memory_order_relaxed) + m_frames.size(),
+                           m_linkBitRate.load(std::memory_order_relaxed),
+                           static_cast<U16>(m_linkLossPerMille.load(std::memory_order_relaxed)),
+                           static_cast<U16>(m_linkAirtimePerMille.load(std::memory_order_relaxed)));
+  }
+
+  void CoreLink ::
+    framedReturn_handler(
+        FwIndexType portNum,
+        Fw::Buffer& fwBuffer
+    )
+  {
+    const bool returned = m_frameReturns.push(handleOf(fwBuffer));
+    FW_ASSERT(returned, m_frameReturns.size());
+  }
+
+  void CoreLink ::
+    bufferIn_handler(
+        FwIndexType portNum,
+        Fw::Buffer& fwBuffer
+    )
+  {
+    if (not m_packets.push(handleOf(fwBuffer))) {
+      this->radioOverflow();
+      this->bufferDeallocate_out(0, fwBuffer);
+      return;
+    }
+    this->recordMainQueueDepth();
+  }
+
+  void CoreLink ::
+    comIn_handler(
+        FwIndexType portNum,
+        Fw::ComBuffer& data,
+        U32 context
+    )
+  {
+    ComCall* const call = m_coms.claim();
+    if (call == nullptr) {
+      this->radioOverflow();
+      return;
+    }
+    call->data = data;
+    call->context = context;
+    m_coms.publish();
+    this->recordMainQueueDepth();
+  }
+
+  void CoreLink ::
+    radioStatusIn_handler(
+        FwIndexType portNum,
+        Fw::Success& condition
+    )
+  {
+    m_radioStatus.store(static_cast<U32>(condition.e), std::memory_order_relaxed);
+    m_radioStatusReports.store(m_radioStatusReports.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  void CoreLink ::
+    radioTlmIn_handler(
+        FwIndexType portNum,
+        FwChanIdType id,
+        Fw::Time& timeTag,
+        Fw::TlmBuffer& val
+    )
+  {
+    TlmCall* const call = m_tlms.claim();
+    if (call == nullptr) {
+      this->radioOverflow();
+      return;
+    }
+    call->id = id;
+    call->timeTag = timeTag;
+    call->val = val;
+    m_tlms.publish();
+  }
+
+  void CoreLink ::
+    radioLogIn_handler(
+        FwIndexType portNum,
+        FwEventIdType id,
+        Fw::Time& timeTag,
+        const Fw::LogSeverity& severity,
+        Fw::LogBuffer& args
+    )
+  {
+    LogCall* const call = m_logs.claim();
+    if (call == nullptr) {
+      this->radioOverflow();
+      return;
+    }
+    call->id = id;
+    call->timeTag = timeTag;
+    call->severity = severity;
+    call->args = args;
+    m_logs.publish();
+  }
+
+  void CoreLink ::
+    clockExchangeIn_handler(
+        FwIndexType portNum,
+        U64 requestSent,
+        U64 requestReceived,
+        U64 responseSent,
+        U64 responseReceived
+    )
+  {
+    // The timestamps are absolute, so the tick an exchange waits to cross costs it nothing
+    const ClockSample sample = {requestSent, requestReceived, responseSent, responseReceived};
+    if (not m_clockSamples.push(sample)) {
+      this->radioOverflow();
+    }
+  }
+
+  Fw::Success CoreLink ::
+    productGetIn_handler(
+        FwIndexType portNum,
+        FwDpIdType id,
+        FwSizeType dataSize,
+        Fw::Buffer& buffer
+    )
+  {
+    // The radio asks again on its next run when there is none, as it does when the buffer manager has none to give
+    ContainerHandle container;
+    if (m_containers.pop(container)) {
+      m_containerAsked = false;
+      if ((container.id == id) && (container.dataSize == dataSize)) {
+        buffer = bufferOf(container.buffer);
+        return (container.buffer.data != nullptr) ? Fw::Success::SUCCESS : Fw::Success::FAILURE;
+      }
+      if (container.buffer.data != nullptr) {
+        // Not the container asked for this time: back to the main core's buffer manager, as a finished frame
+        const bool returned = m_frameReturns.push(container.buffer);
+        FW_ASSERT(returned, m_frameReturns.size());
+      }
+    }
+    if (not m_containerAsked) {
+      ContainerHandle request;
+      request.id = id;
+      request.dataSize = dataSize;
+      request.buffer = handleOf(Fw::Buffer());
+      m_containerAsked = m_containerRequests.push(request);
+      this->ringDoorbell();
+    }
+    return Fw::Success::FAILURE;
+  }
+
+  void CoreLink ::
+    productSendIn_handler(
+        FwIndexType portNum,
+        FwDpIdType id,
+        const Fw::Buffer& buffer
+    )
+  {
+    ContainerHandle container;
+    container.id = id;
+    container.dataSize = 0;
+    container.buffer = handleOf(buffer);
+    if (not m_products.push(container)) {
+      // The container is lost, but its buffer goes back to the main core's buffer manager
+      this->radioOverflow();
+      const bool returned = m_frameReturns.push(container.buffer);
+      FW_ASSERT(returned, m_frameReturns.size());
+    }
+  }
+
+  // ----------------------------------------------------------------------
+  // Helpers
+  // ----------------------------------------------------------------------
+
+  void CoreLink ::
+    serviceRadioSide()
+  {
+    // Returned packets first, so the deframer has buffers for what the radio receives
+    BufferHandle handle;
+    while (m_packetReturns.pop(handle)) {
+      Fw::Buffer packet = bufferOf(handle);
+      this->bufferDeallocate_out(0, packet);
+    }
+    while (m_frames.pop(handle)) {
+      Fw::Buffer frame = bufferOf(handle);
+      // The radio deallocates the frame, whether it goes out or not
+      (void) this->framedOut_out(0, frame);
+    }
+    // Ticks that passed while the radio was busy sending are not made up, as with a rate group that overruns
+    const U32 ticks = m_ticks.load(std::memory_order_acquire);
+    if (ticks != m_ticksRun) {
+      m_ticksRun = ticks;
+      this->radioRun_out(0, 0);
+    }
+    // Read last, so the frames just sent are off the radio's queue
+    if (this->isConnected_radioLinkLoad_OutputPort(0)) {
+      const Radio::LinkLoad load = this->radioLinkLoad_out(0);
+      m_linkQueued.store(load.getqueued(), std::memory_order_relaxed);
+      m_linkBitRate.store(load.getbitRate(), std::memory_order_relaxed);
+      m_linkLossPerMille.store(load.getlossPerMille(), std::memory_order_relaxed);
+      m_linkAirtimePerMille.store(load.getairtimePerMille(), std::memory_order_relaxed);
+      m_linkUp.store(load.getup(), std::memory_order_release);
+    }
+  }
+
+  void CoreLink ::
+    notifyRadioSide()
+  {
+    if (m_radioCore.load(std::memory_order_acquire)) {
+      this->ringDoorbell();
+      return;
+    }
+    m_radioLock.lock();
+    this->serviceRadioSide();
+    m_radioLock.unLock();
+  }
+
+  void CoreLink ::
+    releaseFrames()
+  {
+    for (;;) {
+      BufferHandle handle;
+      m_frameLock.lock();
+      const bool released = m_frameReturns.pop(handle);
+      m_frameLock.unLock();
+      if (not released) {
+        break;
+      }
+      Fw::Buffer frame = bufferOf(handle);
+      this->framedDeallocate_out(0, frame);
+    }
+  }
+
+  void CoreLink ::
+    serviceRadioServices()
+  {
+    TlmCall* tlm = nullptr;
+    while ((tlm = m_tlms.front()) != nullptr) {
+      if (this->isConnected_radioTlmOut_OutputPort(0)) {
+        this->radioTlmOut_out(0, tlm->id, tlm->timeTag, tlm->val);
+      }
+      m_tlms.release();
+    }
+    LogCall* log = nullptr;
+    while ((log = m_logs.front()) != nullptr) {
+      if (this->isConnected_radioLogOut_OutputPort(0)) {
+        this->radioLogOut_out(0, log->id, log->timeTag, log->severity, log->args);
+      }
+      m_logs.release();
+    }
+    ClockSample sample;
+    while (m_clockSamples.pop(sample)) {
+      if (this->isConnected_clockExchangeOut_OutputPort(0)) {
+        this->clockExchangeOut_out(0, sample.requestSent, sample.requestReceived, sample.responseSent,
+                                   sample.responseReceived);
+      }
+    }
+
+    ContainerHandle container;
+    while (m_products.pop(container)) {
+      if (this->isConnected_productSendOut_OutputPort(0)) {
+        this->productSendOut_out(0, container.id, bufferOf(container.buffer));
+      } else {
+        this->framedDeallocate_out(0, bufferOf(container.buffer));
+      }
+    }
+    // The ring back holds the one container asked for, so there is always room for it
+    while (m_containerRequests.pop(container)) {
+      Fw::Buffer buffer;
+      if (not this->isConnected_productGetOut_OutputPort(0) ||
+          (this->productGetOut_out(0, container.id, container.dataSize, buffer) != Fw::Success::SUCCESS)) {
+        buffer = Fw::Buffer();
+      }
+      container.buffer = handleOf(buffer);
+      const bool handed = m_containers.push(container);
+      FW_ASSERT(handed, m_containers.size());
+    }
+  }
+
+  void CoreLink ::
+    radioOverflow()
+  {
+    add(m_radioOverflows, 1);
+  }
+
+  void CoreLink ::
+    recordMainQueueDepth()
+  {
+    const U32 depth = m_packets.size() + m_coms.size();
+    if (depth > m_mainQueuePeak.load(std::memory_order_relaxed)) {
+      m_mainQueuePeak.store(depth, std::memory_order_relaxed);
+    }
+  }
+
+  void CoreLink ::
+    updateTelemetry()
+  {
+    this->tlmWrite_MainCoreLoad(perMille(m_mainBusyUs - m_mainBusyReported, m_mainTotalUs - m_mainTotalReported));
+    m_mainBusyReported = m_mainBusyUs;
+    m_mainTotalReported = m_mainTotalUs;
+
+    // Busy before total, the reverse of the order they are published in
+    const U32 radioBusy = m_radioBusyUs.load(std::memory_order_acquire);
+    const U32 radioTotal = m_radioTotalUs.load(std::memory_order_relaxed);
+    this->tlmWrite_RadioCoreLoad(perMille(radioBusy - m_radioBusyReported, radioTotal - m_radioTotalReported));
+    m_radioBusyReported = radioBusy;
+    m_radioTotalReported = radioTotal;
+
+    m_frameLock.lock();
+    const U32 radioQueuePeak = m_radioQueuePeak;
+    const U32 frameOverflows = m_frameOverflows;
+    m_frameLock.unLock();
+    this->tlmWrite_RadioQueueDepth(m_frames.size());
+    this->tlmWrite_RadioQueuePeak(radioQueuePeak);
+    this->tlmWrite_MainQueueDepth(m_packets.size() + m_coms.size());
+    this->tlmWrite_MainQueuePeak(m_mainQueuePeak.load(std::memory_order_relaxed));
+    this->tlmWrite_QueueOverflows(frameOverflows + m_radioOverflows.load(std::memory_order_relaxed));
+  }
+
+  CoreLink::BufferHandle CoreLink ::
+    handleOf(const Fw::Buffer& buffer)
+  {
+    BufferHandle handle;
+    handle.data = buffer.getData();
+    handle.size = buffer.getSize();
+    handle.context = buffer.getContext();
+    return handle;
+  }
+
+  Fw::Buffer CoreLink ::
+    bufferOf(const BufferHandle& handle)
+  {
+    return Fw::Buffer(handle.data, handle.size, handle.context);
+  }
+
+  U16 CoreLink ::
+    perMille(U32 part, U32 whole)
+  {
+    if (whole == 0) {
+      return 0;
+    }
+    return static_cast<U16>(FW_MIN(static_cast<U64>(part) * 1000 / whole, static_cast<U64>(1000)));
+  }
+
+  void CoreLink ::
+    add(std::atomic<U32>& counter, U32 amount)
+  {
+    // A load and a store rather than fetch_add, which the Cortex-M0+ cannot do without a lock
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_release);
+  }
+
+}
@@ -0,0 +1,345 @@
+// ======================================================================
+// \title  CoreLink.hpp
+// \brief  hpp file for CoreLink component implementation class
+// ======================================================================
+
+#ifndef Components_CoreLink_HPP
+#define Components_CoreLink_HPP
+
+#include "Components/CoreLink/CoreLinkComponentAc.hpp"
+#include <Components/CoreLink/SpscRing.hpp>
+#include <Fw/Com/ComBuffer.hpp>
+#include <Fw/Log/LogBuffer.hpp>
+#include <Fw/Tlm/TlmBuffer.hpp>
+#include <Os/Mutex.hpp>
+#include <config/CoreLinkCfg.hpp>
+
+#include <atomic>
+#ifndef ARDUINO
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace Components {
+
+  //! Carries the hub radio's traffic between the main core and the radio core
+  //!
+  //! The radio, its deframer and the buffer manager they allocate from run on the radio core; everything else runs
+  //! on the main core. Only this component is called from both. Frames and packets cross as handles in
+  //! single-producer, single-consumer rings, and each buffer goes back through a return ring to the core that
+  //! allocated it, so neither core's buffer manager is ever called from the other. Com calls for the message handler
+  //! cross as copies, as a Com buffer owns its storage.
+  //!
+  //! The radio core's telemetry, events and clock exchanges cross the same way, as copies, and are passed on at the
+  //! main core's next tick: the components they go to guard themselves with Os::Mutex and Os::Queue, which on the
+  //! board only keep out other work on the main core. Data product containers are got by the main core when the
+  //! radio asks for one, and handed over on a later call.
+  //!
+  //! The main core rings the radio core's doorbell whenever it queues a frame and on every tick of its rate group; the
+  //! radio core sleeps until then. It sends the frames, runs the radio once if there was a tick, and queues what the
+  //! radio received for the main core, which brings it in on its next tick.
+  //!
+  //! Without a radio core, the main core services the radio side itself, on the spot, so the link costs a ring
+  //! round trip per buffer and changes nothing else.
+  class CoreLink :
+    public CoreLinkComponentBase
+  {
+
+    public:
+
+      // ----------------------------------------------------------------------
+      // Component construction and destruction
+      // ----------------------------------------------------------------------
+
+      //! Construct CoreLink object
+      CoreLink(
+          const char* const compName //!< The component name
+      );
+
+      //! Destroy CoreLink object
+      ~CoreLink();
+
+      //! Choose where the radio side runs, once the rest of the topology is set up
+      void configure(
+          bool radioCore //!< Whether a radio core calls serviceRadioCore; otherwise the main core does the work
+      );
+
+      //! Wait for the doorbell and service the radio side. The radio core calls this in a loop, from before the
+      //! link is configured; until then it returns at once.
+      void serviceRadioCore();
+
+      //! Ring the radio core's doorbell, so a serviceRadioCore that is waiting returns
+      void wake();
+
+      //! Account for one pass of the main loop, for MainCoreLoad. A pass longer than the shortest one seen is taken
+      //! to have worked for the difference and polled for the rest.
+      void recordMainLoop(
+          U32 elapsedUs //!< Length of the pass
+      );
+
+      //! Bring in what the radio core has queued for the main core. The rate group tick does this too.
+      void serviceMainCore();
+
+      //! Frames waiting for the radio core
+      U32 radioQueueDepth() const { return m_frames.size(); }
+
+    PRIVATE:
+
+      //! A buffer on its way across, without the serialization state of an Fw::Buffer
+      struct BufferHandle {
+        U8* data; //!< Buffer memory
+        U32 size; //!< Buffer size
+        U32 context; //!< Buffer manager context
+      };
+
+      //! A Com call on its way across
+      struct ComCall {
+        Fw::ComBuffer data; //!< Com buffer
+        U32 context; //!< Call context
+      };
+
+      //! A telemetry write on its way across
+      struct TlmCall {
+        FwChanIdType id; //!< Channel id
+        Fw::Time timeTag; //!< Time of the write
+        Fw::TlmBuffer val; //!< Serialized value
+      };
+
+      //! An event on its way across
+      struct LogCall {
+        FwEventIdType id; //!< Event id
+        Fw::Time timeTag; //!< Time of the event
+        Fw::LogSeverity severity; //!< Severity
+        Fw::LogBuffer args; //!< Serialized arguments
+      };
+
+      //! A clock exchange on its way across
+      struct ClockSample {
+        U64 requestSent; //!< The request left this node
+        U64 requestReceived; //!< The request reached the time source
+        U64 responseSent; //!< The response left the time source
+        U64 responseReceived; //!< The response reached this node
+      };
+
+      //! A data product container, asked for or on its way to or from the radio
+      struct ContainerHandle {
+        FwDpIdType id; //!< Container id
+        FwSizeType dataSize; //!< Data size asked for
+        BufferHandle buffer; //!< Container buffer, no data if the main core could not get one
+      };
+
+      // ----------------------------------------------------------------------
+      // Handler implementations for user-defined typed input ports
+      // ----------------------------------------------------------------------
+
+      //! Handler implementation for framedIn
+      Drv::SendStatus framedIn_handler(
+          FwIndexType portNum, //!< The port number
+          Fw::Buffer& sendBuffer //!< The frame
+      ) override;
+
+      //! Handler implementation for bufferReturn
+      void bufferReturn_handler(
+          FwIndexType portNum, //!< The port number
+          Fw::Buffer& fwBuffer //!< The packet
+      ) override;
+
+      //! Handler implementation for schedIn
+      void schedIn_handler(
+          FwIndexType portNum, //!< The port number
+          NATIVE_UINT_TYPE context //!< The call order
+      ) override;
+
+      //! Handler implementation for linkLoadIn
+      Radio::LinkLoad linkLoadIn_handler(
+          FwIndexType portNum //!< The port number
+      ) override;
+
+      //! Handler implementation for framedReturn
+      void framedReturn_handler(
+          FwIndexType portNum, //!< The port number
+          Fw::Buffer& fwBuffer //!< The frame
+      ) override;
+
+      //! Handler implementation for bufferIn
+      void bufferIn_handler(
+          FwIndexType portNum, //!< The port number
+          Fw::Buffer& fwBuffer //!< The packet
+      ) override;
+
+      //! Handler implementation for comIn
+      void comIn_handler(
+          FwIndexType portNum, //!< The port number
+          Fw::ComBuffer& data, //!< The Com buffer
+          U32 context //!< The call context
+      ) override;
+
+      //! Handler implementation for radioStatusIn
+      void radioStatusIn_handler(
+          FwIndexType portNum, //!< The port number
+          Fw::Success& condition //!< The status
+      ) override;
+
+      //! Handler implementation for radioTlmIn
+      void radioTlmIn_handler(
+          FwIndexType portNum, //!< The port number
+          FwChanIdType id, //!< Channel id
+          Fw::Time& timeTag, //!< Time of the write
+          Fw::TlmBuffer& val //!< Serialized value
+      ) override;
+
+      //! Handler implementation for radioLogIn
+      void radioLogIn_handler(
+          FwIndexType portNum, //!< The port number
+          FwEventIdType id, //!< Event id
+          Fw::Time& timeTag, //!< Time of the event
+          const Fw::LogSeverity& severity, //!< Severity
+          Fw::LogBuffer& args //!< Serialized arguments
+      ) override;
+
+      //! Handler implementation for clockExchangeIn
+      void clockExchangeIn_handler(
+          FwIndexType portNum, //!< The port number
+          U64 requestSent, //!< The request left this node
+          U64 requestReceived, //!< The request reached the time source
+          U64 responseSent, //!< The response left the time source
+          U64 responseReceived //!< The response reached this node
+      ) override;
+
+      //! Handler implementation for productGetIn
+      Fw::Success productGetIn_handler(
+          FwIndexType portNum, //!< The port number
+          FwDpIdType id, //!< Container id
+          FwSizeType dataSize, //!< Data size
+          Fw::Buffer& buffer //!< Container buffer, set on success
+      ) override;
+
+      //! Handler implementation for productSendIn
+      void productSendIn_handler(
+          FwIndexType portNum, //!< The port number
+          FwDpIdType id, //!< Container id
+          const Fw::Buffer& buffer //!< Container buffer
+      ) override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Helpers
+      // ----------------------------------------------------------------------
+
+      //! Send queued frames, run the radio if there was a tick, release returned packets and read the radio's load
+      void serviceRadioSide();
+
+      //! Have the radio side serviced: by the radio core, or here if there is none
+      void notifyRadioSide();
+
+      //! Release the frames the radio side has finished with
+      void releaseFrames();
+
+      //! Pass on the radio core's telemetry, events, clock exchanges and containers, and get the container it asked
+      //! for
+      void serviceRadioServices();
+
+      //! Count an item the radio core dropped on a full ring
+      void radioOverflow();
+
+      //! Note the depth of the rings to the main core for MainQueuePeak
+      void recordMainQueueDepth();
+
+      //! Write telemetry
+      void updateTelemetry();
+
+      //! Handle of a buffer
+      static BufferHandle handleOf(const Fw::Buffer& buffer);
+
+      //! Buffer of a handle
+      static Fw::Buffer bufferOf(const BufferHandle& handle);
+
+      //! Share of a window, per thousand
+      static U16 perMille(U32 part, U32 whole);
+
+      //! Add to a counter only this core writes
+      static void add(std::atomic<U32>& counter, U32 amount);
+
+      // ----------------------------------------------------------------------
+      // Platform
+      // ----------------------------------------------------------------------
+
+      //! Ring the doorbell
+      void ringDoorbell();
+
+      //! Sleep until the doorbell rings, or return at once if it rang since the last wait
+      void waitForDoorbell();
+
+      //! Microseconds of a free-running clock
+      static U32 nowUs();
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Member variables
+      // ----------------------------------------------------------------------
+
+      std::atomic<bool> m_radioCore; //!< Whether a radio core services the radio side
+
+      // Only one container is asked for at a time, and one clock exchange is under way at a time
+      static const U32 CONTAINER_RING_SIZE = 1;
+      static const U32 CLOCK_RING_SIZE = 2;
+
+      // Written by the main core
+      SpscRing<BufferHandle, CoreLinkCfg::RING_SIZE> m_frames; //!< Frames for the radio
+      SpscRing<BufferHandle, CoreLinkCfg::RETURN_RING_SIZE> m_packetReturns; //!< Packets back to the radio core
+      SpscRing<ContainerHandle, CONTAINER_RING_SIZE> m_containers; //!< Containers the radio asked for
+      std::atomic<U32> m_ticks; //!< Rate group ticks since startup
+
+      // Written by the radio core
+      SpscRing<BufferHandle, CoreLinkCfg::RETURN_RING_SIZE> m_frameReturns; //!< Frames back to the main core
+      SpscRing<BufferHandle, CoreLinkCfg::RING_SIZE> m_packets; //!< Deframed packets for the hub
+      SpscRing<ComCall, CoreLinkCfg::COM_RING_SIZE> m_coms; //!< Com calls for their receiver
+      SpscRing<TlmCall, CoreLinkCfg::TLM_RING_SIZE> m_tlms; //!< Telemetry for the channelizer
+      SpscRing<LogCall, CoreLinkCfg::LOG_RING_SIZE> m_logs; //!< Events for the event logger
+      SpscRing<ClockSample, CLOCK_RING_SIZE> m_clockSamples; //!< Clock exchanges for the disciplined clock
+      SpscRing<ContainerHandle, CONTAINER_RING_SIZE> m_containerRequests; //!< Containers the radio asks for
+      SpscRing<ContainerHandle, CoreLinkCfg::RING_SIZE> m_products; //!< Filled containers for the data products
+      std::atomic<U32> m_radioStatus; //!< Last status the radio reported
+      std::atomic<U32> m_radioStatusReports; //!< Statuses the radio has reported since startup
+      std::atomic<U32> m_radioBusyUs; //!< Microseconds the radio core has worked
+      std::atomic<U32> m_radioTotalUs; //!< Microseconds the radio core has worked or waited
+      std::atomic<U32> m_mainQueuePeak; //!< Most packets and Com calls ever waiting for the main core
+      std::atomic<U32> m_radioOverflows; //!< Packets and Com calls dropped on a full ring
+      std::atomic<bool> m_linkUp; //!< Whether the radio was running at the last pass of the radio side
+      std::atomic<U32> m_linkQueued; //!< Frames the radio held for a clear channel at the last pass
+      std::atomic<U32> m_linkBitRate; //!< Bit rate of the radio at the last pass
+      std::atomic<U32> m_linkLossPerMille; //!< Loss the radio reported at the last pass, per thousand
+      std::atomic<U32> m_linkAirtimePerMille; //!< Airtime the radio reported at the last pass, per thousand
+
+      // Main core only
+      Os::Mutex m_frameLock; //!< Serializes the main core's threads on the frame rings
+      Os::Mutex m_returnLock; //!< Serializes the main core's threads on the packet return ring
+      U32 m_radioQueuePeak; //!< Most frames ever waiting for the radio core
+      U32 m_frameOverflows; //!< Frames dropped on a full ring
+      U32 m_radioStatusSeen; //!< Radio status reports passed on
+      U32 m_mainBusyUs; //!< Microseconds the main loop has worked
+      U32 m_mainTotalUs; //!< Microseconds the main loop has run
+      U32 m_mainPassUs; //!< Shortest pass of the main loop seen, taken as polling with nothing to do
+      U32 m_mainBusyReported; //!< m_mainBusyUs at the last telemetry update
+      U32 m_mainTotalReported; //!< m_mainTotalUs at the last telemetry update
+      U32 m_radioBusyReported; //!< m_radioBusyUs at the last telemetry update
+      U32 m_radioTotalReported; //!< m_radioTotalUs at the last telemetry update
+      U32 m_telemetryCountdown; //!< Ticks until the next telemetry update
+
+      // Radio side only
+      Os::Mutex m_radioLock; //!< Serializes the main core's threads on the radio side when there is no radio core
+      U32 m_ticksRun; //!< Ticks the radio has been run for
+      bool m_containerAsked; //!< Whether a container has been asked for and has not come back
+
+#ifndef ARDUINO
+      std::mutex m_doorbellMutex; //!< Guards m_doorbellRung
+      std::condition_variable m_doorbell; //!< Signalled when the doorbell rings
+      bool m_doorbellRung; //!< Whether the doorbell rang since the last wait
+#endif
+  };
+
+}
+
+#endif
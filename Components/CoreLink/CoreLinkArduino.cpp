@@ -0,0 +1,41 @@
+// ======================================================================
+// \title  CoreLinkArduino.cpp
+// \brief  Arduino backend for the CoreLink component: the radio core is RP2040 core 1
+// ======================================================================
+
+#include "Components/CoreLink/CoreLink.hpp"
+#include "FpConfig.hpp"
+#include <FprimeArduino.hpp>
+
+#ifdef ARDUINO_ARCH_RP2040
+#include <hardware/sync.h>
+#endif
+
+namespace Components {
+
+  void CoreLink ::
+    ringDoorbell()
+  {
+#ifdef ARDUINO_ARCH_RP2040
+    // Sets the event flag of both cores. Core 1 wakes from __wfe(), or skips its next one if it is not waiting yet,
+    // so a ring is never lost.
+    __sev();
+#endif
+  }
+
+  void CoreLink ::
+    waitForDoorbell()
+  {
+#ifdef ARDUINO_ARCH_RP2040
+    // Also woken by core 1's own interrupts, such as the radio's; servicing the link then finds nothing to do
+    __wfe();
+#endif
+  }
+
+  U32 CoreLink ::
+    nowUs()
+  {
+    return micros();
+  }
+
+}
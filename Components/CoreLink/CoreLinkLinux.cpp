@@ -0,0 +1,38 @@
+// ======================================================================
+// \title  CoreLinkLinux.cpp
+// \brief  Host backend for the CoreLink component: the radio core is a thread
+// ======================================================================
+
+#include "Components/CoreLink/CoreLink.hpp"
+#include "FpConfig.hpp"
+
+#include <chrono>
+
+namespace Components {
+
+  void CoreLink ::
+    ringDoorbell()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_doorbellMutex);
+      m_doorbellRung = true;
+    }
+    m_doorbell.notify_one();
+  }
+
+  void CoreLink ::
+    waitForDoorbell()
+  {
+    std::unique_lock<std::mutex> lock(m_doorbellMutex);
+    m_doorbell.wait(lock, [this]() { return m_doorbellRung; });
+    m_doorbellRung = false;
+  }
+
+  U32 CoreLink ::
+    nowUs()
+  {
+    const std::chrono::steady_clock::duration now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<U32>(std::chrono::duration_cast<std::chrono::microseconds>(now).count());
+  }
+
+}
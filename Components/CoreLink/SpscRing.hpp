@@ -0,0 +1,97 @@
+// ======================================================================
+// \title  SpscRing.hpp
+// \brief  Lock-free ring between one producer and one consumer
+//
+// The producer only writes the head and the consumer only writes the tail, so neither needs a lock or a
+// read-modify-write instruction, which the RP2040's Cortex-M0+ cores do not have. Each index is a free-running count
+// that a release store publishes and an acquire load reads, so a slot is written in full before the other side sees
+// it.
+// ======================================================================
+
+#ifndef Components_SpscRing_HPP
+#define Components_SpscRing_HPP
+
+#include <FpConfig.hpp>
+
+#include <atomic>
+
+namespace Components {
+
+  template <typename T, U32 SIZE>
+  class SpscRing {
+      static_assert((SIZE > 0) && ((SIZE & (SIZE - 1)) == 0), "ring size must be a power of two");
+
+    public:
+
+      SpscRing() : m_head(0), m_tail(0) {}
+
+      //! Slots in the ring
+      static constexpr U32 capacity() { return SIZE; }
+
+      //! Producer: the slot to fill next, nullptr if the ring is full. It is not the consumer's until publish().
+      T* claim() {
+        const U32 head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == SIZE) {
+          return nullptr;
+        }
+        return &m_slots[head & (SIZE - 1)];
+      }
+
+      //! Producer: hand the claimed slot to the consumer
+      void publish() { m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+      //! Producer: copy an item in
+      //!
+      //! \return false if the ring is full
+      bool push(const T& item) {
+        T* const slot = this->claim();
+        if (slot == nullptr) {
+          return false;
+        }
+        *slot = item;
+        this->publish();
+        return true;
+      }
+
+      //! Consumer: the oldest item, nullptr if the ring is empty. It stays the consumer's until release().
+      T* front() {
+        const U32 tail = m_tail.load(std::memory_order_relaxed);
+        if (m_head.load(std::memory_order_acquire) == tail) {
+          return nullptr;
+        }
+        return &m_slots[tail & (SIZE - 1)];
+      }
+
+      //! Consumer: hand the front slot back to the producer
+      void release() { m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+      //! Consumer: copy the oldest item out
+      //!
+      //! \return false if the ring is empty
+      bool pop(T& item) {
+        T* const slot = this->front();
+        if (slot == nullptr) {
+          return false;
+        }
+        item = *slot;
+        this->release();
+        return true;
+      }
+
+      //! Items in the ring; exact on either side, a snapshot from anywhere else
+      U32 size() const { return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire); }
+
+    private:
+
+      //! Keeps the two indices on separate cache lines on the host, where each side's writes would otherwise evict
+      //! the other's
+      static const U32 CACHE_LINE = 64;
+
+      T m_slots[SIZE]; //!< Items
+      alignas(CACHE_LINE) std::atomic<U32> m_head; //!< Items ever published, written by the producer
+      alignas(CACHE_LINE) std::atomic<U32> m_tail; //!< Items ever released, written by the consumer
+  };
+
+}
+
+#endif
@@ -0,0 +1,173 @@
+// ======================================================================
+// \title  DisciplinedTime.cpp
+// \brief  cpp file for DisciplinedTime component implementation class
+// ======================================================================
+
+#include "Components/DisciplinedTime/DisciplinedTime.hpp"
+#include "FpConfig.hpp"
+#include <config/DisciplinedTimeCfg.hpp>
+
+namespace Components {
+
+  // ----------------------------------------------------------------------
+  // Component construction and destruction
+  // ----------------------------------------------------------------------
+
+  DisciplinedTime ::
+    DisciplinedTime(const char* const compName) :
+      DisciplinedTimeComponentBase(compName),
+      m_version(0),
+      m_synchronized(false),
+      m_anchorUs(0),
+      m_offsetUs(0),
+      m_slewUs(0),
+      m_slewPeriodUs(DisciplinedTimeCfg::SLEW_PERIOD_US),
+      m_driftPpb(0),
+      m_rejected(0)
+  {
+
+  }
+
+  DisciplinedTime ::
+    ~DisciplinedTime()
+  {
+
+  }
+
+  // ----------------------------------------------------------------------
+  // Handler implementations for user-defined typed input ports
+  // ----------------------------------------------------------------------
+
+  void DisciplinedTime ::
+    timeGetPort_handler(
+        FwIndexType portNum,
+        Fw::Time& time
+    )
+  {
+    this->localTime_out(0, time);
+    const U64 local = static_cast<U64>(time.getSeconds()) * 1000000 + time.getUSeconds();
+    // Read on both cores, so without a lock: Os::Mutex does not keep out the other core. A read that overlapped an
+    // update is taken again.
+    I64 correction = 0;
+    U32 version = 0;
+    do {
+      version = m_version.load(std::memory_order_acquire);
+      correction = this->correctionUs(local);
+      std::atomic_thread_fence(std::memory_order_acquire);
+    } while (((version & 1) != 0) || (m_version.load(std::memory_order_relaxed) != version));
+    const I64 corrected = static_cast<I64>(local) + correction;
+    const U64 now = static_cast<U64>(FW_MAX(corrected, static_cast<I64>(0)));
+    time.set(time.getTimeBase(), time.getContext(), static_cast<U32>(now / 1000000), static_cast<U32>(now % 1000000));
+  }
+
+  void DisciplinedTime ::
+    exchangeIn_handler(
+        FwIndexType portNum,
+        U64 requestSent,
+        U64 requestReceived,
+        U64 responseSent,
+        U64 responseReceived
+    )
+  {
+    // Both legs take as long on the air, so the offset is the mean of what each leg measures
+    const I64 there = static_cast<I64>(requestReceived - requestSent);
+    const I64 back = static_cast<I64>(responseReceived - responseSent);
+    const I64 offset = (there - back) / 2;
+    const I64 delay = there + back;
+    // Rate error between the clocks over the exchange can leave a short round trip slightly negative
+    if ((delay < -static_cast<I64>(DisciplinedTimeCfg::MAX_ROUND_TRIP_US)) ||
+        (delay > static_cast<I64>(DisciplinedTimeCfg::MAX_ROUND_TRIP_US))) {
+      m_rejected++;
+      this->tlmWrite_ExchangesRejected(m_rejected);
+      return;
+    }
+
+    const U64 local = this->localUs();
+    m_lock.lock();
+    // Offset still being slewed in from the last exchange is not error built up since
+    const I64 pending = m_synchronized ? (m_slewUs - this->slewedUs(local)) : 0;
+    const I64 builtUp = offset - pending;
+    const bool step = not m_synchronized || (builtUp > static_cast<I64>(DisciplinedTimeCfg::STEP_THRESHOLD_US)) ||
+                      (builtUp < -static_cast<I64>(DisciplinedTimeCfg::STEP_THRESHOLD_US));
+    I64 drift = m_driftPpb;
+    if (m_synchronized && (local > m_anchorUs)) {
+      // The offset left over built up since the last exchange at the rate the correction is still off by. A step
+      // still teaches the rate, so a clock fast enough to need stepping every exchange stops needing it.
+      const I64 rateError = builtUp * 1000000000 / static_cast<I64>(local - m_anchorUs);
+      drift = FW_MAX(FW_MIN(drift + rateError / (static_cast<I64>(1) << DisciplinedTimeCfg::DRIFT_GAIN_SHIFT),
+                            static_cast<I64>(DisciplinedTimeCfg::MAX_DRIFT_PPB)),
+                     -static_cast<I64>(DisciplinedTimeCfg::MAX_DRIFT_PPB));
+    }
+    // The served time never goes back. A large offset ahead is stepped; any other is slewed in over SLEW_PERIOD_US,
+    // except one so far behind that the clock would drop below half rate, which is slewed at half rate.
+    I64 correction = this->correctionUs(local);
+    I64 slew = offset;
+    U64 slewPeriod = DisciplinedTimeCfg::SLEW_PERIOD_US;
+    if (offset > static_cast<I64>(DisciplinedTimeCfg::STEP_THRESHOLD_US)) {
+      correction += offset;
+      slew = 0;
+    } else if (-offset > static_cast<I64>(DisciplinedTimeCfg::SLEW_PERIOD_US / 2)) {
+      slewPeriod = static_cast<U64>(-offset) * 2;
+    }
+    // Odd while the correction is being written, so a reader on either core knows to read it again
+    const U32 version = m_version.load(std::memory_order_relaxed);
+    m_version.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_offsetUs = correction;
+    m_slewUs = slew;
+    m_slewPeriodUs = slewPeriod;
+    m_anchorUs = local;
+    m_driftPpb = drift;
+    m_synchronized = true;
+    m_version.store(version + 2, std::memory_order_release);
+    m_lock.unLock();
+
+    if (step) {
+      this->log_ACTIVITY_HI_ClockStepped(offset);
+    }
+    this->tlmWrite_ClockOffset(static_cast<I32>(FW_MAX(FW_MIN(offset, static_cast<I64>(0x7FFFFFFF)),
+                                                       -static_cast<I64>(0x7FFFFFFF))));
+    // The correction speeds a slow clock up, so the clock's own rate is the opposite
+    this->tlmWrite_ClockDrift(static_cast<I32>(-drift));
+    this->tlmWrite_RoundTripDelay(static_cast<I32>(delay));
+  }
+
+  // ----------------------------------------------------------------------
+  // Helpers
+  // ----------------------------------------------------------------------
+
+  U64 DisciplinedTime ::
+    localUs()
+  {
+    Fw::Time time;
+    this->localTime_out(0, time);
+    return static_cast<U64>(time.getSeconds()) * 1000000 + time.getUSeconds();
+  }
+
+  I64 DisciplinedTime ::
+    correctionUs(U64 localUs) const
+  {
+    if (localUs <= m_anchorUs) {
+      return m_offsetUs;
+    }
+    return m_offsetUs + this->slewedUs(localUs) + m_driftPpb * static_cast<I64>(localUs - m_anchorUs) / 1000000000;
+  }
+
+  I64 DisciplinedTime ::
+    slewedUs(U64 localUs) const
+  {
+    if (localUs <= m_anchorUs) {
+      return 0;
+    }
+    const U64 elapsed = localUs - m_anchorUs;
+    if (elapsed >= m_slewPeriodUs) {
+      return m_slewUs;
+    }
+    if (m_slewPeriodUs > DisciplinedTimeCfg::SLEW_PERIOD_US) {
+      // A large offset behind, taken out at half rate; the product below could overflow for it
+      return -static_cast<I64>(elapsed / 2);
+    }
+    return m_slewUs * static_cast<I64>(elapsed) / static_cast<I64>(m_slewPeriodUs);
+  }
+
+}
@@ -0,0 +1,102 @@
+// ======================================================================
+// \title  DisciplinedTime.hpp
+// \brief  hpp file for DisciplinedTime component implementation class
+// ======================================================================
+
+#ifndef Components_DisciplinedTime_HPP
+#define Components_DisciplinedTime_HPP
+
+#include "Components/DisciplinedTime/DisciplinedTimeComponentAc.hpp"
+#include <Os/Mutex.hpp>
+#include <config/DisciplinedTimeCfg.hpp>
+#include <atomic>
+
+namespace Components {
+
+  //! Serves the local clock corrected toward a time source, from two-way exchanges with it over the radio
+  //!
+  //! The correction is an offset and a rate, both taken from the local clock at the last exchange, so the time served
+  //! moves smoothly between exchanges. Each exchange measures the offset left over. An offset ahead past
+  //! DisciplinedTimeCfg::STEP_THRESHOLD_US steps the clock; any other is slewed in over the following
+  //! DisciplinedTimeCfg::SLEW_PERIOD_US, or at half rate if it is too far behind for that, so the time served never
+  //! goes back. From the second exchange on, the rate error the offset implies over the time since the last one,
+  //! less what was still being slewed in, is added to the rate in part.
+  class DisciplinedTime :
+    public DisciplinedTimeComponentBase
+  {
+
+    public:
+
+      // ----------------------------------------------------------------------
+      // Component construction and destruction
+      // ----------------------------------------------------------------------
+
+      //! Construct DisciplinedTime object
+      DisciplinedTime(
+          const char* const compName //!< The component name
+      );
+
+      //! Destroy DisciplinedTime object
+      ~DisciplinedTime();
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Handler implementations for user-defined typed input ports
+      // ----------------------------------------------------------------------
+
+      //! Handler implementation for timeGetPort
+      void timeGetPort_handler(
+          FwIndexType portNum, //!< The port number
+          Fw::Time& time //!< Reference to Time object
+      ) override;
+
+      //! Handler implementation for exchangeIn
+      void exchangeIn_handler(
+          FwIndexType portNum, //!< The port number
+          U64 requestSent, //!< The request left this node
+          U64 requestReceived, //!< The request reached the time source
+          U64 responseSent, //!< The response left the time source
+          U64 responseReceived //!< The response reached this node
+      ) override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Helpers
+      // ----------------------------------------------------------------------
+
+      //! Read the local clock in microseconds
+      U64 localUs();
+
+      //! Correction to the local clock at a local time; the caller holds m_lock or checks m_version around it
+      I64 correctionUs(U64 localUs) const;
+
+      //! Part of m_slewUs taken out by a local time; the caller holds m_lock or checks m_version around it
+      I64 slewedUs(U64 localUs) const;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Member variables
+      // ----------------------------------------------------------------------
+
+      static_assert(DisciplinedTimeCfg::STEP_THRESHOLD_US < DisciplinedTimeCfg::SLEW_PERIOD_US / 2,
+                    "Slewing an offset below the step threshold must not slow the clock below half rate");
+      static_assert(DisciplinedTimeCfg::MAX_DRIFT_PPB < 500000000,
+                    "Drift correction must not stop a clock slewing at half rate");
+
+      Os::Mutex m_lock; //!< Serializes exchanges
+      std::atomic<U32> m_version; //!< Updates of the correction, doubled; odd while one is being written
+      bool m_synchronized; //!< Whether an exchange has been accepted
+      U64 m_anchorUs; //!< Local time of the last accepted exchange
+      I64 m_offsetUs; //!< Correction at m_anchorUs
+      I64 m_slewUs; //!< Offset being slewed in from m_anchorUs
+      U64 m_slewPeriodUs; //!< Local time over which m_slewUs is slewed in
+      I64 m_driftPpb; //!< Correction to the rate of the local clock, in parts per billion
+      U32 m_rejected; //!< Exchanges discarded
+  };
+
+}
+
+#endif
@@ -0,0 +1,248 @@
+// ======================================================================
+// \title  DownlinkArbiter.cpp
+// \brief  cpp file for DownlinkArbiter component implementation class
+// ======================================================================
+
+#include "Components/DownlinkArbiter/DownlinkArbiter.hpp"
+#include "FpConfig.hpp"
+#include <cstring>
+
+namespace Components {
+
+  // ----------------------------------------------------------------------
+  // Component construction and destruction
+  // ----------------------------------------------------------------------
+
+  DownlinkArbiter ::
+    DownlinkArbiter(const char* const compName) :
+      DownlinkArbiterComponentBase(compName),
+      m_paramsChanged(true),
+      m_linkRate(0),
+      m_budget(0),
+      m_current(0),
+      m_credited(false),
+      m_telemetryTicks(0)
+  {
+    for (U32 cls = 0; cls < DownlinkClasses; cls++) {
+      m_shares[cls] = 1;
+    }
+    memset(m_head, 0, sizeof(m_head));
+    memset(m_count, 0, sizeof(m_count));
+    memset(m_deficits, 0, sizeof(m_deficits));
+    memset(m_backlog, 0, sizeof(m_backlog));
+    memset(m_sent, 0, sizeof(m_sent));
+    memset(m_dropped, 0, sizeof(m_dropped));
+  }
+
+  DownlinkArbiter ::
+    ~DownlinkArbiter()
+  {
+
+  }
+
+  // ----------------------------------------------------------------------
+  // Handler implementations for user-defined typed input ports
+  // ----------------------------------------------------------------------
+
+  void DownlinkArbiter ::
+    comIn_handler(
+        FwIndexType portNum,
+        Fw::ComBuffer& data,
+        U32 context
+    )
+  {
+    const U32 cls = static_cast<U32>(portNum);
+    FW_ASSERT(cls < DownlinkClasses, cls);
+    if (m_count[cls] >= DownlinkArbiterCfg::QUEUE_DEPTH) {
+      // Tail drop: what is queued is older and goes out first
+      m_dropped[cls]++;
+      return;
+    }
+    Packet& packet = m_queues[cls][(m_head[cls] + m_count[cls]) % DownlinkArbiterCfg::QUEUE_DEPTH];
+    packet.data = data;
+    packet.context = context;
+    m_count[cls]++;
+    m_backlog[cls] += static_cast<U32>(data.getBuffLength()) + DownlinkArbiterCfg::FRAME_OVERHEAD_BYTES;
+  }
+
+  void DownlinkArbiter ::
+    schedIn_handler(
+        FwIndexType portNum,
+        U32 context
+    )
+  {
+    if (m_paramsChanged.exchange(false)) {
+      this->loadParameters();
+    }
+    // The link does not save up while idle: the budget holds a tick's worth, and enough over it for the largest
+    // packet, so one that costs more than a tick still goes out
+    m_budget = FW_MIN(m_budget + m_linkRate, m_linkRate + cost(FW_COM_BUFFER_MAX_SIZE));
+    this->serve();
+
+    m_telemetryTicks++;
+    if (m_telemetryTicks >= DownlinkArbiterCfg::TELEMETRY_PERIOD_TICKS) {
+      m_telemetryTicks = 0;
+      this->updateTelemetry();
+    }
+  }
+
+  // ----------------------------------------------------------------------
+  // Parameter update hooks
+  // ----------------------------------------------------------------------
+
+  void DownlinkArbiter ::
+    parameterUpdated(FwPrmIdType id)
+  {
+    // Called on the thread that ran PRM_SET; schedIn reads the new value under the component's lock
+    m_paramsChanged.store(true);
+  }
+
+  void DownlinkArbiter ::
+    parametersLoaded()
+  {
+    m_paramsChanged.store(true);
+  }
+
+  // ----------------------------------------------------------------------
+  // Helpers
+  // ----------------------------------------------------------------------
+
+  void DownlinkArbiter ::
+    loadParameters()
+  {
+    Fw::ParamValid valid;
+    m_linkRate = this->paramGet_LINK_RATE(valid);
+    const DownlinkClassFigures shares = this->paramGet_SHARES(valid);
+    U64 total = 0;
+    for (U32 cls = 0; cls < DownlinkClasses; cls++) {
+      // A share of 0 still sends when the link would otherwise be idle
+      m_shares[cls] = FW_MAX(shares[cls], static_cast<U32>(1));
+      total += shares[cls];
+    }
+    // Deficit round robin shares out what the link carries in proportion, so this is a misconfiguration only in
+    // that the shares no longer read as rates
+    if ((m_linkRate != 0) && (total > m_linkRate)) {
+      this->log_WARNING_LO_SharesExceedLink(static_cast<U32>(FW_MIN(total, static_cast<U64>(0xFFFFFFFF))), m_linkRate);
+    }
+  }
+
+  void DownlinkArbiter ::
+    serve()
+  {
+    for (;;) {
+      bool waiting = false;
+      bool sent = false;
+      for (U32 visit = 0; visit < DownlinkClasses; visit++) {
+        const U32 cls = m_current;
+        if (m_count[cls] > 0) {
+          waiting = true;
+          if (not m_credited) {
+            m_deficits[cls] += m_shares[cls];
+            m_credited = true;
+          }
+          while ((m_count[cls] > 0) && (this->frontCost(cls) <= m_deficits[cls])) {
+            const U64 packetCost = this->frontCost(cls);
+            if ((m_linkRate != 0) && (packetCost > m_budget)) {
+              // Out of budget: the next call picks up with this class, already credited for this visit
+              return;
+            }
+            m_deficits[cls] -= packetCost;
+            if (m_linkRate != 0) {
+              m_budget -= packetCost;
+            }
+            this->sendFront(cls);
+            sent = true;
+          }
+        }
+        if (m_count[cls] == 0) {
+          m_deficits[cls] = 0;
+        }
+        m_credited = false;
+        m_current = (cls + 1) % DownlinkClasses;
+      }
+      if (not waiting) {
+        return;
+      }
+      if (not sent) {
+        this->skipIdleRounds();
+      }
+    }
+  }
+
+  void DownlinkArbiter ::
+    skipIdleRounds()
+  {
+    // The round just finished credited every waiting class once and none could send, so each needs at least one
+    // more; find the fewest any needs and credit all of them that many, less the one the next round gives
+    U64 rounds = 0;
+    bool found = false;
+    for (U32 cls = 0; cls < DownlinkClasses; cls++) {
+      if (m_count[cls] == 0) {
+        continue;
+      }
+      const U64 needed = (this->frontCost(cls) - m_deficits[cls] + m_shares[cls] - 1) / m_shares[cls];
+      if (not found || (needed < rounds)) {
+        rounds = needed;
+        found = true;
+      }
+    }
+    if (rounds <= 1) {
+      return;
+    }
+    for (U32 cls = 0; cls < DownlinkClasses; cls++) {
+      if (m_count[cls] > 0) {
+        m_deficits[cls] += (rounds - 1) * m_shares[cls];
+      }
+    }
+  }
+
+  U64 DownlinkArbiter ::
+    frontCost(U32 cls) const
+  {
+    FW_ASSERT(m_count[cls] > 0, cls);
+    return cost(static_cast<U32>(m_queues[cls][m_head[cls]].data.getBuffLength()));
+  }
+
+  void DownlinkArbiter ::
+    sendFront(U32 cls)
+  {
+    Packet& packet = m_queues[cls][m_head[cls]];
+    const U32 bytes = static_cast<U32>(packet.data.getBuffLength()) + DownlinkArbiterCfg::FRAME_OVERHEAD_BYTES;
+    m_head[cls] = (m_head[cls] + 1) % DownlinkArbiterCfg::QUEUE_DEPTH;
+    m_count[cls]--;
+    m_backlog[cls] -= bytes;
+    m_sent[cls] += bytes;
+    if (this->isConnected_comOut_OutputPort(0)) {
+      this->comOut_out(0, packet.data, packet.context);
+    }
+  }
+
+  void DownlinkArbiter ::
+    updateTelemetry()
+  {
+    DownlinkClassFigures throughput;
+    DownlinkClassFigures backlog;
+    DownlinkClassFigures dropped;
+    U64 total = 0;
+    for (U32 cls = 0; cls < DownlinkClasses; cls++) {
+      throughput[cls] = static_cast<U32>(static_cast<U64>(m_sent[cls]) * DownlinkArbiterCfg::TICKS_PER_SECOND /
+                                         DownlinkArbiterCfg::TELEMETRY_PERIOD_TICKS);
+      backlog[cls] = m_backlog[cls];
+      dropped[cls] = m_dropped[cls];
+      total += throughput[cls];
+      m_sent[cls] = 0;
+    }
+    this->tlmWrite_Throughput(throughput);
+    this->tlmWrite_Backlog(backlog);
+    this->tlmWrite_Dropped(dropped);
+    this->tlmWrite_LinkUtilization(
+        (m_linkRate != 0) ? static_cast<U16>(FW_MIN(total * 1000 / m_linkRate, static_cast<U64>(1000))) : 0);
+  }
+
+  U64 DownlinkArbiter ::
+    cost(U32 size)
+  {
+    return static_cast<U64>(size + DownlinkArbiterCfg::FRAME_OVERHEAD_BYTES) * DownlinkArbiterCfg::TICKS_PER_SECOND;
+  }
+
+}
@@ -0,0 +1,137 @@
+// ======================================================================
+// \title  DownlinkArbiter.hpp
+// \brief  hpp file for DownlinkArbiter component implementation class
+// ======================================================================
+
+#ifndef Components_DownlinkArbiter_HPP
+#define Components_DownlinkArbiter_HPP
+
+#include "Components/DownlinkArbiter/DownlinkArbiterComponentAc.hpp"
+#include <config/DownlinkArbiterCfg.hpp>
+
+#include <atomic>
+
+namespace Components {
+
+  //! Meters Com packets onto the ground link, sharing its bandwidth between classes of traffic
+  //!
+  //! Each class, by the comIn port its packets arrive on, has a queue of DownlinkArbiterCfg::QUEUE_DEPTH packets.
+  //! Every schedIn call adds a tick's worth of LINK_RATE to the link budget, then serves the queues by deficit round
+  //! robin: on each visit a class with packets waiting is credited its share, and sends from the front of its queue
+  //! while the packet, with the framing around it, fits both its credit and the budget. A class with nothing waiting
+  //! keeps no credit, so the rounds go on among the others and what it leaves of its share is theirs. Everything is
+  //! counted in bytes times DownlinkArbiterCfg::TICKS_PER_SECOND, so a share in bytes per second is also the credit
+  //! of one round and nothing is lost to rounding.
+  class DownlinkArbiter :
+    public DownlinkArbiterComponentBase
+  {
+
+    public:
+
+      // ----------------------------------------------------------------------
+      // Component construction and destruction
+      // ----------------------------------------------------------------------
+
+      //! Construct DownlinkArbiter object
+      DownlinkArbiter(
+          const char* const compName //!< The component name
+      );
+
+      //! Destroy DownlinkArbiter object
+      ~DownlinkArbiter();
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Handler implementations for user-defined typed input ports
+      // ----------------------------------------------------------------------
+
+      //! Handler implementation for comIn
+      void comIn_handler(
+          FwIndexType portNum, //!< The port number, which is the DownlinkClass
+          Fw::ComBuffer& data, //!< Buffer containing packet data
+          U32 context //!< Call context value; meaning chosen by user
+      ) override;
+
+      //! Handler implementation for schedIn
+      void schedIn_handler(
+          FwIndexType portNum, //!< The port number
+          U32 context //!< The call order
+      ) override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Parameter update hooks
+      // ----------------------------------------------------------------------
+
+      //! Called when a parameter is set; the new value is read on the next schedIn call
+      void parameterUpdated(
+          FwPrmIdType id //!< The parameter ID
+      ) override;
+
+      //! Called when the parameters are loaded at startup
+      void parametersLoaded() override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Helpers
+      // ----------------------------------------------------------------------
+
+      //! A packet held for the link
+      struct Packet {
+        Fw::ComBuffer data; //!< The packet
+        U32 context; //!< Context it was sent with
+      };
+
+      //! Read LINK_RATE and SHARES
+      void loadParameters();
+
+      //! Send what the link budget allows, by deficit round robin
+      void serve();
+
+      //! Credit every class with packets waiting the rounds it would take for the first of them to have enough to
+      //! send, less one, so a round that sends nothing is not repeated a packet's cost over a share times
+      void skipIdleRounds();
+
+      //! Link cost of the packet at the front of a class's queue
+      U64 frontCost(U32 cls) const;
+
+      //! Send the packet at the front of a class's queue
+      void sendFront(U32 cls);
+
+      //! Write the telemetry
+      void updateTelemetry();
+
+      //! Link cost of a packet of the given size: its bytes and its framing, times the tick rate
+      static U64 cost(U32 size);
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Member variables
+      // ----------------------------------------------------------------------
+
+      std::atomic<bool> m_paramsChanged; //!< Whether a parameter was set since they were read
+      U32 m_linkRate; //!< LINK_RATE, 0 for no limit
+      U32 m_shares[DownlinkClasses]; //!< SHARES, each at least 1
+
+      Packet m_queues[DownlinkClasses][DownlinkArbiterCfg::QUEUE_DEPTH]; //!< Packets waiting, by class
+      U32 m_head[DownlinkClasses]; //!< Index of the first packet waiting in each queue
+      U32 m_count[DownlinkClasses]; //!< Packets waiting in each queue
+
+      U64 m_budget; //!< Link budget left
+      U64 m_deficits[DownlinkClasses]; //!< Credit of each class
+      U32 m_current; //!< Class being served, where the next call picks up
+      bool m_credited; //!< Whether the class being served has had its credit for this visit
+
+      U32 m_backlog[DownlinkClasses]; //!< Bytes waiting in each queue, framing included
+      U32 m_sent[DownlinkClasses]; //!< Bytes each class sent this telemetry period, framing included
+      U32 m_dropped[DownlinkClasses]; //!< Packets of each class dropped to a full queue
+      U32 m_telemetryTicks; //!< schedIn calls since telemetry was written
+  };
+
+}
+
+#endif
@@ -0,0 +1,194 @@
+// ======================================================================
+// \title  DpProcessor.cpp
+// \brief  cpp file for DpProcessor component implementation class
+// ======================================================================
+
+#include "Components/DpProcessor/DpProcessor.hpp"
+#include "FpConfig.hpp"
+#include <Components/Framing/Crc32.hpp>
+#include <cstring>
+
+namespace Components {
+
+  namespace {
+    //! Longest run or literal span in one PackBits code
+    const FwSizeType PACKBITS_MAX_SPAN = 128;
+
+    //! Write a big-endian U32 into user data
+    void putU32(U8* dest, U32 value) {
+      dest[0] = static_cast<U8>(value >> 24);
+      dest[1] = static_cast<U8>(value >> 16);
+      dest[2] = static_cast<U8>(value >> 8);
+      dest[3] = static_cast<U8>(value);
+    }
+  }
+
+  // ----------------------------------------------------------------------
+  // Component construction and destruction
+  // ----------------------------------------------------------------------
+
+  DpProcessor ::
+    DpProcessor(const char* const compName) :
+      DpProcessorComponentBase(compName),
+      m_containersCompressed(0),
+      m_bytesSaved(0),
+      m_containersChecksummed(0),
+      m_filesQueued(0),
+      m_filesRefused(0)
+  {
+
+  }
+
+  DpProcessor ::
+    ~DpProcessor()
+  {
+
+  }
+
+  FwSizeType DpProcessor ::
+    packBits(const U8* data, FwSizeType size, U8* out, FwSizeType capacity)
+  {
+    FwSizeType in = 0;
+    FwSizeType written = 0;
+    while (in < size) {
+      // Runs of three or more are worth a repeat code
+      FwSizeType run = 1;
+      while ((in + run < size) && (run < PACKBITS_MAX_SPAN) && (data[in + run] == data[in])) {
+        run++;
+      }
+      if (run >= 3) {
+        if (written + 2 > capacity) {
+          return capacity + 1;
+        }
+        out[written++] = static_cast<U8>(257 - run);
+        out[written++] = data[in];
+        in += run;
+        continue;
+      }
+
+      // Literal span up to the next run of three
+      FwSizeType literal = 0;
+      while ((in + literal < size) && (literal < PACKBITS_MAX_SPAN)) {
+        const FwSizeType at = in + literal;
+        if ((at + 2 < size) && (data[at] == data[at + 1]) && (data[at] == data[at + 2])) {
+          break;
+        }
+        literal++;
+      }
+      if (written + 1 + literal > capacity) {
+        return capacity + 1;
+      }
+      out[written++] = static_cast<U8>(literal - 1);
+      memcpy(out + written, data + in, literal);
+      written += literal;
+      in += literal;
+    }
+    return written;
+  }
+
+  // ----------------------------------------------------------------------
+  // Handler implementations for user-defined typed input ports
+  // ----------------------------------------------------------------------
+
+  void DpProcessor ::
+    productIn_handler(
+        FwIndexType portNum,
+        Fw::Buffer& fwBuffer
+    )
+  {
+    // A container that does not parse goes on as it is, for DpWriter to reject
+    Fw::DpContainer container;
+    if (this->load(fwBuffer, container)) {
+      // In bit order, so a checksum covers the data as it is finally written
+      const Fw::DpCfg::ProcType::SerialType procTypes = container.getProcTypes();
+      if ((procTypes & Fw::DpCfg::ProcType::COMPRESS) != 0) {
+        this->compress(fwBuffer, container);
+      }
+      if ((procTypes & Fw::DpCfg::ProcType::CHECKSUM) != 0) {
+        this->checksum(fwBuffer, container);
+      }
+      // The user data flags say what was done; DpWriter must not run the stages again
+      container.setProcTypes(0);
+      container.serializeHeader();
+    }
+    this->productOut_out(0, fwBuffer);
+  }
+
+  void DpProcessor ::
+    writtenIn_handler(
+        FwIndexType portNum,
+        const Fw::StringBase& fileName,
+        FwDpPriorityType priority,
+        FwSizeType size
+    )
+  {
+    // Whole files, under their own names on the ground
+    const Svc::SendFileResponse response = this->sendFileOut_out(0, fileName, fileName, 0, 0);
+    if (response.getstatus() != Svc::SendFileStatus::STATUS_OK) {
+      m_filesRefused++;
+      this->tlmWrite_FilesRefused(m_filesRefused);
+      this->log_WARNING_LO_DownlinkRefused(fileName);
+      return;
+    }
+    m_filesQueued++;
+    this->tlmWrite_FilesQueued(m_filesQueued);
+  }
+
+  // ----------------------------------------------------------------------
+  // Helpers
+  // ----------------------------------------------------------------------
+
+  bool DpProcessor ::
+    load(Fw::Buffer& fwBuffer, Fw::DpContainer& container)
+  {
+    container.setBuffer(fwBuffer);
+    const Fw::SerializeStatus status = container.deserializeHeader();
+    if (status != Fw::FW_SERIALIZE_OK) {
+      this->log_WARNING_LO_InvalidContainer(static_cast<I32>(status));
+      return false;
+    }
+    return true;
+  }
+
+  void DpProcessor ::
+    compress(Fw::Buffer& fwBuffer, Fw::DpContainer& container)
+  {
+    const FwSizeType dataSize = container.getDataSize();
+    if ((dataSize == 0) || (container.m_userData[FLAGS_OFFSET] & FLAG_COMPRESSED)) {
+      return;
+    }
+
+    // Only keep the encoding if it saves space
+    U8* const data = fwBuffer.getData() + Fw::DpContainer::DATA_OFFSET;
+    const FwSizeType capacity = FW_MIN(dataSize - 1, SCRATCH_SIZE);
+    const FwSizeType packed = packBits(data, dataSize, m_scratch, capacity);
+    if (packed > capacity) {
+      return;
+    }
+    memcpy(data, m_scratch, packed);
+
+    container.m_userData[FLAGS_OFFSET] |= FLAG_COMPRESSED;
+    putU32(&container.m_userData[ORIGINAL_SIZE_OFFSET], static_cast<U32>(dataSize));
+    container.setDataSize(packed);
+    container.updateDataHash();
+
+    m_containersCompressed++;
+    m_bytesSaved += static_cast<U32>(dataSize - packed);
+    this->tlmWrite_ContainersCompressed(m_containersCompressed);
+    this->tlmWrite_BytesSaved(m_bytesSaved);
+  }
+
+  void DpProcessor ::
+    checksum(Fw::Buffer& fwBuffer, Fw::DpContainer& container)
+  {
+    const U8* const data = fwBuffer.getData() + Fw::DpContainer::DATA_OFFSET;
+    const U32 crc = Framing::defaultCrc32Engine().compute(data, container.getDataSize());
+
+    container.m_userData[FLAGS_OFFSET] |= FLAG_CHECKSUMMED;
+    putU32(&container.m_userData[CRC_OFFSET], crc);
+
+    m_containersChecksummed++;
+    this->tlmWrite_ContainersChecksummed(m_containersChecksummed);
+  }
+
+}
@@ -0,0 +1,123 @@
+// ======================================================================
+// \title  DpProcessor.hpp
+// \brief  hpp file for DpProcessor component implementation class
+// ======================================================================
+
+#ifndef Components_DpProcessor_HPP
+#define Components_DpProcessor_HPP
+
+#include "Components/DpProcessor/DpProcessorComponentAc.hpp"
+#include <Fw/Dp/DpContainer.hpp>
+
+namespace Components {
+
+  //! Processing stages for data product containers
+  //!
+  //! Containers pass through on their way from the data product manager to DpWriter. The stage for each bit of the
+  //! container's ProcType mask runs in bit order, on the container buffer in place, and records what it did in the
+  //! container user data so the ground can undo it. The mask is then cleared: DpWriter takes a container's size
+  //! before running its own processing ports, so a stage there that shrank the data would leave the file its old
+  //! size.
+  //!
+  //! Each file DpWriter writes is then queued for downlink.
+  class DpProcessor :
+    public DpProcessorComponentBase
+  {
+
+    public:
+
+      //! Container user data written by the stages
+      enum UserDataOffset {
+        FLAGS_OFFSET = 0, //!< U8 of UserDataFlags
+        CRC_OFFSET = 4, //!< U32 CRC-32 of the data as written
+        ORIGINAL_SIZE_OFFSET = 8, //!< U32 data size before compression
+      };
+
+      //! Stages that have run on a container
+      enum UserDataFlags : U8 {
+        FLAG_COMPRESSED = 0x01, //!< Data is PackBits run-length encoded
+        FLAG_CHECKSUMMED = 0x02, //!< CRC_OFFSET holds the data CRC
+      };
+
+      //! Largest container data the compression stage handles; larger containers are written uncompressed
+      static const FwSizeType SCRATCH_SIZE = 1024;
+
+      // ----------------------------------------------------------------------
+      // Component construction and destruction
+      // ----------------------------------------------------------------------
+
+      //! Construct DpProcessor object
+      DpProcessor(
+          const char* const compName //!< The component name
+      );
+
+      //! Destroy DpProcessor object
+      ~DpProcessor();
+
+      //! PackBits-encode data
+      //!
+      //! \return the encoded size, or a value above capacity if the encoding does not fit
+      static FwSizeType packBits(
+          const U8* data, //!< Data to encode
+          FwSizeType size, //!< Size of the data
+          U8* out, //!< Destination
+          FwSizeType capacity //!< Size of the destination
+      );
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Handler implementations for user-defined typed input ports
+      // ----------------------------------------------------------------------
+
+      //! Handler implementation for productIn
+      void productIn_handler(
+          FwIndexType portNum, //!< The port number
+          Fw::Buffer& fwBuffer //!< The container
+      ) override;
+
+      //! Handler implementation for writtenIn
+      void writtenIn_handler(
+          FwIndexType portNum, //!< The port number
+          const Fw::StringBase& fileName, //!< The file written
+          FwDpPriorityType priority, //!< The container priority
+          FwSizeType size //!< The file size
+      ) override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Helpers
+      // ----------------------------------------------------------------------
+
+      //! Attach a container buffer and read its header
+      //!
+      //! \return false if the header is invalid
+      bool load(Fw::Buffer& fwBuffer, Fw::DpContainer& container);
+
+      //! PackBits-encode the container data in place, if that shrinks it
+      void compress(Fw::Buffer& fwBuffer, Fw::DpContainer& container);
+
+      //! Store the CRC-32 of the container data in its user data
+      void checksum(Fw::Buffer& fwBuffer, Fw::DpContainer& container);
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Member variables
+      // ----------------------------------------------------------------------
+
+      static_assert(ORIGINAL_SIZE_OFFSET + sizeof(U32) <= Fw::DpCfg::CONTAINER_USER_DATA_SIZE,
+                    "Container user data too small for the processing stages");
+
+      U8 m_scratch[SCRATCH_SIZE]; //!< Encoding area for compression
+      U32 m_containersCompressed; //!< Containers compressed
+      U32 m_bytesSaved; //!< Bytes removed by compression
+      U32 m_containersChecksummed; //!< Containers checksummed
+      U32 m_filesQueued; //!< Files queued for downlink
+      U32 m_filesRefused; //!< Files the downlink refused
+  };
+
+}
+
+#endif
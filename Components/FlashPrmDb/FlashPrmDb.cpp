@@ -0,0 +1,537 @@
+// ======================================================================
+// \title  FlashPrmDb.cpp
+// \brief  cpp file for FlashPrmDb component implementation class
+// ======================================================================
+
+#include "Components/FlashPrmDb/FlashPrmDb.hpp"
+#include "FpConfig.hpp"
+#include <Components/Framing/Crc32.hpp>
+#include <cstring>
+
+namespace Components {
+
+  // ----------------------------------------------------------------------
+  // Component construction and destruction
+  // ----------------------------------------------------------------------
+
+  FlashPrmDb ::
+    FlashPrmDb(const char* const compName) :
+      FlashPrmDbComponentBase(compName),
+      m_store(nullptr),
+      m_available(false),
+      m_activeSector(0),
+      m_sequence(0),
+      m_writeOffset(HEADER_SIZE),
+      m_liveBytes(HEADER_SIZE),
+      m_compactState(COMPACT_IDLE),
+      m_compactEntry(0),
+      m_standbyOffset(HEADER_SIZE),
+      m_savePending(false),
+      m_saveOpCode(0),
+      m_saveCmdSeq(0),
+      m_recordsWritten(0),
+      m_compactions(0),
+      m_telemetryDirty(false)
+  {
+    for (U32 entry = 0; entry < PRMDB_NUM_DB_ENTRIES; entry++) {
+      m_entries[entry].used = false;
+      m_entries[entry].id = 0;
+      m_entries[entry].set = false;
+      m_entries[entry].saved = false;
+      m_entries[entry].savedOffset = 0;
+      m_entries[entry].savedSize = 0;
+      m_entries[entry].standbyOffset = 0;
+    }
+  }
+
+  FlashPrmDb ::
+    ~FlashPrmDb()
+  {
+
+  }
+
+  void FlashPrmDb ::
+    configure(FlashStore& store)
+  {
+    m_store = &store;
+  }
+
+  void FlashPrmDb ::
+    load()
+  {
+    FW_ASSERT(m_store != nullptr);
+    m_available = true;
+
+    bool found = false;
+    for (U32 sector = 0; sector < FlashPrmDbCfg::SECTOR_COUNT; sector++) {
+      U32 sequence = 0;
+      if (this->readHeader(sector, sequence) && (not found || (sequence > m_sequence))) {
+        found = true;
+        m_activeSector = sector;
+        m_sequence = sequence;
+      }
+    }
+
+    U32 records = 0;
+    if (found) {
+      records = this->replay(m_activeSector);
+    } else {
+      // Blank or never-committed flash starts an empty log
+      m_activeSector = 0;
+      m_sequence = 1;
+      m_writeOffset = HEADER_SIZE;
+      if (not m_store->erase(m_activeSector) || not this->writeHeader(m_activeSector, m_sequence)) {
+        this->flashFailed(0);
+      }
+    }
+
+    U32 entries = 0;
+    for (U32 entry = 0; entry < PRMDB_NUM_DB_ENTRIES; entry++) {
+      entries += m_entries[entry].used ? 1 : 0;
+    }
+    this->log_ACTIVITY_LO_PrmDbLoaded(entries, records, m_sequence);
+    m_telemetryDirty = true;
+  }
+
+  // ----------------------------------------------------------------------
+  // Handler implementations for user-defined typed input ports
+  // ----------------------------------------------------------------------
+
+  Fw::ParamValid FlashPrmDb ::
+    getPrm_handler(
+        FwIndexType portNum,
+        FwPrmIdType id,
+        Fw::ParamBuffer& val
+    )
+  {
+    const U32 entry = this->find(id);
+    if (entry == NO_ENTRY) {
+      return Fw::ParamValid::INVALID;
+    }
+    val = m_entries[entry].value;
+    return Fw::ParamValid::VALID;
+  }
+
+  void FlashPrmDb ::
+    setPrm_handler(
+        FwIndexType portNum,
+        FwPrmIdType id,
+        Fw::ParamBuffer& val
+    )
+  {
+    const U32 existing = this->find(id);
+    if ((existing != NO_ENTRY) &&
+        (m_entries[existing].value.getBuffLength() == val.getBuffLength()) &&
+        (memcmp(m_entries[existing].value.getBuffAddr(), val.getBuffAddr(), val.getBuffLength()) == 0)) {
+      // Nothing changed, so there is nothing to save
+      return;
+    }
+
+    const U32 entry = this->store(id, val);
+    if (entry == NO_ENTRY) {
+      this->log_WARNING_HI_PrmDbFull(id);
+      return;
+    }
+    // Kept in RAM until PRM_SAVE, as Svc::PrmDb keeps it until PRM_SAVE_FILE
+    m_entries[entry].set = true;
+  }
+
+  void FlashPrmDb ::
+    run_handler(
+        FwIndexType portNum,
+        NATIVE_UINT_TYPE context
+    )
+  {
+    if (m_available && (m_compactState == COMPACT_IDLE) && this->compactionDue()) {
+      m_compactState = COMPACT_ERASE;
+    }
+    if (m_available && (m_compactState != COMPACT_IDLE)) {
+      this->compactStep();
+    }
+    if (m_savePending && (not m_available || this->saveSet())) {
+      m_savePending = false;
+      this->cmdResponse_out(m_saveOpCode, m_saveCmdSeq,
+                            m_available ? Fw::CmdResponse::OK : Fw::CmdResponse::EXECUTION_ERROR);
+    }
+    this->updateTelemetry();
+  }
+
+  // ----------------------------------------------------------------------
+  // Handler implementations for commands
+  // ----------------------------------------------------------------------
+
+  void FlashPrmDb ::
+    PRM_COMPACT_cmdHandler(
+        FwOpcodeType opCode,
+        U32 cmdSeq
+    )
+  {
+    if (not m_available) {
+      this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::EXECUTION_ERROR);
+      return;
+    }
+    if (m_compactState == COMPACT_IDLE) {
+      m_compactState = COMPACT_ERASE;
+    }
+    this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::OK);
+  }
+
+  void FlashPrmDb ::
+    PRM_SAVE_cmdHandler(
+        FwOpcodeType opCode,
+        U32 cmdSeq
+    )
+  {
+    if (m_savePending) {
+      this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::BUSY);
+      return;
+    }
+    const bool saved = m_available && this->saveSet();
+    this->updateTelemetry();
+    if (m_available && not saved) {
+      // A compaction erases and rewrites a sector, with interrupts off for each step, so it is left to the run calls
+      m_savePending = true;
+      m_saveOpCode = opCode;
+      m_saveCmdSeq = cmdSeq;
+      return;
+    }
+    this->cmdResponse_out(opCode, cmdSeq, saved ? Fw::CmdResponse::OK : Fw::CmdResponse::EXECUTION_ERROR);
+  }
+
+  // ----------------------------------------------------------------------
+  // Table
+  // ----------------------------------------------------------------------
+
+  U32 FlashPrmDb ::
+    find(FwPrmIdType id) const
+  {
+    for (U32 entry = 0; entry < PRMDB_NUM_DB_ENTRIES; entry++) {
+      if (m_entries[entry].used && (m_entries[entry].id == id)) {
+        return entry;
+      }
+    }
+    return NO_ENTRY;
+  }
+
+  U32 FlashPrmDb ::
+    store(FwPrmIdType id, const Fw::ParamBuffer& value)
+  {
+    U32 entry = this->find(id);
+    if (entry == NO_ENTRY) {
+      for (U32 candidate = 0; candidate < PRMDB_NUM_DB_ENTRIES; candidate++) {
+        if (not m_entries[candidate].used) {
+          entry = candidate;
+          m_entries[entry].used = true;
+          m_entries[entry].id = id;
+          m_entries[entry].set = false;
+          m_entries[entry].saved = false;
+          break;
+        }
+      }
+      if (entry == NO_ENTRY) {
+        return NO_ENTRY;
+      }
+    }
+    m_entries[entry].value = value;
+    return entry;
+  }
+
+  // ----------------------------------------------------------------------
+  // Log
+  // ----------------------------------------------------------------------
+
+  bool FlashPrmDb ::
+    readHeader(U32 sector, U32& sequence)
+  {
+    U8 header[HEADER_SIZE];
+    if (not m_store->read(sector * FlashPrmDbCfg::SECTOR_SIZE, header, sizeof(header))) {
+      return false;
+    }
+    Fw::ExternalSerializeBuffer serial(header, sizeof(header));
+    (void) serial.setBuffLen(sizeof(header));
+    U32 magic = 0;
+    U32 crc = 0;
+    (void) serial.deserialize(magic);
+    (void) serial.deserialize(sequence);
+    (void) serial.deserialize(crc);
+    return (magic == HEADER_MAGIC) &&
+           (crc == Framing::defaultCrc32Engine().compute(header, HEADER_SIZE - sizeof(crc)));
+  }
+
+  bool FlashPrmDb ::
+    writeHeader(U32 sector, U32 sequence)
+  {
+    U8 header[HEADER_SIZE];
+    Fw::ExternalSerializeBuffer serial(header, sizeof(header));
+    Fw::SerializeStatus status = serial.serialize(HEADER_MAGIC);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = serial.serialize(sequence);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = serial.serialize(Framing::defaultCrc32Engine().compute(header, serial.getBuffLength()));
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    return m_store->program(sector * FlashPrmDbCfg::SECTOR_SIZE, header, sizeof(header));
+  }
+
+  U32 FlashPrmDb ::
+    replay(U32 sector)
+  {
+    const U32 base = sector * FlashPrmDbCfg::SECTOR_SIZE;
+    U32 records = 0;
+    m_writeOffset = HEADER_SIZE;
+    while (m_writeOffset < FlashPrmDbCfg::SECTOR_SIZE) {
+      U8 record[MAX_RECORD_SIZE];
+      if (not m_store->read(base + m_writeOffset, record, 1)) {
+        this->flashFailed(base + m_writeOffset);
+        break;
+      }
+      if (record[0] == 0xFF) {
+        // Erased flash: the end of the log
+        break;
+      }
+
+      bool valid = (record[0] == RECORD_MARKER) && (m_writeOffset + RECORD_OVERHEAD <= FlashPrmDbCfg::SECTOR_SIZE) &&
+                   m_store->read(base + m_writeOffset + 1, &record[1], 1);
+      const U32 size = valid ? (RECORD_OVERHEAD + record[1]) : 0;
+      valid = valid && (record[1] <= FW_PARAM_BUFFER_MAX_SIZE) &&
+              (m_writeOffset + size <= FlashPrmDbCfg::SECTOR_SIZE) &&
+              m_store->read(base + m_writeOffset + 2, &record[2], size - 2);
+
+      U32 id = 0;
+      U32 crc = 0;
+      if (valid) {
+        Fw::ExternalSerializeBuffer idSerial(&record[2], sizeof(id));
+        (void) idSerial.setBuffLen(sizeof(id));
+        (void) idSerial.deserialize(id);
+        Fw::ExternalSerializeBuffer crcSerial(&record[size - sizeof(crc)], sizeof(crc));
+        (void) crcSerial.setBuffLen(sizeof(crc));
+        (void) crcSerial.deserialize(crc);
+        valid = (crc == Framing::defaultCrc32Engine().compute(&record[1], size - 1 - sizeof(crc)));
+      }
+      if (not valid) {
+        // A write interrupted by a reset. Nothing more can be appended here, so the next run call compacts the log.
+        this->log_WARNING_LO_LogCorrupt(base + m_writeOffset);
+        m_writeOffset = FlashPrmDbCfg::SECTOR_SIZE;
+        break;
+      }
+
+      Fw::ParamBuffer value;
+      const Fw::SerializeStatus status = value.setBuff(&record[RECORD_OVERHEAD - sizeof(crc)], record[1]);
+      FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+      const U32 entry = this->store(id, value);
+      if (entry == NO_ENTRY) {
+        this->log_WARNING_HI_PrmDbFull(id);
+      } else {
+        m_entries[entry].set = false;
+        this->recordSaved(entry, m_writeOffset, size);
+      }
+      m_writeOffset += size;
+      records++;
+    }
+    return records;
+  }
+
+  bool FlashPrmDb ::
+    append(U32 sector, U32& offset, U32 entry)
+  {
+    FW_ASSERT(entry < PRMDB_NUM_DB_ENTRIES, entry);
+    const Entry& current = m_entries[entry];
+    const U32 valueSize = current.value.getBuffLength();
+    const U32 size = RECORD_OVERHEAD + valueSize;
+    FW_ASSERT(offset + size <= FlashPrmDbCfg::SECTOR_SIZE, offset, size);
+
+    U8 record[MAX_RECORD_SIZE];
+    Fw::ExternalSerializeBuffer serial(record, sizeof(record));
+    Fw::SerializeStatus status = serial.serialize(RECORD_MARKER);
+    status = (status == Fw::FW_SERIALIZE_OK) ? serial.serialize(static_cast<U8>(valueSize)) : status;
+    status = (status == Fw::FW_SERIALIZE_OK) ? serial.serialize(static_cast<U32>(current.id)) : status;
+    status = (status == Fw::FW_SERIALIZE_OK) ? serial.serialize(current.value.getBuffAddr(), valueSize, true) : status;
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    // The CRC covers everything after the marker
+    status = serial.serialize(Framing::defaultCrc32Engine().compute(&record[1], serial.getBuffLength() - 1));
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    FW_ASSERT(serial.getBuffLength() == size, serial.getBuffLength(), size);
+
+    const U32 address = sector * FlashPrmDbCfg::SECTOR_SIZE + offset;
+    if (not m_store->program(address, record, size)) {
+      this->flashFailed(address);
+      return false;
+    }
+    offset += size;
+    m_recordsWritten++;
+    m_telemetryDirty = true;
+    return true;
+  }
+
+  void FlashPrmDb ::
+    recordSaved(U32 entry, U32 offset, U32 size)
+  {
+    Entry& current = m_entries[entry];
+    if (current.saved) {
+      m_liveBytes -= current.savedSize;
+    }
+    current.saved = true;
+    current.savedOffset = offset;
+    current.savedSize = size;
+    m_liveBytes += size;
+  }
+
+  bool FlashPrmDb ::
+    persist(U32 entry)
+  {
+    // A copied entry is already in the standby sector with its old value
+    const bool copied = ((m_compactState == COMPACT_COPY) && (entry < m_compactEntry)) ||
+                        (m_compactState == COMPACT_COMMIT);
+    const U32 size = RECORD_OVERHEAD + m_entries[entry].value.getBuffLength();
+
+    const U32 offset = m_writeOffset;
+    if (not this->append(m_activeSector, m_writeOffset, entry)) {
+      return false;
+    }
+    this->recordSaved(entry, offset, size);
+    m_entries[entry].set = false;
+    if (not copied) {
+      return true;
+    }
+    if (m_standbyOffset + size > FlashPrmDbCfg::SECTOR_SIZE) {
+      m_compactState = COMPACT_ERASE;
+      return true;
+    }
+    const U32 standbyOffset = m_standbyOffset;
+    if (not this->append(m_activeSector ^ 1, m_standbyOffset, entry)) {
+      return false;
+    }
+    m_entries[entry].standbyOffset = standbyOffset;
+    return true;
+  }
+
+  bool FlashPrmDb ::
+    saveSet()
+  {
+    for (U32 entry = 0; entry < PRMDB_NUM_DB_ENTRIES; entry++) {
+      if (not m_entries[entry].used || not m_entries[entry].set) {
+        continue;
+      }
+      const U32 size = RECORD_OVERHEAD + m_entries[entry].value.getBuffLength();
+      if (m_writeOffset + size > FlashPrmDbCfg::SECTOR_SIZE) {
+        // No room until a compaction, which leaves one record per parameter and so always room for another
+        if (m_compactState == COMPACT_IDLE) {
+          m_compactState = COMPACT_ERASE;
+        }
+        return false;
+      }
+      if (not this->persist(entry)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool FlashPrmDb ::
+    copyRecord(U32 entry)
+  {
+    Entry& current = m_entries[entry];
+    U8 record[MAX_RECORD_SIZE];
+    FW_ASSERT(current.savedSize <= sizeof(record), current.savedSize);
+    const U32 from = m_activeSector * FlashPrmDbCfg::SECTOR_SIZE + current.savedOffset;
+    if (not m_store->read(from, record, current.savedSize)) {
+      this->flashFailed(from);
+      return false;
+    }
+    const U32 to = (m_activeSector ^ 1) * FlashPrmDbCfg::SECTOR_SIZE + m_standbyOffset;
+    if (not m_store->program(to, record, current.savedSize)) {
+      this->flashFailed(to);
+      return false;
+    }
+    current.standbyOffset = m_standbyOffset;
+    m_standbyOffset += current.savedSize;
+    m_recordsWritten++;
+    m_telemetryDirty = true;
+    return true;
+  }
+
+  // ----------------------------------------------------------------------
+  // Compaction
+  // ----------------------------------------------------------------------
+
+  bool FlashPrmDb ::
+    compactionDue() const
+  {
+    const U32 garbage = m_writeOffset - FW_MIN(m_writeOffset, m_liveBytes);
+    return (garbage > 0) && ((garbage >= FlashPrmDbCfg::COMPACT_GARBAGE_BYTES) ||
+                             (m_writeOffset + FlashPrmDbCfg::COMPACT_FREE_BYTES > FlashPrmDbCfg::SECTOR_SIZE));
+  }
+
+  void FlashPrmDb ::
+    compactStep()
+  {
+    const U32 standby = m_activeSector ^ 1;
+    switch (m_compactState) {
+      case COMPACT_ERASE:
+        if (not m_store->erase(standby)) {
+          this->flashFailed(standby * FlashPrmDbCfg::SECTOR_SIZE);
+          return;
+        }
+        m_standbyOffset = HEADER_SIZE;
+        m_compactEntry = 0;
+        m_compactState = COMPACT_COPY;
+        break;
+      case COMPACT_COPY:
+        // The saved records are copied as they are, so values set and not yet saved stay unsaved
+        for (U32 copied = 0; (copied < FlashPrmDbCfg::COMPACT_ENTRIES_PER_RUN) &&
+                             (m_compactEntry < PRMDB_NUM_DB_ENTRIES); m_compactEntry++) {
+          if (m_entries[m_compactEntry].used && m_entries[m_compactEntry].saved) {
+            if (not this->copyRecord(m_compactEntry)) {
+              return;
+            }
+            copied++;
+          }
+        }
+        if (m_compactEntry == PRMDB_NUM_DB_ENTRIES) {
+          m_compactState = COMPACT_COMMIT;
+        }
+        break;
+      case COMPACT_COMMIT:
+        // The header goes last, so a reset before this point leaves the old sector in charge
+        if (not this->writeHeader(standby, m_sequence + 1)) {
+          this->flashFailed(standby * FlashPrmDbCfg::SECTOR_SIZE);
+          return;
+        }
+        m_activeSector = standby;
+        m_sequence++;
+        m_writeOffset = m_standbyOffset;
+        for (U32 entry = 0; entry < PRMDB_NUM_DB_ENTRIES; entry++) {
+          m_entries[entry].savedOffset = m_entries[entry].standbyOffset;
+        }
+        m_compactState = COMPACT_IDLE;
+        m_compactions++;
+        m_telemetryDirty = true;
+        this->log_ACTIVITY_LO_LogCompacted(m_sequence, m_writeOffset);
+        break;
+      default:
+        FW_ASSERT(0, m_compactState);
+        break;
+    }
+  }
+
+  void FlashPrmDb ::
+    flashFailed(U32 offset)
+  {
+    // Parameters keep working from the table; they are just not saved
+    this->log_WARNING_HI_FlashError(offset);
+    m_available = false;
+    m_compactState = COMPACT_IDLE;
+  }
+
+  void FlashPrmDb ::
+    updateTelemetry()
+  {
+    if (not m_telemetryDirty) {
+      return;
+    }
+    this->tlmWrite_RecordsWritten(m_recordsWritten);
+    this->tlmWrite_LogBytesUsed(m_writeOffset);
+    this->tlmWrite_Compactions(m_compactions);
+    m_telemetryDirty = false;
+  }
+
+}
@@ -0,0 +1,228 @@
+// ======================================================================
+// \title  FlashPrmDb.hpp
+// \brief  hpp file for FlashPrmDb component implementation class
+// ======================================================================
+
+#ifndef Components_FlashPrmDb_HPP
+#define Components_FlashPrmDb_HPP
+
+#include "Components/FlashPrmDb/FlashPrmDbComponentAc.hpp"
+#include <Components/FlashPrmDb/FlashStore.hpp>
+#include <config/FlashPrmDbCfg.hpp>
+#include <config/PrmDbImplCfg.hpp>
+
+namespace Components {
+
+  //! Parameter database that writes only what changed
+  //!
+  //! As with Svc::PrmDb, a set only changes the value in RAM. Svc::PrmDb then rewrites every parameter to a file on
+  //! PRM_SAVE_FILE; here PRM_SAVE appends one record to a log in flash for each parameter set since it was last
+  //! saved, so saving costs the size of what changed. The log lives in one of two sectors. Once enough records are
+  //! superseded, the latest record of each parameter is copied a few at a time from the run port into the other
+  //! sector, which then takes over. The log is therefore never much longer than one record per parameter plus
+  //! FlashPrmDbCfg::COMPACT_GARBAGE_BYTES, which bounds the replay at boot.
+  class FlashPrmDb :
+    public FlashPrmDbComponentBase
+  {
+
+    public:
+
+      //! First byte of every record; erased flash reads 0xFF and ends the log
+      static const U8 RECORD_MARKER = 0x5A;
+
+      //! Bytes of a record besides its value: marker, size, id and CRC
+      static const U32 RECORD_OVERHEAD = sizeof(U8) + sizeof(U8) + sizeof(U32) + sizeof(U32);
+
+      //! Bytes of the largest record
+      static const U32 MAX_RECORD_SIZE = RECORD_OVERHEAD + FW_PARAM_BUFFER_MAX_SIZE;
+
+      //! First word of a sector header
+      static const U32 HEADER_MAGIC = 0x50524D4C;
+
+      //! Bytes of a sector header: magic, sequence and CRC
+      static const U32 HEADER_SIZE = 3 * sizeof(U32);
+
+      // ----------------------------------------------------------------------
+      // Component construction and destruction
+      // ----------------------------------------------------------------------
+
+      //! Construct FlashPrmDb object
+      FlashPrmDb(
+          const char* const compName //!< The component name
+      );
+
+      //! Destroy FlashPrmDb object
+      ~FlashPrmDb();
+
+      //! Attach the flash holding the log
+      void configure(
+          FlashStore& store //!< Flash region; must outlive the component
+      );
+
+      //! Replay the log into the table; call before components load their parameters
+      void load();
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Handler implementations for user-defined typed input ports
+      // ----------------------------------------------------------------------
+
+      //! Handler implementation for getPrm
+      Fw::ParamValid getPrm_handler(
+          FwIndexType portNum, //!< The port number
+          FwPrmIdType id, //!< Parameter ID
+          Fw::ParamBuffer& val //!< Buffer containing serialized parameter value
+      ) override;
+
+      //! Handler implementation for setPrm
+      void setPrm_handler(
+          FwIndexType portNum, //!< The port number
+          FwPrmIdType id, //!< Parameter ID
+          Fw::ParamBuffer& val //!< Buffer containing serialized parameter value
+      ) override;
+
+      //! Handler implementation for run
+      void run_handler(
+          FwIndexType portNum, //!< The port number
+          NATIVE_UINT_TYPE context //!< The call order
+      ) override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Handler implementations for commands
+      // ----------------------------------------------------------------------
+
+      //! Handler implementation for command PRM_COMPACT
+      void PRM_COMPACT_cmdHandler(
+          FwOpcodeType opCode, //!< The opcode
+          U32 cmdSeq //!< The command sequence number
+      ) override;
+
+      //! Handler implementation for command PRM_SAVE
+      void PRM_SAVE_cmdHandler(
+          FwOpcodeType opCode, //!< The opcode
+          U32 cmdSeq //!< The command sequence number
+      ) override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Helpers
+      // ----------------------------------------------------------------------
+
+      //! Marker for a parameter not in the table
+      static const U32 NO_ENTRY = PRMDB_NUM_DB_ENTRIES;
+
+      //! Find the table entry for a parameter
+      //!
+      //! \return the entry, or NO_ENTRY
+      U32 find(FwPrmIdType id) const;
+
+      //! Store a value in the table, taking a free entry for a new parameter
+      //!
+      //! \return the entry, or NO_ENTRY if the table is full
+      U32 store(FwPrmIdType id, const Fw::ParamBuffer& value);
+
+      //! Read and check the header of a sector
+      //!
+      //! \return true if the header is valid
+      bool readHeader(U32 sector, U32& sequence);
+
+      //! Write the header that makes a sector valid
+      bool writeHeader(U32 sector, U32 sequence);
+
+      //! Replay the records of a sector into the table
+      //!
+      //! \return records replayed
+      U32 replay(U32 sector);
+
+      //! Append a table entry to a sector
+      bool append(U32 sector, U32& offset, U32 entry);
+
+      //! Note the latest record of a parameter in the active sector
+      void recordSaved(U32 entry, U32 offset, U32 size);
+
+      //! Append a set entry to the log, and to the compacted copy if it was already copied
+      //!
+      //! \return false if the flash failed
+      bool persist(U32 entry);
+
+      //! Append every set entry that fits in the active sector, and start a compaction if one does not
+      //!
+      //! \return true once none is left; false if one waits for the compaction or the flash failed
+      bool saveSet();
+
+      //! Copy the latest record of a parameter from the active sector into the standby sector
+      bool copyRecord(U32 entry);
+
+      //! Whether superseded records warrant a compaction
+      bool compactionDue() const;
+
+      //! Advance compaction by one step
+      void compactStep();
+
+      //! Stop using the flash after it fails
+      void flashFailed(U32 offset);
+
+      //! Publish counters that changed since the last update
+      void updateTelemetry();
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Member variables
+      // ----------------------------------------------------------------------
+
+      static_assert(FW_PARAM_BUFFER_MAX_SIZE <= 0xFF, "Parameter size must fit the U8 record size field");
+      static_assert(HEADER_SIZE + PRMDB_NUM_DB_ENTRIES * MAX_RECORD_SIZE <= FlashPrmDbCfg::SECTOR_SIZE,
+                    "A compacted log must fit in one sector");
+      static_assert(FlashPrmDbCfg::SECTOR_COUNT == 2, "Compaction alternates between two sectors");
+      static_assert(FlashPrmDbCfg::COMPACT_FREE_BYTES >= MAX_RECORD_SIZE,
+                    "Compaction must start while another record still fits");
+
+      //! Compaction progress
+      enum CompactState {
+        COMPACT_IDLE, //!< Not compacting
+        COMPACT_ERASE, //!< Erase the standby sector next
+        COMPACT_COPY, //!< Copying entries into the standby sector
+        COMPACT_COMMIT //!< Write the standby header next
+      };
+
+      //! Parameter value
+      struct Entry {
+        bool used; //!< Whether the entry is in use
+        FwPrmIdType id; //!< Parameter ID
+        Fw::ParamBuffer value; //!< Serialized value, as last set
+        bool set; //!< Whether the value was set since it was last saved
+        bool saved; //!< Whether the active sector holds a record of the parameter
+        U32 savedOffset; //!< Offset of its latest record in the active sector
+        U32 savedSize; //!< Bytes of that record
+        U32 standbyOffset; //!< Offset of its record in the standby sector, once compaction has copied it
+      };
+      Entry m_entries[PRMDB_NUM_DB_ENTRIES]; //!< Current values
+
+      FlashStore* m_store; //!< Flash holding the log
+      bool m_available; //!< Whether the flash is in use
+      U32 m_activeSector; //!< Sector the log is appended to
+      U32 m_sequence; //!< Sequence number of the active sector
+      U32 m_writeOffset; //!< Bytes used in the active sector
+      U32 m_liveBytes; //!< Bytes a compacted copy of the log takes: the header and each parameter's latest record
+
+      CompactState m_compactState; //!< Compaction progress
+      U32 m_compactEntry; //!< Next entry to copy
+      U32 m_standbyOffset; //!< Bytes used in the standby sector
+
+      bool m_savePending; //!< Whether a PRM_SAVE waits for a compaction to make room
+      FwOpcodeType m_saveOpCode; //!< Opcode of the waiting PRM_SAVE
+      U32 m_saveCmdSeq; //!< Sequence number of the waiting PRM_SAVE
+
+      U32 m_recordsWritten; //!< Records appended
+      U32 m_compactions; //!< Compactions completed
+      bool m_telemetryDirty; //!< Counters changed since last published
+  };
+
+}
+
+#endif
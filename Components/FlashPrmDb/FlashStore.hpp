@@ -0,0 +1,63 @@
+// ======================================================================
+// \title  FlashStore.hpp
+// \brief  Flash region holding the parameter log
+// ======================================================================
+
+#ifndef Components_FlashStore_HPP
+#define Components_FlashStore_HPP
+
+#include <FpConfig.hpp>
+#include <config/FlashPrmDbCfg.hpp>
+
+namespace Components {
+
+  //! A region of FlashPrmDbCfg::SECTOR_COUNT sectors with NOR flash semantics
+  //!
+  //! Erasing sets a sector to 0xFF and programming can only clear bits, so bytes that are still 0xFF can be programmed
+  //! later without an erase. Offsets are relative to the start of the region. On RP2040 the region is in the program
+  //! flash; elsewhere it is a file that behaves the same way, so the log can be exercised on a host.
+  class FlashStore {
+
+    public:
+
+      //! Bytes in the region
+      static const U32 SIZE = FlashPrmDbCfg::SECTOR_COUNT * FlashPrmDbCfg::SECTOR_SIZE;
+
+      FlashStore();
+
+      ~FlashStore();
+
+#ifndef ARDUINO
+      //! Open the file standing in for flash, creating it erased if it does not exist
+      //!
+      //! \return true if the file is ready
+      bool open(
+          const char* const path //!< Path to the file
+      );
+#endif
+
+      //! Read bytes from the region
+      //!
+      //! \return false if the region is unavailable
+      bool read(U32 offset, U8* data, U32 size);
+
+      //! Clear bits in the region; bytes being programmed should be erased or already hold the value
+      //!
+      //! \return false if the region is unavailable
+      bool program(U32 offset, const U8* data, U32 size);
+
+      //! Set a whole sector to 0xFF
+      //!
+      //! \return false if the region is unavailable
+      bool erase(U32 sector);
+
+    PRIVATE:
+
+#ifndef ARDUINO
+      int m_fd; //!< File standing in for flash
+#endif
+  };
+
+}
+
+#endif
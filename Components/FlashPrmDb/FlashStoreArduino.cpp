@@ -0,0 +1,128 @@
+// ======================================================================
+// \title  FlashStoreArduino.cpp
+// \brief  RP2040 program flash backend for FlashStore
+// ======================================================================
+
+#include <Components/FlashPrmDb/FlashStore.hpp>
+#include <Fw/Types/Assert.hpp>
+#include <FprimeArduino.hpp>
+#include <cstring>
+
+#ifdef ARDUINO_ARCH_RP2040
+#include <hardware/flash.h>
+
+// arduino-pico's linker script ends flash with the filesystem, sized by the board's Flash Size menu, and the EEPROM
+// emulation's sector after it. Without a filesystem _FS_start is _EEPROM_start.
+extern uint8_t _FS_start;
+extern uint8_t _EEPROM_start;
+// End of the program image, from the pico-sdk linker script
+extern char __flash_binary_end;
+
+namespace {
+  static_assert(Components::FlashPrmDbCfg::SECTOR_SIZE % FLASH_SECTOR_SIZE == 0,
+                "Log sectors must be whole flash sectors");
+
+  //! Offset of the region from the start of flash: the sectors just below the filesystem, so it is in neither the
+  //! filesystem nor the EEPROM sector, whatever size the board gives the filesystem
+  U32 regionOffset() {
+    const uintptr_t fsStart = reinterpret_cast<uintptr_t>(&_FS_start);
+    const uintptr_t region = fsStart - Components::FlashStore::SIZE;
+    FW_ASSERT(fsStart <= reinterpret_cast<uintptr_t>(&_EEPROM_start), static_cast<FwAssertArgType>(fsStart));
+    // A program grown into the region would be erased by the first compaction
+    FW_ASSERT(reinterpret_cast<uintptr_t>(&__flash_binary_end) <= region, static_cast<FwAssertArgType>(region));
+    return static_cast<U32>(region - XIP_BASE);
+  }
+}
+#endif
+
+namespace Components {
+
+  FlashStore ::
+    FlashStore()
+  {
+
+  }
+
+  FlashStore ::
+    ~FlashStore()
+  {
+
+  }
+
+#ifdef ARDUINO_ARCH_RP2040
+
+  bool FlashStore ::
+    read(U32 offset, U8* data, U32 size)
+  {
+    FW_ASSERT(offset + size <= SIZE, offset, size);
+    // Flash is memory mapped through XIP
+    memcpy(data, reinterpret_cast<const U8*>(XIP_BASE + regionOffset() + offset), size);
+    return true;
+  }
+
+  bool FlashStore ::
+    program(U32 offset, const U8* data, U32 size)
+  {
+    FW_ASSERT(offset + size <= SIZE, offset, size);
+    const U32 region = regionOffset();
+    // The flash programs whole pages; 0xFF around the new bytes leaves the rest of the page as it was
+    U8 page[FLASH_PAGE_SIZE];
+    while (size > 0) {
+      const U32 pageStart = offset - (offset % FLASH_PAGE_SIZE);
+      const U32 within = offset - pageStart;
+      const U32 chunk = FW_MIN(size, static_cast<U32>(FLASH_PAGE_SIZE) - within);
+      memset(page, 0xFF, sizeof(page));
+      memcpy(page + within, data, chunk);
+
+      // XIP is unavailable while programming, so nothing may run from flash on either core
+      noInterrupts();
+      rp2040.idleOtherCore();
+      flash_range_program(region + pageStart, page, FLASH_PAGE_SIZE);
+      rp2040.resumeOtherCore();
+      interrupts();
+
+      offset += chunk;
+      data += chunk;
+      size -= chunk;
+    }
+    return true;
+  }
+
+  bool FlashStore ::
+    erase(U32 sector)
+  {
+    FW_ASSERT(sector < FlashPrmDbCfg::SECTOR_COUNT, sector);
+    const U32 region = regionOffset();
+    noInterrupts();
+    rp2040.idleOtherCore();
+    flash_range_erase(region + sector * FlashPrmDbCfg::SECTOR_SIZE, FlashPrmDbCfg::SECTOR_SIZE);
+    rp2040.resumeOtherCore();
+    interrupts();
+    return true;
+  }
+
+#else
+
+  // Other Arduino targets have no flash backend; the parameter database runs from defaults
+
+  bool FlashStore ::
+    read(U32 offset, U8* data, U32 size)
+  {
+    return false;
+  }
+
+  bool FlashStore ::
+    program(U32 offset, const U8* data, U32 size)
+  {
+    return false;
+  }
+
+  bool FlashStore ::
+    erase(U32 sector)
+  {
+    return false;
+  }
+
+#endif
+
+}
@@ -0,0 +1,94 @@
+// ======================================================================
+// \title  FlashStoreLinux.cpp
+// \brief  File-backed stand-in for FlashStore
+// ======================================================================
+
+#include <Components/FlashPrmDb/FlashStore.hpp>
+#include <Fw/Types/Assert.hpp>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Components {
+
+  FlashStore ::
+    FlashStore() :
+      m_fd(-1)
+  {
+
+  }
+
+  FlashStore ::
+    ~FlashStore()
+  {
+    if (m_fd >= 0) {
+      (void) ::close(m_fd);
+    }
+  }
+
+  bool FlashStore ::
+    open(const char* const path)
+  {
+    FW_ASSERT(path != nullptr);
+    m_fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    if (m_fd < 0) {
+      return false;
+    }
+    struct stat info;
+    if (::fstat(m_fd, &info) != 0) {
+      return false;
+    }
+    // A new or short file is erased flash
+    for (U32 sector = static_cast<U32>(info.st_size) / FlashPrmDbCfg::SECTOR_SIZE;
+         sector < FlashPrmDbCfg::SECTOR_COUNT; sector++) {
+      if (not this->erase(sector)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool FlashStore ::
+    read(U32 offset, U8* data, U32 size)
+  {
+    FW_ASSERT(offset + size <= SIZE, offset, size);
+    return (m_fd >= 0) && (::pread(m_fd, data, size, offset) == static_cast<ssize_t>(size));
+  }
+
+  bool FlashStore ::
+    program(U32 offset, const U8* data, U32 size)
+  {
+    FW_ASSERT(offset + size <= SIZE, offset, size);
+    U8 current[FlashPrmDbCfg::SECTOR_SIZE];
+    while (size > 0) {
+      const U32 chunk = FW_MIN(size, static_cast<U32>(sizeof(current)));
+      if (not this->read(offset, current, chunk)) {
+        return false;
+      }
+      // Programming only clears bits
+      for (U32 i = 0; i < chunk; i++) {
+        current[i] &= data[i];
+      }
+      if (::pwrite(m_fd, current, chunk, offset) != static_cast<ssize_t>(chunk)) {
+        return false;
+      }
+      offset += chunk;
+      data += chunk;
+      size -= chunk;
+    }
+    return true;
+  }
+
+  bool FlashStore ::
+    erase(U32 sector)
+  {
+    FW_ASSERT(sector < FlashPrmDbCfg::SECTOR_COUNT, sector);
+    U8 erased[FlashPrmDbCfg::SECTOR_SIZE];
+    memset(erased, 0xFF, sizeof(erased));
+    return (m_fd >= 0) &&
+           (::pwrite(m_fd, erased, sizeof(erased), sector * FlashPrmDbCfg::SECTOR_SIZE) ==
+            static_cast<ssize_t>(sizeof(erased)));
+  }
+
+}
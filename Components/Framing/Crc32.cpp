@@ -0,0 +1,202 @@
+// ======================================================================
+// \title  Crc32.cpp
+// \brief  Pluggable CRC-32 engines for F´ framing
+// ======================================================================
+
+#include "Components/Framing/Crc32.hpp"
+#include <Fw/Types/Assert.hpp>
+
+#if defined(ARDUINO_ARCH_RP2040)
+#include <hardware/dma.h>
+#endif
+
+namespace Framing {
+
+  namespace {
+    const U32 POLYNOMIAL = 0xEDB88320;
+
+    void buildTable(U32* table) {
+      for (U32 i = 0; i < 256; i++) {
+        U32 crc = i;
+        for (U32 bit = 0; bit < 8; bit++) {
+          crc = (crc & 1) ? ((crc >> 1) ^ POLYNOMIAL) : (crc >> 1);
+        }
+        table[i] = crc;
+      }
+    }
+
+    //! Extend table[0] into table[1..slices-1], where table[k][i] is the CRC of byte i followed by k zero bytes
+    void buildSlices(U32 (*table)[256], const U32 slices) {
+      buildTable(table[0]);
+      for (U32 i = 0; i < 256; i++) {
+        for (U32 k = 1; k < slices; k++) {
+          table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF];
+        }
+      }
+    }
+
+    //! Little-endian load without alignment requirements; compilers fuse this into a single load where allowed
+    inline U32 load32(const U8* data) {
+      return static_cast<U32>(data[0]) | (static_cast<U32>(data[1]) << 8) | (static_cast<U32>(data[2]) << 16) |
+             (static_cast<U32>(data[3]) << 24);
+    }
+
+    inline U32 bytewise(const U32* table, U32 crc, const U8* data, FwSizeType size) {
+      for (FwSizeType i = 0; i < size; i++) {
+        crc = (crc >> 8) ^ table[(crc ^ data[i]) & 0xFF];
+      }
+      return crc;
+    }
+  }
+
+  // ----------------------------------------------------------------------
+  // Bytewise
+  // ----------------------------------------------------------------------
+
+  BytewiseCrc32::BytewiseCrc32() {
+    buildTable(m_table);
+  }
+
+  U32 BytewiseCrc32::update(U32 crc, const U8* data, FwSizeType size) {
+    FW_ASSERT((data != nullptr) || (size == 0));
+    return bytewise(m_table, crc, data, size);
+  }
+
+  // ----------------------------------------------------------------------
+  // Slicing-by-4
+  // ----------------------------------------------------------------------
+
+  SliceBy4Crc32::SliceBy4Crc32() {
+    buildSlices(m_table, 4);
+  }
+
+  U32 SliceBy4Crc32::update(U32 crc, const U8* data, FwSizeType size) {
+    FW_ASSERT((data != nullptr) || (size == 0));
+    while (size >= 4) {
+      const U32 word = load32(data) ^ crc;
+      crc = m_table[3][word & 0xFF] ^ m_table[2][(word >> 8) & 0xFF] ^ m_table[1][(word >> 16) & 0xFF] ^
+            m_table[0][word >> 24];
+      data += 4;
+      size -= 4;
+    }
+    return bytewise(m_table[0], crc, data, size);
+  }
+
+  // ----------------------------------------------------------------------
+  // Slicing-by-8
+  // ----------------------------------------------------------------------
+
+  SliceBy8Crc32::SliceBy8Crc32() {
+    buildSlices(m_table, 8);
+  }
+
+  U32 SliceBy8Crc32::update(U32 crc, const U8* data, FwSizeType size) {
+    FW_ASSERT((data != nullptr) || (size == 0));
+    while (size >= 8) {
+      const U32 low = load32(data) ^ crc;
+      const U32 high = load32(data + 4);
+      crc = m_table[7][low & 0xFF] ^ m_table[6][(low >> 8) & 0xFF] ^ m_table[5][(low >> 16) & 0xFF] ^
+            m_table[4][low >> 24] ^ m_table[3][high & 0xFF] ^ m_table[2][(high >> 8) & 0xFF] ^
+            m_table[1][(high >> 16) & 0xFF] ^ m_table[0][high >> 24];
+      data += 8;
+      size -= 8;
+    }
+    return bytewise(m_table[0], crc, data, size);
+  }
+
+  // ----------------------------------------------------------------------
+  // RP2040 DMA sniffer
+  // ----------------------------------------------------------------------
+
+#if defined(ARDUINO_ARCH_RP2040)
+  namespace {
+    //! Bit reversal; the sniffer register holds the CRC in non-reflected bit order
+    U32 reverse32(U32 value) {
+      value = ((value >> 1) & 0x55555555) | ((value & 0x55555555) << 1);
+      value = ((value >> 2) & 0x33333333) | ((value & 0x33333333) << 2);
+      value = ((value >> 4) & 0x0F0F0F0F) | ((value & 0x0F0F0F0F) << 4);
+      value = ((value >> 8) & 0x00FF00FF) | ((value & 0x00FF00FF) << 8);
+      return (value >> 16) | (value << 16);
+    }
+
+    //! Sniffer calculation mode: CRC-32 over bit-reversed data, i.e. the reflected IEEE CRC
+    const uint SNIFF_MODE_CRC32_REVERSED = 0x1;
+
+    //! Write target for the sniffing transfer; the data itself is discarded
+    volatile U8 s_sink;
+  }
+
+  DmaSnifferCrc32::DmaSnifferCrc32(Crc32Engine& fallback) : m_fallback(fallback), m_channel(-1) {}
+
+  U32 DmaSnifferCrc32::update(U32 crc, const U8* data, FwSizeType size) {
+    FW_ASSERT((data != nullptr) || (size == 0));
+    if (size < MIN_DMA_SIZE) {
+      return m_fallback.update(crc, data, size);
+    }
+    if (m_channel < 0) {
+      m_channel = dma_claim_unused_channel(false);
+      if (m_channel < 0) {
+        return m_fallback.update(crc, data, size);
+      }
+    }
+    const uint channel = static_cast<uint>(m_channel);
+
+    dma_channel_config config = dma_channel_get_default_config(channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_sniff_enable(&config, true);
+
+    // The accumulator is loaded and read in the sniffer's bit order; output reversal converts on read only
+    dma_sniffer_enable(channel, SNIFF_MODE_CRC32_REVERSED, false);
+    dma_sniffer_set_output_reverse_enabled(true);
+    dma_sniffer_set_output_invert_enabled(false);
+    dma_sniffer_set_data_accumulator(reverse32(crc));
+
+    dma_channel_configure(channel, &config, &s_sink, data, size, true);
+    dma_channel_wait_for_finish_blocking(channel);
+
+    const U32 result = dma_sniffer_get_data_accumulator();
+    dma_sniffer_disable();
+    return result;
+  }
+#endif
+
+  // ----------------------------------------------------------------------
+  // Engine instances
+  // ----------------------------------------------------------------------
+
+  BytewiseCrc32& bytewiseCrc32() {
+    static BytewiseCrc32 engine;
+    return engine;
+  }
+
+  SliceBy4Crc32& sliceBy4Crc32() {
+    static SliceBy4Crc32 engine;
+    return engine;
+  }
+
+  SliceBy8Crc32& sliceBy8Crc32() {
+    static SliceBy8Crc32 engine;
+    return engine;
+  }
+
+  Crc32Engine& defaultCrc32Engine() {
+#if defined(ARDUINO_ARCH_RP2040)
+    static DmaSnifferCrc32 engine(softwareCrc32Engine());
+    return engine;
+#else
+    return softwareCrc32Engine();
+#endif
+  }
+
+  Crc32Engine& softwareCrc32Engine() {
+#if defined(ARDUINO)
+    // Slicing-by-4 keeps the tables small enough for RAM-limited parts
+    return sliceBy4Crc32();
+#else
+    return sliceBy8Crc32();
+#endif
+  }
+
+}
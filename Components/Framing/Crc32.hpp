@@ -0,0 +1,106 @@
+// ======================================================================
+// \title  Crc32.hpp
+// \brief  Pluggable CRC-32 engines for F´ framing
+//
+// All engines compute the same CRC-32 (IEEE 802.3, reflected, polynomial 0xEDB88320) as Utils::Hash, so frames stay
+// compatible with the stock framer/deframer and the GDS. They differ only in how many bytes they consume per step.
+// ======================================================================
+
+#ifndef Framing_Crc32_HPP
+#define Framing_Crc32_HPP
+
+#include <FpConfig.hpp>
+
+namespace Framing {
+
+  //! Interface to a CRC-32 implementation
+  //!
+  //! The running value passed between update() calls is the raw register, i.e. seeded with INITIAL and not yet
+  //! inverted. finalize() produces the value placed in a frame.
+  class Crc32Engine {
+    public:
+      //! Seed for a new computation
+      static const U32 INITIAL = 0xFFFFFFFF;
+
+      virtual ~Crc32Engine() {}
+
+      //! Continue a running CRC over size bytes of data
+      //!
+      //! \return the updated running CRC
+      virtual U32 update(
+          U32 crc, //!< Running CRC, INITIAL for the first span
+          const U8* data, //!< Data to checksum
+          FwSizeType size //!< Number of bytes
+      ) = 0;
+
+      //! Convert a running CRC into the transmitted checksum
+      static U32 finalize(U32 crc) { return ~crc; }
+
+      //! Checksum a contiguous buffer in one call
+      U32 compute(const U8* data, FwSizeType size) { return finalize(this->update(INITIAL, data, size)); }
+  };
+
+  //! Reference engine: one table lookup per byte, identical to the libcrc routine behind Utils::Hash
+  class BytewiseCrc32 : public Crc32Engine {
+    public:
+      BytewiseCrc32();
+      U32 update(U32 crc, const U8* data, FwSizeType size) override;
+
+    PRIVATE:
+      U32 m_table[256];
+  };
+
+  //! Slicing-by-4: four bytes per step using 4 KiB of tables
+  class SliceBy4Crc32 : public Crc32Engine {
+    public:
+      SliceBy4Crc32();
+      U32 update(U32 crc, const U8* data, FwSizeType size) override;
+
+    PRIVATE:
+      U32 m_table[4][256];
+  };
+
+  //! Slicing-by-8: eight bytes per step using 8 KiB of tables
+  class SliceBy8Crc32 : public Crc32Engine {
+    public:
+      SliceBy8Crc32();
+      U32 update(U32 crc, const U8* data, FwSizeType size) override;
+
+    PRIVATE:
+      U32 m_table[8][256];
+  };
+
+#if defined(ARDUINO_ARCH_RP2040)
+  //! RP2040 DMA sniffer offload: a DMA channel streams the data past the sniffer, which accumulates the CRC in
+  //! hardware. Short spans, where channel setup costs more than it saves, go to the fallback engine.
+  //!
+  //! The sniffer is a single hardware resource, so only one instance may exist, and it may only be used from one
+  //! core. Code on the other core takes softwareCrc32Engine().
+  class DmaSnifferCrc32 : public Crc32Engine {
+    public:
+      //! Spans shorter than this are computed by the fallback engine
+      static const FwSizeType MIN_DMA_SIZE = 64;
+
+      explicit DmaSnifferCrc32(Crc32Engine& fallback);
+      U32 update(U32 crc, const U8* data, FwSizeType size) override;
+
+    PRIVATE:
+      Crc32Engine& m_fallback;
+      I32 m_channel; //!< Claimed DMA channel, -1 until first use
+  };
+#endif
+
+  //! Fastest engine available on this target
+  Crc32Engine& defaultCrc32Engine();
+
+  //! Fastest engine that uses no hardware unit, so it can be used from any core at once
+  Crc32Engine& softwareCrc32Engine();
+
+  //! Engines by name, for selecting and comparing implementations
+  BytewiseCrc32& bytewiseCrc32();
+  SliceBy4Crc32& sliceBy4Crc32();
+  SliceBy8Crc32& sliceBy8Crc32();
+
+}
+
+#endif
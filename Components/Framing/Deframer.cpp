@@ -0,0 +1,281 @@
+// ======================================================================
+// \title  Deframer.cpp
+// \brief  cpp file for Deframer component implementation class
+// ======================================================================
+
+#include "Components/Framing/Deframer.hpp"
+#include "FpConfig.hpp"
+#include <Fw/Com/ComBuffer.hpp>
+#include <Fw/Com/ComPacket.hpp>
+#include <Fw/Logger/Logger.hpp>
+#include <Svc/GenericHub/GenericHubComponentImpl.hpp>
+#include <config/FppConstantsAc.hpp>
+
+namespace Framing {
+
+  // ----------------------------------------------------------------------
+  // Component construction and destruction
+  // ----------------------------------------------------------------------
+
+  Deframer ::
+    Deframer(const char* const compName) :
+      DeframerComponentBase(compName),
+      m_protocol(nullptr),
+      m_inRing(m_ringBuffer, sizeof(m_ringBuffer)),
+      m_framesDeframed(0),
+      m_resyncEvents(0),
+      m_bytesDiscarded(0),
+      m_checksumErrors(0),
+      m_hubComsRouted(0),
+      m_telemetryDirty(false)
+  {
+
+  }
+
+  Deframer ::
+    ~Deframer()
+  {
+
+  }
+
+  void Deframer ::
+    setup(FastFprimeDeframing& protocol)
+  {
+    FW_ASSERT(m_protocol == nullptr);
+    m_protocol = &protocol;
+    protocol.setup(*this);
+  }
+
+  // ----------------------------------------------------------------------
+  // Handler implementations for user-defined typed input ports
+  // ----------------------------------------------------------------------
+
+  void Deframer ::
+    framedIn_handler(
+        FwIndexType portNum,
+        Fw::Buffer& recvBuffer,
+        const Drv::RecvStatus& recvStatus
+    )
+  {
+    if (recvStatus.e == Drv::RecvStatus::RECV_OK) {
+      this->processBuffer(recvBuffer);
+    }
+    this->framedDeallocate_out(0, recvBuffer);
+    this->updateTelemetry();
+  }
+
+  void Deframer ::
+    cmdResponseIn_handler(
+        FwIndexType portNum,
+        FwOpcodeType opCode,
+        U32 cmdSeq,
+        const Fw::CmdResponse& response
+    )
+  {
+    // Nothing to do
+  }
+
+  // ----------------------------------------------------------------------
+  // Implementation of DeframingProtocolInterface
+  // ----------------------------------------------------------------------
+
+  Fw::Buffer Deframer ::
+    allocate(const U32 size)
+  {
+    // A Com call is decoded out of the packet before route returns, so the packet can live in a member buffer
+    if ((size <= sizeof(m_hubComPacket)) && this->isHubCom()) {
+      return Fw::Buffer(m_hubComPacket, size);
+    }
+    return this->bufferAllocate_out(0, size);
+  }
+
+  void Deframer ::
+    route(Fw::Buffer& packetBuffer)
+  {
+    FwPacketDescriptorType packetType = Fw::ComPacket::FW_PACKET_UNKNOWN;
+    Fw::SerializeStatus status = Fw::FW_SERIALIZE_OK;
+    {
+      Fw::SerializeBufferBase& serial = packetBuffer.getSerializeRepr();
+      status = serial.setBuffLen(packetBuffer.getSize());
+      FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+      status = serial.deserialize(packetType);
+    }
+
+    bool deallocate = true;
+    if (status == Fw::FW_SERIALIZE_OK) {
+      m_framesDeframed++;
+      m_telemetryDirty = true;
+      U8* const packetData = packetBuffer.getData();
+      const U32 packetSize = packetBuffer.getSize();
+      switch (packetType) {
+        case Fw::ComPacket::FW_PACKET_COMMAND: {
+          Fw::ComBuffer com;
+          status = com.setBuff(packetData, packetSize);
+          if (status == Fw::FW_SERIALIZE_OK) {
+            if (this->isConnected_comOut_OutputPort(0)) {
+              this->comOut_out(0, com, 0);
+            }
+          } else {
+            Fw::Logger::logMsg("[ERROR] Serializing com buffer failed with status %d\n", status);
+          }
+          break;
+        }
+        case Fw::ComPacket::FW_PACKET_FILE: {
+          if (this->routeHubCom(packetData + sizeof(packetType), packetSize - sizeof(packetType))) {
+            break;
+          }
+          if (this->isConnected_bufferOut_OutputPort(0)) {
+            // Receivers of file packets do not expect the packet type
+            packetBuffer.setData(packetData + sizeof(packetType));
+            packetBuffer.setSize(static_cast<U32>(packetSize - sizeof(packetType)));
+            this->bufferOut_out(0, packetBuffer);
+            deallocate = false;
+          }
+          break;
+        }
+        case CommandBatchPacketType: {
+          if (this->isConnected_batchOut_OutputPort(0)) {
+            packetBuffer.setData(packetData + sizeof(packetType));
+            packetBuffer.setSize(static_cast<U32>(packetSize - sizeof(packetType)));
+            this->batchOut_out(0, packetBuffer);
+            deallocate = false;
+          }
+          break;
+        }
+        default:
+          break;
+      }
+    } else {
+      Fw::Logger::logMsg("[ERROR] Deserializing packet type failed with status %d\n", status);
+    }
+
+    if (deallocate && (packetBuffer.getData() != m_hubComPacket)) {
+      this->bufferDeallocate_out(0, packetBuffer);
+    }
+  }
+
+  // ----------------------------------------------------------------------
+  // Helpers
+  // ----------------------------------------------------------------------
+
+  void Deframer ::
+    processBuffer(Fw::Buffer& buffer)
+  {
+    const U8* const data = buffer.getData();
+    const U32 size = buffer.getSize();
+    U32 offset = 0;
+    while (offset < size) {
+      // Deframing always leaves room for the frame it is waiting on, so the ring cannot stay full
+      const U32 chunk = FW_MIN(static_cast<U32>(m_inRing.get_free_size()), size - offset);
+      FW_ASSERT(chunk > 0);
+      const Fw::SerializeStatus status = m_inRing.serialize(data + offset, chunk);
+      FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+      offset += chunk;
+      this->processRing();
+    }
+  }
+
+  void Deframer ::
+    processRing()
+  {
+    FW_ASSERT(m_protocol != nullptr);
+    const U32 capacity = m_inRing.get_capacity();
+    // Every pass consumes at least one byte, so the ring capacity bounds the loop
+    for (U32 i = 0; i < capacity; i++) {
+      const U32 remaining = m_inRing.get_allocated_size();
+      if (remaining == 0) {
+        break;
+      }
+      U32 needed = 0;
+      const Svc::DeframingProtocol::DeframingStatus status = m_protocol->deframe(m_inRing, needed);
+      FW_ASSERT(m_inRing.get_allocated_size() == remaining, m_inRing.get_allocated_size(), remaining);
+
+      if (status == Svc::DeframingProtocol::DEFRAMING_STATUS_SUCCESS) {
+        m_inRing.rotate(needed);
+      } else if (status == Svc::DeframingProtocol::DEFRAMING_MORE_NEEDED) {
+        FW_ASSERT(needed > remaining, needed, remaining);
+        break;
+      } else {
+        if (status == Svc::DeframingProtocol::DEFRAMING_INVALID_CHECKSUM) {
+          m_checksumErrors++;
+        }
+        // Drop everything up to the next possible start word in one step
+        const U32 discard = m_protocol->resync(m_inRing);
+        FW_ASSERT((discard > 0) && (discard <= remaining), discard, remaining);
+        m_inRing.rotate(discard);
+        m_resyncEvents++;
+        m_bytesDiscarded += discard;
+        m_telemetryDirty = true;
+      }
+    }
+  }
+
+  bool Deframer ::
+    isHubCom()
+  {
+    // Deframing happens at the head of the ring, so the packet starts right after the frame header
+    U32 packetType = 0;
+    U32 hubType = 0;
+    U32 port = 0;
+    if ((m_inRing.peek(packetType, Svc::FpFrameHeader::SIZE) != Fw::FW_SERIALIZE_OK) ||
+        (m_inRing.peek(hubType, Svc::FpFrameHeader::SIZE + sizeof(U32)) != Fw::FW_SERIALIZE_OK) ||
+        (m_inRing.peek(port, Svc::FpFrameHeader::SIZE + 2 * sizeof(U32)) != Fw::FW_SERIALIZE_OK)) {
+      return false;
+    }
+    return (packetType == static_cast<U32>(Fw::ComPacket::FW_PACKET_FILE)) &&
+           (hubType == static_cast<U32>(Svc::GenericHubComponentImpl::HUB_TYPE_PORT)) &&
+           (port < static_cast<U32>(this->getNum_hubComOut_OutputPorts())) &&
+           this->isConnected_hubComOut_OutputPort(static_cast<FwIndexType>(port));
+  }
+
+  bool Deframer ::
+    routeHubCom(const U8* packet, U32 size)
+  {
+    Fw::ExternalSerializeBuffer serial(const_cast<U8*>(packet), size);
+    Fw::SerializeStatus status = serial.setBuffLen(size);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    U32 hubType = 0;
+    U32 port = 0;
+    FwBuffSizeType callSize = 0;
+    if ((serial.deserialize(hubType) != Fw::FW_SERIALIZE_OK) || (serial.deserialize(port) != Fw::FW_SERIALIZE_OK) ||
+        (hubType != static_cast<U32>(Svc::GenericHubComponentImpl::HUB_TYPE_PORT)) ||
+        (port >= static_cast<U32>(this->getNum_hubComOut_OutputPorts())) ||
+        not this->isConnected_hubComOut_OutputPort(static_cast<FwIndexType>(port))) {
+      return false;
+    }
+
+    // The serialized call is the Com buffer behind its size, then the context; anything else is dropped
+    FwBuffSizeType comSize = 0;
+    U32 context = 0;
+    if ((serial.deserialize(callSize) != Fw::FW_SERIALIZE_OK) || (callSize != serial.getBuffLeft()) ||
+        (serial.deserialize(comSize) != Fw::FW_SERIALIZE_OK) ||
+        (callSize != sizeof(FwBuffSizeType) + comSize + sizeof(U32)) || (comSize > FW_COM_BUFFER_MAX_SIZE)) {
+      return true;
+    }
+    const U8* const comData = packet + HUB_PORT_HEADER_SIZE + sizeof(FwBuffSizeType);
+    status = serial.deserializeSkip(comSize);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = serial.deserialize(context);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+
+    Fw::ComBuffer com(comData, comSize);
+    this->hubComOut_out(static_cast<FwIndexType>(port), com, context);
+    m_hubComsRouted++;
+    return true;
+  }
+
+  void Deframer ::
+    updateTelemetry()
+  {
+    if (not m_telemetryDirty) {
+      return;
+    }
+    this->tlmWrite_FramesDeframed(m_framesDeframed);
+    this->tlmWrite_ResyncEvents(m_resyncEvents);
+    this->tlmWrite_BytesDiscarded(m_bytesDiscarded);
+    this->tlmWrite_ChecksumErrors(m_checksumErrors);
+    this->tlmWrite_HubComsRouted(m_hubComsRouted);
+    m_telemetryDirty = false;
+  }
+
+}
@@ -0,0 +1,124 @@
+// ======================================================================
+// \title  Deframer.hpp
+// \brief  hpp file for Deframer component implementation class
+// ======================================================================
+
+#ifndef Framing_Deframer_HPP
+#define Framing_Deframer_HPP
+
+#include "Components/Framing/DeframerComponentAc.hpp"
+#include <Components/Framing/FastFprimeProtocol.hpp>
+#include <Components/Framing/HubComFramer.hpp>
+#include <Utils/Types/CircularBuffer.hpp>
+#include <config/DeframerCfg.hpp>
+
+namespace Framing {
+
+  //! Push-mode deframer. Unlike Svc::Deframer, which discards one byte per failed parse, it asks the protocol where
+  //! the next candidate frame starts and discards everything before it at once. GenericHub port packets for a
+  //! connected hubComOut port skip the hub: they are deframed into a member buffer instead of one from the
+  //! allocator, and decoded from there into the Com buffer handed on.
+  class Deframer :
+    public DeframerComponentBase,
+    public Svc::DeframingProtocolInterface
+  {
+
+    public:
+
+      // ----------------------------------------------------------------------
+      // Component construction and destruction
+      // ----------------------------------------------------------------------
+
+      //! Construct Deframer object
+      Deframer(
+          const char* const compName //!< The component name
+      );
+
+      //! Destroy Deframer object
+      ~Deframer();
+
+      //! Attach the deframing protocol
+      void setup(
+          FastFprimeDeframing& protocol //!< Protocol used to parse and resynchronize the stream
+      );
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Handler implementations for user-defined typed input ports
+      // ----------------------------------------------------------------------
+
+      //! Handler implementation for framedIn
+      void framedIn_handler(
+          FwIndexType portNum, //!< The port number
+          Fw::Buffer& recvBuffer, //!< Received data
+          const Drv::RecvStatus& recvStatus //!< Receive status
+      ) override;
+
+      //! Handler implementation for cmdResponseIn
+      void cmdResponseIn_handler(
+          FwIndexType portNum, //!< The port number
+          FwOpcodeType opCode, //!< Command Op Code
+          U32 cmdSeq, //!< Command Sequence
+          const Fw::CmdResponse& response //!< The command response argument
+      ) override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Implementation of DeframingProtocolInterface
+      // ----------------------------------------------------------------------
+
+      //! Allocate a buffer for a deframed packet
+      Fw::Buffer allocate(const U32 size) override;
+
+      //! Route a deframed packet by its packet type
+      void route(Fw::Buffer& packetBuffer) override;
+
+      // ----------------------------------------------------------------------
+      // Helpers
+      // ----------------------------------------------------------------------
+
+      //! Copy received data into the ring, deframing as space is needed
+      void processBuffer(Fw::Buffer& buffer);
+
+      //! Deframe everything currently in the ring
+      void processRing();
+
+      //! Whether the frame at the head of the ring is a GenericHub port packet for a connected hubComOut port
+      bool isHubCom();
+
+      //! Send a GenericHub port packet on hubComOut if it is for a connected port
+      //!
+      //! \return false if the packet is for some other hub port or channel, and was not handled
+      bool routeHubCom(
+          const U8* packet, //!< Hub packet, after its packet type
+          U32 size //!< Bytes of the hub packet
+      );
+
+      //! Publish counters that changed since the last update
+      void updateTelemetry();
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Member variables
+      // ----------------------------------------------------------------------
+
+      FastFprimeDeframing* m_protocol; //!< Attached protocol
+      U8 m_ringBuffer[Svc::DeframerCfg::RING_BUFFER_SIZE]; //!< Storage for the ring
+      Types::CircularBuffer m_inRing; //!< Received bytes not yet deframed
+      //! Packet being deframed when it is for hubComOut, so it needs no buffer from the allocator
+      U8 m_hubComPacket[sizeof(FwPacketDescriptorType) + HUB_PORT_HEADER_SIZE + HUB_COM_CALL_MAX_SIZE];
+
+      U32 m_framesDeframed; //!< Frames routed
+      U32 m_resyncEvents; //!< Resynchronization searches
+      U32 m_bytesDiscarded; //!< Bytes dropped while resynchronizing
+      U32 m_checksumErrors; //!< Frames dropped for a bad checksum
+      U32 m_hubComsRouted; //!< Com calls sent on hubComOut
+      bool m_telemetryDirty; //!< Counters changed since last published
+  };
+
+}
+
+#endif
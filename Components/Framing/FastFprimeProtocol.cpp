@@ -0,0 +1,185 @@
+// ======================================================================
+// \title  FastFprimeProtocol.cpp
+// \brief  F´ framing protocol with a pluggable checksum engine
+// ======================================================================
+
+#include <Components/Framing/FastFprimeProtocol.hpp>
+#include <Fw/Types/Assert.hpp>
+#include <Utils/Hash/Hash.hpp>
+
+namespace Framing {
+
+  static_assert(FRAME_CRC_SIZE == HASH_DIGEST_LENGTH, "Frame checksum must match the Utils::Hash digest");
+
+  namespace {
+    const U32 START_SIZE = sizeof(Svc::FpFrameHeader::TokenType);
+
+    //! Start word bytes in transmission (big-endian) order
+    const U8 START_BYTES[START_SIZE] = {
+        static_cast<U8>(Svc::FpFrameHeader::START_WORD >> 24), static_cast<U8>(Svc::FpFrameHeader::START_WORD >> 16),
+        static_cast<U8>(Svc::FpFrameHeader::START_WORD >> 8), static_cast<U8>(Svc::FpFrameHeader::START_WORD)};
+
+    //! Word with the first start byte in every lane, for the word-at-a-time search
+    const U32 FIRST_BYTE_LANES = 0x01010101U * START_BYTES[0];
+
+    //! Whether any byte of word equals the first start byte
+    inline bool hasFirstByte(const U32 word) {
+      const U32 x = word ^ FIRST_BYTE_LANES;
+      return ((x - 0x01010101U) & ~x & 0x80808080U) != 0;
+    }
+
+    inline U32 load32(const U8* data) {
+      return static_cast<U32>(data[0]) | (static_cast<U32>(data[1]) << 8) | (static_cast<U32>(data[2]) << 16) |
+             (static_cast<U32>(data[3]) << 24);
+    }
+  }
+
+  // ----------------------------------------------------------------------
+  // Framing
+  // ----------------------------------------------------------------------
+
+  FastFprimeFraming::FastFprimeFraming(Crc32Engine& crc) : Svc::FramingProtocol(), m_crc(crc) {}
+
+  void FastFprimeFraming::frame(const U8* const data, const U32 size, Fw::ComPacket::ComPacketType packet_type) {
+    FW_ASSERT(data != nullptr);
+    const Span span = {data, size};
+    this->frame(&span, 1, packet_type);
+  }
+
+  void FastFprimeFraming::frame(const Span* spans, const U32 count, Fw::ComPacket::ComPacketType packet_type) {
+    FW_ASSERT(spans != nullptr);
+    FW_ASSERT(m_interface != nullptr);
+    U32 size = 0;
+    for (U32 i = 0; i < count; i++) {
+      FW_ASSERT(spans[i].data != nullptr, i);
+      size += spans[i].size;
+    }
+    // Packet type is serialized as an I32 when supplied separately from the data
+    const Svc::FpFrameHeader::TokenType real_data_size =
+        size + ((packet_type != Fw::ComPacket::FW_PACKET_UNKNOWN) ? sizeof(I32) : 0);
+    const Svc::FpFrameHeader::TokenType total = real_data_size + Svc::FpFrameHeader::SIZE + FRAME_CRC_SIZE;
+    Fw::Buffer buffer = m_interface->allocate(total);
+    Fw::SerializeBufferBase& serializer = buffer.getSerializeRepr();
+
+    Fw::SerializeStatus status = serializer.serialize(Svc::FpFrameHeader::START_WORD);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = serializer.serialize(real_data_size);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    if (packet_type != Fw::ComPacket::FW_PACKET_UNKNOWN) {
+      status = serializer.serialize(static_cast<I32>(packet_type));
+      FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    }
+    for (U32 i = 0; i < count; i++) {
+      status = serializer.serialize(spans[i].data, spans[i].size, true);
+      FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    }
+
+    // The frame is contiguous here, so the engine runs over it in a single call
+    const U32 crc = m_crc.compute(buffer.getData(), total - FRAME_CRC_SIZE);
+    status = serializer.serialize(crc);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+
+    buffer.setSize(total);
+    m_interface->send(buffer);
+  }
+
+  // ----------------------------------------------------------------------
+  // Deframing
+  // ----------------------------------------------------------------------
+
+  FastFprimeDeframing::FastFprimeDeframing(Crc32Engine& crc) : Svc::DeframingProtocol(), m_crc(crc) {}
+
+  bool FastFprimeDeframing::validate(Types::CircularBuffer& ring, U32 size) {
+    // Peek the ring a chunk at a time instead of a byte at a time so the engine works on contiguous spans
+    U8 chunk[CRC_CHUNK_SIZE];
+    U32 crc = Crc32Engine::INITIAL;
+    for (U32 offset = 0; offset < size; offset += CRC_CHUNK_SIZE) {
+      const U32 length = FW_MIN(CRC_CHUNK_SIZE, size - offset);
+      if (ring.peek(chunk, length, offset) != Fw::FW_SERIALIZE_OK) {
+        return false;
+      }
+      crc = m_crc.update(crc, chunk, length);
+    }
+    U32 sent = 0;
+    if (ring.peek(sent, size) != Fw::FW_SERIALIZE_OK) {
+      return false;
+    }
+    return Crc32Engine::finalize(crc) == sent;
+  }
+
+  U32 FastFprimeDeframing::resync(Types::CircularBuffer& ring) {
+    const U32 allocated = ring.get_allocated_size();
+    // Each peek overlaps the previous one by START_SIZE - 1 bytes so a start word spanning two chunks is still seen
+    U8 chunk[SCAN_CHUNK_SIZE + START_SIZE - 1];
+    U32 offset = 1;
+    while (offset < allocated) {
+      const U32 length = FW_MIN(static_cast<U32>(sizeof(chunk)), allocated - offset);
+      const Fw::SerializeStatus status = ring.peek(chunk, length, offset);
+      FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+      const U32 searchable = FW_MIN(SCAN_CHUNK_SIZE, length);
+
+      U32 i = 0;
+      while (i < searchable) {
+        // Skip four bytes at a time while none of them can begin a start word
+        if (((i + sizeof(U32)) <= searchable) && not hasFirstByte(load32(&chunk[i]))) {
+          i += sizeof(U32);
+          continue;
+        }
+        if (chunk[i] == START_BYTES[0]) {
+          // Compare what is available; a partial match at the end of the data is kept for the next buffer
+          const U32 available = FW_MIN(START_SIZE, length - i);
+          U32 matched = 1;
+          while ((matched < available) && (chunk[i + matched] == START_BYTES[matched])) {
+            matched++;
+          }
+          if (matched == available) {
+            return offset + i;
+          }
+        }
+        i++;
+      }
+      offset += searchable;
+    }
+    return allocated;
+  }
+
+  Svc::DeframingProtocol::DeframingStatus FastFprimeDeframing::deframe(Types::CircularBuffer& ring, U32& needed) {
+    Svc::FpFrameHeader::TokenType start = 0;
+    Svc::FpFrameHeader::TokenType size = 0;
+    FW_ASSERT(m_interface != nullptr);
+    if (ring.get_allocated_size() < Svc::FpFrameHeader::SIZE) {
+      needed = Svc::FpFrameHeader::SIZE;
+      return DeframingProtocol::DEFRAMING_MORE_NEEDED;
+    }
+    Fw::SerializeStatus status = ring.peek(start, 0);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = ring.peek(size, sizeof(Svc::FpFrameHeader::TokenType));
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+
+    if (start != Svc::FpFrameHeader::START_WORD) {
+      needed = Svc::FpFrameHeader::SIZE;
+      return DeframingProtocol::DEFRAMING_INVALID_FORMAT;
+    }
+    // Reject sizes that cannot fit the ring before computing needed, which would otherwise overflow
+    if (size > (ring.get_capacity() - Svc::FpFrameHeader::SIZE - FRAME_CRC_SIZE)) {
+      needed = Svc::FpFrameHeader::SIZE;
+      return DeframingProtocol::DEFRAMING_INVALID_SIZE;
+    }
+    needed = Svc::FpFrameHeader::SIZE + size + FRAME_CRC_SIZE;
+    if (ring.get_allocated_size() < needed) {
+      return DeframingProtocol::DEFRAMING_MORE_NEEDED;
+    }
+    if (not this->validate(ring, needed - FRAME_CRC_SIZE)) {
+      return DeframingProtocol::DEFRAMING_INVALID_CHECKSUM;
+    }
+    Fw::Buffer buffer = m_interface->allocate(size);
+    // Some allocators return buffers larger than requested, which confuses routing
+    FW_ASSERT(buffer.getSize() >= size);
+    buffer.setSize(size);
+    status = ring.peek(buffer.getData(), size, Svc::FpFrameHeader::SIZE);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    m_interface->route(buffer);
+    return DeframingProtocol::DEFRAMING_STATUS_SUCCESS;
+  }
+
+}
@@ -0,0 +1,82 @@
+// ======================================================================
+// \title  FastFprimeProtocol.hpp
+// \brief  F´ framing protocol with a pluggable checksum engine
+//
+// Wire compatible with Svc::FprimeFraming/Svc::FprimeDeframing: start word, size, payload and a big-endian CRC-32.
+// ======================================================================
+
+#ifndef Framing_FastFprimeProtocol_HPP
+#define Framing_FastFprimeProtocol_HPP
+
+#include <Components/Framing/Crc32.hpp>
+#include <Svc/FramingProtocol/DeframingProtocol.hpp>
+#include <Svc/FramingProtocol/FprimeProtocol.hpp>
+#include <Svc/FramingProtocol/FramingProtocol.hpp>
+
+namespace Framing {
+
+  //! Size of the checksum trailing each frame
+  static const U32 FRAME_CRC_SIZE = sizeof(U32);
+
+  //! Framing half of the protocol
+  class FastFprimeFraming : public Svc::FramingProtocol {
+    public:
+      //! A piece of a payload gathered into one frame
+      struct Span {
+        const U8* data; //!< Bytes
+        U32 size; //!< Byte count
+      };
+
+      explicit FastFprimeFraming(Crc32Engine& crc = defaultCrc32Engine());
+
+      //! Frame data into a buffer from the framer's allocator and send it
+      void frame(
+          const U8* const data, //!< Payload
+          const U32 size, //!< Payload size
+          Fw::ComPacket::ComPacketType packet_type //!< Packet type, FW_PACKET_UNKNOWN if already in the data
+      ) override;
+
+      //! Frame a payload held in pieces, copying each piece once into the frame, and send it
+      void frame(
+          const Span* spans, //!< Pieces of the payload, in order
+          const U32 count, //!< Number of pieces
+          Fw::ComPacket::ComPacketType packet_type //!< Packet type, FW_PACKET_UNKNOWN if already in the data
+      );
+
+    PRIVATE:
+      Crc32Engine& m_crc;
+  };
+
+  //! Deframing half of the protocol
+  class FastFprimeDeframing : public Svc::DeframingProtocol {
+    public:
+      //! Bytes checksummed per peek out of the ring buffer
+      static const U32 CRC_CHUNK_SIZE = 128;
+
+      //! Bytes searched per peek out of the ring buffer while resynchronizing
+      static const U32 SCAN_CHUNK_SIZE = 64;
+
+      explicit FastFprimeDeframing(Crc32Engine& crc = defaultCrc32Engine());
+
+      //! Check the CRC of the first size bytes of the ring against the CRC that follows them
+      bool validate(Types::CircularBuffer& ring, U32 size);
+
+      //! Deframe one frame from the head of the ring
+      DeframingStatus deframe(Types::CircularBuffer& ring, U32& needed) override;
+
+      //! Find how many bytes to discard after a failed deframe so the ring starts at the next candidate frame
+      //!
+      //! The search starts one byte past the head and scans a word at a time for the first byte of the start word,
+      //! so spans without a candidate are skipped whole. A candidate cut off by the end of the data is kept until
+      //! more bytes arrive.
+      //!
+      //! \return number of bytes to discard, at least one and at most the allocated size of the ring
+      U32 resync(Types::CircularBuffer& ring);
+
+    PRIVATE:
+      Crc32Engine& m_crc;
+  };
+
+}
+
+#endif
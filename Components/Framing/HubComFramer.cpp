@@ -0,0 +1,93 @@
+// ======================================================================
+// \title  HubComFramer.cpp
+// \brief  cpp file for HubComFramer component implementation class
+// ======================================================================
+
+#include "Components/Framing/HubComFramer.hpp"
+#include "FpConfig.hpp"
+#include <Svc/GenericHub/GenericHubComponentImpl.hpp>
+
+namespace Framing {
+
+  // ----------------------------------------------------------------------
+  // Component construction and destruction
+  // ----------------------------------------------------------------------
+
+  HubComFramer ::
+    HubComFramer(const char* const compName) :
+      HubComFramerComponentBase(compName),
+      m_protocol(nullptr)
+  {
+
+  }
+
+  HubComFramer ::
+    ~HubComFramer()
+  {
+
+  }
+
+  void HubComFramer ::
+    setup(FastFprimeFraming& protocol)
+  {
+    FW_ASSERT(m_protocol == nullptr);
+    m_protocol = &protocol;
+    protocol.setup(*this);
+  }
+
+  // ----------------------------------------------------------------------
+  // Handler implementations for user-defined typed input ports
+  // ----------------------------------------------------------------------
+
+  void HubComFramer ::
+    comIn_handler(
+        FwIndexType portNum,
+        Fw::ComBuffer& data,
+        U32 context
+    )
+  {
+    FW_ASSERT(m_protocol != nullptr);
+    const FwBuffSizeType comSize = static_cast<FwBuffSizeType>(data.getBuffLength());
+
+    // Hub header and the Com buffer's size, as GenericHub and the serialized port call lay them out
+    U8 header[HUB_PORT_HEADER_SIZE + sizeof(FwBuffSizeType)];
+    Fw::ExternalSerializeBuffer headerSerializer(header, sizeof(header));
+    Fw::SerializeStatus status =
+        headerSerializer.serialize(static_cast<U32>(Svc::GenericHubComponentImpl::HUB_TYPE_PORT));
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = headerSerializer.serialize(static_cast<U32>(portNum));
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = headerSerializer.serialize(static_cast<FwBuffSizeType>(sizeof(FwBuffSizeType) + comSize + sizeof(U32)));
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = headerSerializer.serialize(comSize);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+
+    U8 trailer[sizeof(U32)];
+    Fw::ExternalSerializeBuffer trailerSerializer(trailer, sizeof(trailer));
+    status = trailerSerializer.serialize(context);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+
+    // The Com buffer is copied once, into the frame; hub traffic travels as file packets
+    const FastFprimeFraming::Span spans[] = {
+        {header, sizeof(header)}, {data.getBuffAddr(), comSize}, {trailer, sizeof(trailer)}};
+    m_protocol->frame(spans, FW_NUM_ARRAY_ELEMENTS(spans), Fw::ComPacket::FW_PACKET_FILE);
+  }
+
+  // ----------------------------------------------------------------------
+  // Implementation of FramingProtocolInterface
+  // ----------------------------------------------------------------------
+
+  Fw::Buffer HubComFramer ::
+    allocate(const U32 size)
+  {
+    return this->framedAllocate_out(0, size);
+  }
+
+  void HubComFramer ::
+    send(Fw::Buffer& outgoing)
+  {
+    // The driver owns the buffer whatever the status, as with Svc::Framer
+    (void) this->framedOut_out(0, outgoing);
+  }
+
+}
@@ -0,0 +1,84 @@
+// ======================================================================
+// \title  HubComFramer.hpp
+// \brief  hpp file for HubComFramer component implementation class
+// ======================================================================
+
+#ifndef Framing_HubComFramer_HPP
+#define Framing_HubComFramer_HPP
+
+#include "Components/Framing/HubComFramerComponentAc.hpp"
+#include <Components/Framing/FastFprimeProtocol.hpp>
+
+namespace Framing {
+
+  //! Bytes of a GenericHub port packet ahead of the serialized port call: hub type, port number and call size
+  static const U32 HUB_PORT_HEADER_SIZE = sizeof(U32) + sizeof(U32) + sizeof(FwBuffSizeType);
+
+  //! Largest serialized Fw.Com call: Com buffer size, Com buffer and context
+  static const U32 HUB_COM_CALL_MAX_SIZE = sizeof(FwBuffSizeType) + FW_COM_BUFFER_MAX_SIZE + sizeof(U32);
+
+  //! Frames Fw.Com calls as GenericHub port packets without going through the hub. Svc::GenericHub serializes the
+  //! call into a hub buffer and Svc::Framer copies that into a framed buffer; here the hub header, the Com buffer and
+  //! the context are written straight into the framed buffer. The frame is the one the hub and framer would send, so
+  //! either end of the link can use either path.
+  class HubComFramer :
+    public HubComFramerComponentBase,
+    public Svc::FramingProtocolInterface
+  {
+
+    public:
+
+      // ----------------------------------------------------------------------
+      // Component construction and destruction
+      // ----------------------------------------------------------------------
+
+      //! Construct HubComFramer object
+      HubComFramer(
+          const char* const compName //!< The component name
+      );
+
+      //! Destroy HubComFramer object
+      ~HubComFramer();
+
+      //! Attach the framing protocol
+      void setup(
+          FastFprimeFraming& protocol //!< Protocol used to frame the packets, not shared with another framer
+      );
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Handler implementations for user-defined typed input ports
+      // ----------------------------------------------------------------------
+
+      //! Handler implementation for comIn
+      void comIn_handler(
+          FwIndexType portNum, //!< The port number
+          Fw::ComBuffer& data, //!< Buffer containing packet data
+          U32 context //!< Call context value; meaning chosen by user
+      ) override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Implementation of FramingProtocolInterface
+      // ----------------------------------------------------------------------
+
+      //! Allocate a buffer for a frame
+      Fw::Buffer allocate(const U32 size) override;
+
+      //! Send a frame to the driver
+      void send(Fw::Buffer& outgoing) override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Member variables
+      // ----------------------------------------------------------------------
+
+      FastFprimeFraming* m_protocol; //!< Attached protocol
+  };
+
+}
+
+#endif
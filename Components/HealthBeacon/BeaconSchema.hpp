@@ -0,0 +1,143 @@
+// ======================================================================
+// \title  BeaconSchema.hpp
+// \brief  Compile-time layout of a bit-packed beacon: the fields, their widths and the code to pack and unpack them
+//
+// A schema is a list of field types. Every field has a fixed bit offset, worked out by the compiler from the widths
+// of the fields before it, so packing a beacon is a straight run of reads and shifts with no table to walk. The same
+// schema instantiated on the host unpacks it, so the flight packer and the ground decoder cannot disagree.
+// ======================================================================
+
+#ifndef Components_BeaconSchema_HPP
+#define Components_BeaconSchema_HPP
+
+#include <FpConfig.hpp>
+
+namespace Components {
+
+  namespace Beacon {
+
+    //! Whole number nearest a channel value; integer channels are taken as they are
+    template <typename T>
+    inline I64 whole(T value) { return static_cast<I64>(value); }
+
+    inline I64 whole(F32 value) { return static_cast<I64>((value < 0.0f) ? (value - 0.5f) : (value + 0.5f)); }
+
+    //! Set BITS bits of a zeroed buffer from OFFSET on, most significant bit first
+    template <U32 OFFSET, U32 BITS>
+    inline void putBits(U8* out, U32 value) {
+      for (U32 bit = 0; bit < BITS; bit++) {
+        if (((value >> (BITS - 1 - bit)) & 1) != 0) {
+          out[(OFFSET + bit) / 8] |= static_cast<U8>(0x80 >> ((OFFSET + bit) % 8));
+        }
+      }
+    }
+
+    //! Read BITS bits of a buffer from OFFSET on, most significant bit first
+    template <U32 OFFSET, U32 BITS>
+    inline U32 getBits(const U8* in) {
+      U32 value = 0;
+      for (U32 bit = 0; bit < BITS; bit++) {
+        value = (value << 1) | ((in[(OFFSET + bit) / 8] >> (7 - (OFFSET + bit) % 8)) & 1);
+      }
+      return value;
+    }
+
+    //! A counter channel, sent as its low BITS bits. It wraps, so the difference between two beacons is right as long
+    //! as the counter moves less than 2^BITS between them.
+    template <FwChanIdType ID, typename T, U32 BITS>
+    struct Counter {
+      static_assert((BITS >= 1) && (BITS <= 32), "a field takes 1 to 32 bits");
+      typedef T Type; //!< Type the channel is serialized as
+      static const FwChanIdType CHANNEL = ID; //!< Channel id
+      static const U32 WIDTH = BITS; //!< Bits of the value
+
+      static U32 encode(T value) { return static_cast<U32>(static_cast<U64>(whole(value)) & mask()); }
+      static I64 decode(U32 raw) { return raw; }
+      static U64 mask() { return (static_cast<U64>(1) << BITS) - 1; }
+    };
+
+    //! A gauge channel, sent as the number of STEPs it is above MIN in BITS bits. Values outside the range go as
+    //! its nearest end.
+    template <FwChanIdType ID, typename T, U32 BITS, I32 MIN, U32 STEP>
+    struct Gauge {
+      static_assert((BITS >= 1) && (BITS <= 32), "a field takes 1 to 32 bits");
+      static_assert(STEP > 0, "a gauge needs a step");
+      typedef T Type; //!< Type the channel is serialized as
+      static const FwChanIdType CHANNEL = ID; //!< Channel id
+      static const U32 WIDTH = BITS; //!< Bits of the value
+
+      static U32 encode(T value) {
+        const I64 steps = (whole(value) - MIN) / static_cast<I64>(STEP);
+        if (steps < 0) {
+          return 0;
+        }
+        return static_cast<U32>(FW_MIN(static_cast<U64>(steps), mask()));
+      }
+      static I64 decode(U32 raw) { return static_cast<I64>(raw) * STEP + MIN; }
+      static U64 mask() { return (static_cast<U64>(1) << BITS) - 1; }
+    };
+
+    //! The fields of a beacon, in the order they are packed. Each takes a presence bit, set if its channel had a
+    //! value, then its value bits, which are zero when it had none.
+    //!
+    //! A field type gives the channel id and serialized type, its width, encode() and decode(), and a name() for the
+    //! decoder. pack() reads each channel through source.read(id, value), which returns false if the channel has no
+    //! value. unpack() hands each field to sink.field(name, present, value).
+    template <typename... Fields>
+    struct Schema;
+
+    template <>
+    struct Schema<> {
+      static const U32 BITS = 0; //!< Bits of every field
+      static const U32 FIELDS = 0; //!< Number of fields
+      static const U32 HASH = 0x811C9DC5; //!< Hash of the layout
+
+      template <U32 OFFSET, typename Source>
+      static void packAt(Source&, U8*) {}
+
+      template <U32 OFFSET, typename Sink>
+      static void unpackAt(const U8*, Sink&) {}
+    };
+
+    template <typename Field, typename... Rest>
+    struct Schema<Field, Rest...> {
+      static const U32 BITS = 1 + Field::WIDTH + Schema<Rest...>::BITS;
+      static const U32 FIELDS = 1 + Schema<Rest...>::FIELDS;
+      //! Folds each field's channel and width into the hash of the ones after it, so a change to either gives a
+      //! different layout id
+      static const U32 HASH = ((Schema<Rest...>::HASH ^ Field::CHANNEL) * 0x01000193u ^ Field::WIDTH) * 0x01000193u;
+
+      //! Bytes the fields take, the last one padded with zeros
+      static const U32 BYTES = (BITS + 7) / 8;
+
+      //! Pack every field into out, which must be BYTES of zeros
+      template <typename Source>
+      static void pack(Source& source, U8* out) { packAt<0>(source, out); }
+
+      //! Unpack every field of in, BYTES long
+      template <typename Sink>
+      static void unpack(const U8* in, Sink& sink) { unpackAt<0>(in, sink); }
+
+      template <U32 OFFSET, typename Source>
+      static void packAt(Source& source, U8* out) {
+        typename Field::Type value = typename Field::Type();
+        if (source.read(Field::CHANNEL, value)) {
+          putBits<OFFSET, 1>(out, 1);
+          putBits<OFFSET + 1, Field::WIDTH>(out, Field::encode(value));
+        }
+        Schema<Rest...>::template packAt<OFFSET + 1 + Field::WIDTH>(source, out);
+      }
+
+      template <U32 OFFSET, typename Sink>
+      static void unpackAt(const U8* in, Sink& sink) {
+        const bool present = (getBits<OFFSET, 1>(in) != 0);
+        sink.field(Field::name(), present, Field::decode(getBits<OFFSET + 1, Field::WIDTH>(in)));
+        Schema<Rest...>::template unpackAt<OFFSET + 1 + Field::WIDTH>(in, sink);
+      }
+    };
+
+  }
+
+}
+
+#endif
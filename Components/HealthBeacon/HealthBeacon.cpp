@@ -0,0 +1,104 @@
+// ======================================================================
+// \title  HealthBeacon.cpp
+// \brief  cpp file for HealthBeacon component implementation class
+// ======================================================================
+
+#include "Components/HealthBeacon/HealthBeacon.hpp"
+#include "FpConfig.hpp"
+#include <cstring>
+
+namespace Components {
+
+  // ----------------------------------------------------------------------
+  // Component construction and destruction
+  // ----------------------------------------------------------------------
+
+  HealthBeacon ::
+    HealthBeacon(const char* const compName) :
+      HealthBeaconComponentBase(compName),
+      m_ticks(0),
+      m_sendNow(false),
+      m_sequence(0),
+      m_sent(0),
+      m_skipped(0)
+  {
+
+  }
+
+  HealthBeacon ::
+    ~HealthBeacon()
+  {
+
+  }
+
+  // ----------------------------------------------------------------------
+  // Handler implementations for user-defined typed input ports
+  // ----------------------------------------------------------------------
+
+  void HealthBeacon ::
+    run_handler(
+        FwIndexType portNum,
+        U32 context
+    )
+  {
+    Fw::ParamValid valid;
+    const U32 periodTicks = static_cast<U32>(this->paramGet_PERIOD(valid)) * HealthBeaconCfg::TICKS_PER_SECOND;
+    m_ticks++;
+    if (m_sendNow || ((periodTicks > 0) && (m_ticks >= periodTicks))) {
+      m_sendNow = false;
+      m_ticks = 0;
+      this->sendBeacon();
+    }
+  }
+
+  // ----------------------------------------------------------------------
+  // Handler implementations for commands
+  // ----------------------------------------------------------------------
+
+  void HealthBeacon ::
+    BEACON_NOW_cmdHandler(
+        FwOpcodeType opCode,
+        U32 cmdSeq
+    )
+  {
+    // Sent from run, so the radio is only ever handed beacons on the rate group's thread
+    m_sendNow = true;
+    this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::OK);
+  }
+
+  // ----------------------------------------------------------------------
+  // Helpers
+  // ----------------------------------------------------------------------
+
+  void HealthBeacon ::
+    sendBeacon()
+  {
+    Fw::Buffer buffer = this->allocate_out(0, HEALTH_BEACON_SIZE);
+    if ((buffer.getData() == nullptr) || (buffer.getSize() < HEALTH_BEACON_SIZE)) {
+      m_skipped++;
+      this->tlmWrite_BeaconsSkipped(m_skipped);
+      return;
+    }
+
+    U8* const beacon = buffer.getData();
+    memset(beacon, 0, HEALTH_BEACON_SIZE);
+    const U32 seconds = this->getTime().getSeconds();
+    beacon[0] = HealthBeaconCfg::BEACON_MARKER;
+    beacon[1] = static_cast<U8>(HEALTH_BEACON_LAYOUT >> 8);
+    beacon[2] = static_cast<U8>(HEALTH_BEACON_LAYOUT);
+    beacon[3] = m_sequence++;
+    beacon[4] = static_cast<U8>(seconds >> 24);
+    beacon[5] = static_cast<U8>(seconds >> 16);
+    beacon[6] = static_cast<U8>(seconds >> 8);
+    beacon[7] = static_cast<U8>(seconds);
+    ChannelSource source(*this);
+    HealthBeaconSchema::pack(source, &beacon[HEALTH_BEACON_HEADER_SIZE]);
+    buffer.setSize(HEALTH_BEACON_SIZE);
+
+    // The radio owns the buffer whatever the status
+    (void) this->beaconOut_out(0, buffer);
+    m_sent++;
+    this->tlmWrite_BeaconsSent(m_sent);
+  }
+
+}
@@ -0,0 +1,106 @@
+// ======================================================================
+// \title  HealthBeacon.hpp
+// \brief  hpp file for HealthBeacon component implementation class
+// ======================================================================
+
+#ifndef Components_HealthBeacon_HPP
+#define Components_HealthBeacon_HPP
+
+#include "Components/HealthBeacon/HealthBeaconComponentAc.hpp"
+#include <Components/HealthBeacon/HealthBeaconSchema.hpp>
+
+namespace Components {
+
+  //! Sends node health as one small radio packet that needs no F Prime ground system to read
+  //!
+  //! Every PERIOD seconds of run calls the beacon reads the latest value of each channel in HealthBeaconSchema from
+  //! the telemetry channelizer, packs them at the bit offsets the schema fixes, and sends the packet to the radio
+  //! unframed, so it goes out as it is. A channel not written yet is sent as absent.
+  class HealthBeacon :
+    public HealthBeaconComponentBase
+  {
+
+    public:
+
+      // ----------------------------------------------------------------------
+      // Component construction and destruction
+      // ----------------------------------------------------------------------
+
+      //! Construct HealthBeacon object
+      HealthBeacon(
+          const char* const compName //!< The component name
+      );
+
+      //! Destroy HealthBeacon object
+      ~HealthBeacon();
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Handler implementations for user-defined typed input ports
+      // ----------------------------------------------------------------------
+
+      //! Handler implementation for run
+      void run_handler(
+          FwIndexType portNum, //!< The port number
+          U32 context //!< The call order
+      ) override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Handler implementations for commands
+      // ----------------------------------------------------------------------
+
+      //! Handler implementation for command BEACON_NOW
+      void BEACON_NOW_cmdHandler(
+          FwOpcodeType opCode, //!< The opcode
+          U32 cmdSeq //!< The command sequence number
+      ) override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Helpers
+      // ----------------------------------------------------------------------
+
+      //! Reads the channels of the schema through tlmGet
+      class ChannelSource {
+        public:
+          explicit ChannelSource(HealthBeacon& beacon) : m_beacon(beacon) {}
+
+          //! Latest value of a channel
+          //!
+          //! \return false if the channel has no value
+          template <typename T>
+          bool read(FwChanIdType id, T& value) {
+            Fw::Time time;
+            Fw::TlmBuffer buffer;
+            m_beacon.tlmGet_out(0, id, time, buffer);
+            // The channelizer leaves the buffer empty for a channel it has no value of
+            return (buffer.getBuffLength() > 0) && (buffer.deserialize(value) == Fw::FW_SERIALIZE_OK);
+          }
+
+        private:
+          HealthBeacon& m_beacon; //!< The beacon
+      };
+
+      //! Pack and send a beacon
+      void sendBeacon();
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Member variables
+      // ----------------------------------------------------------------------
+
+      U32 m_ticks; //!< Run calls since the last beacon
+      bool m_sendNow; //!< Whether BEACON_NOW asked for a beacon
+      U8 m_sequence; //!< Sequence number of the next beacon
+      U32 m_sent; //!< Beacons sent
+      U32 m_skipped; //!< Beacons skipped for want of a buffer
+  };
+
+}
+
+#endif
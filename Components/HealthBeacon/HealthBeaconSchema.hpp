@@ -0,0 +1,101 @@
+// ======================================================================
+// \title  HealthBeaconSchema.hpp
+// \brief  Channels in the health beacon and how each is packed
+//
+// Channel ids are the instance base ids in HealthBeaconCfg plus the channel's offset, from the order of channels in
+// the component's FPP, or its explicit id. The deployment's topology checks both against the generated ids, so
+// reordering those channels or moving the instances fails the build until they are updated here. A field added,
+// removed or resized changes HealthBeaconSchema::HASH, and so the layout id in every beacon.
+// ======================================================================
+
+#ifndef Components_HealthBeaconSchema_HPP
+#define Components_HealthBeaconSchema_HPP
+
+#include <Components/HealthBeacon/BeaconSchema.hpp>
+#include <config/HealthBeaconCfg.hpp>
+
+namespace Components {
+
+  namespace HealthBeaconFields {
+
+    //! RFM69 Status: 1 when the radio is up
+    struct RadioStatus : Beacon::Gauge<HealthBeaconCfg::RADIO_ID_BASE + 0, I32, 1, 0, 1> {
+      static const char* name() { return "radio_status"; }
+    };
+
+    //! RFM69 NumPacketsSent
+    struct PacketsSent : Beacon::Counter<HealthBeaconCfg::RADIO_ID_BASE + 1, U32, 16> {
+      static const char* name() { return "packets_sent"; }
+    };
+
+    //! RFM69 NumPacketsReceived
+    struct PacketsReceived : Beacon::Counter<HealthBeaconCfg::RADIO_ID_BASE + 2, U32, 16> {
+      static const char* name() { return "packets_received"; }
+    };
+
+    //! RFM69 PacketsLost
+    struct PacketsLost : Beacon::Counter<HealthBeaconCfg::RADIO_ID_BASE + 4, U32, 12> {
+      static const char* name() { return "packets_lost"; }
+    };
+
+    //! RFM69 AirtimeUtilization, per thousand
+    struct Airtime : Beacon::Gauge<HealthBeaconCfg::RADIO_ID_BASE + 7, U16, 10, 0, 1> {
+      static const char* name() { return "airtime_permille"; }
+    };
+
+    //! RFM69 RSSI, from -127 to 0 dBm
+    struct Rssi : Beacon::Gauge<HealthBeaconCfg::RADIO_ID_BASE + 12, I16, 7, -127, 1> {
+      static const char* name() { return "rssi_dbm"; }
+    };
+
+    //! SystemResources CPU, in percent
+    struct Cpu : Beacon::Gauge<HealthBeaconCfg::SYSTEM_RESOURCES_ID_BASE + 4, F32, 7, 0, 1> {
+      static const char* name() { return "cpu_percent"; }
+    };
+
+    //! SystemResources MEMORY_USED, up to 1023 KB
+    struct MemoryUsed : Beacon::Gauge<HealthBeaconCfg::SYSTEM_RESOURCES_ID_BASE + 1, U64, 10, 0, 1> {
+      static const char* name() { return "memory_used_kb"; }
+    };
+
+    //! SystemResources NON_VOLATILE_FREE, in 4 KB steps up to 16 MB
+    struct NonVolatileFree : Beacon::Gauge<HealthBeaconCfg::SYSTEM_RESOURCES_ID_BASE + 3, U64, 12, 0, 4> {
+      static const char* name() { return "nonvolatile_free_kb"; }
+    };
+
+    //! DisciplinedTime ClockOffset, in 16 us steps within about 33 ms either way
+    struct ClockOffset : Beacon::Gauge<HealthBeaconCfg::TIME_ID_BASE + 0, I32, 12, -32768, 16> {
+      static const char* name() { return "clock_offset_us"; }
+    };
+
+  }
+
+  //! Layout of the health beacon's fields
+  typedef Beacon::Schema<
+      HealthBeaconFields::RadioStatus,
+      HealthBeaconFields::PacketsSent,
+      HealthBeaconFields::PacketsReceived,
+      HealthBeaconFields::PacketsLost,
+      HealthBeaconFields::Airtime,
+      HealthBeaconFields::Rssi,
+      HealthBeaconFields::Cpu,
+      HealthBeaconFields::MemoryUsed,
+      HealthBeaconFields::NonVolatileFree,
+      HealthBeaconFields::ClockOffset
+  > HealthBeaconSchema;
+
+  //! Bytes of a beacon ahead of the fields: the marker, the low 16 bits of the layout hash as the layout id, a
+  //! sequence number and the sender's time in seconds
+  static const U32 HEALTH_BEACON_HEADER_SIZE = 2 * sizeof(U8) + sizeof(U16) + sizeof(U32);
+
+  //! Layout id sent in every beacon
+  static const U16 HEALTH_BEACON_LAYOUT = static_cast<U16>(HealthBeaconSchema::HASH);
+
+  //! Bytes of a beacon
+  static const U32 HEALTH_BEACON_SIZE = HEALTH_BEACON_HEADER_SIZE + HealthBeaconSchema::BYTES;
+
+  static_assert(HEALTH_BEACON_SIZE <= HealthBeaconCfg::MAX_BEACON_SIZE, "the health beacon must fit one radio packet");
+
+}
+
+#endif
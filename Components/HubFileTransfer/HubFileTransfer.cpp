@@ -0,0 +1,781 @@
+// ======================================================================
+// \title  HubFileTransfer.cpp
+// \brief  cpp file for HubFileTransfer component implementation class
+// ======================================================================
+
+#include "Components/HubFileTransfer/HubFileTransfer.hpp"
+#include "FpConfig.hpp"
+#include <Components/Framing/Crc32.hpp>
+#include <Os/FileSystem.hpp>
+#include <cstring>
+
+namespace Components {
+
+  namespace {
+    //! Bytes of a start message ahead of the destination path
+    const U32 START_HEADER_SIZE = sizeof(U8) + sizeof(U8) + sizeof(U32) + sizeof(U32) + sizeof(U16);
+
+    //! Bytes of the file read into the checksum at a time
+    const U32 CHECKSUM_BLOCK_SIZE = 256;
+
+    //! Bytes of a status message
+    const U32 STATUS_MESSAGE_SIZE =
+        sizeof(U8) + sizeof(U8) + sizeof(U8) + sizeof(U16) + sizeof(U16) + HubFileTransfer::STATUS_BITMAP_SIZE;
+
+    //! Bytes of a message carrying only a type and transfer id
+    const U32 CONTROL_MESSAGE_SIZE = sizeof(U8) + sizeof(U8);
+  }
+
+  // ----------------------------------------------------------------------
+  // Component construction and destruction
+  // ----------------------------------------------------------------------
+
+  HubFileTransfer ::
+    HubFileTransfer(const char* const compName) :
+      HubFileTransferComponentBase(compName),
+      m_txState(TX_IDLE),
+      m_txSize(0),
+      m_txChunks(0),
+      m_txChecksum(0),
+      m_txId(0),
+      m_txBase(0),
+      m_txNext(0),
+      m_txPollNext(0),
+      m_txFilePos(0),
+      m_txIdleRuns(0),
+      m_txPolls(0),
+      m_txRetransmits(0),
+      m_txStartBase(0),
+      m_rxState(RX_IDLE),
+      m_rxSize(0),
+      m_rxChunkSize(0),
+      m_rxChunks(0),
+      m_rxChecksum(0),
+      m_rxId(0),
+      m_rxCount(0),
+      m_rxBase(0),
+      m_rxHighest(0),
+      m_rxSinceStatus(0),
+      m_rxSessionBytes(0)
+  {
+    memset(m_txResend, 0, sizeof(m_txResend));
+    memset(m_rxReceived, 0, sizeof(m_rxReceived));
+  }
+
+  HubFileTransfer ::
+    ~HubFileTransfer()
+  {
+
+  }
+
+  // ----------------------------------------------------------------------
+  // Handler implementations for user-defined typed input ports
+  // ----------------------------------------------------------------------
+
+  void HubFileTransfer ::
+    run_handler(
+        FwIndexType portNum,
+        NATIVE_UINT_TYPE context
+    )
+  {
+    this->runSender();
+  }
+
+  void HubFileTransfer ::
+    hubIn_handler(
+        FwIndexType portNum,
+        Fw::Buffer& fwBuffer
+    )
+  {
+    const U32 size = fwBuffer.getSize();
+    Fw::SerializeBufferBase& serial = fwBuffer.getSerializeRepr();
+    Fw::SerializeStatus status = serial.setBuffLen(size);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+
+    U8 type = 0;
+    U8 transferId = 0;
+    status = serial.deserialize(type);
+    if (status == Fw::FW_SERIALIZE_OK) {
+      status = serial.deserialize(transferId);
+    }
+    if (status != Fw::FW_SERIALIZE_OK) {
+      this->log_WARNING_LO_MessageMalformed(size);
+      this->deallocate_out(0, fwBuffer);
+      return;
+    }
+
+    switch (type) {
+      case MSG_START:
+        this->handleStart(serial, transferId, size);
+        break;
+      case MSG_DATA: {
+        U16 chunk = 0;
+        if ((size <= DATA_HEADER_SIZE) || (serial.deserialize(chunk) != Fw::FW_SERIALIZE_OK)) {
+          this->log_WARNING_LO_MessageMalformed(size);
+          break;
+        }
+        this->handleData(transferId, chunk, fwBuffer.getData() + DATA_HEADER_SIZE, size - DATA_HEADER_SIZE);
+        break;
+      }
+      case MSG_STATUS:
+        if (transferId == m_txId) {
+          this->handleStatus(serial);
+        }
+        break;
+      case MSG_POLL:
+        if ((m_rxState != RX_IDLE) && (transferId == m_rxId)) {
+          this->sendStatus(true);
+        } else {
+          this->sendRefusal(transferId);
+        }
+        break;
+      case MSG_CANCEL:
+        if ((m_rxState == RX_RECEIVING) && (transferId == m_rxId)) {
+          (void) m_rxFile.close();
+          m_rxState = RX_IDLE;
+        }
+        break;
+      default:
+        this->log_WARNING_LO_MessageMalformed(size);
+        break;
+    }
+    this->deallocate_out(0, fwBuffer);
+  }
+
+  // ----------------------------------------------------------------------
+  // Handler implementations for commands
+  // ----------------------------------------------------------------------
+
+  void HubFileTransfer ::
+    SEND_FILE_cmdHandler(
+        FwOpcodeType opCode,
+        U32 cmdSeq,
+        const Fw::CmdStringArg& sourceFileName,
+        const Fw::CmdStringArg& destFileName
+    )
+  {
+    if ((m_txState == TX_CHECKSUMMING) || (m_txState == TX_STARTING) || (m_txState == TX_SENDING)) {
+      this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::BUSY);
+      return;
+    }
+    if (not isConfined(destFileName.toChar())) {
+      // The peer would refuse it
+      this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::VALIDATION_ERROR);
+      return;
+    }
+    if (m_txState == TX_SUSPENDED) {
+      // A new transfer replaces a suspended one
+      this->endSend();
+    }
+
+    Fw::LogStringArg logSource(sourceFileName.toChar());
+    FwSizeType fileSize = 0;
+    const Os::FileSystem::Status fsStatus = Os::FileSystem::getFileSize(sourceFileName.toChar(), fileSize);
+    if (fsStatus != Os::FileSystem::OP_OK) {
+      this->log_WARNING_HI_SendError(logSource, static_cast<I32>(fsStatus));
+      this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::EXECUTION_ERROR);
+      return;
+    }
+    const FwSizeType chunks = (fileSize + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    if (chunks > HubFileTransferCfg::MAX_CHUNKS) {
+      this->log_WARNING_HI_SendError(logSource, -1);
+      this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::VALIDATION_ERROR);
+      return;
+    }
+    const Os::File::Status fileStatus = m_txFile.open(sourceFileName.toChar(), Os::File::OPEN_READ);
+    if (fileStatus != Os::File::OP_OK) {
+      this->log_WARNING_HI_SendError(logSource, static_cast<I32>(fileStatus));
+      this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::EXECUTION_ERROR);
+      return;
+    }
+
+    m_txSource = sourceFileName;
+    m_txDest = destFileName;
+    m_txSize = static_cast<U32>(fileSize);
+    m_txChunks = static_cast<U32>(chunks);
+    m_txChecksum = Framing::Crc32Engine::INITIAL;
+    m_txId++;
+    m_txBase = 0;
+    m_txNext = 0;
+    m_txFilePos = 0;
+    m_txIdleRuns = 0;
+    m_txPolls = 0;
+    // The start message goes out once the file has been read for its checksum, over the next run calls
+    m_txState = TX_CHECKSUMMING;
+
+    Fw::LogStringArg logDest(destFileName.toChar());
+    this->log_ACTIVITY_HI_SendStarted(logSource, logDest, m_txSize);
+    this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::OK);
+  }
+
+  void HubFileTransfer ::
+    RESUME_SEND_cmdHandler(
+        FwOpcodeType opCode,
+        U32 cmdSeq
+    )
+  {
+    if (m_txState != TX_SUSPENDED) {
+      this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::VALIDATION_ERROR);
+      return;
+    }
+    // The receiver answers the repeated start message with the chunks it still needs
+    m_txIdleRuns = 0;
+    m_txPolls = 0;
+    m_txState = TX_STARTING;
+    this->sendStart();
+    this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::OK);
+  }
+
+  void HubFileTransfer ::
+    CANCEL_SEND_cmdHandler(
+        FwOpcodeType opCode,
+        U32 cmdSeq
+    )
+  {
+    if (m_txState != TX_IDLE) {
+      // The peer has heard nothing of a transfer still being checksummed
+      if (m_txState != TX_CHECKSUMMING) {
+        this->sendControl(MSG_CANCEL);
+      }
+      Fw::LogStringArg logDest(m_txDest.toChar());
+      this->log_ACTIVITY_HI_SendCancelled(logDest);
+      this->endSend();
+    }
+    this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::OK);
+  }
+
+  // ----------------------------------------------------------------------
+  // Sender
+  // ----------------------------------------------------------------------
+
+  void HubFileTransfer ::
+    runSender()
+  {
+    if (m_txState == TX_CHECKSUMMING) {
+      this->checksumFile();
+      return;
+    }
+    if (m_txState == TX_STARTING) {
+      this->checkSenderTimeout();
+      return;
+    }
+    if (m_txState != TX_SENDING) {
+      return;
+    }
+
+    U32 budget = this->chunkBudget();
+    // Each chunk is read from the file, which the time limit bounds
+    const Fw::Time started = this->getTime();
+
+    // Holes the receiver reported come first so its base can advance
+    const U32 windowEnd = FW_MIN(m_txNext, m_txBase + HubFileTransferCfg::WINDOW_CHUNKS);
+    for (U32 chunk = m_txBase; (chunk < windowEnd) && (budget > 0); chunk++) {
+      const U32 bit = chunk % HubFileTransferCfg::WINDOW_CHUNKS;
+      const U8 mask = static_cast<U8>(1 << (bit % 8));
+      if ((m_txResend[bit / 8] & mask) == 0) {
+        continue;
+      }
+      if (not this->sendChunk(chunk)) {
+        budget = 0;
+        break;
+      }
+      m_txResend[bit / 8] &= static_cast<U8>(~mask);
+      m_txRetransmits++;
+      budget--;
+      if (this->elapsedUs(started) >= HubFileTransferCfg::SEND_TIME_LIMIT_US) {
+        budget = 0;
+      }
+    }
+
+    const U32 windowLimit = FW_MIN(m_txChunks, m_txBase + HubFileTransferCfg::WINDOW_CHUNKS);
+    while ((budget > 0) && (m_txNext < windowLimit)) {
+      if (not this->sendChunk(m_txNext)) {
+        break;
+      }
+      m_txNext++;
+      budget--;
+      if (this->elapsedUs(started) >= HubFileTransferCfg::SEND_TIME_LIMIT_US) {
+        budget = 0;
+      }
+    }
+
+    this->checkSenderTimeout();
+  }
+
+  U32 HubFileTransfer ::
+    chunkBudget()
+  {
+    const Radio::LinkLoad load = this->linkLoad_out(0);
+    if (not load.getup() || (load.getbitRate() == 0)) {
+      return 0;
+    }
+    // A run period of airtime, rounded up, and a chunk more so the radio has one to send when the period ends
+    const U64 chunkBitUs =
+        static_cast<U64>(HubFileTransferCfg::RADIO_MTU + HubFileTransferCfg::RADIO_OVERHEAD_BYTES) * 8 * 1000000;
+    const U64 periodChunks =
+        (static_cast<U64>(HubFileTransferCfg::RUN_PERIOD_US) * load.getbitRate() + chunkBitUs - 1) / chunkBitUs;
+    const U32 target = static_cast<U32>(FW_MIN(periodChunks + 1, HubFileTransferCfg::MAX_QUEUED_CHUNKS));
+    return (load.getqueued() < target) ? (target - load.getqueued()) : 0;
+  }
+
+  void HubFileTransfer ::
+    handleStatus(Fw::SerializeBufferBase& serial)
+  {
+    if ((m_txState != TX_STARTING) && (m_txState != TX_SENDING)) {
+      return;
+    }
+
+    U8 flags = 0;
+    U16 base = 0;
+    U16 highest = 0;
+    U8 bitmap[STATUS_BITMAP_SIZE];
+    NATIVE_UINT_TYPE bitmapSize = sizeof(bitmap);
+    if ((serial.deserialize(flags) != Fw::FW_SERIALIZE_OK) || (serial.deserialize(base) != Fw::FW_SERIALIZE_OK) ||
+        (serial.deserialize(highest) != Fw::FW_SERIALIZE_OK) ||
+        (serial.deserialize(bitmap, bitmapSize, true) != Fw::FW_SERIALIZE_OK) || (base > m_txChunks)) {
+      this->log_WARNING_LO_MessageMalformed(serial.getBuffLength());
+      return;
+    }
+
+    Fw::LogStringArg logDest(m_txDest.toChar());
+    if (flags & STATUS_REFUSED) {
+      this->log_WARNING_HI_SendError(logDest, -1);
+      this->endSend();
+      return;
+    }
+    if (flags & STATUS_COMPLETE) {
+      m_txBase = m_txChunks;
+      this->updateSenderTelemetry();
+      const U32 bytes = FW_MIN((m_txBase - m_txStartBase) * CHUNK_SIZE, m_txSize);
+      this->log_ACTIVITY_HI_SendCompleted(logDest, m_txSize, this->goodput(bytes, m_txStart));
+      this->endSend();
+      return;
+    }
+
+    if (m_txState == TX_STARTING) {
+      // Carry on from the first chunk the receiver is missing
+      m_txState = TX_SENDING;
+      m_txNext = base;
+      m_txStartBase = base;
+      m_txStart = this->getTime();
+    }
+    m_txBase = base;
+    if (m_txNext < base) {
+      m_txNext = base;
+    }
+
+    // Chunks after the highest one seen may still be in flight, unless this answers a poll that followed them
+    const U32 limit = (flags & STATUS_POLLED) ? m_txPollNext : FW_MIN(static_cast<U32>(highest), m_txNext);
+    const U32 end = FW_MIN(limit, m_txBase + HubFileTransferCfg::WINDOW_CHUNKS);
+    memset(m_txResend, 0, sizeof(m_txResend));
+    for (U32 chunk = m_txBase; chunk < end; chunk++) {
+      const U32 offset = chunk - m_txBase;
+      if ((bitmap[offset / 8] & (1 << (offset % 8))) == 0) {
+        const U32 bit = chunk % HubFileTransferCfg::WINDOW_CHUNKS;
+        m_txResend[bit / 8] |= static_cast<U8>(1 << (bit % 8));
+      }
+    }
+
+    m_txIdleRuns = 0;
+    m_txPolls = 0;
+    this->updateSenderTelemetry();
+  }
+
+  void HubFileTransfer ::
+    checksumFile()
+  {
+    U8 block[CHECKSUM_BLOCK_SIZE];
+    U32 budget = HubFileTransferCfg::CHECKSUM_BYTES_PER_RUN;
+    while ((budget > 0) && (m_txFilePos < m_txSize)) {
+      const U32 size = FW_MIN(FW_MIN(CHECKSUM_BLOCK_SIZE, budget), m_txSize - m_txFilePos);
+      NATIVE_INT_TYPE read = static_cast<NATIVE_INT_TYPE>(size);
+      const Os::File::Status readStatus = m_txFile.read(block, read, true);
+      if ((readStatus != Os::File::OP_OK) || (read != static_cast<NATIVE_INT_TYPE>(size))) {
+        Fw::LogStringArg logSource(m_txSource.toChar());
+        this->log_WARNING_HI_SendError(logSource, static_cast<I32>(readStatus));
+        this->endSend();
+        return;
+      }
+      m_txChecksum = Framing::defaultCrc32Engine().update(m_txChecksum, block, size);
+      m_txFilePos += size;
+      budget -= size;
+    }
+    if (m_txFilePos < m_txSize) {
+      return;
+    }
+    m_txChecksum = Framing::Crc32Engine::finalize(m_txChecksum);
+    m_txState = TX_STARTING;
+    this->sendStart();
+  }
+
+  void HubFileTransfer ::
+    sendStart()
+  {
+    Fw::Buffer buffer;
+    if (not this->allocateMessage(START_HEADER_SIZE + sizeof(FwBuffSizeType) + m_txDest.length(), buffer)) {
+      // Retried on the next timeout
+      return;
+    }
+    Fw::SerializeBufferBase& serial = buffer.getSerializeRepr();
+    serial.resetSer();
+    Fw::SerializeStatus status = serial.serialize(static_cast<U8>(MSG_START));
+    status = (status == Fw::FW_SERIALIZE_OK) ? serial.serialize(m_txId) : status;
+    status = (status == Fw::FW_SERIALIZE_OK) ? serial.serialize(m_txSize) : status;
+    status = (status == Fw::FW_SERIALIZE_OK) ? serial.serialize(m_txChecksum) : status;
+    status = (status == Fw::FW_SERIALIZE_OK) ? serial.serialize(static_cast<U16>(CHUNK_SIZE)) : status;
+    status = (status == Fw::FW_SERIALIZE_OK) ? serial.serialize(m_txDest) : status;
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    buffer.setSize(serial.getBuffLength());
+    this->hubOut_out(0, buffer);
+  }
+
+  bool HubFileTransfer ::
+    sendChunk(U32 chunk)
+  {
+    const U32 offset = chunk * CHUNK_SIZE;
+    const U32 size = FW_MIN(CHUNK_SIZE, m_txSize - offset);
+    Fw::Buffer buffer;
+    if (not this->allocateMessage(DATA_HEADER_SIZE + size, buffer)) {
+      return false;
+    }
+
+    if (offset != m_txFilePos) {
+      const Os::File::Status seekStatus = m_txFile.seek(static_cast<NATIVE_INT_TYPE>(offset), true);
+      if (seekStatus != Os::File::OP_OK) {
+        this->deallocate_out(0, buffer);
+        return false;
+      }
+    }
+    U8* const data = buffer.getData();
+    data[0] = MSG_DATA;
+    data[1] = m_txId;
+    data[2] = static_cast<U8>(chunk >> 8);
+    data[3] = static_cast<U8>(chunk);
+    NATIVE_INT_TYPE read = static_cast<NATIVE_INT_TYPE>(size);
+    const Os::File::Status readStatus = m_txFile.read(data + DATA_HEADER_SIZE, read, true);
+    if ((readStatus != Os::File::OP_OK) || (read != static_cast<NATIVE_INT_TYPE>(size))) {
+      // Force a seek next time since the position is unknown
+      m_txFilePos = m_txSize + 1;
+      this->deallocate_out(0, buffer);
+      return false;
+    }
+    m_txFilePos = offset + size;
+
+    buffer.setSize(DATA_HEADER_SIZE + size);
+    this->hubOut_out(0, buffer);
+    return true;
+  }
+
+  void HubFileTransfer ::
+    sendControl(MessageType type)
+  {
+    Fw::Buffer buffer;
+    if (not this->allocateMessage(CONTROL_MESSAGE_SIZE, buffer)) {
+      return;
+    }
+    U8* const data = buffer.getData();
+    data[0] = type;
+    data[1] = m_txId;
+    buffer.setSize(CONTROL_MESSAGE_SIZE);
+    this->hubOut_out(0, buffer);
+  }
+
+  void HubFileTransfer ::
+    checkSenderTimeout()
+  {
+    if (++m_txIdleRuns < HubFileTransferCfg::STATUS_TIMEOUT_RUNS) {
+      return;
+    }
+    m_txIdleRuns = 0;
+    if (++m_txPolls > HubFileTransferCfg::MAX_POLLS) {
+      m_txState = TX_SUSPENDED;
+      Fw::LogStringArg logDest(m_txDest.toChar());
+      this->log_WARNING_LO_SendSuspended(logDest, FW_MIN(m_txBase * CHUNK_SIZE, m_txSize));
+      return;
+    }
+    if (m_txState == TX_STARTING) {
+      this->sendStart();
+    } else {
+      m_txPollNext = m_txNext;
+      this->sendControl(MSG_POLL);
+    }
+  }
+
+  void HubFileTransfer ::
+    endSend()
+  {
+    (void) m_txFile.close();
+    m_txState = TX_IDLE;
+    memset(m_txResend, 0, sizeof(m_txResend));
+  }
+
+  void HubFileTransfer ::
+    updateSenderTelemetry()
+  {
+    const U32 bytes = FW_MIN((m_txBase - m_txStartBase) * CHUNK_SIZE, m_txSize);
+    this->tlmWrite_TxProgress(percent(m_txBase, m_txChunks));
+    this->tlmWrite_TxGoodput(this->goodput(bytes, m_txStart));
+    this->tlmWrite_TxRetransmits(m_txRetransmits);
+  }
+
+  // ----------------------------------------------------------------------
+  // Receiver
+  // ----------------------------------------------------------------------
+
+  void HubFileTransfer ::
+    handleStart(Fw::SerializeBufferBase& serial, U8 transferId, U32 messageSize)
+  {
+    U32 fileSize = 0;
+    U32 checksum = 0;
+    U16 chunkSize = 0;
+    Fw::String dest;
+    if ((serial.deserialize(fileSize) != Fw::FW_SERIALIZE_OK) ||
+        (serial.deserialize(checksum) != Fw::FW_SERIALIZE_OK) ||
+        (serial.deserialize(chunkSize) != Fw::FW_SERIALIZE_OK) || (serial.deserialize(dest) != Fw::FW_SERIALIZE_OK) ||
+        (chunkSize == 0)) {
+      this->log_WARNING_LO_MessageMalformed(messageSize);
+      return;
+    }
+    Fw::LogStringArg logDest(dest.toChar());
+    // The peer names the file, so it is kept from writing anywhere but below the working directory
+    if (not isConfined(dest.toChar())) {
+      this->log_WARNING_HI_ReceiveRejected(logDest);
+      this->sendRefusal(transferId);
+      return;
+    }
+
+    // A repeated start resumes the transfer rather than restarting it. The checksum tells it from a transfer of another
+    // file that a restarted sender gave the same id.
+    if ((m_rxState != RX_IDLE) && (transferId == m_rxId) && (fileSize == m_rxSize) && (checksum == m_rxChecksum) &&
+        (chunkSize == m_rxChunkSize) && (dest == m_rxDest)) {
+      if (m_rxState == RX_RECEIVING) {
+        m_rxSessionBytes = 0;
+        m_rxStart = this->getTime();
+        this->log_ACTIVITY_HI_ReceiveStarted(logDest, m_rxSize, FW_MIN(m_rxCount * m_rxChunkSize, m_rxSize));
+      }
+      this->sendStatus(false);
+      return;
+    }
+
+    if (m_rxState == RX_RECEIVING) {
+      (void) m_rxFile.close();
+    }
+    m_rxState = RX_IDLE;
+
+    const U32 chunks = static_cast<U32>((static_cast<U64>(fileSize) + chunkSize - 1) / chunkSize);
+    if (chunks > HubFileTransferCfg::MAX_CHUNKS) {
+      this->log_WARNING_HI_ReceiveError(logDest, -1);
+      this->sendRefusal(transferId);
+      return;
+    }
+    const Os::File::Status fileStatus = m_rxFile.open(dest.toChar(), Os::File::OPEN_CREATE);
+    if (fileStatus != Os::File::OP_OK) {
+      this->log_WARNING_HI_ReceiveError(logDest, static_cast<I32>(fileStatus));
+      this->sendRefusal(transferId);
+      return;
+    }
+
+    m_rxState = RX_RECEIVING;
+    m_rxDest = dest;
+    m_rxId = transferId;
+    m_rxSize = fileSize;
+    m_rxChecksum = checksum;
+    m_rxChunkSize = chunkSize;
+    m_rxChunks = chunks;
+    memset(m_rxReceived, 0, sizeof(m_rxReceived));
+    m_rxCount = 0;
+    m_rxBase = 0;
+    m_rxHighest = 0;
+    m_rxSinceStatus = 0;
+    m_rxSessionBytes = 0;
+    m_rxStart = this->getTime();
+    this->log_ACTIVITY_HI_ReceiveStarted(logDest, m_rxSize, 0);
+
+    if (m_rxChunks == 0) {
+      (void) m_rxFile.close();
+      m_rxState = RX_COMPLETE;
+      this->log_ACTIVITY_HI_ReceiveCompleted(logDest, m_rxSize);
+    }
+    this->sendStatus(false);
+  }
+
+  void HubFileTransfer ::
+    handleData(U8 transferId, U32 chunk, const U8* data, U32 size)
+  {
+    if ((m_rxState != RX_RECEIVING) || (transferId != m_rxId)) {
+      return;
+    }
+    const U32 offset = chunk * m_rxChunkSize;
+    if ((chunk >= m_rxChunks) || (size != FW_MIN(m_rxChunkSize, m_rxSize - offset))) {
+      this->log_WARNING_LO_MessageMalformed(DATA_HEADER_SIZE + size);
+      return;
+    }
+
+    if (not this->isReceived(chunk)) {
+      NATIVE_INT_TYPE written = static_cast<NATIVE_INT_TYPE>(size);
+      Os::File::Status fileStatus = m_rxFile.seek(static_cast<NATIVE_INT_TYPE>(offset), true);
+      if (fileStatus == Os::File::OP_OK) {
+        fileStatus = m_rxFile.write(data, written, true);
+      }
+      if ((fileStatus != Os::File::OP_OK) || (written != static_cast<NATIVE_INT_TYPE>(size))) {
+        Fw::LogStringArg logDest(m_rxDest.toChar());
+        this->log_WARNING_HI_ReceiveError(logDest, static_cast<I32>(fileStatus));
+        (void) m_rxFile.close();
+        m_rxState = RX_IDLE;
+        this->sendRefusal(transferId);
+        return;
+      }
+      m_rxReceived[chunk / 8] |= static_cast<U8>(1 << (chunk % 8));
+      m_rxCount++;
+      m_rxSessionBytes += size;
+      while ((m_rxBase < m_rxChunks) && this->isReceived(m_rxBase)) {
+        m_rxBase++;
+      }
+    }
+
+    // Skipping past the highest chunk means the ones in between were lost; report them right away
+    const bool gap = chunk > m_rxHighest;
+    m_rxHighest = FW_MAX(m_rxHighest, chunk + 1);
+    m_rxSinceStatus++;
+
+    if (m_rxCount == m_rxChunks) {
+      (void) m_rxFile.close();
+      m_rxState = RX_COMPLETE;
+      Fw::LogStringArg logDest(m_rxDest.toChar());
+      this->log_ACTIVITY_HI_ReceiveCompleted(logDest, m_rxSize);
+      this->sendStatus(false);
+    } else if (gap || (m_rxSinceStatus >= HubFileTransferCfg::STATUS_INTERVAL_CHUNKS)) {
+      this->sendStatus(false);
+    }
+  }
+
+  void HubFileTransfer ::
+    sendStatus(bool polled)
+  {
+    m_rxSinceStatus = 0;
+    this->updateReceiverTelemetry();
+
+    Fw::Buffer buffer;
+    if (not this->allocateMessage(STATUS_MESSAGE_SIZE, buffer)) {
+      return;
+    }
+    U8 flags = polled ? STATUS_POLLED : 0;
+    if (m_rxState == RX_COMPLETE) {
+      flags |= STATUS_COMPLETE;
+    }
+    U8 bitmap[STATUS_BITMAP_SIZE];
+    memset(bitmap, 0, sizeof(bitmap));
+    for (U32 offset = 0; offset < (STATUS_BITMAP_SIZE * 8); offset++) {
+      const U32 chunk = m_rxBase + offset;
+      if ((chunk < m_rxChunks) && this->isReceived(chunk)) {
+        bitmap[offset / 8] |= static_cast<U8>(1 << (offset % 8));
+      }
+    }
+
+    Fw::SerializeBufferBase& serial = buffer.getSerializeRepr();
+    serial.resetSer();
+    Fw::SerializeStatus status = serial.serialize(static_cast<U8>(MSG_STATUS));
+    status = (status == Fw::FW_SERIALIZE_OK) ? serial.serialize(m_rxId) : status;
+    status = (status == Fw::FW_SERIALIZE_OK) ? serial.serialize(flags) : status;
+    status = (status == Fw::FW_SERIALIZE_OK) ? serial.serialize(static_cast<U16>(m_rxBase)) : status;
+    status = (status == Fw::FW_SERIALIZE_OK) ? serial.serialize(static_cast<U16>(m_rxHighest)) : status;
+    status = (status == Fw::FW_SERIALIZE_OK) ? serial.serialize(bitmap, sizeof(bitmap), true) : status;
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    buffer.setSize(serial.getBuffLength());
+    this->hubOut_out(0, buffer);
+  }
+
+  void HubFileTransfer ::
+    sendRefusal(U8 transferId)
+  {
+    Fw::Buffer buffer;
+    if (not this->allocateMessage(STATUS_MESSAGE_SIZE, buffer)) {
+      return;
+    }
+    U8* const data = buffer.getData();
+    memset(data, 0, STATUS_MESSAGE_SIZE);
+    data[0] = MSG_STATUS;
+    data[1] = transferId;
+    data[2] = STATUS_REFUSED;
+    buffer.setSize(STATUS_MESSAGE_SIZE);
+    this->hubOut_out(0, buffer);
+  }
+
+  bool HubFileTransfer ::
+    isReceived(U32 chunk) const
+  {
+    return (m_rxReceived[chunk / 8] & (1 << (chunk % 8))) != 0;
+  }
+
+  void HubFileTransfer ::
+    updateReceiverTelemetry()
+  {
+    this->tlmWrite_RxProgress(percent(m_rxCount, m_rxChunks));
+    this->tlmWrite_RxGoodput(this->goodput(m_rxSessionBytes, m_rxStart));
+  }
+
+  // ----------------------------------------------------------------------
+  // Helpers
+  // ----------------------------------------------------------------------
+
+  bool HubFileTransfer ::
+    allocateMessage(U32 size, Fw::Buffer& buffer)
+  {
+    buffer = this->allocate_out(0, size);
+    if (buffer.getSize() < size) {
+      if (buffer.isValid()) {
+        this->deallocate_out(0, buffer);
+      }
+      return false;
+    }
+    buffer.setSize(size);
+    return true;
+  }
+
+  U32 HubFileTransfer ::
+    goodput(U32 bytes, const Fw::Time& start)
+  {
+    const U64 micros = this->elapsedUs(start);
+    if (micros == 0) {
+      return 0;
+    }
+    return static_cast<U32>((static_cast<U64>(bytes) * 1000000) / micros);
+  }
+
+  U64 HubFileTransfer ::
+    elapsedUs(const Fw::Time& start)
+  {
+    const Fw::Time elapsed = Fw::Time::sub(this->getTime(), start);
+    return static_cast<U64>(elapsed.getSeconds()) * 1000000 + elapsed.getUSeconds();
+  }
+
+  U8 HubFileTransfer ::
+    percent(U32 part, U32 total)
+  {
+    if (total == 0) {
+      return 100;
+    }
+    return static_cast<U8>((static_cast<U64>(part) * 100) / total);
+  }
+
+  bool HubFileTransfer ::
+    isConfined(const char* path)
+  {
+    if ((path[0] == '\0') || (path[0] == '/')) {
+      return false;
+    }
+    for (const char* component = path; *component != '\0';) {
+      const char* const end = strchr(component, '/');
+      const size_t length = (end != nullptr) ? static_cast<size_t>(end - component) : strlen(component);
+      if ((length == 2) && (component[0] == '.') && (component[1] == '.')) {
+        return false;
+      }
+      component += length;
+      if (*component == '/') {
+        component++;
+      }
+    }
+    return true;
+  }
+
+}
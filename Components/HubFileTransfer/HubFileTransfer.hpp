@@ -0,0 +1,270 @@
+// ======================================================================
+// \title  HubFileTransfer.hpp
+// \brief  hpp file for HubFileTransfer component implementation class
+// ======================================================================
+
+#ifndef Components_HubFileTransfer_HPP
+#define Components_HubFileTransfer_HPP
+
+#include "Components/HubFileTransfer/HubFileTransferComponentAc.hpp"
+#include <Fw/Types/String.hpp>
+#include <Os/File.hpp>
+#include <Svc/FramingProtocol/FprimeProtocol.hpp>
+#include <Utils/Hash/Hash.hpp>
+#include <config/HubFileTransferCfg.hpp>
+
+namespace Components {
+
+  //! Sends files to, and receives files from, the peer on the other end of the hub link
+  //!
+  //! The sender keeps up to WINDOW_CHUNKS chunks in flight past the first chunk the receiver is missing. The receiver
+  //! answers with a status report naming that chunk, the highest chunk seen and a bitmap of the chunks after it, and
+  //! the sender resends the holes. Because the radio delivers in order, a hole below the highest chunk seen is a
+  //! loss. A transfer whose peer goes quiet is suspended rather than dropped, and resumes from the receiver's state.
+  //! The start message carries a CRC-32 of the file, so a sender that restarts and numbers its transfers from the
+  //! beginning again never resumes an earlier transfer of a different file.
+  //!
+  //! Each run call tops the radio's queue up to a run period of airtime at its bit rate, so the radio is never left
+  //! idle between calls and the queue does not grow past what it can send.
+  class HubFileTransfer :
+    public HubFileTransferComponentBase
+  {
+
+    public:
+
+      //! Frame bytes around a hub message: frame header, packet type and CRC
+      static const U32 FRAME_OVERHEAD = Svc::FpFrameHeader::SIZE + sizeof(FwPacketDescriptorType) + HASH_DIGEST_LENGTH;
+
+      //! Hub bytes around a buffer: hub type, port and buffer size
+      static const U32 HUB_OVERHEAD = sizeof(U32) + sizeof(U32) + sizeof(FwBuffSizeType);
+
+      //! Bytes of a data message ahead of the chunk: message type, transfer id and chunk index
+      static const U32 DATA_HEADER_SIZE = sizeof(U8) + sizeof(U8) + sizeof(U16);
+
+      //! File bytes per chunk, so that a framed data message fills exactly one radio packet
+      static const U32 CHUNK_SIZE =
+          HubFileTransferCfg::RADIO_MTU - FRAME_OVERHEAD - HUB_OVERHEAD - DATA_HEADER_SIZE;
+
+      //! Bytes of the received-chunk bitmap in a status report
+      static const U32 STATUS_BITMAP_SIZE = 16;
+
+      //! Message types
+      enum MessageType : U8 {
+        MSG_START = 0, //!< Sender announces or resumes a transfer
+        MSG_DATA = 1, //!< Sender delivers a chunk
+        MSG_STATUS = 2, //!< Receiver reports which chunks it holds
+        MSG_POLL = 3, //!< Sender asks for a status report
+        MSG_CANCEL = 4, //!< Sender abandons the transfer
+      };
+
+      //! Status report flags
+      enum StatusFlags : U8 {
+        STATUS_COMPLETE = 0x01, //!< The receiver has the whole file
+        STATUS_POLLED = 0x02, //!< The report answers a poll, so every chunk sent before the poll has arrived
+        STATUS_REFUSED = 0x04, //!< The receiver cannot take the transfer
+      };
+
+      // ----------------------------------------------------------------------
+      // Component construction and destruction
+      // ----------------------------------------------------------------------
+
+      //! Construct HubFileTransfer object
+      HubFileTransfer(
+          const char* const compName //!< The component name
+      );
+
+      //! Destroy HubFileTransfer object
+      ~HubFileTransfer();
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Handler implementations for user-defined typed input ports
+      // ----------------------------------------------------------------------
+
+      //! Handler implementation for run
+      void run_handler(
+          FwIndexType portNum, //!< The port number
+          NATIVE_UINT_TYPE context //!< The call order
+      ) override;
+
+      //! Handler implementation for hubIn
+      void hubIn_handler(
+          FwIndexType portNum, //!< The port number
+          Fw::Buffer& fwBuffer //!< The message from the peer
+      ) override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Handler implementations for commands
+      // ----------------------------------------------------------------------
+
+      //! Handler implementation for command SEND_FILE
+      void SEND_FILE_cmdHandler(
+          FwOpcodeType opCode, //!< The opcode
+          U32 cmdSeq, //!< The command sequence number
+          const Fw::CmdStringArg& sourceFileName, //!< The file to send
+          const Fw::CmdStringArg& destFileName //!< The path to write on the peer
+      ) override;
+
+      //! Handler implementation for command RESUME_SEND
+      void RESUME_SEND_cmdHandler(
+          FwOpcodeType opCode, //!< The opcode
+          U32 cmdSeq //!< The command sequence number
+      ) override;
+
+      //! Handler implementation for command CANCEL_SEND
+      void CANCEL_SEND_cmdHandler(
+          FwOpcodeType opCode, //!< The opcode
+          U32 cmdSeq //!< The command sequence number
+      ) override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Sender
+      // ----------------------------------------------------------------------
+
+      //! Send chunks for this run call and poll a quiet receiver
+      void runSender();
+
+      //! Chunks to send on this run call: enough to top the radio's queue up to a run period of airtime
+      U32 chunkBudget();
+
+      //! Process a status report for the outgoing transfer
+      void handleStatus(Fw::SerializeBufferBase& serial);
+
+      //! Read the next part of the outgoing file into its checksum, and send the start message once it is all read
+      void checksumFile();
+
+      //! Send the start message for the outgoing transfer
+      void sendStart();
+
+      //! Send one chunk of the outgoing file
+      //!
+      //! \return false if no buffer was available or the file could not be read
+      bool sendChunk(U32 chunk);
+
+      //! Send a message with only a type and the outgoing transfer id
+      void sendControl(MessageType type);
+
+      //! Count a run call without a status report, polling or suspending once it has gone on too long
+      void checkSenderTimeout();
+
+      //! Close the outgoing file and return to idle
+      void endSend();
+
+      //! Publish sender progress and goodput
+      void updateSenderTelemetry();
+
+      // ----------------------------------------------------------------------
+      // Receiver
+      // ----------------------------------------------------------------------
+
+      //! Start or resume an incoming transfer
+      void handleStart(Fw::SerializeBufferBase& serial, U8 transferId, U32 messageSize);
+
+      //! Store a chunk of the incoming file
+      void handleData(U8 transferId, U32 chunk, const U8* data, U32 size);
+
+      //! Send a status report for the incoming transfer
+      void sendStatus(bool polled);
+
+      //! Refuse a transfer the receiver cannot take
+      void sendRefusal(U8 transferId);
+
+      //! Whether a chunk of the incoming file has been stored
+      bool isReceived(U32 chunk) const;
+
+      //! Publish receiver progress and goodput
+      void updateReceiverTelemetry();
+
+      // ----------------------------------------------------------------------
+      // Helpers
+      // ----------------------------------------------------------------------
+
+      //! Allocate a buffer for an outgoing message
+      //!
+      //! \return false if no buffer of the size is available
+      bool allocateMessage(U32 size, Fw::Buffer& buffer);
+
+      //! Bytes per second over the time since a start time
+      U32 goodput(U32 bytes, const Fw::Time& start);
+
+      //! Microseconds since a start time
+      U64 elapsedUs(const Fw::Time& start);
+
+      //! Percent of a total
+      static U8 percent(U32 part, U32 total);
+
+      //! Whether a path stays below the working directory: not empty, not absolute, and with no .. component
+      static bool isConfined(const char* path);
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Member variables
+      // ----------------------------------------------------------------------
+
+      static_assert(CHUNK_SIZE > 0, "Radio MTU too small for a data message");
+      static_assert(HubFileTransferCfg::WINDOW_CHUNKS % 8 == 0, "Window must be a whole number of bytes of bits");
+      static_assert(HubFileTransferCfg::WINDOW_CHUNKS <= STATUS_BITMAP_SIZE * 8, "Status report must cover the window");
+      static_assert(HubFileTransferCfg::MAX_CHUNKS % 8 == 0, "Chunk limit must be a whole number of bytes of bits");
+      static_assert(HubFileTransferCfg::MAX_CHUNKS <= 0xFFFF, "Chunk indices are sent as U16");
+
+      //! Outgoing transfer state
+      enum TxState {
+        TX_IDLE, //!< No transfer
+        TX_CHECKSUMMING, //!< Reading the file for the checksum the start message carries
+        TX_STARTING, //!< Waiting for the receiver to answer the start message
+        TX_SENDING, //!< Sending chunks
+        TX_SUSPENDED, //!< Receiver stopped answering; waiting for RESUME_SEND
+      };
+
+      TxState m_txState; //!< Outgoing transfer state
+      Os::File m_txFile; //!< File being sent
+      Fw::String m_txSource; //!< Path of the file being sent
+      Fw::String m_txDest; //!< Path on the receiver
+      U32 m_txSize; //!< Size of the file being sent
+      U32 m_txChunks; //!< Chunks in the file being sent
+      U32 m_txChecksum; //!< CRC-32 of the file being sent, running until TX_CHECKSUMMING ends
+      U8 m_txId; //!< Id of the outgoing transfer
+      U32 m_txBase; //!< First chunk the receiver is missing
+      U32 m_txNext; //!< First chunk never sent
+      U32 m_txPollNext; //!< m_txNext when the last poll was sent
+      U32 m_txFilePos; //!< Read position of m_txFile
+      U8 m_txResend[HubFileTransferCfg::WINDOW_CHUNKS / 8]; //!< Chunks to resend, bit chunk % WINDOW_CHUNKS
+      U32 m_txIdleRuns; //!< Run calls since the last status report
+      U32 m_txPolls; //!< Polls since the last status report
+      U32 m_txRetransmits; //!< Chunks resent
+      Fw::Time m_txStart; //!< Time the transfer started or resumed
+      U32 m_txStartBase; //!< m_txBase when the transfer started or resumed
+
+      //! Incoming transfer state
+      enum RxState {
+        RX_IDLE, //!< No transfer
+        RX_RECEIVING, //!< Receiving chunks
+        RX_COMPLETE, //!< The last transfer completed; its id is kept to answer repeats
+      };
+
+      RxState m_rxState; //!< Incoming transfer state
+      Os::File m_rxFile; //!< File being written
+      Fw::String m_rxDest; //!< Path of the file being written
+      U32 m_rxSize; //!< Size of the incoming file
+      U32 m_rxChunkSize; //!< Chunk size chosen by the sender
+      U32 m_rxChunks; //!< Chunks in the incoming file
+      U32 m_rxChecksum; //!< CRC-32 of the incoming file, as the sender gave it
+      U8 m_rxId; //!< Id of the incoming transfer
+      U8 m_rxReceived[HubFileTransferCfg::MAX_CHUNKS / 8]; //!< Chunks stored, one bit each
+      U32 m_rxCount; //!< Chunks stored
+      U32 m_rxBase; //!< First chunk not stored
+      U32 m_rxHighest; //!< One past the highest chunk stored
+      U32 m_rxSinceStatus; //!< Chunks stored since the last status report
+      U32 m_rxSessionBytes; //!< Bytes stored since the transfer started or resumed
+      Fw::Time m_rxStart; //!< Time the transfer started or resumed
+  };
+
+}
+
+#endif
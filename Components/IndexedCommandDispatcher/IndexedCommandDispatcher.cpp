@@ -0,0 +1,264 @@
+// ======================================================================
+// \title  IndexedCommandDispatcher.cpp
+// \brief  cpp file for IndexedCommandDispatcher component implementation class
+// ======================================================================
+
+#include "Components/IndexedCommandDispatcher/IndexedCommandDispatcher.hpp"
+#include "FpConfig.hpp"
+#include <Fw/Cmd/CmdPacket.hpp>
+#include <cstring>
+
+namespace Components {
+
+  // ----------------------------------------------------------------------
+  // Component construction and destruction
+  // ----------------------------------------------------------------------
+
+  IndexedCommandDispatcher ::
+    IndexedCommandDispatcher(const char* const compName) :
+      IndexedCommandDispatcherComponentBase(compName),
+      m_numEntries(0),
+      m_numPages(0),
+      m_hasUnindexed(false),
+      m_seq(0),
+      m_numCmdsDispatched(0),
+      m_numCmdErrors(0)
+  {
+    memset(m_entryTable, 0, sizeof(m_entryTable));
+    memset(m_directory, NO_SLOT, sizeof(m_directory));
+    memset(m_pages, NO_SLOT, sizeof(m_pages));
+    memset(m_sequenceTracker, 0, sizeof(m_sequenceTracker));
+  }
+
+  IndexedCommandDispatcher ::
+    ~IndexedCommandDispatcher()
+  {
+
+  }
+
+  // ----------------------------------------------------------------------
+  // Handler implementations for user-defined typed input ports
+  // ----------------------------------------------------------------------
+
+  void IndexedCommandDispatcher ::
+    compCmdReg_handler(
+        FwIndexType portNum,
+        FwOpcodeType opCode
+    )
+  {
+    const U8 existing = this->lookup(opCode);
+    if (existing != NO_SLOT) {
+      // Components may register again, but never take over another component's opcode
+      FW_ASSERT(m_entryTable[existing].port == portNum, opCode, portNum);
+      this->log_DIAGNOSTIC_OpCodeReregistered(opCode, portNum);
+      return;
+    }
+
+    FW_ASSERT(m_numEntries < CMD_DISPATCHER_DISPATCH_TABLE_SIZE, opCode);
+    const U8 entry = m_numEntries++;
+    m_entryTable[entry].opcode = opCode;
+    m_entryTable[entry].port = portNum;
+    if (not this->index(opCode, entry)) {
+      m_hasUnindexed = true;
+      this->log_WARNING_LO_OpCodeUnindexed(opCode);
+    }
+    this->log_DIAGNOSTIC_OpCodeRegistered(opCode, portNum, entry);
+  }
+
+  void IndexedCommandDispatcher ::
+    compCmdStat_handler(
+        FwIndexType portNum,
+        FwOpcodeType opCode,
+        U32 cmdSeq,
+        const Fw::CmdResponse& response
+    )
+  {
+    if (response.e == Fw::CmdResponse::OK) {
+      this->log_COMMAND_OpCodeCompleted(opCode);
+    } else {
+      m_numCmdErrors++;
+      this->log_COMMAND_OpCodeError(opCode, response);
+      this->tlmWrite_CommandErrors(m_numCmdErrors);
+    }
+
+    for (U32 pending = 0; pending < FW_NUM_ARRAY_ELEMENTS(m_sequenceTracker); pending++) {
+      SequenceTracker& tracker = m_sequenceTracker[pending];
+      if (tracker.used && (tracker.seq == cmdSeq)) {
+        FW_ASSERT(opCode == tracker.opCode, opCode, tracker.opCode);
+        FW_ASSERT(tracker.callerPort < this->getNum_seqCmdStatus_OutputPorts(), tracker.callerPort);
+        tracker.used = false;
+        if (this->isConnected_seqCmdStatus_OutputPort(tracker.callerPort)) {
+          this->seqCmdStatus_out(tracker.callerPort, opCode, tracker.context, response);
+        }
+        break;
+      }
+    }
+  }
+
+  void IndexedCommandDispatcher ::
+    seqCmdBuff_handler(
+        FwIndexType portNum,
+        Fw::ComBuffer& data,
+        U32 context
+    )
+  {
+    Fw::CmdPacket cmdPkt;
+    const Fw::SerializeStatus stat = cmdPkt.deserialize(data);
+    if (stat != Fw::FW_SERIALIZE_OK) {
+      Fw::DeserialStatus serErr;
+      serErr.e = static_cast<Fw::DeserialStatus::T>(stat);
+      this->log_WARNING_HI_MalformedCommand(serErr);
+      if (this->isConnected_seqCmdStatus_OutputPort(portNum)) {
+        this->seqCmdStatus_out(portNum, cmdPkt.getOpCode(), context, Fw::CmdResponse::VALIDATION_ERROR);
+      }
+      return;
+    }
+
+    const FwOpcodeType opCode = cmdPkt.getOpCode();
+    const U8 entry = this->lookup(opCode);
+    if ((entry == NO_SLOT) || not this->isConnected_compCmdSend_OutputPort(m_entryTable[entry].port)) {
+      this->log_WARNING_HI_InvalidCommand(opCode);
+      m_numCmdErrors++;
+      if (this->isConnected_seqCmdStatus_OutputPort(portNum)) {
+        this->seqCmdStatus_out(portNum, opCode, context, Fw::CmdResponse::INVALID_OPCODE);
+      }
+      this->tlmWrite_CommandErrors(m_numCmdErrors);
+      m_seq++;
+      return;
+    }
+
+    // Track the command only when there is somewhere to send its status
+    if (this->isConnected_seqCmdStatus_OutputPort(portNum)) {
+      bool pendingFound = false;
+      for (U32 pending = 0; pending < FW_NUM_ARRAY_ELEMENTS(m_sequenceTracker); pending++) {
+        SequenceTracker& tracker = m_sequenceTracker[pending];
+        if (not tracker.used) {
+          tracker.used = true;
+          tracker.seq = m_seq;
+          tracker.opCode = opCode;
+          tracker.context = context;
+          tracker.callerPort = portNum;
+          pendingFound = true;
+          break;
+        }
+      }
+      if (not pendingFound) {
+        this->log_WARNING_HI_TooManyCommands(opCode);
+        this->seqCmdStatus_out(portNum, opCode, context, Fw::CmdResponse::EXECUTION_ERROR);
+        return;
+      }
+    }
+
+    const FwIndexType port = m_entryTable[entry].port;
+    this->compCmdSend_out(port, opCode, m_seq, cmdPkt.getArgBuffer());
+    this->log_COMMAND_OpCodeDispatched(opCode, port);
+    m_numCmdsDispatched++;
+    this->tlmWrite_CommandsDispatched(m_numCmdsDispatched);
+    m_seq++;
+  }
+
+  void IndexedCommandDispatcher ::
+    pingIn_handler(
+        FwIndexType portNum,
+        U32 key
+    )
+  {
+    this->pingOut_out(0, key);
+  }
+
+  // ----------------------------------------------------------------------
+  // Handler implementations for commands
+  // ----------------------------------------------------------------------
+
+  void IndexedCommandDispatcher ::
+    CMD_NO_OP_cmdHandler(
+        FwOpcodeType opCode,
+        U32 cmdSeq
+    )
+  {
+    this->log_ACTIVITY_HI_NoOpReceived();
+    this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::OK);
+  }
+
+  void IndexedCommandDispatcher ::
+    CMD_NO_OP_STRING_cmdHandler(
+        FwOpcodeType opCode,
+        U32 cmdSeq,
+        const Fw::CmdStringArg& arg1
+    )
+  {
+    Fw::LogStringArg msg(arg1.toChar());
+    this->log_ACTIVITY_HI_NoOpStringReceived(msg);
+    this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::OK);
+  }
+
+  void IndexedCommandDispatcher ::
+    CMD_TEST_CMD_1_cmdHandler(
+        FwOpcodeType opCode,
+        U32 cmdSeq,
+        I32 arg1,
+        F32 arg2,
+        U8 arg3
+    )
+  {
+    this->log_ACTIVITY_HI_TestCmd1Args(arg1, arg2, arg3);
+    this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::OK);
+  }
+
+  void IndexedCommandDispatcher ::
+    CMD_CLEAR_TRACKING_cmdHandler(
+        FwOpcodeType opCode,
+        U32 cmdSeq
+    )
+  {
+    for (U32 entry = 0; entry < FW_NUM_ARRAY_ELEMENTS(m_sequenceTracker); entry++) {
+      m_sequenceTracker[entry].used = false;
+    }
+    this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::OK);
+  }
+
+  // ----------------------------------------------------------------------
+  // Dispatch index
+  // ----------------------------------------------------------------------
+
+  bool IndexedCommandDispatcher ::
+    index(FwOpcodeType opCode, U8 entry)
+  {
+    const FwOpcodeType block = opCode / PAGE_SIZE;
+    if (block >= DIRECTORY_SIZE) {
+      return false;
+    }
+    U8 page = m_directory[block];
+    if (page == NO_SLOT) {
+      if (m_numPages == CMD_DISPATCHER_INDEX_PAGE_COUNT) {
+        return false;
+      }
+      page = m_numPages++;
+      m_directory[block] = page;
+    }
+    m_pages[page][opCode % PAGE_SIZE] = entry;
+    return true;
+  }
+
+  U8 IndexedCommandDispatcher ::
+    lookup(FwOpcodeType opCode) const
+  {
+    const FwOpcodeType block = opCode / PAGE_SIZE;
+    if (block < DIRECTORY_SIZE) {
+      const U8 page = m_directory[block];
+      if (page != NO_SLOT) {
+        // Every opcode in a block with a page is indexed, so a miss here is final
+        return m_pages[page][opCode % PAGE_SIZE];
+      }
+    }
+    if (m_hasUnindexed) {
+      for (U8 entry = 0; entry < m_numEntries; entry++) {
+        if (m_entryTable[entry].opcode == opCode) {
+          return entry;
+        }
+      }
+    }
+    return NO_SLOT;
+  }
+
+}
@@ -0,0 +1,169 @@
+// ======================================================================
+// \title  IndexedCommandDispatcher.hpp
+// \brief  hpp file for IndexedCommandDispatcher component implementation class
+// ======================================================================
+
+#ifndef Components_IndexedCommandDispatcher_HPP
+#define Components_IndexedCommandDispatcher_HPP
+
+#include "Components/IndexedCommandDispatcher/IndexedCommandDispatcherComponentAc.hpp"
+#include <config/CommandDispatcherImplCfg.hpp>
+
+namespace Components {
+
+  //! Drop-in replacement for Svc::CommandDispatcher with constant-time opcode lookup
+  //!
+  //! Opcodes are base ID + offset, and component base IDs are spaced at least 0x100 apart. The dispatch index is a
+  //! directory keyed by the upper byte of a 16-bit opcode that points at a page of 256 slots, one per offset, holding
+  //! the dispatch table entry. A lookup is two array reads regardless of how many opcodes are registered. Opcodes
+  //! above 0xFFFF, or registered after the page pool is exhausted, are still dispatched through a linear search.
+  class IndexedCommandDispatcher :
+    public IndexedCommandDispatcherComponentBase
+  {
+
+    public:
+
+      //! Opcodes per index page
+      static const U32 PAGE_SIZE = 256;
+
+      //! Directory entries; opcodes below PAGE_SIZE * DIRECTORY_SIZE can be indexed
+      static const U32 DIRECTORY_SIZE = 256;
+
+      // ----------------------------------------------------------------------
+      // Component construction and destruction
+      // ----------------------------------------------------------------------
+
+      //! Construct IndexedCommandDispatcher object
+      IndexedCommandDispatcher(
+          const char* const compName //!< The component name
+      );
+
+      //! Destroy IndexedCommandDispatcher object
+      ~IndexedCommandDispatcher();
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Handler implementations for user-defined typed input ports
+      // ----------------------------------------------------------------------
+
+      //! Handler implementation for compCmdReg
+      void compCmdReg_handler(
+          FwIndexType portNum, //!< The port number
+          FwOpcodeType opCode //!< Command Op Code
+      ) override;
+
+      //! Handler implementation for compCmdStat
+      void compCmdStat_handler(
+          FwIndexType portNum, //!< The port number
+          FwOpcodeType opCode, //!< Command Op Code
+          U32 cmdSeq, //!< Command Sequence
+          const Fw::CmdResponse& response //!< The command response argument
+      ) override;
+
+      //! Handler implementation for seqCmdBuff
+      void seqCmdBuff_handler(
+          FwIndexType portNum, //!< The port number
+          Fw::ComBuffer& data, //!< Buffer containing packet data
+          U32 context //!< Call context value; meaning chosen by user
+      ) override;
+
+      //! Handler implementation for pingIn
+      void pingIn_handler(
+          FwIndexType portNum, //!< The port number
+          U32 key //!< Value to return to pinger
+      ) override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Handler implementations for commands
+      // ----------------------------------------------------------------------
+
+      //! Handler implementation for command CMD_NO_OP
+      void CMD_NO_OP_cmdHandler(
+          FwOpcodeType opCode, //!< The opcode
+          U32 cmdSeq //!< The command sequence number
+      ) override;
+
+      //! Handler implementation for command CMD_NO_OP_STRING
+      void CMD_NO_OP_STRING_cmdHandler(
+          FwOpcodeType opCode, //!< The opcode
+          U32 cmdSeq, //!< The command sequence number
+          const Fw::CmdStringArg& arg1 //!< The String command argument
+      ) override;
+
+      //! Handler implementation for command CMD_TEST_CMD_1
+      void CMD_TEST_CMD_1_cmdHandler(
+          FwOpcodeType opCode, //!< The opcode
+          U32 cmdSeq, //!< The command sequence number
+          I32 arg1, //!< The I32 command argument
+          F32 arg2, //!< The F32 command argument
+          U8 arg3 //!< The U8 command argument
+      ) override;
+
+      //! Handler implementation for command CMD_CLEAR_TRACKING
+      void CMD_CLEAR_TRACKING_cmdHandler(
+          FwOpcodeType opCode, //!< The opcode
+          U32 cmdSeq //!< The command sequence number
+      ) override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Dispatch index
+      // ----------------------------------------------------------------------
+
+      //! Marker for an empty directory or page slot
+      static const U8 NO_SLOT = 0xFF;
+
+      //! Add a dispatch table entry to the index
+      //!
+      //! \return true if the opcode is indexed, false if it needs the linear fallback
+      bool index(FwOpcodeType opCode, U8 entry);
+
+      //! Find the dispatch table entry for an opcode
+      //!
+      //! \return the entry, or NO_SLOT if the opcode is not registered
+      U8 lookup(FwOpcodeType opCode) const;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Member variables
+      // ----------------------------------------------------------------------
+
+      static_assert(CMD_DISPATCHER_DISPATCH_TABLE_SIZE < NO_SLOT, "Dispatch table entries must fit a U8 slot");
+      static_assert(CMD_DISPATCHER_INDEX_PAGE_COUNT < NO_SLOT, "Index pages must fit a U8 directory slot");
+
+      //! Registered opcode
+      struct DispatchEntry {
+        FwOpcodeType opcode; //!< The opcode
+        FwIndexType port; //!< Port the command is dispatched on
+      };
+      DispatchEntry m_entryTable[CMD_DISPATCHER_DISPATCH_TABLE_SIZE]; //!< Registered opcodes, in registration order
+      U8 m_numEntries; //!< Used entries of m_entryTable
+
+      U8 m_directory[DIRECTORY_SIZE]; //!< Page for each 256-opcode block, NO_SLOT if none
+      U8 m_pages[CMD_DISPATCHER_INDEX_PAGE_COUNT][PAGE_SIZE]; //!< Dispatch entry for each opcode offset
+      U8 m_numPages; //!< Used pages of m_pages
+      bool m_hasUnindexed; //!< Whether any entry must be found by linear search
+
+      //! Command in flight, tracked so its status returns to the source
+      struct SequenceTracker {
+        bool used; //!< Whether the entry is in use
+        U32 seq; //!< Dispatch sequence number
+        FwOpcodeType opCode; //!< Opcode dispatched
+        U32 context; //!< Context of the source
+        FwIndexType callerPort; //!< Port the command came in on
+      };
+      SequenceTracker m_sequenceTracker[CMD_DISPATCHER_SEQUENCER_TABLE_SIZE]; //!< Commands in flight
+
+      U32 m_seq; //!< Next dispatch sequence number
+      U32 m_numCmdsDispatched; //!< Commands dispatched
+      U32 m_numCmdErrors; //!< Commands failed
+  };
+
+}
+
+#endif
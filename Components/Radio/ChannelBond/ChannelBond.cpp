@@ -0,0 +1,270 @@
+// ======================================================================
+// \title  ChannelBond.cpp
+// \brief  cpp file for ChannelBond component implementation class
+// ======================================================================
+
+#include "Components/Radio/ChannelBond/ChannelBond.hpp"
+#include "FpConfig.hpp"
+#include <cstring>
+
+namespace Radio {
+
+  // ----------------------------------------------------------------------
+  // Component construction and destruction
+  // ----------------------------------------------------------------------
+
+  ChannelBond ::
+    ChannelBond(const char* const compName) :
+      ChannelBondComponentBase(compName),
+      m_nextLink(0),
+      m_txSeq(0),
+      m_held(0),
+      m_rxStarted(false),
+      m_rxNext(0),
+      m_waitTicks(0),
+      m_reordered(0),
+      m_skipped(0),
+      m_dropped(0),
+      m_telemetryTicks(0)
+  {
+    memset(m_busyUntilUs, 0, sizeof(m_busyUntilUs));
+    memset(m_linkChunks, 0, sizeof(m_linkChunks));
+  }
+
+  ChannelBond ::
+    ~ChannelBond()
+  {
+
+  }
+
+  // ----------------------------------------------------------------------
+  // Handler implementations for user-defined typed input ports
+  // ----------------------------------------------------------------------
+
+  Drv::SendStatus ChannelBond ::
+    comDataIn_handler(
+        FwIndexType portNum,
+        Fw::Buffer& sendBuffer
+    )
+  {
+    const U8* const data = sendBuffer.getData();
+    const U32 size = sendBuffer.getSize();
+    for (U32 offset = 0; offset < size; offset += ChannelBondCfg::CHUNK_BYTES) {
+      const U32 chunkBytes = FW_MIN(ChannelBondCfg::CHUNK_BYTES, size - offset);
+      const FwIndexType link = this->selectLink(HEADER_BYTES + chunkBytes);
+      if (link == NO_LINK) {
+        m_dropped++;
+        continue;
+      }
+      Fw::Buffer chunk = this->allocate_out(0, HEADER_BYTES + chunkBytes);
+      if (chunk.getSize() < HEADER_BYTES + chunkBytes) {
+        if (chunk.isValid()) {
+          this->deallocate_out(0, chunk);
+        }
+        m_dropped++;
+        continue;
+      }
+      // A chunk that is not sent is not numbered, so the receiver never waits for it
+      U8* const out = chunk.getData();
+      out[0] = static_cast<U8>(m_txSeq >> 8);
+      out[1] = static_cast<U8>(m_txSeq);
+      memcpy(&out[HEADER_BYTES], &data[offset], chunkBytes);
+      chunk.setSize(HEADER_BYTES + chunkBytes);
+      m_txSeq++;
+      m_linkChunks[link]++;
+      // The radio deallocates the chunk, whether it goes out or not
+      (void) this->linkDataOut_out(link, chunk);
+    }
+    this->deallocate_out(0, sendBuffer);
+    return Drv::SendStatus::SEND_OK;
+  }
+
+  void ChannelBond ::
+    linkDataIn_handler(
+        FwIndexType portNum,
+        Fw::Buffer& recvBuffer,
+        const Drv::RecvStatus& recvStatus
+    )
+  {
+    if ((recvStatus.e != Drv::RecvStatus::RECV_OK) || (recvBuffer.getSize() <= HEADER_BYTES)) {
+      m_dropped++;
+      this->deallocate_out(0, recvBuffer);
+      return;
+    }
+    const U8* const data = recvBuffer.getData();
+    const U16 seq = static_cast<U16>((data[0] << 8) | data[1]);
+    if (not m_rxStarted) {
+      m_rxStarted = true;
+      m_rxNext = seq;
+    }
+
+    const U16 ahead = static_cast<U16>(seq - m_rxNext);
+    const U16 behind = static_cast<U16>(m_rxNext - seq);
+    if ((behind > 0) && (behind <= ChannelBondCfg::REORDER_WINDOW)) {
+      // Passed on or given up on already
+      m_dropped++;
+      this->deallocate_out(0, recvBuffer);
+      return;
+    }
+    if (ahead >= ChannelBondCfg::REORDER_WINDOW) {
+      // Too far ahead to hold, or from a sender that restarted its numbering
+      this->flushWindow();
+      m_rxNext = seq;
+    }
+
+    Fw::Buffer& slot = m_window[seq % ChannelBondCfg::REORDER_WINDOW];
+    if (slot.getData() != nullptr) {
+      m_dropped++;
+      this->deallocate_out(0, recvBuffer);
+      return;
+    }
+    slot = recvBuffer;
+    m_held++;
+    if (seq != m_rxNext) {
+      m_reordered++;
+    }
+    this->deliverInOrder();
+  }
+
+  void ChannelBond ::
+    linkStatus_handler(
+        FwIndexType portNum,
+        Fw::Success& condition
+    )
+  {
+    if (this->isConnected_comStatus_OutputPort(0)) {
+      this->comStatus_out(0, condition);
+    }
+  }
+
+  void ChannelBond ::
+    run_handler(
+        FwIndexType portNum,
+        U32 context
+    )
+  {
+    if (m_held > 0) {
+      m_waitTicks++;
+      if (m_waitTicks >= ChannelBondCfg::REORDER_TIMEOUT_TICKS) {
+        this->skipGap();
+      }
+    }
+    m_telemetryTicks++;
+    if (m_telemetryTicks >= ChannelBondCfg::TELEMETRY_PERIOD_TICKS) {
+      m_telemetryTicks = 0;
+      this->updateTelemetry();
+    }
+  }
+
+  // ----------------------------------------------------------------------
+  // Helpers
+  // ----------------------------------------------------------------------
+
+  FwIndexType ChannelBond ::
+    selectLink(U32 chunkBytes)
+  {
+    const U64 now = this->nowUs();
+    FwIndexType best = NO_LINK;
+    U64 bestFinishUs = 0;
+    for (FwIndexType i = 0; i < ChannelBondLinks; i++) {
+      const FwIndexType link = (m_nextLink + i) % ChannelBondLinks;
+      if (not this->isConnected_linkDataOut_OutputPort(link) || not this->isConnected_linkLoad_OutputPort(link)) {
+        continue;
+      }
+      const LinkLoad load = this->linkLoad_out(link);
+      if (not load.getup() || (load.getbitRate() == 0)) {
+        continue;
+      }
+      const U64 airtimeUs =
+          static_cast<U64>(ChannelBondCfg::PACKET_OVERHEAD_BYTES + chunkBytes) * 8 * 1000000 / load.getbitRate();
+      // A lost chunk used its airtime too, so a lossy radio is charged more for each one that gets through
+      const U64 chargedUs = airtimeUs * 1000 / (1000 - FW_MIN(load.getlossPerMille(), static_cast<U16>(900)));
+      // Frames the radio is holding for a clear channel go out ahead of this chunk
+      const U64 startUs = FW_MAX(m_busyUntilUs[link], now + load.getqueued() * airtimeUs);
+      if ((best == NO_LINK) || (startUs + chargedUs < bestFinishUs)) {
+        best = link;
+        bestFinishUs = startUs + chargedUs;
+      }
+    }
+    if (best != NO_LINK) {
+      m_busyUntilUs[best] = bestFinishUs;
+      m_nextLink = (best + 1) % ChannelBondLinks;
+    }
+    return best;
+  }
+
+  void ChannelBond ::
+    deliverInOrder()
+  {
+    Fw::Buffer* slot = &m_window[m_rxNext % ChannelBondCfg::REORDER_WINDOW];
+    while (slot->getData() != nullptr) {
+      this->deliver(*slot);
+      *slot = Fw::Buffer();
+      m_held--;
+      m_rxNext++;
+      m_waitTicks = 0;
+      slot = &m_window[m_rxNext % ChannelBondCfg::REORDER_WINDOW];
+    }
+  }
+
+  void ChannelBond ::
+    skipGap()
+  {
+    if (m_held == 0) {
+      return;
+    }
+    while (m_window[m_rxNext % ChannelBondCfg::REORDER_WINDOW].getData() == nullptr) {
+      m_skipped++;
+      m_rxNext++;
+    }
+    this->deliverInOrder();
+  }
+
+  void ChannelBond ::
+    flushWindow()
+  {
+    while (m_held > 0) {
+      this->skipGap();
+    }
+    m_waitTicks = 0;
+  }
+
+  void ChannelBond ::
+    deliver(Fw::Buffer& buffer)
+  {
+    // The deframer deallocates the chunk, which stays inside the buffer it was allocated as
+    Fw::Buffer stream = buffer;
+    stream.setData(buffer.getData() + HEADER_BYTES);
+    stream.setSize(buffer.getSize() - HEADER_BYTES);
+    if (this->isConnected_comDataOut_OutputPort(0)) {
+      this->comDataOut_out(0, stream, Drv::RecvStatus::RECV_OK);
+    } else {
+      this->deallocate_out(0, buffer);
+    }
+  }
+
+  void ChannelBond ::
+    updateTelemetry()
+  {
+    LinkChunks chunks;
+    LinkUtilization utilization;
+    for (FwIndexType link = 0; link < ChannelBondLinks; link++) {
+      chunks[link] = m_linkChunks[link];
+      utilization[link] =
+          this->isConnected_linkLoad_OutputPort(link) ? this->linkLoad_out(link).getairtimePerMille() : 0;
+    }
+    this->tlmWrite_LinkChunksSent(chunks);
+    this->tlmWrite_LinkUtilization(utilization);
+    this->tlmWrite_ChunksReordered(m_reordered);
+    this->tlmWrite_ChunksSkipped(m_skipped);
+    this->tlmWrite_ChunksDropped(m_dropped);
+  }
+
+  U64 ChannelBond ::
+    nowUs()
+  {
+    const Fw::Time now = this->getTime();
+    return static_cast<U64>(now.getSeconds()) * 1000000 + now.getUSeconds();
+  }
+
+}
@@ -0,0 +1,129 @@
+// ======================================================================
+// \title  ChannelBond.hpp
+// \brief  hpp file for ChannelBond component implementation class
+// ======================================================================
+
+#ifndef Radio_ChannelBond_HPP
+#define Radio_ChannelBond_HPP
+
+#include "Components/Radio/ChannelBond/ChannelBondComponentAc.hpp"
+#include <config/ChannelBondCfg.hpp>
+
+namespace Radio {
+
+  //! Stripes the hub byte stream across several radios and reassembles it in order on the other side
+  //!
+  //! Frames are cut into chunks of ChannelBondCfg::CHUNK_BYTES, each numbered and sent whole in one radio packet.
+  //! Every chunk goes to the radio that would have it on the air soonest: each radio is charged the airtime of the
+  //! chunks it was given, at its bit rate and stretched by its loss, on top of the frames it still has queued for a
+  //! clear channel. Radios with equal loads take turns. The receiving bond holds chunks that arrive ahead of a
+  //! missing one and passes them on once it arrives or once it is given up as lost; the deframer resynchronizes on
+  //! the frame a lost chunk was part of.
+  class ChannelBond :
+    public ChannelBondComponentBase
+  {
+
+    public:
+
+      // ----------------------------------------------------------------------
+      // Component construction and destruction
+      // ----------------------------------------------------------------------
+
+      //! Construct ChannelBond object
+      ChannelBond(
+          const char* const compName //!< The component name
+      );
+
+      //! Destroy ChannelBond object
+      ~ChannelBond();
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Handler implementations for user-defined typed input ports
+      // ----------------------------------------------------------------------
+
+      //! Handler implementation for comDataIn
+      Drv::SendStatus comDataIn_handler(
+          FwIndexType portNum, //!< The port number
+          Fw::Buffer& sendBuffer //!< The frame
+      ) override;
+
+      //! Handler implementation for linkDataIn
+      void linkDataIn_handler(
+          FwIndexType portNum, //!< The port number
+          Fw::Buffer& recvBuffer, //!< The chunk
+          const Drv::RecvStatus& recvStatus //!< Status of the receive
+      ) override;
+
+      //! Handler implementation for linkStatus
+      void linkStatus_handler(
+          FwIndexType portNum, //!< The port number
+          Fw::Success& condition //!< Whether the radio came up
+      ) override;
+
+      //! Handler implementation for run
+      void run_handler(
+          FwIndexType portNum, //!< The port number
+          U32 context //!< The call order
+      ) override;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Helpers
+      // ----------------------------------------------------------------------
+
+      //! Radio to send a chunk of the given size on, or NO_LINK if none is up
+      FwIndexType selectLink(U32 chunkBytes);
+
+      //! Pass on the chunks held from the next one expected onward, up to the first missing one
+      void deliverInOrder();
+
+      //! Give up on the chunks missing ahead of the first one held, and pass on what follows in order
+      void skipGap();
+
+      //! Pass on every chunk held, giving up on the missing ones in between
+      void flushWindow();
+
+      //! Write the telemetry
+      void updateTelemetry();
+
+      //! Pass one chunk on to the deframer, without its sequence number
+      void deliver(Fw::Buffer& buffer);
+
+      //! Current time in microseconds
+      U64 nowUs();
+
+      //! Bytes of a chunk's sequence number
+      static const U32 HEADER_BYTES = sizeof(U16);
+
+      //! No radio
+      static const FwIndexType NO_LINK = -1;
+
+    PRIVATE:
+
+      // ----------------------------------------------------------------------
+      // Member variables
+      // ----------------------------------------------------------------------
+
+      FwIndexType m_nextLink; //!< Radio that wins a tie, moved on after every chunk
+      U64 m_busyUntilUs[ChannelBondLinks]; //!< Time each radio is done with the chunks it was given
+      U16 m_txSeq; //!< Sequence number of the next chunk sent
+
+      Fw::Buffer m_window[ChannelBondCfg::REORDER_WINDOW]; //!< Chunks held, by sequence number modulo the window
+      U32 m_held; //!< Chunks in the window
+      bool m_rxStarted; //!< Whether a chunk has been received
+      U16 m_rxNext; //!< Sequence number of the next chunk to pass on
+      U32 m_waitTicks; //!< Run calls the next chunk has been missing while later ones were held
+
+      U32 m_linkChunks[ChannelBondLinks]; //!< Chunks sent on each radio
+      U32 m_reordered; //!< Chunks held for an earlier one
+      U32 m_skipped; //!< Chunks given up on
+      U32 m_dropped; //!< Chunks dropped
+      U32 m_telemetryTicks; //!< Run calls since telemetry was written
+  };
+
+}
+
+#endif
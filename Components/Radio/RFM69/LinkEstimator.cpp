@@ -0,0 +1,115 @@
+// ======================================================================
+// \title  LinkEstimator.cpp
+// \brief  Link quality over fixed windows for the RFM69 component
+// ======================================================================
+
+#include <Components/Radio/RFM69/LinkEstimator.hpp>
+#include <config/RFM69Cfg.hpp>
+#include <cstring>
+
+namespace Radio {
+
+  LinkEstimator ::
+    LinkEstimator() :
+      m_windowOpen(false),
+      m_windowStartUs(0),
+      m_airtimeUs(0),
+      m_packetsLost(0)
+  {
+    memset(m_peers, 0, sizeof(m_peers));
+  }
+
+  void LinkEstimator ::
+    received(U8 peer, U8 seq, I16 rssi, U32 bytes, U32 airtimeUs, U64 nowUs)
+  {
+    if (peer == 0) {
+      // Not a node address; the packet still used the air
+      m_airtimeUs += airtimeUs;
+      return;
+    }
+    Peer& entry = this->lookup(peer);
+    if (entry.address == 0) {
+      entry.address = peer;
+      entry.rssiX16 = rssi * 16;
+    } else {
+      const U8 gap = static_cast<U8>(seq - entry.lastSeq - 1);
+      if (gap <= RFM69Cfg::MAX_SEQUENCE_GAP) {
+        entry.lost += gap;
+        m_packetsLost += gap;
+      }
+      entry.rssiX16 += (rssi * 16 - entry.rssiX16) / (1 << RFM69Cfg::RSSI_SMOOTHING_SHIFT);
+    }
+    entry.lastSeq = seq;
+    entry.lastHeardUs = nowUs;
+    entry.received++;
+    entry.bytes += bytes;
+    m_airtimeUs += airtimeUs;
+  }
+
+  void LinkEstimator ::
+    sent(U32 airtimeUs)
+  {
+    m_airtimeUs += airtimeUs;
+  }
+
+  bool LinkEstimator ::
+    closeWindow(U64 nowUs, Report& report)
+  {
+    if (not m_windowOpen) {
+      m_windowOpen = true;
+      m_windowStartUs = nowUs;
+      return false;
+    }
+    if (nowUs < m_windowStartUs) {
+      // The clock was stepped back by time synchronization; the window starts over
+      m_windowStartUs = nowUs;
+      m_airtimeUs = 0;
+      return false;
+    }
+    const U64 windowUs = nowUs - m_windowStartUs;
+    if (windowUs < RFM69Cfg::LINK_WINDOW_US) {
+      return false;
+    }
+
+    U64 bytes = 0;
+    for (U32 i = 0; i < PeerLinks::SIZE; i++) {
+      Peer& entry = m_peers[i];
+      const U32 sent = entry.received + entry.lost;
+      report.peers[i] = PeerLink(entry.address, static_cast<I16>(entry.rssiX16 / 16),
+                                 static_cast<U16>((sent > 0) ? (static_cast<U64>(entry.lost) * 1000 / sent) : 0),
+                                 static_cast<U32>(static_cast<U64>(entry.bytes) * 1000000 / windowUs));
+      bytes += entry.bytes;
+      entry.received = 0;
+      entry.lost = 0;
+      entry.bytes = 0;
+    }
+    report.goodput = static_cast<U32>(bytes * 1000000 / windowUs);
+    report.airtimePerMille = static_cast<U16>(FW_MIN(m_airtimeUs * 1000 / windowUs, static_cast<U64>(1000)));
+
+    m_windowStartUs = nowUs;
+    m_airtimeUs = 0;
+    return true;
+  }
+
+  LinkEstimator::Peer& LinkEstimator ::
+    lookup(U8 address)
+  {
+    U32 oldest = 0;
+    for (U32 i = 0; i < PeerLinks::SIZE; i++) {
+      if (m_peers[i].address == address) {
+        return m_peers[i];
+      }
+      if (m_peers[i].address == 0) {
+        oldest = i;
+        break;
+      }
+      if (m_peers[i].lastHeardUs < m_peers[oldest].lastHeardUs) {
+        oldest = i;
+      }
+    }
+    // A peer not in the table takes a free entry, or the one heard from least recently
+    memset(&m_peers[oldest], 0, sizeof(m_peers[oldest]));
+    return m_peers[oldest];
+  }
+
+}
@@ -0,0 +1,84 @@
+// ======================================================================
+// \title  LinkEstimator.hpp
+// \brief  Link quality over fixed windows for the RFM69 component
+// ======================================================================
+
+#ifndef RADIO_LINK_ESTIMATOR_HPP
+#define RADIO_LINK_ESTIMATOR_HPP
+
+#include <Components/Radio/RFM69/PeerLinksArrayAc.hpp>
+#include <FpConfig.hpp>
+
+namespace Radio {
+
+  //! Link quality over fixed windows, from the packets a radio sends and receives
+  //!
+  //! Each packet carries its sender's address and an 8-bit sequence number in the RadioHead header. Peers are tracked
+  //! by address; when the table is full the peer heard from least recently gives up its entry. A jump in a peer's
+  //! sequence numbers counts the skipped packets as lost, which gives the packet error rate without any traffic of
+  //! its own. Airtime is what the packets sent and received occupied on the air.
+  class LinkEstimator {
+
+    public:
+
+      //! Link quality published when a window closes
+      struct Report {
+        PeerLinks peers; //!< Quality of the link from each peer
+        U32 goodput; //!< Payload bytes received per second from all peers
+        U16 airtimePerMille; //!< Share of the window spent sending or receiving, per thousand
+      };
+
+      LinkEstimator();
+
+      //! Count a packet received
+      void received(
+          U8 peer, //!< Address of the sender
+          U8 seq, //!< Sequence number of the packet
+          I16 rssi, //!< Signal strength in dBm
+          U32 bytes, //!< Payload bytes
+          U32 airtimeUs, //!< Time the packet occupied the air
+          U64 nowUs //!< Time received
+      );
+
+      //! Count a packet sent
+      void sent(
+          U32 airtimeUs //!< Time the packet occupied the air
+      );
+
+      //! Close the window if it has run its length and start the next one
+      //!
+      //! \return true if a window closed, in which case the report is filled in
+      bool closeWindow(
+          U64 nowUs, //!< Time now
+          Report& report //!< The report for the window
+      );
+
+      //! Packets lost from all peers since startup
+      U32 packetsLost() const { return m_packetsLost; }
+
+    private:
+
+      //! A peer heard from
+      struct Peer {
+        U8 address; //!< Address, 0 if the entry is unused
+        U8 lastSeq; //!< Sequence number of the last packet received
+        I32 rssiX16; //!< Smoothed signal strength in 1/16 dBm
+        U64 lastHeardUs; //!< Time of the last packet received
+        U32 received; //!< Packets received in this window
+        U32 lost; //!< Packets lost in this window
+        U32 bytes; //!< Payload bytes received in this window
+      };
+
+      //! Entry for a peer, taking over the least recently heard one for a new peer
+      Peer& lookup(U8 address);
+
+      Peer m_peers[PeerLinks::SIZE]; //!< Peers heard from
+      bool m_windowOpen; //!< Whether a window has started
+      U64 m_windowStartUs; //!< Start of the current window
+      U64 m_airtimeUs; //!< Airtime used in this window
+      U32 m_packetsLost; //!< Packets lost since startup
+  };
+
+}
+
+#endif
@@ -0,0 +1,223 @@
+// ======================================================================
+// \title  PacketCapture.cpp
+// \brief  Ring of the packets an RFM69 radio sent and received, written out as pcap
+// ======================================================================
+
+#include <Components/Radio/RFM69/PacketCapture.hpp>
+#include <Fw/Types/Assert.hpp>
+
+#include <cstring>
+
+namespace Radio {
+
+  namespace {
+    void putU16(U8* out, U16 value) {
+      out[0] = static_cast<U8>(value >> 8);
+      out[1] = static_cast<U8>(value);
+    }
+
+    void putU32(U8* out, U32 value) {
+      for (U32 i = 0; i < 4; i++) {
+        out[i] = static_cast<U8>(value >> (24 - 8 * i));
+      }
+    }
+  }
+
+  PacketCapture ::
+    PacketCapture() :
+      m_head(0),
+      m_used(0),
+      m_packets(0),
+      m_first(0),
+      m_oldestUs(0),
+      m_newestUs(0),
+      m_overwritten(0),
+      m_readIndex(0),
+      m_readEnd(0),
+      m_readOffset(0),
+      m_readPreviousUs(0),
+      m_skipped(0)
+  {
+    memset(m_ring, 0, sizeof(m_ring));
+  }
+
+  void PacketCapture ::
+    add(const CapturedPacket& packet)
+  {
+    const I64 step = (m_packets == 0) ? 0 : static_cast<I64>(packet.timeUs - m_newestUs);
+    U8 flags = packet.sent ? FLAG_SENT : 0;
+    if ((step < static_cast<I64>(-0x7FFFFFFF - 1)) || (step > static_cast<I64>(0x7FFFFFFF))) {
+      flags |= FLAG_LONG_STEP;
+    }
+    const U32 size = ringSize(packet.size, flags);
+    FW_ASSERT(size <= sizeof(m_ring), size);
+    while (sizeof(m_ring) - m_used < size) {
+      this->evict();
+    }
+
+    U8 header[HEADER_FIXED + 8];
+    header[0] = packet.size;
+    header[1] = flags;
+    header[2] = static_cast<U8>(packet.rssi);
+    memcpy(&header[3], packet.header, CapturedPacket::HEADER_SIZE);
+    const U32 stepBytes = size - HEADER_FIXED - packet.size;
+    for (U32 i = 0; i < stepBytes; i++) {
+      header[HEADER_FIXED + i] = static_cast<U8>(static_cast<U64>(step) >> (8 * (stepBytes - 1 - i)));
+    }
+    const U32 tail = wrap(m_head + m_used);
+    this->copyIn(tail, header, HEADER_FIXED + stepBytes);
+    this->copyIn(wrap(tail + HEADER_FIXED + stepBytes), packet.payload, packet.size);
+
+    if (m_packets == 0) {
+      m_oldestUs = packet.timeUs;
+    }
+    m_newestUs = packet.timeUs;
+    m_used += size;
+    m_packets++;
+  }
+
+  void PacketCapture ::
+    clear()
+  {
+    m_first += m_packets;
+    m_head = 0;
+    m_used = 0;
+    m_packets = 0;
+    // The reader has nothing left to read
+    m_readIndex = m_first;
+    m_readEnd = m_first;
+    m_readOffset = 0;
+  }
+
+  void PacketCapture ::
+    startReading()
+  {
+    m_readIndex = m_first;
+    m_readEnd = m_first + m_packets;
+    m_readOffset = m_head;
+    m_skipped = 0;
+  }
+
+  bool PacketCapture ::
+    peek(CapturedPacket& packet) const
+  {
+    if (static_cast<I32>(m_readEnd - m_readIndex) <= 0) {
+      return false;
+    }
+    U8 header[HEADER_FIXED];
+    this->copyOut(m_readOffset, header, HEADER_FIXED);
+    packet.size = header[0];
+    packet.sent = (header[1] & FLAG_SENT) != 0;
+    packet.rssi = static_cast<I8>(header[2]);
+    memcpy(packet.header, &header[3], CapturedPacket::HEADER_SIZE);
+    // The oldest packet's own step is to a packet that is gone
+    packet.timeUs = (m_readIndex == m_first) ? m_oldestUs
+                                             : m_readPreviousUs + static_cast<U64>(this->stepAt(m_readOffset));
+    const U32 payloadOffset = wrap(m_readOffset + ringSize(packet.size, header[1]) - packet.size);
+    this->copyOut(payloadOffset, packet.payload, packet.size);
+    return true;
+  }
+
+  void PacketCapture ::
+    advance()
+  {
+    CapturedPacket packet;
+    if (not this->peek(packet)) {
+      return;
+    }
+    U8 header[2];
+    this->copyOut(m_readOffset, header, sizeof(header));
+    m_readOffset = wrap(m_readOffset + ringSize(header[0], header[1]));
+    m_readPreviousUs = packet.timeUs;
+    m_readIndex++;
+  }
+
+  U32 PacketCapture ::
+    pcapHeader(U8* out)
+  {
+    putU32(&out[0], PCAP_MAGIC);
+    // Version 2.4
+    putU16(&out[4], 2);
+    putU16(&out[6], 4);
+    // Time zone and timestamp accuracy, both unused
+    putU32(&out[8], 0);
+    putU32(&out[12], 0);
+    putU32(&out[16], PCAP_MAX_RECORD_SIZE - PCAP_RECORD_HEADER_SIZE);
+    putU32(&out[20], PCAP_LINK_TYPE);
+    return PCAP_HEADER_SIZE;
+  }
+
+  U32 PacketCapture ::
+    pcapRecord(const CapturedPacket& packet, U8* out)
+  {
+    const U32 captured = pcapRecordSize(packet) - PCAP_RECORD_HEADER_SIZE;
+    putU32(&out[0], static_cast<U32>(packet.timeUs / 1000000));
+    putU32(&out[4], static_cast<U32>(packet.timeUs % 1000000));
+    putU32(&out[8], captured);
+    putU32(&out[12], captured);
+    U8* const frame = &out[PCAP_RECORD_HEADER_SIZE];
+    frame[0] = packet.sent ? 1 : 0;
+    frame[1] = static_cast<U8>(packet.rssi);
+    memcpy(&frame[PCAP_PSEUDO_HEADER_SIZE], packet.header, CapturedPacket::HEADER_SIZE);
+    memcpy(&frame[PCAP_PSEUDO_HEADER_SIZE + CapturedPacket::HEADER_SIZE], packet.payload, packet.size);
+    return PCAP_RECORD_HEADER_SIZE + captured;
+  }
+
+  void PacketCapture ::
+    evict()
+  {
+    FW_ASSERT(m_packets > 0);
+    U8 header[2];
+    this->copyOut(m_head, header, sizeof(header));
+    const U32 size = ringSize(header[0], header[1]);
+    m_head = wrap(m_head + size);
+    m_used -= size;
+    m_packets--;
+    m_overwritten++;
+    if (m_packets > 0) {
+      m_oldestUs += static_cast<U64>(this->stepAt(m_head));
+    }
+    // A reader that has yet to read the packet overwritten moves on to the new oldest one
+    if ((m_readIndex == m_first) && (static_cast<I32>(m_readEnd - m_readIndex) > 0)) {
+      m_readIndex = m_first + 1;
+      m_readOffset = m_head;
+      m_skipped++;
+    }
+    m_first++;
+  }
+
+  I64 PacketCapture ::
+    stepAt(U32 offset) const
+  {
+    U8 header[HEADER_FIXED + 8];
+    this->copyOut(offset, header, HEADER_FIXED);
+    const U32 stepBytes = ringSize(header[0], header[1]) - HEADER_FIXED - header[0];
+    this->copyOut(wrap(offset + HEADER_FIXED), &header[HEADER_FIXED], stepBytes);
+    U64 step = 0;
+    for (U32 i = 0; i < stepBytes; i++) {
+      step = (step << 8) | header[HEADER_FIXED + i];
+    }
+    // A 4-byte step is sign extended
+    if (stepBytes == 4) {
+      return static_cast<I64>(static_cast<I32>(static_cast<U32>(step)));
+    }
+    return static_cast<I64>(step);
+  }
+
+  void PacketCapture ::
+    copyIn(U32 offset, const U8* data, U32 size)
+  {
+    const U32 first = FW_MIN(size, static_cast<U32>(sizeof(m_ring)) - offset);
+    memcpy(&m_ring[offset], data, first);
+    memcpy(&m_ring[0], &data[first], size - first);
+  }
+
+  void PacketCapture ::
+    copyOut(U32 offset, U8* data, U32 size) const
+  {
+    const U32 first = FW_MIN(size, static_cast<U32>(sizeof(m_ring)) - offset);
+    memcpy(data, &m_ring[offset], first);
+    memcpy(&data[first], &m_ring[0], size - first);
+  }
+
+}
@@ -0,0 +1,162 @@
+// ======================================================================
+// \title  PacketCapture.hpp
+// \brief  Ring of the packets an RFM69 radio sent and received, written out as pcap
+// ======================================================================
+
+#ifndef RADIO_PACKET_CAPTURE_HPP
+#define RADIO_PACKET_CAPTURE_HPP
+
+#include <FpConfig.hpp>
+#include <config/RFM69Cfg.hpp>
+
+namespace Radio {
+
+  //! A packet as it went over the air
+  struct CapturedPacket {
+    //! Bytes in a RadioHead header
+    static const U32 HEADER_SIZE = 4;
+    //! Most payload bytes a packet can have, from its one-byte size
+    static const U32 MAX_PAYLOAD = 255;
+
+    U64 timeUs; //!< When it left the air or was ready to be read, on the node's clock
+    bool sent; //!< Whether this node sent it
+    I8 rssi; //!< Signal strength in dBm of a packet received, 0 for one sent
+    U8 header[HEADER_SIZE]; //!< RadioHead header: to, from, id and flags
+    U8 size; //!< Payload bytes
+    U8 payload[MAX_PAYLOAD]; //!< Payload as it was on the air, decrypted if the radio decrypts
+  };
+
+  //! The packets a radio sent and received, newest kept, and their pcap encoding
+  //!
+  //! Packets are held back to back in a byte ring of RFM69Cfg::CAPTURE_BUFFER_SIZE, each behind an 11-byte header
+  //! that stores its time as the signed microseconds since the packet before it. A step of the clock longer than an
+  //! I32 takes 4 bytes more. When the ring is full the oldest packets make room for the new one.
+  //!
+  //! One reader walks the packets captured up to when it started, oldest first, while capture goes on. Packets
+  //! overwritten before the reader gets to them are skipped and counted.
+  //!
+  //! In pcap each packet is a record of link type LINKTYPE_USER0: a direction byte (0 received, 1 sent), the RSSI as
+  //! a signed byte, the RadioHead header and the payload. Every field is big-endian, which readers tell from the
+  //! magic number.
+  class PacketCapture {
+
+    public:
+
+      //! pcap magic number for microsecond timestamps
+      static const U32 PCAP_MAGIC = 0xA1B2C3D4;
+      //! pcap link type of the records: LINKTYPE_USER0
+      static const U32 PCAP_LINK_TYPE = 147;
+      //! Bytes in the pcap file header
+      static const U32 PCAP_HEADER_SIZE = 24;
+      //! Bytes in a pcap record header
+      static const U32 PCAP_RECORD_HEADER_SIZE = 16;
+      //! Bytes ahead of the RadioHead header in a pcap record: direction and RSSI
+      static const U32 PCAP_PSEUDO_HEADER_SIZE = 2;
+      //! Longest pcap record
+      static const U32 PCAP_MAX_RECORD_SIZE = PCAP_RECORD_HEADER_SIZE + PCAP_PSEUDO_HEADER_SIZE +
+                                              CapturedPacket::HEADER_SIZE + CapturedPacket::MAX_PAYLOAD;
+
+      PacketCapture();
+
+      //! Add a packet, overwriting the oldest ones if there is no room
+      void add(
+          const CapturedPacket& packet //!< The packet
+      );
+
+      //! Drop every packet
+      void clear();
+
+      //! Start the reader at the oldest packet; it reads up to the newest one captured now
+      void startReading();
+
+      //! The packet at the reader, without moving on
+      //!
+      //! \return false once the reader has read every packet
+      bool peek(
+          CapturedPacket& packet //!< The packet
+      ) const;
+
+      //! Move the reader on to the next packet
+      void advance();
+
+      //! Packets held
+      U32 packets() const { return m_packets; }
+
+      //! Packets overwritten since startup
+      U32 overwritten() const { return m_overwritten; }
+
+      //! Packets overwritten before the reader got to them since it started
+      U32 skipped() const { return m_skipped; }
+
+      //! Write the pcap file header
+      //!
+      //! \return bytes written, PCAP_HEADER_SIZE
+      static U32 pcapHeader(
+          U8* out //!< At least PCAP_HEADER_SIZE bytes
+      );
+
+      //! Bytes in the pcap record of a packet
+      static U32 pcapRecordSize(
+          const CapturedPacket& packet //!< The packet
+      ) {
+        return PCAP_RECORD_HEADER_SIZE + PCAP_PSEUDO_HEADER_SIZE + CapturedPacket::HEADER_SIZE + packet.size;
+      }
+
+      //! Write the pcap record of a packet
+      //!
+      //! \return bytes written, pcapRecordSize(packet)
+      static U32 pcapRecord(
+          const CapturedPacket& packet, //!< The packet
+          U8* out //!< At least pcapRecordSize(packet) bytes
+      );
+
+    private:
+
+      //! Ring header bytes: size, flags and RSSI, then the RadioHead header, then the time step
+      static const U32 HEADER_FIXED = 3 + CapturedPacket::HEADER_SIZE;
+
+      //! Flags of a packet in the ring
+      enum Flags {
+        FLAG_SENT = 0x01, //!< This node sent it
+        FLAG_LONG_STEP = 0x02 //!< Its time step takes 8 bytes instead of 4
+      };
+
+      //! Bytes a packet takes in the ring
+      static U32 ringSize(U8 size, U8 flags) {
+        return HEADER_FIXED + (((flags & FLAG_LONG_STEP) != 0) ? 8 : 4) + size;
+      }
+
+      //! Drop the oldest packet
+      void evict();
+
+      //! Time step of the packet at an offset
+      I64 stepAt(U32 offset) const;
+
+      //! Copy into the ring at an offset, wrapping at the end
+      void copyIn(U32 offset, const U8* data, U32 size);
+
+      //! Copy out of the ring from an offset, wrapping at the end
+      void copyOut(U32 offset, U8* data, U32 size) const;
+
+      //! An offset past the end of the ring brought back to the start
+      static U32 wrap(U32 offset) { return offset % RFM69Cfg::CAPTURE_BUFFER_SIZE; }
+
+      U8 m_ring[RFM69Cfg::CAPTURE_BUFFER_SIZE]; //!< Packets, oldest at m_head
+      U32 m_head; //!< Offset of the oldest packet
+      U32 m_used; //!< Bytes held
+      U32 m_packets; //!< Packets held
+      U32 m_first; //!< Number of the oldest packet, counting every packet ever added
+      U64 m_oldestUs; //!< Time of the oldest packet
+      U64 m_newestUs; //!< Time of the newest packet
+      U32 m_overwritten; //!< Packets overwritten since startup
+
+      U32 m_readIndex; //!< Number of the packet at the reader
+      U32 m_readEnd; //!< Number of the packet after the last one the reader reads
+      U32 m_readOffset; //!< Offset of the packet at the reader
+      U64 m_readPreviousUs; //!< Time of the packet the reader last moved past
+      U32 m_skipped; //!< Packets overwritten before the reader got to them
+  };
+
+}
+
+#endif
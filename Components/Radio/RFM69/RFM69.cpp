@@ -7,6 +7,7 @@
 #include <Components/Radio/RFM69/RFM69.hpp>
 #include <FpConfig.hpp>
 #include <Os/Log.hpp>
+#include <cstring>
 
 namespace Radio {
 
@@ -19,27 +20,84 @@ RFM69::RFM69(const char* const compName)
       rfm69(RFM69_CS, RFM69_INT),
       radio_state(Fw::On::OFF),
       pkt_rx_count(0),
-      pkt_tx_count(0) {
+      pkt_tx_count(0),
+      bring_up_state(BRING_UP_RESET),
+      backoff_ticks(0),
+      backoff_remaining(0),
+      settle_remaining(0),
+      init_attempts(0),
+      tx_seq(0),
+      modem_profile(ModemProfile::GFSK_Rb250Fd250),
+      csma_enabled(true),
+      csma_threshold(-90),
+      tx_queue_head(0),
+      tx_queue_count(0),
+      tx_queue_overflows(0),
+      csma_attempts(0),
+      csma_backoff_remaining(0),
+      csma_random(1),
+      csma_sampling(false),
+      csma_wait_start_us(0),
+      csma_samples(0),
+      csma_busy_samples(0),
+      csma_wait_us(0),
+      encryption_enabled(false),
+      decryption_failures(0),
+      address_filter(AddressFilter::HARDWARE),
+      node_address(1),
+      peer_address(RH_BROADCAST_ADDRESS),
+      pkt_filtered(0),
+      link_loss_per_mille(0),
+      link_airtime_per_mille(0),
+      time_source(0),
+      time_sync_state(TIME_SYNC_IDLE),
+      time_sync_seq(0),
+      time_sync_countdown(0),
+      time_sync_request_sent_us(0),
+      time_sync_request_received_us(0),
+      time_sync_response_received_us(0),
+      follow_up_pending(false),
+      follow_up_to(0),
+      follow_up_seq(0),
+      follow_up_sent_us(0),
+      capture_enabled(true),
+      capture_dumping(false),
+      capture_dump_requests(0),
+      capture_clear_requests(0),
+      capture_dumps_served(0),
+      capture_clears_served(0),
+      capture_waits(0),
+      capture_dumped_packets(0),
+      capture_containers(0),
+      published_settings(),
+      param_updates(0),
+      params_applied(0) {
 }
 
 RFM69::~RFM69() {}
 
+void RFM69::configurePins(U8 chipSelectPin, U8 interruptPin) {
+    FW_ASSERT(bring_up_state == BRING_UP_RESET, bring_up_state);
+    rfm69.setPins(chipSelectPin, interruptPin);
+}
+
 bool RFM69::send(const U8* payload, NATIVE_UINT_TYPE len) {
     FW_ASSERT(payload != nullptr);
 
+    const U8 maxPayload = this->maxPayload();
     NATIVE_UINT_TYPE offset = 0;
-    while (len > RH_RF69_MAX_MESSAGE_LEN) {
-        rfm69.send(&payload[offset], RH_RF69_MAX_MESSAGE_LEN);
-        if (!rfm69.waitPacketSent(500)) {
+    while (len > maxPayload) {
+        if (!this->sendPacket(&payload[offset], maxPayload)) {
             return false;
         }
+#ifdef ARDUINO
         delay(1);
-        offset += RH_RF69_MAX_MESSAGE_LEN;
-        len -= RH_RF69_MAX_MESSAGE_LEN;
+#endif
+        offset += maxPayload;
+        len -= maxPayload;
     }
 
-    rfm69.send(&payload[offset], len);
-    if (!rfm69.waitPacketSent(500)) {
+    if (!this->sendPacket(&payload[offset], static_cast<U8>(len))) {
         return false;
     }
 
@@ -55,21 +113,106 @@ bool RFM69::send(const U8* payload, NATIVE_UINT_TYPE len) {
     return true;
 }
 
+bool RFM69::sendPacket(const U8* data, U8 len) {
+    FW_ASSERT(len <= this->maxPayload(), len);
+    U8 packet[RH_RF69_MAX_MESSAGE_LEN];
+    U8 size = 0;
+    if (encryption_enabled) {
+        packet[size++] = static_cast<U8>(RFM69Cfg::KEY_CHECK_VALUE >> 8);
+        packet[size++] = static_cast<U8>(RFM69Cfg::KEY_CHECK_VALUE);
+    }
+    memcpy(&packet[size], data, len);
+    size += len;
+
+    // Receivers count the gaps in each sender's sequence numbers as lost packets
+    const U8 id = tx_seq++;
+    rfm69.setHeaderId(id);
+    // Transmitting switches the receiver off, which ends a channel measurement
+    csma_sampling = false;
+    rfm69.send(packet, size);
+    if (!rfm69.waitPacketSent(500)) {
+        return false;
+    }
+    const U8 header[CapturedPacket::HEADER_SIZE] = {rfm69.txHeaderTo(), node_address, id, rfm69.txHeaderFlags()};
+    this->capturePacket(true, header, 0, this->stampUs(rfm69.txDoneCounter()), packet, size);
+    link_estimator.sent(airtimeUs(modem_profile, size));
+    return true;
+}
+
+U8 RFM69::maxPayload() const {
+    return encryption_enabled ? (RH_RF69_MAX_MESSAGE_LEN - RFM69Cfg::KEY_CHECK_SIZE) : RH_RF69_MAX_MESSAGE_LEN;
+}
+
+#ifndef ARDUINO
+void RFM69::configureLink(U16 localPort, U16 peerPort) {
+    rfm69.setLink(localPort, peerPort);
+}
+
+void RFM69::configureMedium(SimRadioMedium& medium) {
+    rfm69.setMedium(medium);
+}
+
+void RFM69::configureClock(const SimRadioClock& clock) {
+    rfm69.setClock(clock);
+}
+#endif
+
 void RFM69::recv() {
     if (rfm69.available()) {
         U8 buf[RH_RF69_MAX_MESSAGE_LEN];
         U8 bytes_recv = RH_RF69_MAX_MESSAGE_LEN;
 
         if (rfm69.recv(buf, &bytes_recv)) {
-            Fw::Buffer recvBuffer = this->allocate_out(0, bytes_recv);
-            memcpy(recvBuffer.getData(), buf, bytes_recv);
-            recvBuffer.setSize(bytes_recv);
+            // The radio left receive to hand the packet over, which ended any channel measurement
+            csma_sampling = false;
+            // Captured before any check, so packets that fail one are on record too
+            const U8 header[CapturedPacket::HEADER_SIZE] = {rfm69.headerTo(), rfm69.headerFrom(), rfm69.headerId(),
+                                                            rfm69.headerFlags()};
+            this->capturePacket(false, header, static_cast<I8>(rfm69.lastRssi()),
+                                this->stampUs(rfm69.rxReadyCounter()), buf, bytes_recv);
+            // Without a key there is nothing to check: a packet encrypted by the peer arrives as noise
+            U8 offset = 0;
+            if (encryption_enabled) {
+                if ((bytes_recv < RFM69Cfg::KEY_CHECK_SIZE) ||
+                    (((static_cast<U16>(buf[0]) << 8) | buf[1]) != RFM69Cfg::KEY_CHECK_VALUE)) {
+                    decryption_failures++;
+                    this->tlmWrite_DecryptionFailures(decryption_failures);
+                    return;
+                }
+                offset = RFM69Cfg::KEY_CHECK_SIZE;
+            }
+            const U8* payload = &buf[offset];
+            const U8 size = static_cast<U8>(bytes_recv - offset);
+            // The hardware filter already dropped these in the radio; this catches them when it is off
+            const U8 to = rfm69.headerTo();
+            if ((address_filter != AddressFilter::OFF) && (to != node_address) && (to != RH_BROADCAST_ADDRESS)) {
+                pkt_filtered++;
+                this->tlmWrite_PacketsFiltered(pkt_filtered);
+                return;
+            }
+            link_estimator.received(rfm69.headerFrom(), rfm69.headerId(), rfm69.lastRssi(), bytes_recv,
+                                    airtimeUs(modem_profile, bytes_recv), this->nowUs());
+            this->tlmWrite_RSSI(rfm69.lastRssi());
+
+            // The tail of a frame longer than a packet could pass for one, but then also has to have the length of
+            // one; its frame then fails its checksum, as if the packet had been lost
+            if ((size > 0) && (payload[0] == RFM69Cfg::TIME_SYNC_MARKER) &&
+                ((size == TIME_SYNC_REQUEST_SIZE) || (size == TIME_SYNC_TIMESTAMPED_SIZE))) {
+                // Time synchronization is between two nodes; with the filter off others' exchanges are heard too
+                if (to == node_address) {
+                    this->timeSyncReceived(payload, size, rfm69.headerFrom(), this->stampUs(rfm69.rxReadyCounter()));
+                }
+                return;
+            }
+
+            Fw::Buffer recvBuffer = this->allocate_out(0, size);
+            memcpy(recvBuffer.getData(), payload, size);
+            recvBuffer.setSize(size);
             pkt_rx_count++;
 
             this->log_DIAGNOSTIC_PayloadMessageRX(recvBuffer.getSize());
 
             this->tlmWrite_NumPacketsReceived(pkt_rx_count);
-            this->tlmWrite_RSSI(rfm69.lastRssi());
 
             this->comDataOut_out(0, recvBuffer, Drv::RecvStatus::RECV_OK);
         }
@@ -81,44 +224,601 @@ void RFM69::recv() {
 // ----------------------------------------------------------------------
 
 Drv::SendStatus RFM69 ::comDataIn_handler(const NATIVE_INT_TYPE portNum, Fw::Buffer& sendBuffer) {
-    if ((radio_state == Fw::On::ON) && (sendBuffer.getSize() > 0) &&
-        (not this->send(sendBuffer.getData(), sendBuffer.getSize()))) {
-        radio_state = Fw::On::OFF;
+    if ((radio_state != Fw::On::ON) || (sendBuffer.getSize() == 0)) {
+        deallocate_out(0, sendBuffer);
+        return Drv::SendStatus::SEND_OK;
     }
-    deallocate_out(0, sendBuffer);
 
+    if (tx_queue_count == RFM69Cfg::TX_QUEUE_DEPTH) {
+        tx_queue_overflows++;
+        this->tlmWrite_TxQueueOverflows(tx_queue_overflows);
+        deallocate_out(0, sendBuffer);
+        return Drv::SendStatus::SEND_OK;
+    }
+    tx_queue[(tx_queue_head + tx_queue_count) % RFM69Cfg::TX_QUEUE_DEPTH] = sendBuffer;
+    tx_queue_count++;
+
+    // Sent by the next run call once it has sampled the channel, so nothing here waits on the radio
     return Drv::SendStatus::SEND_OK;  // Always send ok to deframer as it does not handle this anyway
 }
 
+LinkLoad RFM69 ::linkLoadGet_handler(const NATIVE_INT_TYPE portNum) {
+    return LinkLoad(radio_state == Fw::On::ON, tx_queue_count, bitRate(modem_profile), link_loss_per_mille,
+                    link_airtime_per_mille);
+}
+
 void RFM69 ::run_handler(const NATIVE_INT_TYPE portNum, NATIVE_UINT_TYPE context) {
     this->tlmWrite_Status(radio_state);
+    // A dump goes on while the radio is down, which is when it is most wanted
+    this->serviceCaptureRequests();
+    this->serviceCaptureDump();
 
     if (radio_state == Fw::On::OFF) {
-        if (this->isConnected_gpioReset_OutputPort(0)) {
-            this->gpioReset_out(0, Fw::Logic::HIGH);
-            delay(10);
-            this->gpioReset_out(0, Fw::Logic::LOW);
-            delay(10);
+        this->bringUp();
+        return;
+    }
+
+    // Parameters set since the last run are applied here, on the thread that owns the SPI bus
+    if (param_updates.load(std::memory_order_acquire) != params_applied) {
+        this->configureRadio();
+    }
+
+    // A follow-up owed from the last poll goes out before anything received now is answered
+    this->serviceTimeSync();
+    if (csma_backoff_remaining > 0) {
+        csma_backoff_remaining--;
+    }
+    // Started before receiving, so at the faster profiles the measurement is done by the time the queue is serviced
+    if (csma_enabled && (tx_queue_count > 0) && (csma_backoff_remaining == 0) && not csma_sampling) {
+        csma_sampling = rfm69.startRssi();
+    }
+    this->recv();
+    this->serviceQueue();
+    this->reportLink();
+}
+
+void RFM69 ::serviceQueue() {
+    if ((tx_queue_count == 0) || (csma_backoff_remaining > 0)) {
+        return;
+    }
+    const ChannelSample sample = csma_enabled ? this->sampleChannel() : CHANNEL_CLEAR;
+    if (sample == CHANNEL_UNSAMPLED) {
+        // Read on the next call, without counting against the frame
+        return;
+    }
+    if (sample == CHANNEL_BUSY) {
+        if (csma_attempts == 0) {
+            csma_wait_start_us = this->nowUs();
+        }
+        csma_attempts++;
+        if (csma_attempts < RFM69Cfg::CSMA_MAX_ATTEMPTS) {
+            // Binary exponential backoff: wait 1 to 2^attempts run calls, the window capped at the maximum
+            const U32 exponent = FW_MIN(csma_attempts, RFM69Cfg::CSMA_MAX_BACKOFF_EXPONENT);
+            csma_backoff_remaining = 1 + this->nextRandom() % (static_cast<U32>(1) << exponent);
+            return;
         }
+    }
+    if (csma_attempts > 0) {
+        // Unless the clock was stepped back by time synchronization while the frame waited
+        const U64 now = this->nowUs();
+        csma_wait_us += (now > csma_wait_start_us) ? (now - csma_wait_start_us) : 0;
+        csma_attempts = 0;
+    }
 
-        if (!rfm69.init()) {
-            Fw::Logger::logMsg("Failed to initialize radio... Trying again...\n");
+    // One clear sample lets the queue out back to back: from the first packet on, other nodes hear the channel busy
+    const U32 start = rfm69.counterUs();
+    while (tx_queue_count > 0) {
+        Fw::Buffer buffer = tx_queue[tx_queue_head];
+        tx_queue_head = (tx_queue_head + 1) % RFM69Cfg::TX_QUEUE_DEPTH;
+        tx_queue_count--;
+        const bool sent = this->send(buffer.getData(), buffer.getSize());
+        deallocate_out(0, buffer);
+        if (not sent) {
+            this->restartRadio();
             return;
         }
+        if ((rfm69.counterUs() - start) >= RFM69Cfg::SEND_TIME_LIMIT_US) {
+            return;
+        }
+    }
+}
 
-        rfm69.setFrequency(RFM69_FREQ);
-        rfm69.setModemConfig(RH_RF69::ModemConfigChoice::GFSK_Rb250Fd250);
-        rfm69.setTxPower(14, true);
+void RFM69 ::restartRadio() {
+    radio_state = Fw::On::OFF;
+    bring_up_state = BRING_UP_RESET;
+    this->flushQueue();
+}
 
-        Fw::Success radioSuccess = Fw::Success::SUCCESS;
-        if (this->isConnected_comStatus_OutputPort(0)) {
-            this->comStatus_out(0, radioSuccess);
+void RFM69 ::serviceTimeSync() {
+    // The follow-up waits a poll after its response, by when the client has read the response out of its radio
+    if (follow_up_pending) {
+        follow_up_pending = false;
+        if (not this->sendTimeSync(follow_up_to, TIME_SYNC_FOLLOW_UP, follow_up_seq, follow_up_sent_us)) {
+            return;
         }
+    }
 
-        radio_state = Fw::On::ON;
+    if ((time_source == 0) || (time_source == node_address)) {
+        return;
+    }
+    // Counted in run calls, as the clock itself moves when an exchange completes
+    if (time_sync_countdown > 0) {
+        time_sync_countdown--;
+        return;
+    }
+    time_sync_countdown = RFM69Cfg::TIME_SYNC_PERIOD_TICKS - 1;
+    // An exchange still in progress has lost a packet and is abandoned
+    time_sync_seq++;
+    time_sync_state = TIME_SYNC_IDLE;
+    if (this->sendTimeSync(time_source, TIME_SYNC_REQUEST, time_sync_seq, 0)) {
+        time_sync_request_sent_us = this->stampUs(rfm69.txDoneCounter());
+        time_sync_state = TIME_SYNC_AWAIT_RESPONSE;
     }
+}
 
-    this->recv();
+void RFM69 ::timeSyncReceived(const U8* data, U8 len, U8 from, U64 receivedUs) {
+    if (len < TIME_SYNC_REQUEST_SIZE) {
+        return;
+    }
+    const U8 type = data[1];
+    const U8 seq = data[2];
+    U64 timestamp = 0;
+    if (len >= TIME_SYNC_TIMESTAMPED_SIZE) {
+        for (U32 i = TIME_SYNC_REQUEST_SIZE; i < TIME_SYNC_TIMESTAMPED_SIZE; i++) {
+            timestamp = (timestamp << 8) | data[i];
+        }
+    } else if (type != TIME_SYNC_REQUEST) {
+        return;
+    }
+
+    switch (type) {
+        case TIME_SYNC_REQUEST:
+            if ((time_source == 0) || (time_source != node_address)) {
+                break;
+            }
+            if (this->sendTimeSync(from, TIME_SYNC_RESPONSE, seq, receivedUs)) {
+                follow_up_pending = true;
+                follow_up_to = from;
+                follow_up_seq = seq;
+                follow_up_sent_us = this->stampUs(rfm69.txDoneCounter());
+            }
+            break;
+        case TIME_SYNC_RESPONSE:
+            if ((from == time_source) && (time_sync_state == TIME_SYNC_AWAIT_RESPONSE) && (seq == time_sync_seq)) {
+                time_sync_request_received_us = timestamp;
+                time_sync_response_received_us = receivedUs;
+                time_sync_state = TIME_SYNC_AWAIT_FOLLOW_UP;
+            }
+            break;
+        case TIME_SYNC_FOLLOW_UP:
+            if ((from == time_source) && (time_sync_state == TIME_SYNC_AWAIT_FOLLOW_UP) && (seq == time_sync_seq)) {
+                time_sync_state = TIME_SYNC_IDLE;
+                if (this->isConnected_clockExchange_OutputPort(0)) {
+                    this->clockExchange_out(0, time_sync_request_sent_us, time_sync_request_received_us, timestamp,
+                                            time_sync_response_received_us);
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+bool RFM69 ::sendTimeSync(U8 to, U8 type, U8 seq, U64 timestampUs) {
+    U8 packet[TIME_SYNC_TIMESTAMPED_SIZE];
+    packet[0] = RFM69Cfg::TIME_SYNC_MARKER;
+    packet[1] = type;
+    packet[2] = seq;
+    for (U32 i = TIME_SYNC_REQUEST_SIZE; i < TIME_SYNC_TIMESTAMPED_SIZE; i++) {
+        packet[i] = static_cast<U8>(timestampUs >> (8 * (TIME_SYNC_TIMESTAMPED_SIZE - 1 - i)));
+    }
+    const U8 len = (type == TIME_SYNC_REQUEST) ? TIME_SYNC_REQUEST_SIZE : TIME_SYNC_TIMESTAMPED_SIZE;
+
+    rfm69.setHeaderTo(to);
+    const bool sent = this->sendPacket(packet, len);
+    rfm69.setHeaderTo(peer_address);
+    if (not sent) {
+        this->restartRadio();
+    }
+    return sent;
+}
+
+U64 RFM69 ::stampUs(U32 counter) {
+    // The counter and the clock run on the same oscillator, so the age of the timestamp carries over to the clock
+    const I32 age = static_cast<I32>(rfm69.counterUs() - counter);
+    return static_cast<U64>(static_cast<I64>(this->nowUs()) - age);
+}
+
+RFM69::ChannelSample RFM69 ::sampleChannel() {
+    if (not csma_sampling) {
+        // Read on a later call, so nothing waits for the receiver to start up and measure
+        csma_sampling = rfm69.startRssi();
+        return CHANNEL_UNSAMPLED;
+    }
+    I8 rssi = 0;
+    if (not rfm69.readRssi(rssi)) {
+        return CHANNEL_UNSAMPLED;
+    }
+    csma_sampling = false;
+    csma_samples++;
+    if (rssi >= csma_threshold) {
+        csma_busy_samples++;
+        return CHANNEL_BUSY;
+    }
+    return CHANNEL_CLEAR;
+}
+
+void RFM69 ::flushQueue() {
+    while (tx_queue_count > 0) {
+        deallocate_out(0, tx_queue[tx_queue_head]);
+        tx_queue_head = (tx_queue_head + 1) % RFM69Cfg::TX_QUEUE_DEPTH;
+        tx_queue_count--;
+    }
+    csma_attempts = 0;
+    csma_backoff_remaining = 0;
+    csma_sampling = false;
+}
+
+void RFM69 ::installKey(const AesKey& key) {
+    U8 bytes[AesKey::SIZE];
+    bool enabled = false;
+    for (U32 i = 0; i < AesKey::SIZE; i++) {
+        bytes[i] = key[i];
+        enabled = enabled || (bytes[i] != 0);
+    }
+    // The engine takes the new key between packets, so the link switches over without a reset
+    rfm69.setEncryptionKey(enabled ? bytes : nullptr);
+    encryption_enabled = enabled;
+    if (not(key == encryption_key)) {
+        encryption_key = key;
+        this->log_ACTIVITY_HI_EncryptionKeyChanged(enabled);
+    }
+}
+
+void RFM69 ::configureAddressFilter(const AddressFilter& filter, U8 address) {
+    // RadioHead's "to" header is the first byte after the length, where the packet engine expects the address byte
+    U8 packetConfig = rfm69.spiRead(RH_RF69_REG_37_PACKETCONFIG1) & ~RH_RF69_PACKETCONFIG1_ADDRESSFILTERING;
+    if (filter == AddressFilter::HARDWARE) {
+        rfm69.spiWrite(RH_RF69_REG_39_NODEADRS, address);
+        rfm69.spiWrite(RH_RF69_REG_3A_BROADCASTADRS, RH_BROADCAST_ADDRESS);
+        packetConfig |= RH_RF69_PACKETCONFIG1_ADDRESSFILTERING_NODE_BC;
+    }
+    rfm69.spiWrite(RH_RF69_REG_37_PACKETCONFIG1, packetConfig);
+}
+
+U32 RFM69 ::nextRandom() {
+    // xorshift32; nodes seeded with different addresses back off differently
+    csma_random ^= csma_random << 13;
+    csma_random ^= csma_random >> 17;
+    csma_random ^= csma_random << 5;
+    return csma_random;
+}
+
+void RFM69 ::parameterUpdated(FwPrmIdType id) {
+    // Called on the thread that ran PRM_SET, which may be on the other core from the radio
+    this->publishSettings();
+}
+
+void RFM69 ::parametersLoaded() {
+    this->publishSettings();
+}
+
+void RFM69 ::publishSettings() {
+    // The parameter storage is guarded by an Os::Mutex, which does not keep out the other core, so the radio reads
+    // this copy. param_updates is odd while it is being written.
+    Fw::ParamValid valid;
+    Settings settings;
+    settings.frequency = this->paramGet_FREQUENCY(valid);
+    settings.power = this->paramGet_TX_POWER(valid);
+    settings.profile = this->paramGet_MODEM_PROFILE(valid);
+    settings.address = this->paramGet_NODE_ADDRESS(valid);
+    settings.peer = this->paramGet_PEER_ADDRESS(valid);
+    settings.filter = this->paramGet_ADDRESS_FILTER(valid);
+    settings.source = this->paramGet_TIME_SOURCE(valid);
+    settings.captureEnabled = this->paramGet_CAPTURE_ENABLED(valid);
+    settings.csmaEnabled = this->paramGet_CSMA_ENABLED(valid);
+    settings.csmaThreshold = this->paramGet_CSMA_THRESHOLD(valid);
+    settings.key = this->paramGet_ENCRYPTION_KEY(valid);
+
+    settings_lock.lock();
+    const U32 updates = param_updates.load(std::memory_order_relaxed);
+    param_updates.store(updates + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    published_settings = settings;
+    param_updates.store(updates + 2, std::memory_order_release);
+    settings_lock.unLock();
+}
+
+void RFM69 ::readSettings(Settings& settings) {
+    U32 updates = 0;
+    do {
+        updates = param_updates.load(std::memory_order_acquire);
+        settings = published_settings;
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while (((updates & 1) != 0) || (param_updates.load(std::memory_order_relaxed) != updates));
+    params_applied = updates;
+}
+
+// ----------------------------------------------------------------------
+// Command handler implementations
+// ----------------------------------------------------------------------
+
+void RFM69 ::CAPTURE_DUMP_cmdHandler(FwOpcodeType opCode, U32 cmdSeq) {
+    // A radio bonded to another shares its data products with nothing
+    if (not this->isConnected_productGetOut_OutputPort(0)) {
+        this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::EXECUTION_ERROR);
+        return;
+    }
+    if (capture_dumping.load(std::memory_order_acquire)) {
+        this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::BUSY);
+        return;
+    }
+    // The capture ring belongs to the radio's thread, which may be on the other core; the dump starts on its next run
+    capture_dump_requests.store(capture_dump_requests.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::OK);
+}
+
+void RFM69 ::CAPTURE_CLEAR_cmdHandler(FwOpcodeType opCode, U32 cmdSeq) {
+    capture_clear_requests.store(capture_clear_requests.load(std::memory_order_relaxed) + 1,
+                                 std::memory_order_release);
+    this->cmdResponse_out(opCode, cmdSeq, Fw::CmdResponse::OK);
+}
+
+// ----------------------------------------------------------------------
+// Helpers
+// ----------------------------------------------------------------------
+
+void RFM69 ::configureRadio() {
+    Settings settings;
+    this->readSettings(settings);
+    const F32 frequency = settings.frequency;
+    const I8 power = settings.power;
+    const ModemProfile profile = settings.profile;
+    const U8 address = settings.address;
+    const U8 peer = settings.peer;
+    const AddressFilter filter = settings.filter;
+    const U8 source = settings.source;
+    capture_enabled = settings.captureEnabled;
+    csma_enabled = settings.csmaEnabled;
+    csma_threshold = settings.csmaThreshold;
+    const AesKey key = settings.key;
+
+    // The registers are written in standby; the next poll for received packets puts the radio back in receive
+    rfm69.setModeIdle();
+    csma_sampling = false;
+    rfm69.setFrequency(frequency);
+    rfm69.setModemConfig(modemConfig(profile));
+    rfm69.setTxPower(power, true);
+    this->configureAddressFilter(filter, address);
+    rfm69.setThisAddress(address);
+    rfm69.setHeaderFrom(address);
+    rfm69.setHeaderTo(peer);
+    // RadioHead would drop most packets that fail to decrypt for their address before they could be counted
+    rfm69.setPromiscuous(true);
+    this->installKey(key);
+    modem_profile = profile;
+    address_filter = filter;
+    node_address = address;
+    peer_address = peer;
+    if (source != time_source) {
+        time_source = source;
+        time_sync_state = TIME_SYNC_IDLE;
+        time_sync_countdown = 0;
+    }
+    csma_random = 0x9E3779B9u ^ address;
+    this->log_ACTIVITY_HI_RadioConfigured(frequency, power, profile);
+}
+
+void RFM69 ::bringUp() {
+    switch (bring_up_state) {
+        case BRING_UP_RESET:
+            if (this->isConnected_gpioReset_OutputPort(0)) {
+                this->gpioReset_out(0, Fw::Logic::HIGH);
+            }
+            bring_up_state = BRING_UP_RELEASE;
+            break;
+        case BRING_UP_RELEASE:
+            if (this->isConnected_gpioReset_OutputPort(0)) {
+                this->gpioReset_out(0, Fw::Logic::LOW);
+            }
+            // RadioHead sleeps 100 ms here; the radio needs 5 ms after reset, so whole run calls are waited instead
+            rfm69.beginBus();
+            settle_remaining = SETTLE_TICKS;
+            bring_up_state = BRING_UP_SETTLE;
+            break;
+        case BRING_UP_SETTLE:
+            settle_remaining--;
+            if (settle_remaining == 0) {
+                bring_up_state = BRING_UP_INIT;
+            }
+            break;
+        case BRING_UP_INIT: {
+            init_attempts++;
+            this->tlmWrite_InitAttempts(init_attempts);
+            if (!rfm69.initRadio()) {
+                // A missing radio is retried ever less often, held in reset in between
+                backoff_ticks = (backoff_ticks == 0) ? 1 : FW_MIN(2 * backoff_ticks, BACKOFF_MAX_TICKS);
+                backoff_remaining = backoff_ticks;
+                if (this->isConnected_gpioReset_OutputPort(0)) {
+                    this->gpioReset_out(0, Fw::Logic::HIGH);
+                }
+                bring_up_state = BRING_UP_BACKOFF;
+                this->log_WARNING_LO_RadioInitFailed(init_attempts, backoff_ticks);
+                break;
+            }
+
+            this->configureRadio();
+            backoff_ticks = 0;
+            bring_up_state = BRING_UP_DONE;
+            radio_state = Fw::On::ON;
+
+            Fw::Success radioSuccess = Fw::Success::SUCCESS;
+            if (this->isConnected_comStatus_OutputPort(0)) {
+                this->comStatus_out(0, radioSuccess);
+            }
+            break;
+        }
+        case BRING_UP_BACKOFF:
+            backoff_remaining--;
+            if (backoff_remaining == 0) {
+                bring_up_state = BRING_UP_RELEASE;
+            }
+            break;
+        default:
+            FW_ASSERT(0, bring_up_state);
+            break;
+    }
+}
+
+void RFM69 ::reportLink() {
+    LinkEstimator::Report report;
+    if (link_estimator.closeWindow(this->nowUs(), report)) {
+        link_loss_per_mille = 0;
+        for (U32 i = 0; i < report.peers.SIZE; i++) {
+            link_loss_per_mille = FW_MAX(link_loss_per_mille, report.peers[i].getlossPerMille());
+        }
+        link_airtime_per_mille = report.airtimePerMille;
+        this->tlmWrite_LinkReport(report.peers);
+        this->tlmWrite_Goodput(report.goodput);
+        this->tlmWrite_AirtimeUtilization(report.airtimePerMille);
+        this->tlmWrite_PacketsLost(link_estimator.packetsLost());
+        this->tlmWrite_ChannelBusyRate(
+            static_cast<U16>((csma_samples > 0) ? (static_cast<U64>(csma_busy_samples) * 1000 / csma_samples) : 0));
+        this->tlmWrite_BackoffTime(static_cast<U32>(csma_wait_us / 1000));
+        this->tlmWrite_CapturePackets(capture.packets());
+        this->tlmWrite_CaptureOverwritten(capture.overwritten());
+        csma_samples = 0;
+        csma_busy_samples = 0;
+        csma_wait_us = 0;
+    }
+}
+
+void RFM69 ::capturePacket(bool sent, const U8* header, I8 rssi, U64 timeUs, const U8* data, U8 len) {
+    if (not capture_enabled) {
+        return;
+    }
+    CapturedPacket packet;
+    packet.timeUs = timeUs;
+    packet.sent = sent;
+    packet.rssi = rssi;
+    memcpy(packet.header, header, CapturedPacket::HEADER_SIZE);
+    packet.size = len;
+    memcpy(packet.payload, data, len);
+    capture.add(packet);
+}
+
+void RFM69 ::serviceCaptureRequests() {
+    // A dump in progress ends with what it has sent
+    const U32 clears = capture_clear_requests.load(std::memory_order_acquire);
+    if (clears != capture_clears_served) {
+        capture_clears_served = clears;
+        capture.clear();
+        this->tlmWrite_CapturePackets(capture.packets());
+    }
+    const U32 dumps = capture_dump_requests.load(std::memory_order_acquire);
+    if (dumps != capture_dumps_served) {
+        capture_dumps_served = dumps;
+        if (not capture_dumping.load(std::memory_order_relaxed)) {
+            capture.startReading();
+            capture_waits = 0;
+            capture_dumped_packets = 0;
+            capture_containers = 0;
+            capture_dumping.store(true, std::memory_order_release);
+        }
+    }
+}
+
+void RFM69 ::serviceCaptureDump() {
+    if (not capture_dumping.load(std::memory_order_relaxed)) {
+        return;
+    }
+    CapturedPacket packet;
+    if (not capture.peek(packet)) {
+        this->finishCaptureDump();
+        return;
+    }
+
+    DpContainer container;
+    if (this->dpGet_Capture(RFM69Cfg::CAPTURE_CONTAINER_DATA_SIZE, container) != Fw::Success::SUCCESS) {
+        // The buffers are shared with other products; one may come back by the next run
+        capture_waits++;
+        if (capture_waits >= RFM69Cfg::CAPTURE_DUMP_MAX_WAITS) {
+            this->log_WARNING_LO_CaptureDumpCut(capture_dumped_packets);
+            capture_dumping.store(false, std::memory_order_release);
+        }
+        return;
+    }
+    capture_waits = 0;
+
+    // Every container is a pcap file of its own, so each can be read without the others
+    U8 record[PacketCapture::PCAP_MAX_RECORD_SIZE];
+    const U32 headerSize = PacketCapture::pcapHeader(record);
+    Fw::SerializeStatus status = container.serializeRecord_PcapHeader(record, headerSize);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    do {
+        const U32 size = PacketCapture::pcapRecordSize(packet);
+        if (RFM69Cfg::CAPTURE_CONTAINER_DATA_SIZE - container.getDataSize() <
+            sizeof(FwDpIdType) + sizeof(FwSizeType) + size) {
+            break;
+        }
+        (void)PacketCapture::pcapRecord(packet, record);
+        status = container.serializeRecord_PcapPacket(record, size);
+        FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+        capture.advance();
+        capture_dumped_packets++;
+    } while (capture.peek(packet));
+    this->dpSend(container, this->getTime());
+    capture_containers++;
+}
+
+void RFM69 ::finishCaptureDump() {
+    capture_dumping.store(false, std::memory_order_release);
+    this->log_ACTIVITY_LO_CaptureDumped(capture_dumped_packets, capture_containers, capture.skipped());
+}
+
+U64 RFM69 ::nowUs() {
+    const Fw::Time now = this->getTime();
+    return static_cast<U64>(now.getSeconds()) * 1000000 + now.getUSeconds();
+}
+
+U32 RFM69 ::airtimeUs(const ModemProfile& profile, U32 payloadBytes) {
+    // Preamble, sync word, length byte, RadioHead header and CRC go out around every payload
+    const U64 bits = (4 + 2 + 1 + RH_RF69_HEADER_LEN + payloadBytes + 2) * 8;
+    return static_cast<U32>(bits * 1000000 / bitRate(profile));
+}
+
+U32 RFM69 ::bitRate(const ModemProfile& profile) {
+    switch (profile.e) {
+        case ModemProfile::GFSK_Rb2Fd5:
+            return 2000;
+        case ModemProfile::GFSK_Rb9_6Fd19_2:
+            return 9600;
+        case ModemProfile::GFSK_Rb38_4Fd76_8:
+            return 38400;
+        case ModemProfile::GFSK_Rb57_6Fd120:
+            return 57600;
+        case ModemProfile::GFSK_Rb125Fd125:
+            return 125000;
+        default:
+            return 250000;
+    }
+}
+
+RH_RF69::ModemConfigChoice RFM69 ::modemConfig(const ModemProfile& profile) {
+    switch (profile.e) {
+        case ModemProfile::GFSK_Rb2Fd5:
+            return RH_RF69::GFSK_Rb2Fd5;
+        case ModemProfile::GFSK_Rb9_6Fd19_2:
+            return RH_RF69::GFSK_Rb9_6Fd19_2;
+        case ModemProfile::GFSK_Rb38_4Fd76_8:
+            return RH_RF69::GFSK_Rb38_4Fd76_8;
+        case ModemProfile::GFSK_Rb57_6Fd120:
+            return RH_RF69::GFSK_Rb57_6Fd120;
+        case ModemProfile::GFSK_Rb125Fd125:
+            return RH_RF69::GFSK_Rb125Fd125;
+        default:
+            return RH_RF69::GFSK_Rb250Fd250;
+    }
 }
 
 }  // end namespace Radio
@@ -8,9 +8,21 @@
 #define RFM69_HPP
 
 #include "Components/Radio/RFM69/RFM69ComponentAc.hpp"
-#include "RH_RF69.h"
+#include "Components/Radio/RFM69/LinkEstimator.hpp"
+#include "Components/Radio/RFM69/PacketCapture.hpp"
 #include "RFM69Pinout.hpp"
+#include <config/RFM69Cfg.hpp>
+#include <Os/Mutex.hpp>
+
+#include <atomic>
+
+#ifdef ARDUINO
+#include "RH_RF69.h"
+#include <Components/Radio/RFM69/TimestampedRF69.hpp>
 #include <FprimeArduino.hpp>
+#else
+#include <Components/Radio/RFM69/SimRH_RF69.hpp>
+#endif
 
 namespace Radio {
 
@@ -20,7 +32,11 @@ namespace Radio {
 
     public:
 
-      static const NATIVE_INT_TYPE RFM69_FREQ = 915;
+      //! Longest wait between attempts to bring up the radio, in run calls
+      static const U32 BACKOFF_MAX_TICKS = 128;
+
+      //! Run calls between starting the bus and initializing the radio, in place of RadioHead's 100 ms sleep
+      static const U32 SETTLE_TICKS = 1;
 
       // ----------------------------------------------------------------------
       // Construction, initialization, and destruction
@@ -39,6 +55,30 @@ namespace Radio {
       bool send(const U8* payload, NATIVE_UINT_TYPE len);
       void recv();
 
+      //! Drive a radio on other pins than the board's own, for a second radio; must be called before the first run
+      void configurePins(
+          U8 chipSelectPin, /*!< SPI chip select of the radio*/
+          U8 interruptPin /*!< Pin the radio's DIO0 interrupt line is on*/
+      );
+
+#ifndef ARDUINO
+      //! Set the loopback ports of the simulated radio
+      void configureLink(
+          U16 localPort, /*!< Port this node receives on*/
+          U16 peerPort /*!< Port the other node receives on*/
+      );
+
+      //! Attach the simulated radio to a medium shared with other radios in the process
+      void configureMedium(
+          SimRadioMedium& medium /*!< The medium*/
+      );
+
+      //! Timestamp the simulated radio's packets on a node's own clock
+      void configureClock(
+          const SimRadioClock& clock /*!< The clock*/
+      );
+#endif
+
     PRIVATE:
 
       // ----------------------------------------------------------------------
@@ -52,6 +92,26 @@ namespace Radio {
           Fw::Buffer &sendBuffer 
       );
 
+      //! Handler implementation for linkLoadGet
+      //!
+      LinkLoad linkLoadGet_handler(
+          const NATIVE_INT_TYPE portNum /*!< The port number*/
+      );
+
+      //! Handler implementation for command CAPTURE_DUMP
+      //!
+      void CAPTURE_DUMP_cmdHandler(
+          FwOpcodeType opCode, /*!< The opcode*/
+          U32 cmdSeq /*!< The command sequence number*/
+      ) override;
+
+      //! Handler implementation for command CAPTURE_CLEAR
+      //!
+      void CAPTURE_CLEAR_cmdHandler(
+          FwOpcodeType opCode, /*!< The opcode*/
+          U32 cmdSeq /*!< The command sequence number*/
+      ) override;
+
       //! Handler implementation for run
       //!
       void run_handler(
@@ -61,10 +121,240 @@ namespace Radio {
       */
       );
 
-      RH_RF69 rfm69;
+      //! Retune a running radio when a parameter is set by command
+      //!
+      void parameterUpdated(
+          FwPrmIdType id /*!< The parameter ID*/
+      ) override;
+
+      //! Retune a running radio when parameters are reloaded
+      //!
+      void parametersLoaded() override;
+
+      //! The parameters the radio is tuned from, copied out of the parameter storage for the radio's thread
+      struct Settings {
+        F32 frequency;
+        I8 power;
+        ModemProfile profile;
+        U8 address;
+        U8 peer;
+        AddressFilter filter;
+        U8 source;
+        bool captureEnabled;
+        bool csmaEnabled;
+        I16 csmaThreshold;
+        AesKey key;
+      };
+
+      //! Copy the parameters for the radio's thread, on the thread that set or loaded them
+      //!
+      void publishSettings();
+
+      //! Take the last copy of the parameters, and note it as applied
+      //!
+      void readSettings(Settings& settings);
+
+      //! Apply the frequency, power and modem parameters without resetting the radio
+      //!
+      void configureRadio();
+
+      //! Modem configuration for a profile
+      //!
+      static RH_RF69::ModemConfigChoice modemConfig(const ModemProfile& profile);
+
+      //! Bit rate of a profile in bits per second
+      //!
+      static U32 bitRate(const ModemProfile& profile);
+
+      //! Time a packet with the given payload occupies the air
+      //!
+      static U32 airtimeUs(const ModemProfile& profile, U32 payloadBytes);
+
+      //! Send one radio packet, numbered in sequence, behind the key check while a key is installed
+      //!
+      bool sendPacket(const U8* data, U8 len);
+
+      //! Largest payload of one radio packet, which the key check shortens while a key is installed
+      //!
+      U8 maxPayload() const;
+
+      //! Send the queued frames in order once the channel is clear, backing off when it is busy
+      //!
+      void serviceQueue();
+
+      //! Result of sampling the channel before a transmission
+      enum ChannelSample {
+        CHANNEL_CLEAR,  //!< Signal strength below CSMA_THRESHOLD
+        CHANNEL_BUSY,  //!< Signal strength at or above CSMA_THRESHOLD
+        CHANNEL_UNSAMPLED  //!< The receiver has not finished measuring
+      };
+
+      //! Read the channel measurement, starting one to be read on a later call if none is running
+      //!
+      ChannelSample sampleChannel();
+
+      //! Deallocate every queued frame
+      //!
+      void flushQueue();
+
+      //! Install a key in the radio's AES engine, or turn encryption off for the all-zero key
+      //!
+      void installKey(const AesKey& key);
+
+      //! Set up the packet engine to match the address byte; must follow the modem configuration, which clears it
+      //!
+      void configureAddressFilter(const AddressFilter& filter, U8 address);
+
+      //! Next value of the backoff random sequence
+      //!
+      U32 nextRandom();
+
+      //! Publish the link report when a link quality window closes
+      //!
+      void reportLink();
+
+      //! Start an exchange with the time source when one is due
+      //!
+      void serviceTimeSync();
+
+      //! Handle a time synchronization packet: answer a request, or take a response or follow-up to our own
+      //!
+      void timeSyncReceived(const U8* data, U8 len, U8 from, U64 receivedUs);
+
+      //! Send a time synchronization packet to one node
+      //!
+      bool sendTimeSync(U8 to, U8 type, U8 seq, U64 timestampUs);
+
+      //! Time of a radio interrupt, from the microsecond counter when it was taken
+      //!
+      U64 stampUs(U32 counter);
+
+      //! Record a packet in the capture ring, if capture is enabled
+      //!
+      void capturePacket(bool sent, const U8* header, I8 rssi, U64 timeUs, const U8* data, U8 len);
+
+      //! Carry out the capture commands given since the last run, on the radio's thread
+      //!
+      void serviceCaptureRequests();
+
+      //! Send the next container of a capture dump in progress
+      //!
+      void serviceCaptureDump();
+
+      //! End a capture dump and report it
+      //!
+      void finishCaptureDump();
+
+      //! Reset the radio after a send failed, dropping the queued frames
+      //!
+      void restartRadio();
+
+      //! Bytes in a time synchronization request: RFM69Cfg::TIME_SYNC_MARKER, type and sequence number
+      static const U8 TIME_SYNC_REQUEST_SIZE = 3;
+
+      //! Bytes in a time synchronization response or follow-up: a request, then a big-endian timestamp
+      static const U8 TIME_SYNC_TIMESTAMPED_SIZE = TIME_SYNC_REQUEST_SIZE + sizeof(U64);
+
+      //! Time synchronization packets, by their second byte
+      enum TimeSyncType {
+        TIME_SYNC_REQUEST = 1,  //!< Client to source: sequence number
+        TIME_SYNC_RESPONSE = 2,  //!< Source to client: sequence number, time the request arrived
+        TIME_SYNC_FOLLOW_UP = 3  //!< Source to client: sequence number, time the response left
+      };
+
+      //! Progress of this node's exchange with the time source
+      enum TimeSyncState {
+        TIME_SYNC_IDLE,  //!< No exchange in progress
+        TIME_SYNC_AWAIT_RESPONSE,  //!< Request sent
+        TIME_SYNC_AWAIT_FOLLOW_UP  //!< Response received
+      };
+
+      //! Current time in microseconds
+      //!
+      U64 nowUs();
+
+      //! Advance radio bring-up by one step; each step is one run call so none of them blocks
+      //!
+      void bringUp();
+
+      //! Radio bring-up progress
+      enum BringUpState {
+        BRING_UP_RESET,  //!< Assert the reset line
+        BRING_UP_RELEASE,  //!< Release the reset line and start the bus
+        BRING_UP_SETTLE,  //!< Wait for the radio to come out of reset
+        BRING_UP_INIT,  //!< Initialize and tune the radio
+        BRING_UP_BACKOFF,  //!< Hold the radio in reset until the next attempt
+        BRING_UP_DONE  //!< Radio running
+      };
+
+      TimestampedRF69 rfm69;
       Fw::On radio_state;
-      U16 pkt_rx_count;
-      U16 pkt_tx_count;
+      U32 pkt_rx_count;
+      U32 pkt_tx_count;
+      BringUpState bring_up_state;
+      U32 backoff_ticks;
+      U32 backoff_remaining;
+      U32 settle_remaining;
+      U32 init_attempts;
+      U8 tx_seq;
+      ModemProfile modem_profile;
+      LinkEstimator link_estimator;
+
+      bool csma_enabled;
+      I16 csma_threshold;
+      Fw::Buffer tx_queue[RFM69Cfg::TX_QUEUE_DEPTH];
+      U32 tx_queue_head;
+      U32 tx_queue_count;
+      U32 tx_queue_overflows;
+      U32 csma_attempts;
+      U32 csma_backoff_remaining;
+      U32 csma_random;
+      bool csma_sampling;
+      U64 csma_wait_start_us;
+      U32 csma_samples;
+      U32 csma_busy_samples;
+      U64 csma_wait_us;
+
+      AesKey encryption_key;
+      bool encryption_enabled;
+      U32 decryption_failures;
+
+      AddressFilter address_filter;
+      U8 node_address;
+      U8 peer_address;
+      U32 pkt_filtered;
+
+      U16 link_loss_per_mille;
+      U16 link_airtime_per_mille;
+
+      U8 time_source;
+      TimeSyncState time_sync_state;
+      U8 time_sync_seq;
+      U32 time_sync_countdown;
+      U64 time_sync_request_sent_us;
+      U64 time_sync_request_received_us;
+      U64 time_sync_response_received_us;
+      bool follow_up_pending;
+      U8 follow_up_to;
+      U8 follow_up_seq;
+      U64 follow_up_sent_us;
+
+      PacketCapture capture;
+      bool capture_enabled;
+      std::atomic<bool> capture_dumping;
+      std::atomic<U32> capture_dump_requests;
+      std::atomic<U32> capture_clear_requests;
+      U32 capture_dumps_served;
+      U32 capture_clears_served;
+      U32 capture_waits;
+      U32 capture_dumped_packets;
+      U32 capture_containers;
+
+      // Written by the thread that sets or loads parameters, which may be on the other core from the radio
+      Os::Mutex settings_lock;
+      Settings published_settings;
+      std::atomic<U32> param_updates;
+      U32 params_applied;
     };
 
 } // end namespace Radio
@@ -0,0 +1,346 @@
+// ======================================================================
+// \title  SimRH_RF69.cpp
+// \brief  Simulated RH_RF69 driver for host builds
+// ======================================================================
+
+#include <Components/Radio/RFM69/SimRH_RF69.hpp>
+#include <Fw/Types/Assert.hpp>
+
+#include <arpa/inet.h>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+  //! Packet configuration RadioHead writes with every modem configuration: no address filtering
+  const U8 PACKET_CONFIG1_DEFAULT = RH_RF69_PACKETCONFIG1_PACKETFORMAT_VARIABLE | RH_RF69_PACKETCONFIG1_DCFREE_WHITENING |
+                                    RH_RF69_PACKETCONFIG1_CRC_ON | RH_RF69_PACKETCONFIG1_ADDRESSFILTERING_NONE;
+
+  sockaddr_in loopback(U16 port) {
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    return address;
+  }
+
+  //! Host time in microseconds, the true time of radios on the loopback link
+  U64 monotonicUs() {
+    timespec now;
+    (void) clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<U64>(now.tv_sec) * 1000000 + static_cast<U64>(now.tv_nsec) / 1000;
+  }
+}
+
+RH_RF69::RH_RF69(int slaveSelectPin, int interruptPin)
+    : m_medium(nullptr),
+      m_clock(nullptr),
+      m_txDoneUs(0),
+      m_rxReadyUs(0),
+      m_fd(-1),
+      m_localPort(0),
+      m_peerPort(0),
+      m_frequencyKhz(0),
+      m_modem(0),
+      m_txPower(0),
+      m_lastRssi(0),
+      m_rxLength(0),
+      m_encrypt(false),
+      m_packetConfig1(PACKET_CONFIG1_DEFAULT),
+      m_nodeAddress(0),
+      m_broadcastAddress(0),
+      m_addressFiltered(0) {
+    // RadioHead sends to and from the broadcast address until told otherwise
+    m_txHeader[0] = RH_BROADCAST_ADDRESS;
+    m_txHeader[1] = RH_BROADCAST_ADDRESS;
+    m_txHeader[2] = 0;
+    m_txHeader[3] = 0;
+    memset(m_rxHeader, 0, sizeof(m_rxHeader));
+}
+
+RH_RF69::~RH_RF69() {
+    if (m_fd >= 0) {
+        (void) ::close(m_fd);
+    }
+}
+
+void RH_RF69::setLink(U16 localPort, U16 peerPort) {
+    m_localPort = localPort;
+    m_peerPort = peerPort;
+}
+
+void RH_RF69::setMedium(SimRadioMedium& medium) {
+    m_medium = &medium;
+    medium.attach(*this);
+}
+
+void RH_RF69::setClock(const SimRadioClock& clock) {
+    m_clock = &clock;
+}
+
+uint32_t RH_RF69::counterUs() const {
+    return this->counter((m_medium != nullptr) ? m_medium->nowUs() : monotonicUs());
+}
+
+uint32_t RH_RF69::counter(U64 trueUs) const {
+    // The counter is 32 bits on the board too, and wraps
+    return static_cast<uint32_t>((m_clock != nullptr) ? m_clock->localUs(trueUs) : trueUs);
+}
+
+bool RH_RF69::deliver(const U8* data, U8 len, I16 rssi, U64 readyUs) {
+    FW_ASSERT(len <= RH_RF69_MAX_ENCRYPTABLE_PAYLOAD_LEN, len);
+    FW_ASSERT(this->airLength(len) <= RH_RF69_MAX_AIR_LEN, len);
+    // The radio holds one received packet and stops receiving until it is read
+    if (m_rxLength > 0) {
+        return false;
+    }
+    (void) this->accept(data, len, rssi, readyUs);
+    return true;
+}
+
+U8 RH_RF69::clearLength() const {
+    return ((m_packetConfig1 & RH_RF69_PACKETCONFIG1_ADDRESSFILTERING) != RH_RF69_PACKETCONFIG1_ADDRESSFILTERING_NONE)
+               ? 1
+               : 0;
+}
+
+U8 RH_RF69::airLength(U8 len) const {
+    if (not m_encrypt) {
+        return len;
+    }
+    const U32 clear = this->clearLength();
+    const U32 blocks = (len - clear + SoftAes128::BLOCK_SIZE - 1) / SoftAes128::BLOCK_SIZE;
+    return static_cast<U8>(clear + blocks * SoftAes128::BLOCK_SIZE);
+}
+
+bool RH_RF69::accept(const U8* data, U8 len, I16 rssi, U64 readyUs) {
+    // RadioHead drops packets too short to carry its header
+    if (len <= RH_RF69_HEADER_LEN) {
+        return false;
+    }
+    // The packet engine compares the address byte before anything is written to the FIFO
+    const U8 filter = m_packetConfig1 & RH_RF69_PACKETCONFIG1_ADDRESSFILTERING;
+    if (((filter == RH_RF69_PACKETCONFIG1_ADDRESSFILTERING_NODE) && (data[0] != m_nodeAddress)) ||
+        ((filter == RH_RF69_PACKETCONFIG1_ADDRESSFILTERING_NODE_BC) && (data[0] != m_nodeAddress) &&
+         (data[0] != m_broadcastAddress))) {
+        m_addressFiltered++;
+        return false;
+    }
+    // Whatever was sent, a radio with a key decrypts it; with the wrong key, or none at one end, the result is noise
+    U8 packet[RH_RF69_MAX_AIR_LEN];
+    const U8 airLength = this->airLength(len);
+    memcpy(packet, data, airLength);
+    if (m_encrypt) {
+        for (U32 offset = this->clearLength(); offset < airLength; offset += SoftAes128::BLOCK_SIZE) {
+            m_aes.decryptBlock(&packet[offset]);
+        }
+    }
+    memcpy(m_rxHeader, packet, RH_RF69_HEADER_LEN);
+    m_rxLength = static_cast<U8>(len - RH_RF69_HEADER_LEN);
+    memcpy(m_rxBuffer, &packet[RH_RF69_HEADER_LEN], m_rxLength);
+    m_lastRssi = rssi;
+    m_rxReadyUs = readyUs;
+    return true;
+}
+
+bool RH_RF69::init() {
+    m_packetConfig1 = PACKET_CONFIG1_DEFAULT;
+    if (m_medium != nullptr) {
+        m_rxLength = 0;
+        return true;
+    }
+    if (m_fd >= 0) {
+        // A reset of a fitted radio
+        m_rxLength = 0;
+        return true;
+    }
+    if ((m_localPort == 0) || (m_peerPort == 0)) {
+        return false;
+    }
+    m_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (m_fd < 0) {
+        return false;
+    }
+    const sockaddr_in address = loopback(m_localPort);
+    if ((bind(m_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) ||
+        (fcntl(m_fd, F_SETFL, O_NONBLOCK) != 0)) {
+        (void) ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+    return true;
+}
+
+bool RH_RF69::setFrequency(float centre, float afcPullInRange) {
+    m_frequencyKhz = static_cast<U32>(centre * 1000.0f + 0.5f);
+    return true;
+}
+
+bool RH_RF69::setModemConfig(ModemConfigChoice index) {
+    m_modem = static_cast<U8>(index);
+    // RadioHead writes the packet configuration with the modem registers, turning the address filter off
+    m_packetConfig1 = PACKET_CONFIG1_DEFAULT;
+    return true;
+}
+
+void RH_RF69::setTxPower(int8_t power, bool ishighpowermodule) {
+    m_txPower = power;
+}
+
+void RH_RF69::setModeIdle() {}
+
+void RH_RF69::setEncryptionKey(uint8_t* key) {
+    m_encrypt = (key != nullptr);
+    if (m_encrypt) {
+        m_aes.setKey(key);
+    }
+}
+
+void RH_RF69::setPromiscuous(bool promiscuous) {}
+
+void RH_RF69::setThisAddress(uint8_t thisAddress) {}
+
+uint8_t RH_RF69::spiRead(uint8_t reg) {
+    switch (reg) {
+        case RH_RF69_REG_37_PACKETCONFIG1:
+            return m_packetConfig1;
+        case RH_RF69_REG_39_NODEADRS:
+            return m_nodeAddress;
+        case RH_RF69_REG_3A_BROADCASTADRS:
+            return m_broadcastAddress;
+        default:
+            return 0;
+    }
+}
+
+uint8_t RH_RF69::spiWrite(uint8_t reg, uint8_t val) {
+    switch (reg) {
+        case RH_RF69_REG_37_PACKETCONFIG1:
+            m_packetConfig1 = val;
+            break;
+        case RH_RF69_REG_39_NODEADRS:
+            m_nodeAddress = val;
+            break;
+        case RH_RF69_REG_3A_BROADCASTADRS:
+            m_broadcastAddress = val;
+            break;
+        default:
+            break;
+    }
+    return 0;
+}
+
+bool RH_RF69::send(const uint8_t* data, uint8_t len) {
+    FW_ASSERT(len <= RH_RF69_MAX_MESSAGE_LEN, len);
+    U8 datagram[DATAGRAM_HEADER_SIZE + RH_RF69_MAX_AIR_LEN];
+    memset(datagram, 0, sizeof(datagram));
+    const U8 packetLength = static_cast<U8>(RH_RF69_HEADER_LEN + len);
+    memcpy(datagram, &m_frequencyKhz, sizeof(m_frequencyKhz));
+    datagram[sizeof(m_frequencyKhz)] = m_modem;
+    datagram[sizeof(m_frequencyKhz) + sizeof(m_modem)] = packetLength;
+    U8* const packet = &datagram[DATAGRAM_HEADER_SIZE];
+    memcpy(packet, m_txHeader, RH_RF69_HEADER_LEN);
+    memcpy(&packet[RH_RF69_HEADER_LEN], data, len);
+    // The AES engine pads the packet with zeros to whole blocks, leaving the address byte in the clear
+    if (m_encrypt) {
+        for (U32 offset = this->clearLength(); offset < this->airLength(packetLength); offset += SoftAes128::BLOCK_SIZE) {
+            m_aes.encryptBlock(&packet[offset]);
+        }
+    }
+
+    if (m_medium != nullptr) {
+        m_txDoneUs = m_medium->transmit(*this, packet, packetLength);
+        return true;
+    }
+    if (m_fd < 0) {
+        return false;
+    }
+    const sockaddr_in peer = loopback(m_peerPort);
+    // Like a radio, the sender cannot tell whether anyone heard the packet
+    (void) sendto(m_fd, datagram, DATAGRAM_HEADER_SIZE + this->airLength(packetLength), 0, reinterpret_cast<const sockaddr*>(&peer),
+                  sizeof(peer));
+    m_txDoneUs = monotonicUs();
+    return true;
+}
+
+bool RH_RF69::waitPacketSent(uint16_t timeout) {
+    return (m_medium != nullptr) || (m_fd >= 0);
+}
+
+bool RH_RF69::available() {
+    while ((m_fd >= 0) && (m_rxLength == 0)) {
+        // A radio with a key reads whole blocks, which a packet sent without one may not fill
+        U8 datagram[DATAGRAM_HEADER_SIZE + RH_RF69_MAX_AIR_LEN];
+        memset(datagram, 0, sizeof(datagram));
+        const ssize_t size = ::recv(m_fd, datagram, sizeof(datagram), 0);
+        if (size < 0) {
+            break;
+        }
+        U32 frequencyKhz = 0;
+        memcpy(&frequencyKhz, datagram, sizeof(frequencyKhz));
+        const U8 length = datagram[sizeof(frequencyKhz) + sizeof(m_modem)];
+        if ((static_cast<U32>(size) > DATAGRAM_HEADER_SIZE) && (length <= RH_RF69_MAX_ENCRYPTABLE_PAYLOAD_LEN) &&
+            (frequencyKhz == m_frequencyKhz) && (datagram[sizeof(frequencyKhz)] == m_modem)) {
+            // A strong, constant signal
+            (void) this->accept(&datagram[DATAGRAM_HEADER_SIZE], length, -40, monotonicUs());
+        }
+    }
+    return m_rxLength > 0;
+}
+
+bool RH_RF69::recv(uint8_t* buf, uint8_t* len) {
+    if (not this->available()) {
+        return false;
+    }
+    const U8 size = FW_MIN(*len, m_rxLength);
+    memcpy(buf, m_rxBuffer, size);
+    *len = size;
+    m_rxLength = 0;
+    return true;
+}
+
+int16_t RH_RF69::lastRssi() {
+    return m_lastRssi;
+}
+
+int8_t RH_RF69::rssiRead() {
+    // The loopback link has no notion of a busy channel
+    const I16 rssi = (m_medium != nullptr) ? m_medium->channelRssi(*this) : RH_RF69_RSSI_FLOOR;
+    return static_cast<int8_t>(FW_MAX(rssi, static_cast<I16>(RH_RF69_RSSI_FLOOR)));
+}
+
+void RH_RF69::setHeaderTo(uint8_t to) {
+    m_txHeader[0] = to;
+}
+
+void RH_RF69::setHeaderFrom(uint8_t from) {
+    m_txHeader[1] = from;
+}
+
+void RH_RF69::setHeaderId(uint8_t id) {
+    m_txHeader[2] = id;
+}
+
+uint8_t RH_RF69::headerTo() {
+    return m_rxHeader[0];
+}
+
+uint8_t RH_RF69::headerFrom() {
+    return m_rxHeader[1];
+}
+
+uint8_t RH_RF69::headerId() {
+    return m_rxHeader[2];
+}
+
+void RH_RF69::setHeaderFlags(uint8_t set, uint8_t clear) {
+    m_txHeader[3] = static_cast<U8>((m_txHeader[3] & ~clear) | set);
+}
+
+uint8_t RH_RF69::headerFlags() {
+    return m_rxHeader[3];
+}
@@ -0,0 +1,279 @@
+// ======================================================================
+// \title  SimRH_RF69.hpp
+// \brief  Simulated RH_RF69 driver for host builds
+// ======================================================================
+
+#ifndef SIM_RH_RF69_HPP
+#define SIM_RH_RF69_HPP
+
+#include <Components/Radio/RFM69/SoftAes128.hpp>
+#include <FpConfig.hpp>
+#include <cstdint>
+
+#define RH_RF69_HEADER_LEN 4
+#define RH_RF69_MAX_ENCRYPTABLE_PAYLOAD_LEN 64
+#define RH_RF69_MAX_MESSAGE_LEN (RH_RF69_MAX_ENCRYPTABLE_PAYLOAD_LEN - RH_RF69_HEADER_LEN)
+#define RH_BROADCAST_ADDRESS 0xff
+#define RH_FLAGS_APPLICATION_SPECIFIC 0x0f
+
+// Packet engine registers emulated by the simulated radio, named as in RadioHead
+#define RH_RF69_REG_37_PACKETCONFIG1 0x37
+#define RH_RF69_REG_39_NODEADRS 0x39
+#define RH_RF69_REG_3A_BROADCASTADRS 0x3a
+#define RH_RF69_PACKETCONFIG1_PACKETFORMAT_VARIABLE 0x80
+#define RH_RF69_PACKETCONFIG1_DCFREE_WHITENING 0x40
+#define RH_RF69_PACKETCONFIG1_CRC_ON 0x10
+#define RH_RF69_PACKETCONFIG1_ADDRESSFILTERING 0x06
+#define RH_RF69_PACKETCONFIG1_ADDRESSFILTERING_NONE 0x00
+#define RH_RF69_PACKETCONFIG1_ADDRESSFILTERING_NODE 0x02
+#define RH_RF69_PACKETCONFIG1_ADDRESSFILTERING_NODE_BC 0x04
+
+//! Longest packet on the air after the length byte: a full encrypted packet with its address byte in the clear
+#define RH_RF69_MAX_AIR_LEN (RH_RF69_MAX_ENCRYPTABLE_PAYLOAD_LEN + 1)
+
+//! Weakest signal the RSSI register reports, in whole dBm
+#define RH_RF69_RSSI_FLOOR (-127)
+
+class RH_RF69;
+
+//! Channel shared by simulated radios in one process, used in place of the loopback link
+//!
+//! Times are in microseconds of the medium's own clock, the true time of the simulation.
+class SimRadioMedium {
+  public:
+    virtual ~SimRadioMedium() {}
+
+    //! Register a radio with the medium
+    virtual void attach(RH_RF69& radio) = 0;
+
+    //! Put a packet, RadioHead header first, on the air; the medium decides who receives it and when
+    //!
+    //! The packet is what follows the length byte on the air, and len is the length byte. An encrypted packet is
+    //! longer: it fills whole AES blocks, radio.airLength(len) bytes in all, at most RH_RF69_MAX_AIR_LEN.
+    //!
+    //! \return the time the packet leaves the air
+    virtual U64 transmit(RH_RF69& radio, const U8* data, U8 len) = 0;
+
+    //! Time now
+    virtual U64 nowUs() = 0;
+
+    //! Strongest signal from other radios on the air at a radio right now, in dBm
+    virtual I16 channelRssi(RH_RF69& radio) = 0;
+};
+
+//! Oscillator of a simulated node, which need not keep true time
+class SimRadioClock {
+  public:
+    virtual ~SimRadioClock() {}
+
+    //! Reading of the node's clock at a true time, in microseconds
+    virtual U64 localUs(U64 trueUs) const = 0;
+};
+
+//! Stand-in for the RadioHead RH_RF69 driver with the subset of its interface used by Radio::RFM69
+//!
+//! Packets travel as UDP datagrams between two ports on the loopback interface, one per node. Each datagram carries
+//! the frequency and modem profile of the sender, and a receiver tuned differently drops it as a real radio would.
+//! Behind those comes the packet as it is on the air: the four byte RadioHead header, then the payload.
+//! With a key installed the packet is encrypted in software, block by block, as the radio's AES engine would.
+//! The packet engine's address filter is emulated through its registers: with it on, the first byte of the packet,
+//! RadioHead's "to" header, is the address byte. It stays in the clear, and packets for other nodes are dropped
+//! before they reach the FIFO.
+//! Transmission completes immediately, so timing measured on the host is the software cost of the stack alone.
+//! Alternatively the radio is attached to a SimRadioMedium, which models the air between many radios in one process.
+//! Packets are timestamped as TimestampedRF69 does on the board, with the times they leave the air and arrive in the
+//! medium's clock, or the host's on the loopback link, read through the node's SimRadioClock if it has one.
+class RH_RF69 {
+
+  public:
+
+    //! Modem configurations, named as in RadioHead
+    typedef enum {
+        GFSK_Rb2Fd5 = 0,
+        GFSK_Rb2_4Fd4_8,
+        GFSK_Rb4_8Fd9_6,
+        GFSK_Rb9_6Fd19_2,
+        GFSK_Rb19_2Fd38_4,
+        GFSK_Rb38_4Fd76_8,
+        GFSK_Rb57_6Fd120,
+        GFSK_Rb125Fd125,
+        GFSK_Rb250Fd250,
+        GFSK_Rb55555Fd50
+    } ModemConfigChoice;
+
+    //! Pins are accepted for compatibility and ignored
+    RH_RF69(int slaveSelectPin, int interruptPin);
+
+    ~RH_RF69();
+
+    //! Pins of another radio, likewise ignored
+    void setPins(uint8_t slaveSelectPin, uint8_t interruptPin) {}
+
+    //! Set the loopback ports; must be called before init()
+    void setLink(
+        U16 localPort, //!< Port this node receives on
+        U16 peerPort //!< Port the other node receives on
+    );
+
+    //! Use an in-process medium instead of the loopback link
+    void setMedium(SimRadioMedium& medium);
+
+    //! Read timestamps through a node's clock instead of in true time
+    void setClock(const SimRadioClock& clock);
+
+    //! Hand the radio a packet, RadioHead header first, that reached it over the medium
+    //!
+    //! \return false if an unread packet is still waiting, in which case the new one is lost
+    bool deliver(
+        const U8* data, //!< The packet, airLength(len) bytes when this radio has a key
+        U8 len, //!< The length byte
+        I16 rssi, //!< Signal strength
+        U64 readyUs //!< Time the packet was received
+    );
+
+    //! Microsecond counter now
+    uint32_t counterUs() const;
+
+    //! Microsecond counter when the last packet sent left the air
+    uint32_t txDoneCounter() const { return this->counter(m_txDoneUs); }
+
+    //! Microsecond counter when the last packet received was ready
+    uint32_t rxReadyCounter() const { return this->counter(m_rxReadyUs); }
+
+    //! Bytes on the air after the length byte for a packet of the given length
+    U8 airLength(U8 len) const;
+
+    //! Packets the address filter dropped
+    U32 addressFiltered() const { return m_addressFiltered; }
+
+    //! Tuned frequency in kHz
+    U32 frequencyKhz() const { return m_frequencyKhz; }
+
+    //! Modem configuration
+    U8 modem() const { return m_modem; }
+
+    //! Transmit power in dBm
+    I8 txPower() const { return m_txPower; }
+
+    //! Open the link
+    //!
+    //! \return false if no link or medium is set or the port cannot be bound, as if no radio were fitted
+    bool init();
+
+    //! No bus to start off target; here so the radio component brings up both radios alike
+    void beginBus() {}
+
+    //! Open the link, as TimestampedRF69 initializes the board's radio once its bus has settled
+    bool initRadio() { return init(); }
+
+    bool setFrequency(float centre, float afcPullInRange = 0.05);
+
+    bool setModemConfig(ModemConfigChoice index);
+
+    void setTxPower(int8_t power, bool ishighpowermodule = true);
+
+    void setModeIdle();
+
+    //! Install a key, encrypting every packet sent and decrypting every packet received, or remove it with nullptr
+    void setEncryptionKey(uint8_t* key = nullptr);
+
+    //! Accept packets for any address; the simulated radio never filters, so this is accepted and ignored
+    void setPromiscuous(bool promiscuous);
+
+    //! Address for RadioHead's software filter, which the simulated radio does not apply; see setPromiscuous
+    void setThisAddress(uint8_t thisAddress);
+
+    //! Read a packet engine register; others read as 0
+    uint8_t spiRead(uint8_t reg);
+
+    //! Write a packet engine register; others are ignored
+    uint8_t spiWrite(uint8_t reg, uint8_t val);
+
+    bool send(const uint8_t* data, uint8_t len);
+
+    bool waitPacketSent(uint16_t timeout);
+
+    //! Whether a packet for this frequency and modem configuration is waiting
+    bool available();
+
+    bool recv(uint8_t* buf, uint8_t* len);
+
+    int16_t lastRssi();
+
+    //! Signal strength on the channel now, from the medium; the loopback link is always quiet
+    int8_t rssiRead();
+
+    //! Start measuring the signal strength; the simulated receiver needs no time to start up
+    bool startRssi() { return true; }
+
+    //! Signal strength on the channel now; the simulated receiver is always done measuring
+    bool readRssi(int8_t& rssi) {
+        rssi = rssiRead();
+        return true;
+    }
+
+    void setHeaderTo(uint8_t to);
+
+    void setHeaderFrom(uint8_t from);
+
+    void setHeaderId(uint8_t id);
+
+    uint8_t headerTo();
+
+    uint8_t headerFrom();
+
+    uint8_t headerId();
+
+    void setHeaderFlags(uint8_t set, uint8_t clear = RH_FLAGS_APPLICATION_SPECIFIC);
+
+    uint8_t headerFlags();
+
+    //! Address packets are sent to
+    uint8_t txHeaderTo() const { return m_txHeader[0]; }
+
+    //! Flags packets are sent with
+    uint8_t txHeaderFlags() const { return m_txHeader[3]; }
+
+  private:
+
+    //! Bytes in front of the packet in a datagram: frequency in kHz, modem configuration and length byte
+    static const U32 DATAGRAM_HEADER_SIZE = sizeof(U32) + sizeof(U8) + sizeof(U8);
+
+    //! Accept a packet as received, filtering it by address, decrypting it and splitting off its header
+    //!
+    //! \return false if it is too short to have a header or is for another node
+    bool accept(const U8* data, U8 len, I16 rssi, U64 readyUs);
+
+    //! Microsecond counter at a true time
+    uint32_t counter(U64 trueUs) const;
+
+    //! Bytes at the start of a packet sent and received in the clear: the address byte when the filter is on
+    U8 clearLength() const;
+
+    SimRadioMedium* m_medium; //!< In-process medium, if used
+    const SimRadioClock* m_clock; //!< Clock of the node, if not true time
+    U64 m_txDoneUs; //!< Time the last packet sent left the air
+    U64 m_rxReadyUs; //!< Time the packet in m_rxBuffer was received
+    int m_fd; //!< Loopback socket
+    U16 m_localPort; //!< Port this node receives on
+    U16 m_peerPort; //!< Port the other node receives on
+    U32 m_frequencyKhz; //!< Tuned frequency
+    U8 m_modem; //!< Modem configuration
+    I8 m_txPower; //!< Transmit power
+    I16 m_lastRssi; //!< Signal strength of the last packet received
+    U8 m_txHeader[RH_RF69_HEADER_LEN]; //!< Header of packets sent: to, from, id and flags
+    U8 m_rxHeader[RH_RF69_HEADER_LEN]; //!< Header of the last packet received
+    U8 m_rxBuffer[RH_RF69_MAX_MESSAGE_LEN]; //!< Payload waiting to be received
+    U8 m_rxLength; //!< Bytes in m_rxBuffer, 0 if none
+    bool m_encrypt; //!< Whether a key is installed
+    SoftAes128 m_aes; //!< The installed key
+    U8 m_packetConfig1; //!< RH_RF69_REG_37_PACKETCONFIG1
+    U8 m_nodeAddress; //!< RH_RF69_REG_39_NODEADRS
+    U8 m_broadcastAddress; //!< RH_RF69_REG_3A_BROADCASTADRS
+    U32 m_addressFiltered; //!< Packets the address filter dropped
+};
+
+//! The simulated radio timestamps its packets itself
+typedef RH_RF69 TimestampedRF69;
+
+#endif
@@ -0,0 +1,148 @@
+// ======================================================================
+// \title  SoftAes128.cpp
+// \brief  AES-128 in software for the simulated radio
+// ======================================================================
+
+#include <Components/Radio/RFM69/SoftAes128.hpp>
+
+#include <cstring>
+
+namespace {
+  const U8 SBOX[256] = {
+      0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+      0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+      0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+      0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+      0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+      0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+      0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+      0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+      0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+      0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+      0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+      0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+      0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+      0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+      0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+      0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16};
+
+  const U8 RCON[10] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36};
+
+  //! Inverse S-box, built from the S-box on first use
+  const U8* inverseSbox() {
+    static U8 inverse[256];
+    static bool built = false;
+    if (not built) {
+      for (U32 i = 0; i < 256; i++) {
+        inverse[SBOX[i]] = static_cast<U8>(i);
+      }
+      built = true;
+    }
+    return inverse;
+  }
+
+  //! Multiply by x in GF(2^8)
+  U8 xtime(U8 value) {
+    return static_cast<U8>((value << 1) ^ ((value & 0x80) ? 0x1b : 0x00));
+  }
+
+  //! Multiply in GF(2^8)
+  U8 multiply(U8 a, U8 b) {
+    U8 product = 0;
+    while (b != 0) {
+      if (b & 1) {
+        product ^= a;
+      }
+      a = xtime(a);
+      b >>= 1;
+    }
+    return product;
+  }
+
+  void addRoundKey(U8* block, const U8* roundKey) {
+    for (U32 i = 0; i < SoftAes128::BLOCK_SIZE; i++) {
+      block[i] ^= roundKey[i];
+    }
+  }
+
+  //! Rotate row r left by r; the block is column-major, byte c * 4 + r
+  void shiftRows(U8* block, bool inverse) {
+    U8 copy[SoftAes128::BLOCK_SIZE];
+    memcpy(copy, block, sizeof(copy));
+    for (U32 c = 0; c < 4; c++) {
+      for (U32 r = 1; r < 4; r++) {
+        const U32 from = inverse ? ((c + 4 - r) % 4) : ((c + r) % 4);
+        block[c * 4 + r] = copy[from * 4 + r];
+      }
+    }
+  }
+
+  void mixColumns(U8* block, bool inverse) {
+    // Coefficients of the first row of the (inverse) MixColumns matrix; the rows are its rotations
+    const U8 forward[4] = {2, 3, 1, 1};
+    const U8 backward[4] = {14, 11, 13, 9};
+    const U8* const coefficients = inverse ? backward : forward;
+    for (U32 c = 0; c < 4; c++) {
+      U8 column[4];
+      memcpy(column, &block[c * 4], sizeof(column));
+      for (U32 r = 0; r < 4; r++) {
+        U8 value = 0;
+        for (U32 i = 0; i < 4; i++) {
+          value ^= multiply(column[i], coefficients[(i + 4 - r) % 4]);
+        }
+        block[c * 4 + r] = value;
+      }
+    }
+  }
+}
+
+SoftAes128::SoftAes128() {
+    memset(m_roundKeys, 0, sizeof(m_roundKeys));
+}
+
+void SoftAes128::setKey(const U8 key[BLOCK_SIZE]) {
+    memcpy(m_roundKeys, key, BLOCK_SIZE);
+    for (U32 i = BLOCK_SIZE; i < sizeof(m_roundKeys); i += 4) {
+        U8 word[4];
+        memcpy(word, &m_roundKeys[i - 4], sizeof(word));
+        if ((i % BLOCK_SIZE) == 0) {
+            const U8 first = word[0];
+            word[0] = static_cast<U8>(SBOX[word[1]] ^ RCON[i / BLOCK_SIZE - 1]);
+            word[1] = SBOX[word[2]];
+            word[2] = SBOX[word[3]];
+            word[3] = SBOX[first];
+        }
+        for (U32 j = 0; j < 4; j++) {
+            m_roundKeys[i + j] = static_cast<U8>(m_roundKeys[i + j - BLOCK_SIZE] ^ word[j]);
+        }
+    }
+}
+
+void SoftAes128::encryptBlock(U8 block[BLOCK_SIZE]) const {
+    addRoundKey(block, m_roundKeys);
+    for (U32 round = 1; round <= ROUNDS; round++) {
+        for (U32 i = 0; i < BLOCK_SIZE; i++) {
+            block[i] = SBOX[block[i]];
+        }
+        shiftRows(block, false);
+        if (round < ROUNDS) {
+            mixColumns(block, false);
+        }
+        addRoundKey(block, &m_roundKeys[round * BLOCK_SIZE]);
+    }
+}
+
+void SoftAes128::decryptBlock(U8 block[BLOCK_SIZE]) const {
+    const U8* const inverse = inverseSbox();
+    addRoundKey(block, &m_roundKeys[ROUNDS * BLOCK_SIZE]);
+    for (U32 round = ROUNDS; round >= 1; round--) {
+        shiftRows(block, true);
+        for (U32 i = 0; i < BLOCK_SIZE; i++) {
+            block[i] = inverse[block[i]];
+        }
+        addRoundKey(block, &m_roundKeys[(round - 1) * BLOCK_SIZE]);
+        if (round > 1) {
+            mixColumns(block, true);
+        }
+    }
+}
@@ -0,0 +1,41 @@
+// ======================================================================
+// \title  SoftAes128.hpp
+// \brief  AES-128 in software for the simulated radio
+// ======================================================================
+
+#ifndef SOFT_AES128_HPP
+#define SOFT_AES128_HPP
+
+#include <FpConfig.hpp>
+
+//! AES-128 block cipher in software, standing in for the AES engine of the RFM69 on host builds
+//!
+//! The radio encrypts each 16-byte block of a packet on its own (ECB) with the installed key, and so does this. It is
+//! written for clarity and portability, not speed; its cost on the host is the cost the hardware engine saves.
+class SoftAes128 {
+
+  public:
+
+    //! Bytes in a key and in a block
+    static const U32 BLOCK_SIZE = 16;
+
+    SoftAes128();
+
+    //! Expand a key for use
+    void setKey(const U8 key[BLOCK_SIZE]);
+
+    //! Encrypt one block in place
+    void encryptBlock(U8 block[BLOCK_SIZE]) const;
+
+    //! Decrypt one block in place
+    void decryptBlock(U8 block[BLOCK_SIZE]) const;
+
+  private:
+
+    //! Rounds of AES-128
+    static const U32 ROUNDS = 10;
+
+    U8 m_roundKeys[(ROUNDS + 1) * BLOCK_SIZE]; //!< Expanded key
+};
+
+#endif
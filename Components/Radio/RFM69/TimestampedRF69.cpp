@@ -0,0 +1,92 @@
+// ======================================================================
+// \title  TimestampedRF69.cpp
+// \brief  RadioHead RH_RF69 driver that timestamps its packet interrupts
+// ======================================================================
+
+#include <Components/Radio/RFM69/TimestampedRF69.hpp>
+
+TimestampedRF69* TimestampedRF69::s_radios[MAX_RADIOS] = {};
+
+TimestampedRF69::TimestampedRF69(uint8_t slaveSelectPin, uint8_t interruptPin)
+    : RH_RF69(slaveSelectPin, interruptPin), m_interruptPin(interruptPin), m_txDoneCounter(0), m_rxReadyCounter(0) {}
+
+void TimestampedRF69::setPins(uint8_t slaveSelectPin, uint8_t interruptPin) {
+    setSlaveSelectPin(slaveSelectPin);
+    _interruptPin = interruptPin;
+    m_interruptPin = interruptPin;
+}
+
+void TimestampedRF69::beginBus() {
+    _spi.begin();
+    // On some cores the pin mode must be set after the bus has begun
+    if (_slaveSelectPin != 0xff) {
+        pinMode(_slaveSelectPin, OUTPUT);
+    }
+    deselectSlave();
+}
+
+bool TimestampedRF69::initRadio() {
+    // A radio that is missing, or still in reset, reads as all zeros or all ones
+    _deviceType = spiRead(RH_RF69_REG_10_VERSION);
+    if ((_deviceType == 0x00) || (_deviceType == 0xff)) {
+        return false;
+    }
+    pinMode(m_interruptPin, INPUT);
+    setModeIdle();
+
+    // The registers and defaults RH_RF69::init sets, so the radio is in the state RadioHead expects
+    spiWrite(RH_RF69_REG_3C_FIFOTHRESH, RH_RF69_FIFOTHRESH_TXSTARTCONDITION_NOTEMPTY | 0x0f);
+    spiWrite(RH_RF69_REG_6F_TESTDAGC, RH_RF69_TESTDAGC_CONTINUOUSDAGC_IMPROVED_LOWBETAOFF);
+    spiWrite(RH_RF69_REG_5A_TESTPA1, RH_RF69_TESTPA1_NORMAL);
+    spiWrite(RH_RF69_REG_5C_TESTPA2, RH_RF69_TESTPA2_NORMAL);
+    uint8_t syncWords[] = {0x2d, 0xd4};
+    setSyncWords(syncWords, sizeof(syncWords));
+    setModemConfig(GFSK_Rb250Fd250);
+    setPreambleLength(4);
+    setFrequency(434.0);
+    setEncryptionKey(nullptr);
+    setTxPower(13);
+
+    // A radio initialized again, after a reset, keeps its slot
+    uint8_t slot = 0;
+    while ((slot < MAX_RADIOS) && (s_radios[slot] != nullptr) && (s_radios[slot] != this)) {
+        slot++;
+    }
+    if (slot == MAX_RADIOS) {
+        return false;
+    }
+    void (*const handlers[MAX_RADIOS])() = {isr<0>, isr<1>, isr<2>};
+    s_radios[slot] = this;
+    attachInterrupt(digitalPinToInterrupt(m_interruptPin), handlers[slot], RISING);
+    return true;
+}
+
+bool TimestampedRF69::startRssi() {
+    if (_mode == RHModeTx) {
+        return false;
+    }
+    // A receiver just switched on finishes the measurement once it has started up
+    if (_mode != RHModeRx) {
+        setModeRx();
+    }
+    spiWrite(RH_RF69_REG_23_RSSICONFIG, RH_RF69_RSSICONFIG_RSSISTART);
+    return true;
+}
+
+bool TimestampedRF69::readRssi(int8_t& rssi) {
+    if ((_mode != RHModeRx) || ((spiRead(RH_RF69_REG_23_RSSICONFIG) & RH_RF69_RSSICONFIG_RSSIDONE) == 0)) {
+        return false;
+    }
+    rssi = rssiRead();
+    return true;
+}
+
+void TimestampedRF69::interrupt() {
+    const uint32_t now = micros();
+    if (_mode == RHModeTx) {
+        m_txDoneCounter = now;
+    } else if (_mode == RHModeRx) {
+        m_rxReadyCounter = now;
+    }
+    handleInterrupt();
+}
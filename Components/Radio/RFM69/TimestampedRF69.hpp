@@ -0,0 +1,86 @@
+// ======================================================================
+// \title  TimestampedRF69.hpp
+// \brief  RadioHead RH_RF69 driver that timestamps its packet interrupts
+// ======================================================================
+
+#ifndef TIMESTAMPED_RF69_HPP
+#define TIMESTAMPED_RF69_HPP
+
+#include "RH_RF69.h"
+
+//! RH_RF69 with the microsecond counter captured on entry to every radio interrupt
+//!
+//! The radio raises its interrupt line when a packet has left the air (PacketSent) and when one has been received
+//! (PayloadReady). RadioHead services both in its own handler, so the counter is read ahead of it, in an interrupt
+//! handler attached in place of RadioHead's, and kept by the mode the radio was in. A timestamp taken there
+//! is a fixed interrupt latency after the packet ends, where one taken when the rate group polls could be a whole
+//! tick late. A board drives as many radios as RadioHead has interrupt vectors for, each on its own pins.
+class TimestampedRF69 : public RH_RF69 {
+
+  public:
+
+    TimestampedRF69(uint8_t slaveSelectPin, uint8_t interruptPin);
+
+    //! Drive the radio on other pins; must be called before beginBus()
+    void setPins(uint8_t slaveSelectPin, uint8_t interruptPin);
+
+    //! Start the SPI bus and deselect the radio, as RHSPIDriver::init does without its 100 ms sleep
+    //!
+    //! The caller waits for the radio to settle before initRadio(), so the wait need not block.
+    void beginBus();
+
+    //! Initialize the radio as RH_RF69::init does, on a bus already begun, and take over its interrupt line
+    //!
+    //! \return false if no radio answers or every interrupt handler is taken
+    bool initRadio();
+
+    //! Start measuring the signal strength on the channel, putting the radio in receive first
+    //!
+    //! REG_24 holds the last measurement the receiver made, which is stale, or meaningless, unless the radio has
+    //! been receiving; so a measurement is started, to be read with readRssi once it is done.
+    //!
+    //! \return false if the radio is transmitting
+    bool startRssi();
+
+    //! Read the measurement startRssi started, without waiting for it
+    //!
+    //! \return false if it has not finished, or the radio has left receive since
+    bool readRssi(int8_t& rssi);
+
+    //! Microsecond counter now
+    uint32_t counterUs() const { return micros(); }
+
+    //! Microsecond counter when the last packet sent left the air
+    uint32_t txDoneCounter() const { return m_txDoneCounter; }
+
+    //! Microsecond counter when the last packet received was ready
+    uint32_t rxReadyCounter() const { return m_rxReadyCounter; }
+
+    //! Address packets are sent to, which RadioHead keeps to itself
+    uint8_t txHeaderTo() const { return _txHeaderTo; }
+
+    //! Flags packets are sent with
+    uint8_t txHeaderFlags() const { return _txHeaderFlags; }
+
+  private:
+
+    //! Radios on the board, one per interrupt handler
+    static const uint8_t MAX_RADIOS = RH_RF69_NUM_INTERRUPTS;
+
+    //! Interrupt handler of the radio in one slot: timestamp, then hand over to RadioHead
+    template <uint8_t slot>
+    static void isr() {
+        s_radios[slot]->interrupt();
+    }
+
+    //! Timestamp an interrupt and service it
+    void interrupt();
+
+    static TimestampedRF69* s_radios[MAX_RADIOS]; //!< The radio whose interrupts each handler takes
+
+    uint8_t m_interruptPin; //!< Pin of the radio's interrupt line
+    volatile uint32_t m_txDoneCounter; //!< Counter at the last PacketSent interrupt
+    volatile uint32_t m_rxReadyCounter; //!< Counter at the last PayloadReady interrupt
+};
+
+#endif
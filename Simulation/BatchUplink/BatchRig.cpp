@@ -0,0 +1,335 @@
+// ======================================================================
+// \title  BatchRig.cpp
+// \brief  Uplinks the same commands one frame at a time and as one batch, and compares the time each takes
+// ======================================================================
+
+#include <Simulation/BatchUplink/BatchRig.hpp>
+#include <Simulation/Tool/Tool.hpp>
+#include <Fw/Com/ComPacket.hpp>
+#include <Fw/Types/Assert.hpp>
+#include <config/FppConstantsAc.hpp>
+
+#include <chrono>
+
+namespace Simulation {
+
+  namespace {
+    //! The batcher's generated channel ids, which its component base keeps protected
+    struct BatcherChannels : Components::CommandBatcherComponentBase {
+      enum : FwChanIdType {
+        LAST_BATCH = CHANNELID_LASTBATCH
+      };
+    };
+
+    //! Runs messages off the dispatcher's queue on the rig's thread, as its own thread would. The queue is reached
+    //! through pointers to QueuedComponentBase's members, which the generated component bases keep out of reach.
+    struct QueueAccess : Fw::QueuedComponentBase {
+      static void drain(Fw::QueuedComponentBase& component) {
+        while ((component.*(&QueueAccess::getNumMsgs))() > 0) {
+          const MsgDispatchStatus status = (component.*(&QueueAccess::doDispatch))();
+          FW_ASSERT(status == MSG_DISPATCH_OK, status);
+        }
+      }
+    };
+
+    //! Bytes of an event packet ahead of its arguments
+    const U32 EVENT_HEADER_SIZE = sizeof(FwPacketDescriptorType) + sizeof(FwEventIdType) + Fw::Time::SERIALIZED_SIZE;
+
+    //! Bytes of a frame around its packet
+    const U32 FRAME_OVERHEAD = Svc::FpFrameHeader::SIZE + Framing::FRAME_CRC_SIZE;
+
+    //! Bytes of the OpCodeCompleted frame the ground waits for after a single command
+    const U32 COMMAND_COMPLETED_FRAME = FRAME_OVERHEAD + EVENT_HEADER_SIZE + sizeof(U32);
+
+    //! Bytes of the BatchCompleted frame the ground waits for after a batch
+    const U32 BATCH_COMPLETED_FRAME = FRAME_OVERHEAD + EVENT_HEADER_SIZE + sizeof(U16) + 3 * sizeof(U8) +
+                                      sizeof(U32) + Fw::CmdResponse::SERIALIZED_SIZE;
+
+    //! Bytes of a command's index, the first of its arguments
+    const U32 INDEX_SIZE = sizeof(U32);
+
+    F64 secondsSince(std::chrono::steady_clock::time_point start) {
+      return std::chrono::duration<F64>(std::chrono::steady_clock::now() - start).count();
+    }
+  }
+
+  BatchRig ::
+    BatchRig(const BatchOptions& options) :
+      Fw::PassiveComponentBase("rig"),
+      m_options(options),
+      m_current(nullptr),
+      m_completions(0),
+      m_batchFrameBytes(0),
+      m_packetOut(false),
+      m_batchReported(false),
+      m_deframer("deframer"),
+      m_batcher("cmdBatcher"),
+      m_dispatcher("cmdDisp")
+  {
+    m_single = Exchange();
+    m_single.inOrder = true;
+    m_batched = Exchange();
+    m_batched.inOrder = true;
+
+    Fw::PassiveComponentBase::init(0);
+    m_deframer.init(0);
+    m_batcher.init(0);
+    m_dispatcher.init(QUEUE_DEPTH, 0);
+
+    m_allocateIn.init();
+    m_allocateIn.addCallComp(this, allocateIn);
+    m_allocateIn.setPortNum(0);
+    m_deallocateIn.init();
+    m_deallocateIn.addCallComp(this, deallocateIn);
+    m_deallocateIn.setPortNum(0);
+    m_cmdIn.init();
+    m_cmdIn.addCallComp(this, cmdIn);
+    m_cmdIn.setPortNum(0);
+    m_groundStatusIn.init();
+    m_groundStatusIn.addCallComp(this, groundStatusIn);
+    m_groundStatusIn.setPortNum(0);
+    m_tlmIn.init();
+    m_tlmIn.addCallComp(this, tlmIn);
+    m_tlmIn.setPortNum(0);
+
+    // The uplink as the deployment wires it: single commands on the dispatcher's first sequence port, batches on
+    // a port of their own
+    m_deframer.set_framedDeallocate_OutputPort(0, &m_deallocateIn);
+    m_deframer.set_bufferAllocate_OutputPort(0, &m_allocateIn);
+    m_deframer.set_bufferDeallocate_OutputPort(0, &m_deallocateIn);
+    m_deframer.set_comOut_OutputPort(0, m_dispatcher.get_seqCmdBuff_InputPort(0));
+    m_deframer.set_batchOut_OutputPort(0, m_batcher.get_batchIn_InputPort(0));
+    m_deframer.setup(m_protocol);
+    m_batcher.set_seqCmdOut_OutputPort(0, m_dispatcher.get_seqCmdBuff_InputPort(1));
+    m_batcher.set_bufferDeallocate_OutputPort(0, &m_deallocateIn);
+    m_batcher.set_tlmOut_OutputPort(0, &m_tlmIn);
+    m_dispatcher.set_seqCmdStatus_OutputPort(0, &m_groundStatusIn);
+    m_dispatcher.set_seqCmdStatus_OutputPort(1, m_batcher.get_seqCmdStatus_InputPort(0));
+
+    FW_ASSERT(fits(m_options), m_options.commands, m_options.argumentBytes);
+    for (U32 index = 0; index < m_options.commands; index++) {
+      const FwIndexType component = static_cast<FwIndexType>(index / COMMANDS_PER_COMPONENT);
+      m_dispatcher.set_compCmdSend_OutputPort(component, &m_cmdIn);
+      m_dispatcher.get_compCmdReg_InputPort(component)->invoke(opCodeOf(index));
+    }
+  }
+
+  bool BatchRig ::
+    fits(const BatchOptions& options)
+  {
+    const U32 commandSize = sizeof(FwPacketDescriptorType) + sizeof(FwOpcodeType) + options.argumentBytes;
+    const U32 frameSize = FRAME_OVERHEAD + sizeof(FwPacketDescriptorType) + Components::CommandBatcher::HEADER_SIZE +
+                          options.commands * (Components::CommandBatcher::COMMAND_SIZE_SIZE + commandSize);
+    return (options.commands > 0) && (options.commands <= 0xFF) &&
+           (options.commands <= CMD_DISPATCHER_DISPATCH_TABLE_SIZE) && (options.argumentBytes >= INDEX_SIZE) &&
+           (commandSize <= FW_COM_BUFFER_MAX_SIZE) && (frameSize <= Svc::DeframerCfg::RING_BUFFER_SIZE);
+  }
+
+  void BatchRig ::
+    run()
+  {
+    std::vector<U8> frame;
+    Fw::ComBuffer packet;
+
+    m_current = &m_single;
+    for (U32 index = 0; index < m_options.commands; index++) {
+      this->buildCommand(index, packet);
+      this->buildFrame(Fw::ComPacket::FW_PACKET_COMMAND, packet.getBuffAddr() + sizeof(FwPacketDescriptorType),
+                       packet.getBuffLength() - sizeof(FwPacketDescriptorType), frame);
+      const U32 completions = m_completions;
+      this->feed(frame, m_single);
+      // The ground sends the next command once this one's completion has come down
+      FW_ASSERT(m_completions == completions + 1, index);
+      m_single.exchanges++;
+      m_single.downlinkBytes += COMMAND_COMPLETED_FRAME;
+    }
+
+    // The batch: id, flags, count, then each command packet behind its size
+    std::vector<U8> batch;
+    batch.push_back(static_cast<U8>(BATCH_ID >> 8));
+    batch.push_back(static_cast<U8>(BATCH_ID));
+    batch.push_back(Components::CommandBatcher::FLAG_STOP_ON_ERROR);
+    batch.push_back(static_cast<U8>(m_options.commands));
+    for (U32 index = 0; index < m_options.commands; index++) {
+      this->buildCommand(index, packet);
+      const U32 size = packet.getBuffLength();
+      batch.push_back(static_cast<U8>(size >> 8));
+      batch.push_back(static_cast<U8>(size));
+      batch.insert(batch.end(), packet.getBuffAddr(), packet.getBuffAddr() + size);
+    }
+    this->buildFrame(CommandBatchPacketType, batch.data(), static_cast<U32>(batch.size()), frame);
+    m_batchFrameBytes = static_cast<U32>(frame.size());
+
+    m_current = &m_batched;
+    this->feed(frame, m_batched);
+    m_batched.exchanges++;
+    m_batched.downlinkBytes += BATCH_COMPLETED_FRAME;
+    m_current = nullptr;
+  }
+
+  FwOpcodeType BatchRig ::
+    opCodeOf(U32 index)
+  {
+    return FIRST_BASE_ID + (index / COMMANDS_PER_COMPONENT) * 0x100 + (index % COMMANDS_PER_COMPONENT);
+  }
+
+  void BatchRig ::
+    buildCommand(U32 index, Fw::ComBuffer& packet) const
+  {
+    packet.resetSer();
+    Fw::SerializeStatus status =
+        packet.serialize(static_cast<FwPacketDescriptorType>(Fw::ComPacket::FW_PACKET_COMMAND));
+    status = (status == Fw::FW_SERIALIZE_OK) ? packet.serialize(opCodeOf(index)) : status;
+    status = (status == Fw::FW_SERIALIZE_OK) ? packet.serialize(index) : status;
+    for (U32 i = INDEX_SIZE; (i < m_options.argumentBytes) && (status == Fw::FW_SERIALIZE_OK); i++) {
+      status = packet.serialize(static_cast<U8>(i));
+    }
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+  }
+
+  void BatchRig ::
+    buildFrame(FwPacketDescriptorType packetType, const U8* packet, U32 size, std::vector<U8>& frame) const
+  {
+    const U32 packetSize = static_cast<U32>(sizeof(FwPacketDescriptorType)) + size;
+    frame.resize(FRAME_OVERHEAD + packetSize);
+    Fw::ExternalSerializeBuffer serial(frame.data(), static_cast<U32>(frame.size()));
+    Fw::SerializeStatus status = serial.serialize(Svc::FpFrameHeader::START_WORD);
+    status = (status == Fw::FW_SERIALIZE_OK) ? serial.serialize(packetSize) : status;
+    status = (status == Fw::FW_SERIALIZE_OK) ? serial.serialize(packetType) : status;
+    status = (status == Fw::FW_SERIALIZE_OK) ? serial.serialize(packet, size, true) : status;
+    status = (status == Fw::FW_SERIALIZE_OK) ?
+        serial.serialize(Framing::defaultCrc32Engine().compute(frame.data(), serial.getBuffLength())) : status;
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+  }
+
+  void BatchRig ::
+    feed(const std::vector<U8>& frame, Exchange& exchange)
+  {
+    std::vector<U8> received(frame);
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Fw::Buffer buffer(received.data(), static_cast<U32>(received.size()));
+    m_deframer.get_framedIn_InputPort(0)->invoke(buffer, Drv::RecvStatus::RECV_OK);
+    QueueAccess::drain(m_dispatcher);
+    exchange.processingS += secondsSince(start);
+    exchange.uplinkBytes += frame.size();
+  }
+
+  F64 BatchRig ::
+    linkSeconds(const Exchange& exchange) const
+  {
+    const F64 bytesPerSecond = static_cast<F64>(m_options.baud) / 10.0;
+    return static_cast<F64>(exchange.uplinkBytes + exchange.downlinkBytes) / bytesPerSecond +
+           exchange.exchanges * (m_options.turnaroundMs / 1000.0);
+  }
+
+  void BatchRig ::
+    report(FILE* out) const
+  {
+    const F64 single = this->linkSeconds(m_single) + m_single.processingS;
+    const F64 batched = this->linkSeconds(m_batched) + m_batched.processingS;
+    JsonLine(out)
+        .field("commands", m_options.commands)
+        .field("argument_bytes", m_options.argumentBytes)
+        .field("baud", m_options.baud)
+        .field("turnaround_ms", m_options.turnaroundMs)
+        .field("single_frames", m_single.exchanges)
+        .field("single_uplink_bytes", m_single.uplinkBytes)
+        .field("single_downlink_bytes", m_single.downlinkBytes)
+        .field("single_processing_us", m_single.processingS * 1e6, 1)
+        .field("single_s", single, 3)
+        .field("batch_frame_bytes", m_batchFrameBytes)
+        .field("batch_downlink_bytes", m_batched.downlinkBytes)
+        .field("batch_processing_us", m_batched.processingS * 1e6, 1)
+        .field("batch_s", batched, 3)
+        .field("speedup", (batched > 0.0) ? (single / batched) : 0.0, 2)
+        .field("single_in_order", m_single.inOrder && (m_single.received == m_options.commands))
+        .field("batch_in_order", m_batched.inOrder && (m_batched.received == m_options.commands))
+        .field("batch_total", static_cast<U32>(m_lastBatch.get_total()))
+        .field("batch_dispatched", static_cast<U32>(m_lastBatch.get_dispatched()))
+        .field("batch_succeeded", static_cast<U32>(m_lastBatch.get_succeeded()))
+        .field("batch_failed_index", static_cast<U32>(m_lastBatch.get_failedIndex()))
+        .field("passed", this->passed())
+        .end();
+  }
+
+  bool BatchRig ::
+    passed() const
+  {
+    const bool batchReported = m_batchReported && (m_lastBatch.get_batchId() == BATCH_ID) &&
+                               (m_lastBatch.get_total() == m_options.commands) &&
+                               (m_lastBatch.get_succeeded() == m_options.commands) &&
+                               (m_lastBatch.get_failedIndex() == m_options.commands);
+    return m_single.inOrder && (m_single.received == m_options.commands) && (m_completions == m_options.commands) &&
+           m_batched.inOrder && (m_batched.received == m_options.commands) && batchReported && not m_packetOut &&
+           ((this->linkSeconds(m_batched) + m_batched.processingS) <
+            (this->linkSeconds(m_single) + m_single.processingS));
+  }
+
+  // ----------------------------------------------------------------------
+  // Ports
+  // ----------------------------------------------------------------------
+
+  Fw::Buffer BatchRig ::
+    allocateIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, U32 size)
+  {
+    BatchRig& rig = *static_cast<BatchRig*>(callComp);
+    // One packet is deframed at a time, and a batch is finished before the rig sends the next frame
+    FW_ASSERT(not rig.m_packetOut);
+    FW_ASSERT(size <= sizeof(rig.m_packet), size);
+    rig.m_packetOut = true;
+    return Fw::Buffer(rig.m_packet, size);
+  }
+
+  void BatchRig ::
+    deallocateIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Buffer& buffer)
+  {
+    BatchRig& rig = *static_cast<BatchRig*>(callComp);
+    // Received frames are the rig's own copies; only the pool buffer is tracked
+    if (buffer.getData() == rig.m_packet) {
+      FW_ASSERT(rig.m_packetOut);
+      rig.m_packetOut = false;
+    }
+  }
+
+  void BatchRig ::
+    cmdIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwOpcodeType opCode, U32 cmdSeq,
+          Fw::CmdArgBuffer& args)
+  {
+    BatchRig& rig = *static_cast<BatchRig*>(callComp);
+    FW_ASSERT(rig.m_current != nullptr);
+    Exchange& exchange = *rig.m_current;
+    U32 index = 0;
+    args.resetDeser();
+    const Fw::SerializeStatus status = args.deserialize(index);
+    if ((status != Fw::FW_SERIALIZE_OK) || (index != exchange.received)) {
+      exchange.inOrder = false;
+    }
+    exchange.received++;
+    rig.m_dispatcher.get_compCmdStat_InputPort(0)->invoke(opCode, cmdSeq, Fw::CmdResponse::OK);
+  }
+
+  void BatchRig ::
+    groundStatusIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwOpcodeType opCode, U32 cmdSeq,
+                   const Fw::CmdResponse& response)
+  {
+    BatchRig& rig = *static_cast<BatchRig*>(callComp);
+    if (response.e == Fw::CmdResponse::OK) {
+      rig.m_completions++;
+    }
+  }
+
+  void BatchRig ::
+    tlmIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwChanIdType id, Fw::Time& timeTag,
+          Fw::TlmBuffer& val)
+  {
+    BatchRig& rig = *static_cast<BatchRig*>(callComp);
+    if ((id - rig.m_batcher.getIdBase()) != BatcherChannels::LAST_BATCH) {
+      return;
+    }
+    val.resetDeser();
+    const Fw::SerializeStatus status = rig.m_lastBatch.deserialize(val);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    rig.m_batchReported = true;
+  }
+
+}
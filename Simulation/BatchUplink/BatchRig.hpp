@@ -0,0 +1,143 @@
+// ======================================================================
+// \title  BatchRig.hpp
+// \brief  Uplinks the same commands one frame at a time and as one batch, and compares the time each takes
+// ======================================================================
+
+#ifndef Simulation_BatchRig_HPP
+#define Simulation_BatchRig_HPP
+
+#include <Components/CommandBatcher/CommandBatcher.hpp>
+#include <Components/Framing/Deframer.hpp>
+#include <Components/Framing/FastFprimeProtocol.hpp>
+#include <Components/IndexedCommandDispatcher/IndexedCommandDispatcher.hpp>
+#include <Fw/Buffer/BufferGetPortAc.hpp>
+#include <Fw/Buffer/BufferSendPortAc.hpp>
+#include <Fw/Cmd/CmdPortAc.hpp>
+#include <Fw/Cmd/CmdResponsePortAc.hpp>
+#include <Fw/Tlm/TlmPortAc.hpp>
+#include <config/DeframerCfg.hpp>
+
+#include <cstdio>
+#include <vector>
+
+namespace Simulation {
+
+  //! The commands uplinked and the link they cross
+  struct BatchOptions {
+    U32 commands; //!< Commands uplinked
+    U32 argumentBytes; //!< Bytes of arguments each command carries
+    U32 baud; //!< Line rate of the ground link; a byte takes ten bit times each way, as 8N1 carries
+    U32 turnaroundMs; //!< Milliseconds the link and the ground add to each exchange, on top of the bytes
+  };
+
+  //! Runs the uplink command path of the deployment, deframer to command dispatcher to the commanded components, and
+  //! sends it the same commands twice: one frame per command, waiting for each completion before the next as a
+  //! ground script that checks its commands does, and then all of them in one CommandBatcher batch
+  //!
+  //! The components run on the host and their time is measured; the link is simulated from the bytes each way and
+  //! the turnaround. Each exchange costs the frames uplinked, the processing, and the completion event downlinked:
+  //! OpCodeCompleted for each single command, BatchCompleted for the batch. The commanded components complete each
+  //! command at once, and check that the commands arrive in order.
+  class BatchRig : public Fw::PassiveComponentBase {
+
+    public:
+
+      BatchRig(
+          const BatchOptions& options //!< The commands and the link
+      );
+
+      //! Whether the commands fit a batch: the dispatch table must hold their opcodes, and the batch frame the
+      //! deframer's ring
+      static bool fits(const BatchOptions& options);
+
+      //! Uplink the commands one at a time, then as a batch
+      void run();
+
+      //! Write the results as one line of JSON
+      void report(FILE* out) const;
+
+      //! Whether both ways dispatched every command in order, the batch reported them all, and it was faster
+      bool passed() const;
+
+    private:
+
+      //! Commands each commanded component registers, as in the dispatch benchmarks
+      static const U32 COMMANDS_PER_COMPONENT = 8;
+
+      //! Base ID of the first commanded component; the rest follow 0x100 apart, as the deployment spaces them
+      static const FwOpcodeType FIRST_BASE_ID = 0x1000;
+
+      //! Messages the dispatcher's queue holds: a command and its status at a time
+      static const NATIVE_INT_TYPE QUEUE_DEPTH = 4;
+
+      //! Batch identifier the rig uses
+      static const U16 BATCH_ID = 0x0BA7;
+
+      //! What one way of uplinking cost
+      struct Exchange {
+        U32 exchanges; //!< Frames sent and completions waited for
+        U64 uplinkBytes; //!< Frame bytes uplinked
+        U64 downlinkBytes; //!< Frame bytes of completion events downlinked
+        F64 processingS; //!< Seconds the components took
+        U32 received; //!< Commands the commanded components received in order
+        bool inOrder; //!< Whether every command arrived in order
+      };
+
+      //! Opcode of a command in the uplink
+      static FwOpcodeType opCodeOf(U32 index);
+
+      //! Command packet of a command in the uplink, packet type included
+      void buildCommand(U32 index, Fw::ComBuffer& packet) const;
+
+      //! Frame a packet for the uplink
+      void buildFrame(FwPacketDescriptorType packetType, const U8* packet, U32 size, std::vector<U8>& frame) const;
+
+      //! Feed a frame to the deframer and run the dispatcher until its queue is empty
+      void feed(const std::vector<U8>& frame, Exchange& exchange);
+
+      //! Seconds an exchange takes on the link and on the host
+      F64 linkSeconds(const Exchange& exchange) const;
+
+      //! Deframed packets, from the one buffer the rig's pool has
+      static Fw::Buffer allocateIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, U32 size);
+
+      //! Returned frames and packets
+      static void deallocateIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Buffer& buffer);
+
+      //! Commands dispatched to the commanded components, completed at once
+      static void cmdIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwOpcodeType opCode,
+                        U32 cmdSeq, Fw::CmdArgBuffer& args);
+
+      //! Status of the single commands, which the ground learns from their OpCodeCompleted events
+      static void groundStatusIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwOpcodeType opCode,
+                                 U32 cmdSeq, const Fw::CmdResponse& response);
+
+      //! The batcher's telemetry
+      static void tlmIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwChanIdType id,
+                        Fw::Time& timeTag, Fw::TlmBuffer& val);
+
+      BatchOptions m_options; //!< The commands and the link
+      Exchange m_single; //!< The commands one frame at a time
+      Exchange m_batched; //!< The commands as a batch
+      Exchange* m_current; //!< The way being run
+      U32 m_completions; //!< Single commands the ground saw complete with OK
+      U32 m_batchFrameBytes; //!< Bytes of the batch frame
+      bool m_packetOut; //!< Whether the pool's buffer is out
+      bool m_batchReported; //!< Whether LastBatch came out
+      Components::CommandBatchStatus m_lastBatch; //!< Latest LastBatch
+
+      U8 m_packet[Svc::DeframerCfg::RING_BUFFER_SIZE]; //!< The pool's one buffer
+      Fw::InputBufferGetPort m_allocateIn; //!< Port behind the deframer's bufferAllocate
+      Fw::InputBufferSendPort m_deallocateIn; //!< Port behind every deallocate port
+      Fw::InputCmdPort m_cmdIn; //!< Port behind the dispatcher's compCmdSend
+      Fw::InputCmdResponsePort m_groundStatusIn; //!< Port behind the dispatcher's seqCmdStatus for the deframer
+      Fw::InputTlmPort m_tlmIn; //!< Port behind the batcher's tlmOut
+      Framing::FastFprimeDeframing m_protocol; //!< The deframing protocol
+      Framing::Deframer m_deframer; //!< The deframer
+      Components::CommandBatcher m_batcher; //!< The batcher
+      Components::IndexedCommandDispatcher m_dispatcher; //!< The dispatcher
+  };
+
+}
+
+#endif
@@ -0,0 +1,47 @@
+// ======================================================================
+// \title  Main.cpp
+// \brief  Uplinks commands one at a time and as a batch, and reports the time each takes as one line of JSON
+// ======================================================================
+
+#include <Simulation/BatchUplink/BatchRig.hpp>
+#include <Simulation/Tool/Tool.hpp>
+
+#include <cstdio>
+
+/**
+ * \brief run both uplinks and exit with 1 if a command was lost or reordered, or the batch was not faster
+ */
+int main(int argc, char* argv[])
+{
+    Simulation::BatchOptions options = {
+        50,
+        8,
+        115200,
+        100
+    };
+
+    Simulation::ToolOptions command;
+    command.addU32('a', "argument bytes of each command", options.argumentBytes);
+    command.addU32('b', "line rate of the ground link in baud", options.baud, 1);
+    command.addU32('n', "commands uplinked", options.commands);
+    command.addU32('r', "milliseconds of turnaround each exchange adds", options.turnaroundMs);
+    if (not command.parse(argc, argv)) {
+        return command.exitStatus();
+    }
+
+    if (not Simulation::BatchRig::fits(options)) {
+        (void) fprintf(stderr, "%u commands of %u argument bytes do not fit a batch\n", options.commands,
+                       options.argumentBytes);
+        return 1;
+    }
+
+    Simulation::ToolReport report;
+    if (not report.open(command.reportPath())) {
+        return 1;
+    }
+
+    Simulation::BatchRig rig(options);
+    rig.run();
+    rig.report(report.file());
+    return report.finish(rig.passed());
+}
@@ -0,0 +1,145 @@
+// ======================================================================
+// \title  Main.cpp
+// \brief  Decodes health beacons, given as hex, with the schema the flight software packs them with
+// ======================================================================
+
+#include <Components/HealthBeacon/HealthBeaconSchema.hpp>
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+  //! Writes each field of a beacon as a JSON member, null if the beacon had no value for it
+  class JsonSink {
+    public:
+      explicit JsonSink(FILE* out) : m_out(out), m_first(true) {}
+
+      void field(const char* name, bool present, I64 value) {
+        (void) fprintf(m_out, "%s\"%s\": ", m_first ? "" : ", ", name);
+        if (present) {
+          (void) fprintf(m_out, "%lld", static_cast<long long>(value));
+        } else {
+          (void) fprintf(m_out, "null");
+        }
+        m_first = false;
+      }
+
+    private:
+      FILE* m_out; //!< Where the report goes
+      bool m_first; //!< Whether no field has been written yet
+  };
+
+  //! Read hex digits into bytes, skipping spaces and colons between them
+  //!
+  //! \return bytes read, or -1 if the text is not whole bytes of hex or longer than size
+  I32 parseHex(const char* text, U8* bytes, U32 size) {
+    U32 count = 0;
+    U32 digits = 0;
+    U8 byte = 0;
+    for (const char* c = text; *c != '\0'; c++) {
+      if (isspace(static_cast<unsigned char>(*c)) || (*c == ':')) {
+        continue;
+      }
+      if (not isxdigit(static_cast<unsigned char>(*c)) || (count >= size)) {
+        return -1;
+      }
+      const U8 nibble = static_cast<U8>(isdigit(static_cast<unsigned char>(*c)) ? (*c - '0')
+                                                                                 : (tolower(*c) - 'a' + 10));
+      byte = static_cast<U8>((byte << 4) | nibble);
+      if (++digits % 2 == 0) {
+        bytes[count++] = byte;
+        byte = 0;
+      }
+    }
+    return (digits % 2 == 0) ? static_cast<I32>(count) : -1;
+  }
+
+  //! Decode one beacon and write it as a line of JSON
+  //!
+  //! \return false if it is not a beacon of this schema, reported on stderr
+  bool decode(const char* text, FILE* out) {
+    U8 beacon[Components::HealthBeaconCfg::MAX_BEACON_SIZE];
+    const I32 size = parseHex(text, beacon, sizeof(beacon));
+    if (size != static_cast<I32>(Components::HEALTH_BEACON_SIZE)) {
+      (void) fprintf(stderr, "%s: not %u bytes of hex\n", text, Components::HEALTH_BEACON_SIZE);
+      return false;
+    }
+    if (beacon[0] != Components::HealthBeaconCfg::BEACON_MARKER) {
+      (void) fprintf(stderr, "%s: not a health beacon\n", text);
+      return false;
+    }
+    const U16 layout = static_cast<U16>((beacon[1] << 8) | beacon[2]);
+    if (layout != Components::HEALTH_BEACON_LAYOUT) {
+      (void) fprintf(stderr, "%s: layout %04x, not this decoder's %04x\n", text, layout,
+                     Components::HEALTH_BEACON_LAYOUT);
+      return false;
+    }
+    const U32 seconds = (static_cast<U32>(beacon[4]) << 24) | (static_cast<U32>(beacon[5]) << 16) |
+                        (static_cast<U32>(beacon[6]) << 8) | beacon[7];
+    (void) fprintf(out, "{\"sequence\": %u, \"time_s\": %u, ", beacon[3], seconds);
+    JsonSink sink(out);
+    Components::HealthBeaconSchema::unpack(&beacon[Components::HEALTH_BEACON_HEADER_SIZE], sink);
+    (void) fprintf(out, "}\n");
+    return true;
+  }
+
+}
+
+/**
+ * \brief print command line help message
+ *
+ * @param app: name of application
+ */
+static void print_usage(const char* app)
+{
+    (void) printf("Usage: ./%s [options] [beacon ...]\n"
+                  "Decodes each beacon given as hex, or each line of stdin if none are given\n"
+                  "-l\tlist the fields of the schema and exit\n",
+                  app);
+}
+
+/**
+ * \brief list the fields, in the order they are packed
+ */
+class ListSink {
+  public:
+    void field(const char* name, bool, I64) { (void) printf("%s\n", name); }
+};
+
+/**
+ * \brief decode every beacon and exit with 1 if any could not be
+ */
+int main(int argc, char* argv[])
+{
+    if ((argc > 1) && (strcmp(argv[1], "-h") == 0)) {
+        print_usage(argv[0]);
+        return 0;
+    }
+    if ((argc > 1) && (strcmp(argv[1], "-l") == 0)) {
+        (void) printf("%u bytes, layout %04x, %u fields in %u bits:\n", Components::HEALTH_BEACON_SIZE,
+                      Components::HEALTH_BEACON_LAYOUT, Components::HealthBeaconSchema::FIELDS,
+                      Components::HealthBeaconSchema::BITS);
+        const U8 zeros[Components::HealthBeaconSchema::BYTES] = {};
+        ListSink sink;
+        Components::HealthBeaconSchema::unpack(zeros, sink);
+        return 0;
+    }
+
+    bool good = true;
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            good = decode(argv[i], stdout) && good;
+        }
+        return good ? 0 : 1;
+    }
+    char line[4 * Components::HealthBeaconCfg::MAX_BEACON_SIZE];
+    while (fgets(line, sizeof(line), stdin) != nullptr) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] != '\0') {
+            good = decode(line, stdout) && good;
+        }
+    }
+    return good ? 0 : 1;
+}
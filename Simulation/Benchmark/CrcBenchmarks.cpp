@@ -0,0 +1,126 @@
+// ======================================================================
+// \title  CrcBenchmarks.cpp
+// \brief  Benchmarks and conformance checks of the framing CRC-32 engines
+// ======================================================================
+
+#include <Simulation/Benchmark/CrcBenchmarks.hpp>
+#include <Components/Framing/Crc32.hpp>
+#include <Fw/Types/Assert.hpp>
+#include <Utils/Hash/Hash.hpp>
+
+namespace Simulation {
+
+  namespace {
+
+    //! Largest span the benchmarks checksum, a ground frame of the largest file packet
+    const U32 MAX_SPAN = 2048;
+
+    //! Spans checked against Utils::Hash at every alignment
+    const U32 CHECKED_SPANS = 300;
+
+    //! The CRC of a span by the stock routine the GDS and Svc::FprimeDeframing use
+    U32 stockCrc(const U8* data, FwSizeType size) {
+      Utils::Hash hash;
+      hash.init();
+      hash.update(data, static_cast<NATIVE_INT_TYPE>(size));
+      U32 value = 0;
+      hash.final(value);
+      return value;
+    }
+
+    //! Data the engines are checked and timed over
+    void fillData(U8* data, U32 size) {
+      U32 state = 0x12345678;
+      for (U32 i = 0; i < size; i++) {
+        // xorshift32, so the data has no runs or period an engine could get right by accident
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        data[i] = static_cast<U8>(state);
+      }
+    }
+
+    //! Check an engine against Utils::Hash, stopping the benchmark on the first difference
+    //!
+    //! The checks are the standard check value, every span up to CHECKED_SPANS bytes at every alignment a word or
+    //! double word load can see, and a frame checksummed in two spans split at every point, as the deframer does
+    //! across the wrap of its ring.
+    void checkConformance(Framing::Crc32Engine& engine, const U8* data) {
+      const U8 check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+      const U32 checkValue = engine.compute(check, sizeof(check));
+      FW_ASSERT(checkValue == 0xCBF43926, checkValue);
+
+      for (U32 offset = 0; offset < 8; offset++) {
+        for (U32 size = 0; size <= CHECKED_SPANS; size++) {
+          const U32 expected = stockCrc(data + offset, size);
+          const U32 actual = engine.compute(data + offset, size);
+          FW_ASSERT(actual == expected, offset, size, actual, expected);
+        }
+      }
+
+      const U32 frameSize = 128;
+      const U32 expected = stockCrc(data, frameSize);
+      for (U32 split = 0; split <= frameSize; split++) {
+        const U32 head = engine.update(Framing::Crc32Engine::INITIAL, data, split);
+        const U32 actual = Framing::Crc32Engine::finalize(engine.update(head, data + split, frameSize - split));
+        FW_ASSERT(actual == expected, split, actual, expected);
+      }
+    }
+
+    //! One span checksummed by an engine, or by Utils::Hash when there is none
+    class CrcSpan : public BenchmarkCase {
+
+      public:
+
+        CrcSpan(const std::string& name, Framing::Crc32Engine* engine, U32 size) :
+            BenchmarkCase(name), m_engine(engine), m_size(size), m_spans(0), m_sum(0) {
+          FW_ASSERT(size <= MAX_SPAN, size);
+          fillData(m_data, sizeof(m_data));
+          if (m_engine != nullptr) {
+            checkConformance(*m_engine, m_data);
+          }
+        }
+
+        void iterate() override {
+          // The running sum keeps the compiler from dropping a result it can see is unused
+          m_sum += (m_engine != nullptr) ? m_engine->compute(m_data, m_size) : stockCrc(m_data, m_size);
+          m_spans++;
+        }
+
+        U64 bufferGets() const override { return 0; }
+        U64 bytesStaged() const override { return 0; }
+        U64 bytesProcessed() const override { return m_spans * m_size; }
+
+      private:
+
+        Framing::Crc32Engine* m_engine;
+        U8 m_data[MAX_SPAN + 8];
+        U32 m_size;
+        U64 m_spans;
+        volatile U32 m_sum;
+    };
+
+    void add(std::vector<BenchmarkFactory>& benchmarks, const char* name, Framing::Crc32Engine* engine, U32 size) {
+      BenchmarkFactory factory;
+      factory.name = std::string("Crc32/") + name + "/" + std::to_string(size);
+      const std::string fullName = factory.name;
+      factory.create = [fullName, engine, size]() -> BenchmarkCase* { return new CrcSpan(fullName, engine, size); };
+      benchmarks.push_back(factory);
+    }
+  }
+
+  std::vector<BenchmarkFactory> crcBenchmarks()
+  {
+    std::vector<BenchmarkFactory> benchmarks;
+    // A hub frame of one radio packet, a command frame, a telemetry frame and a file packet frame
+    for (U32 size : {64U, 256U, 1024U, MAX_SPAN}) {
+      add(benchmarks, "utils_hash", nullptr, size);
+      add(benchmarks, "bytewise", &Framing::bytewiseCrc32(), size);
+      add(benchmarks, "slice_by_4", &Framing::sliceBy4Crc32(), size);
+      add(benchmarks, "slice_by_8", &Framing::sliceBy8Crc32(), size);
+      add(benchmarks, "default", &Framing::defaultCrc32Engine(), size);
+    }
+    return benchmarks;
+  }
+
+}
@@ -0,0 +1,20 @@
+// ======================================================================
+// \title  CrcBenchmarks.hpp
+// \brief  Benchmarks and conformance checks of the framing CRC-32 engines
+// ======================================================================
+
+#ifndef Simulation_Benchmark_CrcBenchmarks_HPP
+#define Simulation_Benchmark_CrcBenchmarks_HPP
+
+#include <Simulation/Benchmark/Harness.hpp>
+
+#include <vector>
+
+namespace Simulation {
+
+  //! The benchmarks of each CRC-32 engine against Utils::Hash, each checked against it before it is timed
+  std::vector<BenchmarkFactory> crcBenchmarks();
+
+}
+
+#endif
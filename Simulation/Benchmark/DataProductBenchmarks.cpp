@@ -0,0 +1,170 @@
+// ======================================================================
+// \title  DataProductBenchmarks.cpp
+// \brief  Benchmarks of the data product record and processing path
+// ======================================================================
+
+#include <Simulation/Benchmark/DataProductBenchmarks.hpp>
+#include <Components/BroncoOreMessageHandler/BroncoOreMessageHandler.hpp>
+#include <Components/DpProcessor/DpProcessor.hpp>
+#include <Fw/Buffer/BufferSendPortAc.hpp>
+#include <Fw/Dp/DpContainer.hpp>
+#include <Fw/Types/Assert.hpp>
+
+namespace Simulation {
+
+  namespace {
+
+    //! The message log container the message handler records into, which its component base keeps protected
+    struct MessageLogProducts : Components::BroncoOreMessageHandlerComponentBase {
+      typedef DpContainer Container;
+      enum : FwDpIdType {
+        MESSAGE_LOG = ContainerId::MessageLog
+      };
+    };
+
+    //! Payloads of the benchmark records
+    enum RecordShape {
+      RECORD_TEXT, //!< Message text, without runs for compression to take out
+      RECORD_RUNS //!< Samples that hold each value for eight records' worth of bytes, as a slow sensor does
+    };
+
+    // ----------------------------------------------------------------------
+    // Mocks
+    // ----------------------------------------------------------------------
+
+    //! Stand-in for DpWriter: takes each processed container, counts the bytes DpProcessor copied back over its data,
+    //! and drops it
+    class WriterSink : public Fw::PassiveComponentBase {
+
+      public:
+
+        WriterSink() : Fw::PassiveComponentBase("dpWriter"), m_bytesCopied(0) {
+          Fw::PassiveComponentBase::init(0);
+          m_productIn.init();
+          m_productIn.addCallComp(this, productIn);
+          m_productIn.setPortNum(0);
+        }
+
+        Fw::InputBufferSendPort* productPort() { return &m_productIn; }
+        U64 bytesCopied() const { return m_bytesCopied; }
+
+      private:
+
+        static void productIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Buffer& buffer) {
+          WriterSink& sink = *static_cast<WriterSink*>(callComp);
+          Fw::DpContainer container;
+          container.setBuffer(buffer);
+          const Fw::SerializeStatus status = container.deserializeHeader();
+          FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+          // The mask is cleared ahead of DpWriter, so it never runs the stages itself
+          FW_ASSERT(container.getProcTypes() == 0, container.getProcTypes());
+          if ((container.m_userData[Components::DpProcessor::FLAGS_OFFSET] &
+               Components::DpProcessor::FLAG_COMPRESSED) != 0) {
+            sink.m_bytesCopied += container.getDataSize();
+          }
+        }
+
+        Fw::InputBufferSendPort m_productIn;
+        U64 m_bytesCopied;
+    };
+
+    // ----------------------------------------------------------------------
+    // Records
+    // ----------------------------------------------------------------------
+
+    //! One record of a given size serialized into the message log container, as the message handler records a
+    //! message. When the container is full it is sent through DpProcessor to a mock writer and a new one is opened
+    //! on the same memory, as the buffer manager would hand it back.
+    class RecordWrite : public BenchmarkCase {
+
+      public:
+
+        RecordWrite(const std::string& name, U32 size, RecordShape shape, Fw::DpCfg::ProcType::SerialType procTypes) :
+            BenchmarkCase(name),
+            m_processor("dpProcessor"),
+            m_size(size),
+            m_procTypes(procTypes),
+            m_opened(0),
+            m_bytesRecorded(0) {
+          m_processor.init(0);
+          m_processor.set_productOut_OutputPort(0, m_writer.productPort());
+          for (U32 i = 0; i < sizeof(m_record); i++) {
+            m_record[i] = (shape == RECORD_TEXT) ? static_cast<U8>('a' + (i % 26)) : static_cast<U8>(i / 8);
+          }
+          this->open();
+        }
+
+        void iterate() override {
+          Fw::SerializeStatus status = m_container.serializeRecord_Message(m_record, m_size);
+          if (status == Fw::FW_SERIALIZE_NO_ROOM_LEFT) {
+            this->send();
+            this->open();
+            status = m_container.serializeRecord_Message(m_record, m_size);
+          }
+          FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+          m_bytesRecorded += sizeof(FwDpIdType) + sizeof(FwSizeType) + m_size;
+        }
+
+        U64 bufferGets() const override { return m_opened; }
+        U64 bytesStaged() const override { return m_bytesRecorded + m_writer.bytesCopied(); }
+
+      private:
+
+        static const FwSizeType DATA_SIZE = Components::BroncoOreMessageHandler::MESSAGE_LOG_DATA_SIZE;
+
+        void open() {
+          const Fw::Buffer buffer(m_memory, static_cast<U32>(Fw::DpContainer::getPacketSizeForDataSize(DATA_SIZE)));
+          m_container = MessageLogProducts::Container(MessageLogProducts::MESSAGE_LOG, buffer, 0);
+          m_container.setProcTypes(m_procTypes);
+          m_opened++;
+        }
+
+        void send() {
+          // What dpSend and the data product manager do on the way to the writer
+          m_container.serializeHeader();
+          Fw::Buffer buffer = m_container.getBuffer();
+          m_processor.get_productIn_InputPort(0)->invoke(buffer);
+        }
+
+        WriterSink m_writer;
+        Components::DpProcessor m_processor;
+        MessageLogProducts::Container m_container;
+        U8 m_memory[Fw::DpContainer::MIN_PACKET_SIZE + DATA_SIZE];
+        U8 m_record[FW_CMD_STRING_MAX_SIZE];
+        U32 m_size;
+        Fw::DpCfg::ProcType::SerialType m_procTypes;
+        U64 m_opened;
+        U64 m_bytesRecorded;
+    };
+
+    void add(std::vector<BenchmarkFactory>& benchmarks, const char* name, U32 size, RecordShape shape,
+             Fw::DpCfg::ProcType::SerialType procTypes) {
+      BenchmarkFactory factory;
+      factory.name = std::string(name) + "/" + std::to_string(size);
+      const std::string fullName = factory.name;
+      factory.create = [fullName, size, shape, procTypes]() -> BenchmarkCase* {
+        return new RecordWrite(fullName, size, shape, procTypes);
+      };
+      benchmarks.push_back(factory);
+    }
+  }
+
+  std::vector<BenchmarkFactory> dataProductBenchmarks()
+  {
+    std::vector<BenchmarkFactory> benchmarks;
+    // The message log's own stages, on text that does not compress and on samples that do, and no stages at all
+    const Fw::DpCfg::ProcType::SerialType messageLogStages =
+        Components::BroncoOreMessageHandler::MESSAGE_LOG_PROC_TYPES;
+    for (U32 size : {16U, 64U, 200U}) {
+      add(benchmarks, "DataProducts/record", size, RECORD_TEXT, messageLogStages);
+    }
+    for (U32 size : {16U, 64U, 200U}) {
+      add(benchmarks, "DataProducts/record_runs", size, RECORD_RUNS, messageLogStages);
+    }
+    for (U32 size : {16U, 64U, 200U}) {
+      add(benchmarks, "DataProducts/record_raw", size, RECORD_TEXT, 0);
+    }
+    return benchmarks;
+  }
+
+}
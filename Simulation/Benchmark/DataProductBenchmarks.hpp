@@ -0,0 +1,20 @@
+// ======================================================================
+// \title  DataProductBenchmarks.hpp
+// \brief  Benchmarks of the data product record and processing path
+// ======================================================================
+
+#ifndef Simulation_Benchmark_DataProductBenchmarks_HPP
+#define Simulation_Benchmark_DataProductBenchmarks_HPP
+
+#include <Simulation/Benchmark/Harness.hpp>
+
+#include <vector>
+
+namespace Simulation {
+
+  //! The benchmarks of records written into containers and processed by DpProcessor on their way to DpWriter
+  std::vector<BenchmarkFactory> dataProductBenchmarks();
+
+}
+
+#endif
@@ -0,0 +1,194 @@
+// ======================================================================
+// \title  DeframerBenchmarks.cpp
+// \brief  Benchmarks of deframer resynchronization after noise
+// ======================================================================
+
+#include <Simulation/Benchmark/DeframerBenchmarks.hpp>
+#include <Components/Framing/Deframer.hpp>
+#include <Components/Framing/FastFprimeProtocol.hpp>
+#include <Fw/Buffer/BufferGetPortAc.hpp>
+#include <Fw/Buffer/BufferSendPortAc.hpp>
+#include <Fw/Com/ComPacket.hpp>
+#include <Fw/Com/ComPortAc.hpp>
+#include <Fw/Types/Assert.hpp>
+#include <Svc/Deframer/Deframer.hpp>
+#include <Svc/FramingProtocol/FprimeProtocol.hpp>
+
+#include <cstring>
+
+namespace Simulation {
+
+  namespace {
+
+    //! Bytes the UART driver hands the deframer at a time, BufferedUartDriverCfg::RX_CHUNK_SIZE
+    const U32 CHUNK_SIZE = 256;
+
+    //! Bytes of the command packet behind the noise, a typical uplinked command
+    const U32 PACKET_SIZE = 32;
+
+    //! Bytes of the frame around the packet
+    const U32 FRAME_SIZE = Svc::FpFrameHeader::SIZE + PACKET_SIZE + Framing::FRAME_CRC_SIZE;
+
+    //! Largest burst of noise
+    const U32 MAX_NOISE = 4096;
+
+    // ----------------------------------------------------------------------
+    // Mocks
+    // ----------------------------------------------------------------------
+
+    //! Stand-in for the buffer manager and the command dispatcher behind a deframer
+    class DeframerSink : public Fw::PassiveComponentBase {
+
+      public:
+
+        DeframerSink() : Fw::PassiveComponentBase("sink"), m_gets(0), m_bytes(0), m_commands(0) {
+          Fw::PassiveComponentBase::init(0);
+          m_allocateIn.init();
+          m_allocateIn.addCallComp(this, allocateIn);
+          m_allocateIn.setPortNum(0);
+          m_deallocateIn.init();
+          m_deallocateIn.addCallComp(this, deallocateIn);
+          m_deallocateIn.setPortNum(0);
+          m_comIn.init();
+          m_comIn.addCallComp(this, comIn);
+          m_comIn.setPortNum(0);
+        }
+
+        //! Wire a deframer, which has the same ports whether it is the project's or Svc::Deframer
+        template <class DeframerType>
+        void connect(DeframerType& deframer) {
+          deframer.set_framedDeallocate_OutputPort(0, &m_deallocateIn);
+          deframer.set_bufferAllocate_OutputPort(0, &m_allocateIn);
+          deframer.set_bufferDeallocate_OutputPort(0, &m_deallocateIn);
+          deframer.set_comOut_OutputPort(0, &m_comIn);
+        }
+
+        U64 gets() const { return m_gets; }
+        U64 bytes() const { return m_bytes; }
+        U64 commands() const { return m_commands; }
+
+      private:
+
+        static Fw::Buffer allocateIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, U32 size) {
+          DeframerSink& sink = *static_cast<DeframerSink*>(callComp);
+          FW_ASSERT(size <= sizeof(sink.m_packet), size);
+          sink.m_gets++;
+          sink.m_bytes += size;
+          return Fw::Buffer(sink.m_packet, size);
+        }
+
+        static void deallocateIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Buffer& buffer) {}
+
+        static void comIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::ComBuffer& data,
+                          U32 context) {
+          DeframerSink& sink = *static_cast<DeframerSink*>(callComp);
+          FW_ASSERT(data.getBuffLength() == PACKET_SIZE, data.getBuffLength());
+          sink.m_commands++;
+        }
+
+        Fw::InputBufferGetPort m_allocateIn;
+        Fw::InputBufferSendPort m_deallocateIn;
+        Fw::InputComPort m_comIn;
+        U8 m_packet[FW_COM_BUFFER_MAX_SIZE];
+        U64 m_gets;
+        U64 m_bytes;
+        U64 m_commands;
+    };
+
+    // ----------------------------------------------------------------------
+    // Streams
+    // ----------------------------------------------------------------------
+
+    //! Write an F´ frame of a command packet
+    void buildFrame(U8* frame) {
+      Fw::ExternalSerializeBuffer serial(frame, FRAME_SIZE);
+      Fw::SerializeStatus status = serial.serialize(Svc::FpFrameHeader::START_WORD);
+      status = (status == Fw::FW_SERIALIZE_OK) ? serial.serialize(static_cast<U32>(PACKET_SIZE)) : status;
+      status = (status == Fw::FW_SERIALIZE_OK) ?
+          serial.serialize(static_cast<FwPacketDescriptorType>(Fw::ComPacket::FW_PACKET_COMMAND)) : status;
+      FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+      for (U32 i = sizeof(FwPacketDescriptorType); i < PACKET_SIZE; i++) {
+        status = serial.serialize(static_cast<U8>(i));
+        FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+      }
+      status = serial.serialize(Framing::defaultCrc32Engine().compute(frame, serial.getBuffLength()));
+      FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    }
+
+    //! Line noise: uniformly random bytes, so the first start-word byte turns up once in 256 as it would
+    void buildNoise(U8* noise, U32 size) {
+      U32 state = 0x2545F491;
+      for (U32 i = 0; i < size; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        noise[i] = static_cast<U8>(state);
+      }
+    }
+
+    //! A burst of noise and the command frame behind it, fed to a deframer in driver-sized chunks until the command
+    //! comes out
+    template <class DeframerType, class ProtocolType>
+    class DeframerResync : public BenchmarkCase {
+
+      public:
+
+        DeframerResync(const std::string& name, U32 noise) :
+            BenchmarkCase(name), m_deframer("deframer"), m_size(noise + FRAME_SIZE), m_passes(0) {
+          FW_ASSERT(noise <= MAX_NOISE, noise);
+          m_deframer.init(0);
+          m_sink.connect(m_deframer);
+          m_deframer.setup(m_protocol);
+          buildNoise(m_stream, noise);
+          buildFrame(m_stream + noise);
+        }
+
+        void iterate() override {
+          const U64 before = m_sink.commands();
+          for (U32 offset = 0; offset < m_size; offset += CHUNK_SIZE) {
+            Fw::Buffer buffer(m_stream + offset, FW_MIN(CHUNK_SIZE, m_size - offset));
+            m_deframer.get_framedIn_InputPort(0)->invoke(buffer, Drv::RecvStatus::RECV_OK);
+          }
+          // A frame the deframer lost behind the noise stops the benchmark
+          FW_ASSERT(m_sink.commands() == before + 1);
+          m_passes++;
+        }
+
+        U64 bufferGets() const override { return m_sink.gets(); }
+        U64 bytesStaged() const override { return m_sink.bytes(); }
+        U64 bytesProcessed() const override { return m_passes * m_size; }
+
+      private:
+
+        DeframerSink m_sink;
+        ProtocolType m_protocol;
+        DeframerType m_deframer;
+        U8 m_stream[MAX_NOISE + FRAME_SIZE];
+        U32 m_size;
+        U64 m_passes;
+    };
+
+    template <class DeframerType, class ProtocolType>
+    void add(std::vector<BenchmarkFactory>& benchmarks, const char* name, U32 noise) {
+      BenchmarkFactory factory;
+      factory.name = std::string(name) + "/" + std::to_string(noise);
+      const std::string fullName = factory.name;
+      factory.create = [fullName, noise]() -> BenchmarkCase* {
+        return new DeframerResync<DeframerType, ProtocolType>(fullName, noise);
+      };
+      benchmarks.push_back(factory);
+    }
+  }
+
+  std::vector<BenchmarkFactory> deframerBenchmarks()
+  {
+    std::vector<BenchmarkFactory> benchmarks;
+    // No noise is the cost of a clean frame; 4096 bytes is a third of a second of noise at 115200 baud
+    for (U32 noise : {0U, 64U, 512U, MAX_NOISE}) {
+      add<Framing::Deframer, Framing::FastFprimeDeframing>(benchmarks, "Deframer/resync", noise);
+      add<Svc::Deframer, Svc::FprimeDeframing>(benchmarks, "Deframer/resync_stock", noise);
+    }
+    return benchmarks;
+  }
+
+}
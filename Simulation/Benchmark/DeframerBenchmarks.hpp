@@ -0,0 +1,20 @@
+// ======================================================================
+// \title  DeframerBenchmarks.hpp
+// \brief  Benchmarks of deframer resynchronization after noise
+// ======================================================================
+
+#ifndef Simulation_Benchmark_DeframerBenchmarks_HPP
+#define Simulation_Benchmark_DeframerBenchmarks_HPP
+
+#include <Simulation/Benchmark/Harness.hpp>
+
+#include <vector>
+
+namespace Simulation {
+
+  //! The benchmarks of the project deframer and Svc::Deframer finding a frame behind a burst of noise
+  std::vector<BenchmarkFactory> deframerBenchmarks();
+
+}
+
+#endif
@@ -0,0 +1,169 @@
+// ======================================================================
+// \title  DispatchBenchmarks.cpp
+// \brief  Benchmarks of command dispatch as the opcode table grows
+// ======================================================================
+
+#include <Simulation/Benchmark/DispatchBenchmarks.hpp>
+#include <Components/IndexedCommandDispatcher/IndexedCommandDispatcher.hpp>
+#include <Fw/Cmd/CmdPortAc.hpp>
+#include <Fw/Cmd/CmdResponsePortAc.hpp>
+#include <Fw/Com/ComPacket.hpp>
+#include <Fw/Types/Assert.hpp>
+#include <Svc/CmdDispatcher/CommandDispatcherImpl.hpp>
+
+namespace Simulation {
+
+  namespace {
+
+    //! Commands each registering component has, about what the deployment's components have
+    const U32 COMMANDS_PER_COMPONENT = 8;
+
+    //! Base ID of the first registering component; the rest follow 0x100 apart, as the deployment spaces them
+    const FwOpcodeType FIRST_BASE_ID = 0x1000;
+
+    //! Spacing of component base IDs
+    const FwOpcodeType BASE_ID_SPACING = 0x100;
+
+    //! Messages each dispatcher's queue holds, one command and its status at a time
+    const NATIVE_INT_TYPE QUEUE_DEPTH = 4;
+
+    //! Runs one message off an active component's queue, as its thread would. The queue is drained through a pointer
+    //! to QueuedComponentBase's virtual doDispatch, which the generated component bases keep out of reach.
+    struct QueueAccess : Fw::QueuedComponentBase {
+      static void dispatchOne(Fw::QueuedComponentBase& component) {
+        const MsgDispatchStatus status = (component.*(&QueueAccess::doDispatch))();
+        FW_ASSERT(status == MSG_DISPATCH_OK, status);
+      }
+    };
+
+    // ----------------------------------------------------------------------
+    // Mocks
+    // ----------------------------------------------------------------------
+
+    //! Stand-in for the commanded components and the command source: every command is completed at once, and the
+    //! status that comes back to the source is counted
+    class CommandSink : public Fw::PassiveComponentBase {
+
+      public:
+
+        CommandSink() : Fw::PassiveComponentBase("components"), m_statusIn(nullptr), m_commands(0), m_completions(0) {
+          Fw::PassiveComponentBase::init(0);
+          m_cmdIn.init();
+          m_cmdIn.addCallComp(this, cmdIn);
+          m_cmdIn.setPortNum(0);
+          m_seqStatusIn.init();
+          m_seqStatusIn.addCallComp(this, seqStatusIn);
+          m_seqStatusIn.setPortNum(0);
+        }
+
+        //! Wire a dispatcher, which has the same ports whether it is the project's or Svc::CommandDispatcherImpl
+        template <class DispatcherType>
+        void connect(DispatcherType& dispatcher, U32 components) {
+          for (U32 port = 0; port < components; port++) {
+            dispatcher.set_compCmdSend_OutputPort(static_cast<FwIndexType>(port), &m_cmdIn);
+          }
+          dispatcher.set_seqCmdStatus_OutputPort(0, &m_seqStatusIn);
+          m_statusIn = dispatcher.get_compCmdStat_InputPort(0);
+        }
+
+        U64 commands() const { return m_commands; }
+        U64 completions() const { return m_completions; }
+
+      private:
+
+        static void cmdIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwOpcodeType opCode, U32 cmdSeq,
+                          Fw::CmdArgBuffer& args) {
+          CommandSink& sink = *static_cast<CommandSink*>(callComp);
+          sink.m_commands++;
+          sink.m_statusIn->invoke(opCode, cmdSeq, Fw::CmdResponse::OK);
+        }
+
+        static void seqStatusIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwOpcodeType opCode,
+                                U32 cmdSeq, const Fw::CmdResponse& response) {
+          CommandSink& sink = *static_cast<CommandSink*>(callComp);
+          FW_ASSERT(response.e == Fw::CmdResponse::OK, response.e);
+          sink.m_completions++;
+        }
+
+        Fw::InputCmdPort m_cmdIn;
+        Fw::InputCmdResponsePort m_seqStatusIn;
+        Fw::InputCmdResponsePort* m_statusIn;
+        U64 m_commands;
+        U64 m_completions;
+    };
+
+    // ----------------------------------------------------------------------
+    // Benchmarks
+    // ----------------------------------------------------------------------
+
+    //! A command with no arguments for the opcode registered last, the stock dispatcher's longest search, sent on
+    //! seqCmdBuff and dispatched, and its status returned on compCmdStat and passed back to the source
+    template <class DispatcherType>
+    class CommandDispatch : public BenchmarkCase {
+
+      public:
+
+        CommandDispatch(const std::string& name, U32 opcodes) : BenchmarkCase(name), m_dispatcher("cmdDisp") {
+          const U32 components = (opcodes + COMMANDS_PER_COMPONENT - 1) / COMMANDS_PER_COMPONENT;
+          m_dispatcher.init(QUEUE_DEPTH, 0);
+          m_sink.connect(m_dispatcher, components);
+          FwOpcodeType opCode = 0;
+          for (U32 i = 0; i < opcodes; i++) {
+            const U32 component = i / COMMANDS_PER_COMPONENT;
+            opCode = FIRST_BASE_ID + component * BASE_ID_SPACING + (i % COMMANDS_PER_COMPONENT);
+            m_dispatcher.get_compCmdReg_InputPort(static_cast<FwIndexType>(component))->invoke(opCode);
+          }
+          Fw::SerializeStatus status =
+              m_packet.serialize(static_cast<FwPacketDescriptorType>(Fw::ComPacket::FW_PACKET_COMMAND));
+          status = (status == Fw::FW_SERIALIZE_OK) ? m_packet.serialize(opCode) : status;
+          FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+        }
+
+        void iterate() override {
+          const U64 before = m_sink.completions();
+          m_dispatcher.get_seqCmdBuff_InputPort(0)->invoke(m_packet, 0);
+          QueueAccess::dispatchOne(m_dispatcher);
+          QueueAccess::dispatchOne(m_dispatcher);
+          // A command that was not dispatched, or whose status did not come back, stops the benchmark
+          FW_ASSERT(m_sink.completions() == before + 1);
+        }
+
+        U64 bufferGets() const override { return 0; }
+        U64 bytesStaged() const override { return 0; }
+
+      private:
+
+        CommandSink m_sink;
+        DispatcherType m_dispatcher;
+        Fw::ComBuffer m_packet;
+    };
+
+    template <class DispatcherType>
+    void add(std::vector<BenchmarkFactory>& benchmarks, const char* name, U32 opcodes) {
+      BenchmarkFactory factory;
+      factory.name = std::string(name) + "/" + std::to_string(opcodes);
+      const std::string fullName = factory.name;
+      factory.create = [fullName, opcodes]() -> BenchmarkCase* {
+        return new CommandDispatch<DispatcherType>(fullName, opcodes);
+      };
+      benchmarks.push_back(factory);
+    }
+  }
+
+  std::vector<BenchmarkFactory> dispatchBenchmarks()
+  {
+    std::vector<BenchmarkFactory> benchmarks;
+    // Doubling opcode counts up to a full dispatch table; a larger CMD_DISPATCHER_DISPATCH_TABLE_SIZE extends the run
+    std::vector<U32> sizes;
+    for (U32 opcodes = COMMANDS_PER_COMPONENT; opcodes < CMD_DISPATCHER_DISPATCH_TABLE_SIZE; opcodes *= 2) {
+      sizes.push_back(opcodes);
+    }
+    sizes.push_back(CMD_DISPATCHER_DISPATCH_TABLE_SIZE);
+    for (U32 opcodes : sizes) {
+      add<Components::IndexedCommandDispatcher>(benchmarks, "Dispatch/indexed", opcodes);
+      add<Svc::CommandDispatcherImpl>(benchmarks, "Dispatch/stock", opcodes);
+    }
+    return benchmarks;
+  }
+
+}
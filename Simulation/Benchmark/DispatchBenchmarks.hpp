@@ -0,0 +1,21 @@
+// ======================================================================
+// \title  DispatchBenchmarks.hpp
+// \brief  Benchmarks of command dispatch as the opcode table grows
+// ======================================================================
+
+#ifndef Simulation_Benchmark_DispatchBenchmarks_HPP
+#define Simulation_Benchmark_DispatchBenchmarks_HPP
+
+#include <Simulation/Benchmark/Harness.hpp>
+
+#include <vector>
+
+namespace Simulation {
+
+  //! The benchmarks of IndexedCommandDispatcher and Svc::CommandDispatcherImpl dispatching a command and returning its
+  //! status, with a growing number of opcodes registered
+  std::vector<BenchmarkFactory> dispatchBenchmarks();
+
+}
+
+#endif
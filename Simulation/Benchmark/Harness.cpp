@@ -0,0 +1,178 @@
+// ======================================================================
+// \title  Harness.cpp
+// \brief  Timing and counting of hot path benchmarks
+// ======================================================================
+
+#include <Simulation/Benchmark/Harness.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <new>
+#include <unistd.h>
+
+namespace {
+  //! Calls to operator new since the program started, from any thread: the CoreLink benchmarks run two
+  std::atomic<U64> s_heapAllocations(0);
+}
+
+// Every allocation the code under test makes shows up here; the flight code should make none per packet
+void* operator new(size_t size) {
+    s_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    void* memory = malloc((size > 0) ? size : 1);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, size_t size) noexcept {
+    free(memory);
+}
+
+void operator delete[](void* memory, size_t size) noexcept {
+    free(memory);
+}
+
+namespace Simulation {
+
+  namespace {
+    //! Untimed packets passed before timing, so caches and lazily set up state are warm
+    const U32 WARMUP_ITERATIONS = 64;
+
+    //! Most iterations of one timed run
+    const U64 MAX_ITERATIONS = 1000000000;
+
+    F64 cpuNowNs() {
+      timespec now;
+      (void) clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+      return now.tv_sec * 1.0e9 + now.tv_nsec;
+    }
+  }
+
+  BenchmarkCase ::
+    BenchmarkCase(const std::string& name) :
+      m_name(name)
+  {
+
+  }
+
+  BenchmarkCase ::
+    ~BenchmarkCase()
+  {
+
+  }
+
+  BenchmarkResult measure(BenchmarkCase& benchmark, F64 minTimeS)
+  {
+    for (U32 i = 0; i < WARMUP_ITERATIONS; i++) {
+      benchmark.iterate();
+    }
+
+    // Grow the run as Google Benchmark does until it fills the minimum time
+    U64 iterations = 1;
+    for (;;) {
+      const U64 heapBefore = s_heapAllocations.load();
+      const U64 getsBefore = benchmark.bufferGets();
+      const U64 bytesBefore = benchmark.bytesStaged();
+      const U64 processedBefore = benchmark.bytesProcessed();
+      const F64 cpuBefore = cpuNowNs();
+      const auto realBefore = std::chrono::steady_clock::now();
+      for (U64 i = 0; i < iterations; i++) {
+        benchmark.iterate();
+      }
+      const F64 realNs = std::chrono::duration<F64, std::nano>(std::chrono::steady_clock::now() - realBefore).count();
+      const F64 cpuNs = cpuNowNs() - cpuBefore;
+
+      if ((realNs >= minTimeS * 1.0e9) || (iterations >= MAX_ITERATIONS)) {
+        BenchmarkResult result;
+        result.name = benchmark.name();
+        result.iterations = iterations;
+        result.realNs = realNs / iterations;
+        result.cpuNs = cpuNs / iterations;
+        result.heapAllocations = static_cast<F64>(s_heapAllocations.load() - heapBefore) / iterations;
+        result.bufferGets = static_cast<F64>(benchmark.bufferGets() - getsBefore) / iterations;
+        result.bytesStaged = static_cast<F64>(benchmark.bytesStaged() - bytesBefore) / iterations;
+        result.bytesProcessed = static_cast<F64>(benchmark.bytesProcessed() - processedBefore) / iterations;
+        return result;
+      }
+
+      const F64 predicted = (realNs > 0.0) ? (minTimeS * 1.0e9 * 1.4 * iterations / realNs) : iterations * 10.0;
+      iterations = std::min(MAX_ITERATIONS, std::max(iterations + 1, static_cast<U64>(
+                                                         std::min(predicted, iterations * 10.0))));
+    }
+  }
+
+  void writeJson(FILE* out, const char* executable, const std::vector<BenchmarkResult>& results)
+  {
+    char date[32];
+    const time_t now = time(nullptr);
+    (void) strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", localtime(&now));
+    char host[64] = {};
+    (void) gethostname(host, sizeof(host) - 1);
+
+    (void) fprintf(out,
+                   "{\n"
+                   "  \"context\": {\n"
+                   "    \"date\": \"%s\",\n"
+                   "    \"host_name\": \"%s\",\n"
+                   "    \"executable\": \"%s\",\n"
+                   "    \"num_cpus\": %ld,\n"
+#ifdef NDEBUG
+                   "    \"library_build_type\": \"release\"\n"
+#else
+                   "    \"library_build_type\": \"debug\"\n"
+#endif
+                   "  },\n"
+                   "  \"benchmarks\": [",
+                   date, host, executable, sysconf(_SC_NPROCESSORS_ONLN));
+    for (size_t i = 0; i < results.size(); i++) {
+      const BenchmarkResult& result = results[i];
+      const F64 perSecond = (result.realNs > 0.0) ? (1.0e9 / result.realNs) : 0.0;
+      // Google Benchmark only writes bytes_per_second for benchmarks that count bytes
+      char bytesPerSecond[64] = {};
+      if (result.bytesProcessed > 0.0) {
+        (void) snprintf(bytesPerSecond, sizeof(bytesPerSecond), "      \"bytes_per_second\": %.1f,\n",
+                        result.bytesProcessed * perSecond);
+      }
+      (void) fprintf(out,
+                     "%s\n"
+                     "    {\n"
+                     "      \"name\": \"%s\",\n"
+                     "      \"run_name\": \"%s\",\n"
+                     "      \"run_type\": \"iteration\",\n"
+                     "      \"repetitions\": 1,\n"
+                     "      \"repetition_index\": 0,\n"
+                     "      \"threads\": 1,\n"
+                     "      \"iterations\": %llu,\n"
+                     "      \"real_time\": %.3f,\n"
+                     "      \"cpu_time\": %.3f,\n"
+                     "      \"time_unit\": \"ns\",\n"
+                     "%s"
+                     "      \"items_per_second\": %.1f,\n"
+                     "      \"allocs_per_packet\": %.3f,\n"
+                     "      \"buffers_per_packet\": %.3f,\n"
+                     "      \"bytes_staged_per_packet\": %.1f\n"
+                     "    }",
+                     (i == 0) ? "" : ",", result.name.c_str(), result.name.c_str(),
+                     static_cast<unsigned long long>(result.iterations), result.realNs, result.cpuNs, bytesPerSecond,
+                     perSecond, result.heapAllocations, result.bufferGets, result.bytesStaged);
+    }
+    (void) fprintf(out, "\n  ]\n}\n");
+  }
+
+}
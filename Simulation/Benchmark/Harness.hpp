@@ -0,0 +1,83 @@
+// ======================================================================
+// \title  Harness.hpp
+// \brief  Timing and counting of hot path benchmarks
+// ======================================================================
+
+#ifndef Simulation_Benchmark_Harness_HPP
+#define Simulation_Benchmark_Harness_HPP
+
+#include <FpConfig.hpp>
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Simulation {
+
+  //! A benchmark: a fixture built once, through which packets are passed one at a time
+  class BenchmarkCase {
+
+    public:
+
+      explicit BenchmarkCase(const std::string& name);
+
+      virtual ~BenchmarkCase();
+
+      //! Name, in the form group/operation/size
+      const std::string& name() const { return m_name; }
+
+      //! Pass one packet through the code under test
+      virtual void iterate() = 0;
+
+      //! Buffers the code under test has requested from its buffer pool so far
+      virtual U64 bufferGets() const = 0;
+
+      //! Bytes the code under test has staged so far: the sizes of the pool buffers it requested, and the bytes of the
+      //! Com buffers and radio packets it handed on. Copies inside a component are not seen.
+      virtual U64 bytesStaged() const = 0;
+
+      //! Bytes of input the code under test has consumed so far, for benchmarks measured in throughput; 0 for the
+      //! rest, which then report no bytes_per_second
+      virtual U64 bytesProcessed() const { return 0; }
+
+    private:
+
+      std::string m_name; //!< Name
+  };
+
+  //! A benchmark that is only built when it is selected
+  struct BenchmarkFactory {
+    std::string name; //!< Name of the benchmark built
+    std::function<BenchmarkCase*()> create; //!< Builds the benchmark
+  };
+
+  //! Per-packet measurements of one benchmark
+  struct BenchmarkResult {
+    std::string name; //!< Benchmark name
+    U64 iterations; //!< Packets timed
+    F64 realNs; //!< Wall clock time per packet
+    F64 cpuNs; //!< Process CPU time per packet
+    F64 heapAllocations; //!< Calls to operator new per packet
+    F64 bufferGets; //!< Pool buffers requested per packet
+    F64 bytesStaged; //!< Bytes staged per packet
+    F64 bytesProcessed; //!< Input bytes consumed per packet
+  };
+
+  //! Time a benchmark over enough packets to fill the minimum time
+  BenchmarkResult measure(
+      BenchmarkCase& benchmark, //!< The benchmark
+      F64 minTimeS //!< Least time the timed run takes
+  );
+
+  //! Write results as JSON in the layout of Google Benchmark's --benchmark_format=json, so its compare.py can diff
+  //! two runs
+  void writeJson(
+      FILE* out, //!< Destination
+      const char* executable, //!< Path of the benchmark executable
+      const std::vector<BenchmarkResult>& results //!< The results
+  );
+
+}
+
+#endif
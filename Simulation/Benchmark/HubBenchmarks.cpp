@@ -0,0 +1,903 @@
+// ======================================================================
+// \title  HubBenchmarks.cpp
+// \brief  Benchmarks of the radio, message handler and hub hot paths
+// ======================================================================
+
+#include <Simulation/Benchmark/HubBenchmarks.hpp>
+#include <Components/BroncoOreMessageHandler/BroncoOreMessageHandler.hpp>
+#include <Components/CoreLink/CoreLink.hpp>
+#include <Components/Radio/RFM69/RFM69.hpp>
+#include <Drv/ByteStreamDriverModel/ByteStreamRecvPortAc.hpp>
+#include <Drv/ByteStreamDriverModel/ByteStreamSendPortAc.hpp>
+#include <Fw/Buffer/BufferGetPortAc.hpp>
+#include <Fw/Buffer/BufferSendPortAc.hpp>
+#include <Fw/Cmd/CmdArgBuffer.hpp>
+#include <Fw/Cmd/CmdResponsePortAc.hpp>
+#include <Fw/Com/ComPortAc.hpp>
+#include <Fw/Dp/DpContainer.hpp>
+#include <Fw/Dp/DpGetPortAc.hpp>
+#include <Fw/Dp/DpSendPortAc.hpp>
+#include <Fw/Time/TimePortAc.hpp>
+#include <Fw/Types/Assert.hpp>
+#include <Simulation/HubNode/HubNode.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+namespace Simulation {
+
+  namespace {
+
+    //! The message handler's generated opcodes, which its component base keeps protected
+    struct HandlerOpcodes : Components::BroncoOreMessageHandlerComponentBase {
+      enum : FwOpcodeType {
+        MESSAGE_SEND = OPCODE_MESSAGE_SEND,
+        INBOX_LIST = OPCODE_INBOX_LIST,
+        INBOX_FETCH = OPCODE_INBOX_FETCH
+      };
+    };
+
+    //! Senders the inbox benchmarks take turns receiving from
+    const U8 INBOX_SENDERS = 4;
+
+    //! Radio runs after which a round trip that has not arrived is a failure
+    const U32 MAX_POLLS = 64;
+
+    //! Radio settings of every benchmark radio, the parameter defaults
+    RadioSettings defaultRadio() {
+      RadioSettings settings;
+      settings.frequencyMhz = 915.0f;
+      settings.txPowerDbm = 14;
+      settings.modem = Radio::ModemProfile::GFSK_Rb250Fd250;
+      settings.csmaEnabled = true;
+      settings.csmaThresholdDbm = -90;
+      settings.unicast = false;
+      settings.addressFilter = Radio::AddressFilter::HARDWARE;
+      settings.timeSync = false;
+      settings.links = 1;
+      settings.linkSpacingMhz = 0.0f;
+      return settings;
+    }
+
+    //! Radio settings with encryption on, under the FIPS-197 example key
+    RadioSettings encryptedRadio() {
+      RadioSettings settings = defaultRadio();
+      for (U32 i = 0; i < Radio::AesKey::SIZE; i++) {
+        settings.encryptionKey[i] = static_cast<U8>(i);
+      }
+      return settings;
+    }
+
+    //! Message text of a given length
+    void fillMessage(char* text, U32 size) {
+      for (U32 i = 0; i < size; i++) {
+        text[i] = static_cast<char>('a' + (i % 26));
+      }
+      text[size] = '\0';
+    }
+
+    // ----------------------------------------------------------------------
+    // Mocks
+    // ----------------------------------------------------------------------
+
+    //! Stand-in for the air: counts what a radio sends and queues it for the other radio, if there is one
+    class LoopbackMedium : public SimRadioMedium {
+
+      public:
+
+        LoopbackMedium() : m_radioCount(0), m_bytes(0) {
+          memset(m_queued, 0, sizeof(m_queued));
+          memset(m_head, 0, sizeof(m_head));
+        }
+
+        void attach(RH_RF69& radio) override {
+          FW_ASSERT(m_radioCount < RADIOS, m_radioCount);
+          m_radios[m_radioCount++] = &radio;
+        }
+
+        U64 transmit(RH_RF69& radio, const U8* data, U8 len) override {
+          const U8 airLength = radio.airLength(len);
+          m_bytes += airLength;
+          if (m_radioCount < RADIOS) {
+            return 0;
+          }
+          const U32 to = (&radio == m_radios[0]) ? 1 : 0;
+          FW_ASSERT(m_queued[to] < QUEUE_DEPTH, m_queued[to]);
+          Packet& packet = m_queue[to][(m_head[to] + m_queued[to]) % QUEUE_DEPTH];
+          memset(packet.data, 0, sizeof(packet.data));
+          memcpy(packet.data, data, airLength);
+          packet.length = len;
+          m_queued[to]++;
+          return 0;
+        }
+
+        U64 nowUs() override {
+          // Nothing here is timed
+          return 0;
+        }
+
+        I16 channelRssi(RH_RF69& radio) override {
+          // Packets leave the air as soon as they are sent
+          return RH_RF69_RSSI_FLOOR;
+        }
+
+        //! Hand each radio its next queued packet once it has read the previous one
+        void pump() {
+          for (U32 to = 0; to < m_radioCount; to++) {
+            if ((m_queued[to] > 0) &&
+                m_radios[to]->deliver(m_queue[to][m_head[to]].data, m_queue[to][m_head[to]].length, -60, 0)) {
+              m_head[to] = (m_head[to] + 1) % QUEUE_DEPTH;
+              m_queued[to]--;
+            }
+          }
+        }
+
+        //! A radio attached to the medium
+        RH_RF69& radio(U32 index) {
+          FW_ASSERT(index < m_radioCount, index);
+          return *m_radios[index];
+        }
+
+        //! Bytes sent by all radios
+        U64 bytes() const { return m_bytes; }
+
+      private:
+
+        static const U32 RADIOS = 2;
+        static const U32 QUEUE_DEPTH = 8;
+
+        struct Packet {
+          U8 data[RH_RF69_MAX_AIR_LEN];
+          U8 length;
+        };
+
+        RH_RF69* m_radios[RADIOS];
+        U32 m_radioCount;
+        Packet m_queue[RADIOS][QUEUE_DEPTH];
+        U32 m_head[RADIOS];
+        U32 m_queued[RADIOS];
+        U64 m_bytes;
+    };
+
+    //! Buffer pool that hands out slots in turn and counts requests
+    class BufferPool : public Fw::PassiveComponentBase {
+
+      public:
+
+        BufferPool() : Fw::PassiveComponentBase("pool"), m_next(0), m_gets(0), m_bytes(0) {
+          Fw::PassiveComponentBase::init(0);
+          m_getIn.init();
+          m_getIn.addCallComp(this, getIn);
+          m_getIn.setPortNum(0);
+          m_sendIn.init();
+          m_sendIn.addCallComp(this, sendIn);
+          m_sendIn.setPortNum(0);
+        }
+
+        Fw::InputBufferGetPort* getPort() { return &m_getIn; }
+        Fw::InputBufferSendPort* sendPort() { return &m_sendIn; }
+        U64 gets() const { return m_gets; }
+        U64 bytes() const { return m_bytes; }
+
+      private:
+
+        static const U32 SLOTS = 8;
+        static const U32 SLOT_SIZE = 512;
+
+        static Fw::Buffer getIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, U32 size) {
+          BufferPool& pool = *static_cast<BufferPool*>(callComp);
+          FW_ASSERT(size <= SLOT_SIZE, size);
+          pool.m_gets++;
+          pool.m_bytes += size;
+          U8* const data = pool.m_memory[pool.m_next];
+          pool.m_next = (pool.m_next + 1) % SLOTS;
+          return Fw::Buffer(data, size);
+        }
+
+        static void sendIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Buffer& buffer) {}
+
+        Fw::InputBufferGetPort m_getIn;
+        Fw::InputBufferSendPort m_sendIn;
+        U8 m_memory[SLOTS][SLOT_SIZE];
+        U32 m_next;
+        U64 m_gets;
+        U64 m_bytes;
+    };
+
+    //! End of the line for packets and messages, counting the bytes handed to it
+    class Sink : public Fw::PassiveComponentBase {
+
+      public:
+
+        Sink() : Fw::PassiveComponentBase("sink"), m_packets(0), m_bytes(0) {
+          Fw::PassiveComponentBase::init(0);
+          m_recvIn.init();
+          m_recvIn.addCallComp(this, recvIn);
+          m_recvIn.setPortNum(0);
+          m_comIn.init();
+          m_comIn.addCallComp(this, comIn);
+          m_comIn.setPortNum(0);
+        }
+
+        Drv::InputByteStreamRecvPort* recvPort() { return &m_recvIn; }
+        Fw::InputComPort* comPort() { return &m_comIn; }
+        U64 packets() const { return m_packets; }
+        U64 bytes() const { return m_bytes; }
+
+      private:
+
+        static void recvIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Buffer& buffer,
+                           const Drv::RecvStatus& status) {
+          static_cast<Sink*>(callComp)->m_packets++;
+        }
+
+        static void comIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::ComBuffer& data,
+                          U32 context) {
+          Sink& sink = *static_cast<Sink*>(callComp);
+          sink.m_packets++;
+          sink.m_bytes += data.getBuffLength();
+        }
+
+        Drv::InputByteStreamRecvPort m_recvIn;
+        Fw::InputComPort m_comIn;
+        U64 m_packets;
+        U64 m_bytes;
+    };
+
+    //! Data product containers from a few fixed slots, counting requests; a slot is free again once sent
+    class DpPool : public Fw::PassiveComponentBase {
+
+      public:
+
+        DpPool() : Fw::PassiveComponentBase("dpPool"), m_gets(0), m_bytes(0) {
+          Fw::PassiveComponentBase::init(0);
+          memset(m_used, 0, sizeof(m_used));
+          m_getIn.init();
+          m_getIn.addCallComp(this, getIn);
+          m_getIn.setPortNum(0);
+          m_sendIn.init();
+          m_sendIn.addCallComp(this, sendIn);
+          m_sendIn.setPortNum(0);
+        }
+
+        Fw::InputDpGetPort* getPort() { return &m_getIn; }
+        Fw::InputDpSendPort* sendPort() { return &m_sendIn; }
+        U64 gets() const { return m_gets; }
+        U64 bytes() const { return m_bytes; }
+
+      private:
+
+        static const U32 SLOTS = 4;
+        static const U32 SLOT_SIZE = 2048;
+
+        static Fw::Success getIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwDpIdType id,
+                                 FwSizeType dataSize, Fw::Buffer& buffer) {
+          DpPool& pool = *static_cast<DpPool*>(callComp);
+          const FwSizeType size = Fw::DpContainer::getPacketSizeForDataSize(dataSize);
+          FW_ASSERT(size <= SLOT_SIZE, static_cast<FwAssertArgType>(size));
+          for (U32 slot = 0; slot < SLOTS; slot++) {
+            if (not pool.m_used[slot]) {
+              pool.m_used[slot] = true;
+              pool.m_gets++;
+              pool.m_bytes += dataSize;
+              buffer = Fw::Buffer(pool.m_memory[slot], static_cast<U32>(size));
+              return Fw::Success::SUCCESS;
+            }
+          }
+          return Fw::Success::FAILURE;
+        }
+
+        static void sendIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwDpIdType id,
+                           const Fw::Buffer& buffer) {
+          DpPool& pool = *static_cast<DpPool*>(callComp);
+          for (U32 slot = 0; slot < SLOTS; slot++) {
+            if (buffer.getData() == pool.m_memory[slot]) {
+              pool.m_used[slot] = false;
+            }
+          }
+        }
+
+        Fw::InputDpGetPort m_getIn;
+        Fw::InputDpSendPort m_sendIn;
+        U8 m_memory[SLOTS][SLOT_SIZE];
+        bool m_used[SLOTS];
+        U64 m_gets;
+        U64 m_bytes;
+    };
+
+    //! Time served to a component, set by the benchmark, and the end of its command responses, which must be OK
+    class Services : public Fw::PassiveComponentBase {
+
+      public:
+
+        Services() : Fw::PassiveComponentBase("services"), m_seconds(0) {
+          Fw::PassiveComponentBase::init(0);
+          m_timeIn.init();
+          m_timeIn.addCallComp(this, timeIn);
+          m_timeIn.setPortNum(0);
+          m_cmdResponseIn.init();
+          m_cmdResponseIn.addCallComp(this, cmdResponseIn);
+          m_cmdResponseIn.setPortNum(0);
+        }
+
+        Fw::InputTimePort* timePort() { return &m_timeIn; }
+        Fw::InputCmdResponsePort* cmdResponsePort() { return &m_cmdResponseIn; }
+        void setTime(U32 seconds) { m_seconds = seconds; }
+
+      private:
+
+        static void timeIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Time& time) {
+          time.set(TB_NONE, static_cast<Services*>(callComp)->m_seconds, 0);
+        }
+
+        static void cmdResponseIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwOpcodeType opCode,
+                                  U32 cmdSeq, const Fw::CmdResponse& response) {
+          FW_ASSERT(response == Fw::CmdResponse::OK, response.e);
+        }
+
+        Fw::InputTimePort m_timeIn;
+        Fw::InputCmdResponsePort m_cmdResponseIn;
+        U32 m_seconds;
+    };
+
+    // ----------------------------------------------------------------------
+    // RFM69
+    // ----------------------------------------------------------------------
+
+    //! A radio on its own with its buffer ports and received packets going to mocks, brought up and ready
+    class RadioFixture {
+
+      public:
+
+        RadioFixture() : m_radio("hubComDriver") {
+          m_radio.init(0);
+          m_radio.set_allocate_OutputPort(0, m_pool.getPort());
+          m_radio.set_deallocate_OutputPort(0, m_pool.sendPort());
+          m_radio.set_comDataOut_OutputPort(0, m_sink.recvPort());
+          m_radio.configureMedium(m_medium);
+          m_radio.loadParameters();
+          // Reset, then initialization
+          m_radio.get_run_InputPort(0)->invoke(0);
+          m_radio.get_run_InputPort(0)->invoke(0);
+        }
+
+      protected:
+
+        LoopbackMedium m_medium;
+        BufferPool m_pool;
+        Sink m_sink;
+        Radio::RFM69 m_radio;
+    };
+
+    //! comDataIn_handler and the run call that sends the frame through RFM69::send, for a frame of a given size
+    class RadioSend : public BenchmarkCase, private RadioFixture {
+
+      public:
+
+        explicit RadioSend(U32 size) : BenchmarkCase("RFM69/send/" + std::to_string(size)), m_size(size) {
+          memset(m_frame, 0x5A, sizeof(m_frame));
+        }
+
+        void iterate() override {
+          Fw::Buffer frame(m_frame, m_size);
+          const Drv::SendStatus status = m_radio.get_comDataIn_InputPort(0)->invoke(frame);
+          FW_ASSERT(status == Drv::SendStatus::SEND_OK, status.e);
+          // The run call samples the channel and sends the queued frame
+          m_radio.get_run_InputPort(0)->invoke(0);
+        }
+
+        U64 bufferGets() const override { return m_pool.gets(); }
+        U64 bytesStaged() const override { return m_pool.bytes() + m_medium.bytes(); }
+
+      private:
+
+        U32 m_size;
+        U8 m_frame[FW_COM_BUFFER_MAX_SIZE];
+    };
+
+    //! A radio run that finds a packet of a given size and hands it on, through RFM69::recv
+    class RadioRecv : public BenchmarkCase, private RadioFixture {
+
+      public:
+
+        explicit RadioRecv(U32 size) : BenchmarkCase("RFM69/recv/" + std::to_string(size)), m_size(size) {
+          memset(m_packet, 0xA5, sizeof(m_packet));
+          // RadioHead header: broadcast from node 2. No key is installed, so the payload has no key check.
+          m_packet[0] = RH_BROADCAST_ADDRESS;
+          m_packet[1] = 2;
+          m_packet[2] = 0;
+          m_packet[3] = 0;
+        }
+
+        void iterate() override {
+          // Packets arrive in sequence, as on a clean link
+          m_packet[2]++;
+          const bool delivered =
+              m_medium.radio(0).deliver(m_packet, static_cast<U8>(RH_RF69_HEADER_LEN + m_size), -60);
+          FW_ASSERT(delivered);
+          m_radio.get_run_InputPort(0)->invoke(0);
+        }
+
+        U64 bufferGets() const override { return m_pool.gets(); }
+        U64 bytesStaged() const override { return m_pool.bytes() + m_medium.bytes(); }
+
+      private:
+
+        U32 m_size;
+        U8 m_packet[RH_RF69_MAX_ENCRYPTABLE_PAYLOAD_LEN];
+    };
+
+    // ----------------------------------------------------------------------
+    // BroncoOreMessageHandler
+    // ----------------------------------------------------------------------
+
+    //! MESSAGE_SEND_cmdHandler for a message of a given length, with the message going to a mock hub
+    class MessageSend : public BenchmarkCase {
+
+      public:
+
+        explicit MessageSend(U32 size) :
+            BenchmarkCase("BroncoOreMessageHandler/MESSAGE_SEND/" + std::to_string(size)),
+            m_handler("broncoOreMessageHandler") {
+          m_handler.init(0);
+          m_handler.set_send_message_OutputPort(0, m_sink.comPort());
+          m_handler.set_cmdResponseOut_OutputPort(0, m_services.cmdResponsePort());
+          char text[FW_CMD_STRING_MAX_SIZE + 1];
+          fillMessage(text, size);
+          const Fw::SerializeStatus status = m_args.serialize(Fw::CmdStringArg(text));
+          FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+        }
+
+        void iterate() override {
+          m_args.resetDeser();
+          m_handler.get_cmdIn_InputPort(0)->invoke(m_handler.getIdBase() + HandlerOpcodes::MESSAGE_SEND, 0, m_args);
+        }
+
+        U64 bufferGets() const override { return 0; }
+        U64 bytesStaged() const override { return m_sink.bytes(); }
+
+      private:
+
+        Sink m_sink;
+        Services m_services;
+        Components::BroncoOreMessageHandler m_handler;
+        Fw::CmdArgBuffer m_args;
+    };
+
+    //! A message handler with containers and time, its inbox filled to capacity with messages of a given length,
+    //! one a second from senders in turn
+    class InboxFixture {
+
+      public:
+
+        explicit InboxFixture(U32 size) : m_handler("broncoOreMessageHandler"), m_received(0) {
+          m_handler.init(0);
+          m_handler.set_productGetOut_OutputPort(0, m_dpPool.getPort());
+          m_handler.set_productSendOut_OutputPort(0, m_dpPool.sendPort());
+          m_handler.set_timeCaller_OutputPort(0, m_services.timePort());
+          m_handler.set_cmdResponseOut_OutputPort(0, m_services.cmdResponsePort());
+          fillMessage(m_text, size);
+          m_size = size;
+          // Enough to go around the inbox whatever bounds it, the arena or the entry count
+          for (U32 i = 0; i < 2 * Components::MessageInboxCfg::CAPACITY; i++) {
+            this->receive();
+          }
+        }
+
+      protected:
+
+        //! Pass the next message to recv_message
+        void receive() {
+          Fw::ComBuffer message;
+          const U8 sender = static_cast<U8>(m_received % INBOX_SENDERS + 1);
+          const U16 seq = static_cast<U16>(m_received / INBOX_SENDERS);
+          Fw::SerializeStatus status = message.serialize(sender);
+          FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+          status = message.serialize(seq);
+          FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+          status = message.serialize(reinterpret_cast<const U8*>(m_text), m_size, true);
+          FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+          m_services.setTime(m_received);
+          m_handler.get_recv_message_InputPort(0)->invoke(message, 0);
+          m_received++;
+        }
+
+        DpPool m_dpPool;
+        Services m_services;
+        Components::BroncoOreMessageHandler m_handler;
+        char m_text[FW_CMD_STRING_MAX_SIZE + 1];
+        U32 m_size;
+        U32 m_received;
+    };
+
+    //! recv_message_handler into a full inbox, evicting the oldest message to make room
+    class InboxInsert : public BenchmarkCase, private InboxFixture {
+
+      public:
+
+        explicit InboxInsert(U32 size) :
+            BenchmarkCase("BroncoOreMessageHandler/recv/" + std::to_string(size)),
+            InboxFixture(size) {}
+
+        void iterate() override { this->receive(); }
+
+        U64 bufferGets() const override { return m_dpPool.gets(); }
+        U64 bytesStaged() const override { return m_dpPool.bytes(); }
+    };
+
+    //! A query command on a full inbox that matches the newest messages, a given number of them
+    class InboxQuery : public BenchmarkCase, private InboxFixture {
+
+      public:
+
+        InboxQuery(const char* group, FwOpcodeType opcode, U32 matches) :
+            BenchmarkCase(std::string(group) + "/" + std::to_string(matches)),
+            InboxFixture(24),
+            m_opcode(opcode) {
+          const U32 newest = m_received - 1;
+          const U32 oldest = newest + 1 - matches;
+          Fw::SerializeStatus status = Fw::FW_SERIALIZE_OK;
+          if (opcode == HandlerOpcodes::INBOX_LIST) {
+            // Every sender, over the seconds the messages arrived in
+            status = m_args.serialize(static_cast<U8>(0));
+            FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+          }
+          // Message ids and arrival seconds are the same, both counting messages received
+          status = m_args.serialize(oldest);
+          FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+          status = m_args.serialize(newest);
+          FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+        }
+
+        void iterate() override {
+          m_args.resetDeser();
+          m_handler.get_cmdIn_InputPort(0)->invoke(m_handler.getIdBase() + m_opcode, 0, m_args);
+        }
+
+        U64 bufferGets() const override { return m_dpPool.gets(); }
+        U64 bytesStaged() const override { return m_dpPool.bytes(); }
+
+      private:
+
+        FwOpcodeType m_opcode;
+        Fw::CmdArgBuffer m_args;
+    };
+
+    //! INBOX_LIST of every sender over a time range
+    class InboxList : public InboxQuery {
+
+      public:
+
+        explicit InboxList(U32 matches) :
+            InboxQuery("BroncoOreMessageHandler/INBOX_LIST", HandlerOpcodes::INBOX_LIST, matches) {}
+    };
+
+    //! INBOX_FETCH of an id range, with the message text
+    class InboxFetch : public InboxQuery {
+
+      public:
+
+        explicit InboxFetch(U32 matches) :
+            InboxQuery("BroncoOreMessageHandler/INBOX_FETCH", HandlerOpcodes::INBOX_FETCH, matches) {}
+    };
+
+    // ----------------------------------------------------------------------
+    // Hub
+    // ----------------------------------------------------------------------
+
+    //! A message from MESSAGE_SEND through the hub Com framer and radio onto the air
+    class HubSend : public BenchmarkCase, private MessageSink {
+
+      public:
+
+        explicit HubSend(U32 size, const char* group = "Hub/send", HubNode::ComPath path = HubNode::ComPath::FRAMED) :
+            BenchmarkCase(std::string(group) + "/" + std::to_string(size)),
+            m_node(0, defaultRadio(), m_medium, *this, path),
+            m_seq(0) {
+          fillMessage(m_text, size);
+          m_node.run();
+          m_node.run();
+        }
+
+        void iterate() override {
+          m_node.sendMessage(m_seq++, m_text);
+        }
+
+        U64 bufferGets() const override { return m_node.bufferGets(); }
+        U64 bytesStaged() const override { return m_node.bufferBytes() + m_medium.bytes(); }
+
+      private:
+
+        void messageReceived(U32 node, const U8* data, U32 size) override {}
+
+        LoopbackMedium m_medium;
+        HubNode m_node;
+        U32 m_seq;
+        char m_text[FW_CMD_STRING_MAX_SIZE + 1];
+    };
+
+    //! A message from MESSAGE_SEND on one node to the message handler of another, through both hub stacks: the
+    //! framer, radio and deframer round trip
+    class HubRoundTrip : public BenchmarkCase, private MessageSink {
+
+      public:
+
+        explicit HubRoundTrip(U32 size, const char* group = "Hub/roundtrip",
+                              const RadioSettings& settings = defaultRadio(),
+                              HubNode::ComPath path = HubNode::ComPath::FRAMED) :
+            BenchmarkCase(std::string(group) + "/" + std::to_string(size)),
+            m_sender(0, settings, m_medium, *this, path),
+            m_receiver(1, settings, m_medium, *this, path),
+            m_seq(0),
+            m_received(0) {
+          fillMessage(m_text, size);
+          for (U32 i = 0; i < 2; i++) {
+            m_sender.run();
+            m_receiver.run();
+          }
+        }
+
+        void iterate() override {
+          const U64 before = m_received;
+          m_sender.sendMessage(m_seq++, m_text);
+          for (U32 poll = 0; m_received == before; poll++) {
+            FW_ASSERT(poll < MAX_POLLS, poll);
+            m_medium.pump();
+            m_receiver.run();
+          }
+        }
+
+        U64 bufferGets() const override { return m_sender.bufferGets() + m_receiver.bufferGets(); }
+        U64 bytesStaged() const override {
+          return m_sender.bufferBytes() + m_receiver.bufferBytes() + m_medium.bytes();
+        }
+
+      private:
+
+        void messageReceived(U32 node, const U8* data, U32 size) override {
+          FW_ASSERT(node == 1, node);
+          m_received++;
+        }
+
+        LoopbackMedium m_medium;
+        HubNode m_sender;
+        HubNode m_receiver;
+        U32 m_seq;
+        U64 m_received;
+        char m_text[FW_CMD_STRING_MAX_SIZE + 1];
+    };
+
+    //! The round trip with both radios encrypting, here in software; a message that does not decrypt never arrives
+    class EncryptedHubRoundTrip : public HubRoundTrip {
+
+      public:
+
+        explicit EncryptedHubRoundTrip(U32 size) : HubRoundTrip(size, "Hub/roundtrip_aes", encryptedRadio()) {}
+    };
+
+    //! The send through GenericHub and Svc::Framer, as messages went before the hub Com framer
+    class GenericHubSend : public HubSend {
+
+      public:
+
+        explicit GenericHubSend(U32 size) : HubSend(size, "Hub/send_generic", HubNode::ComPath::HUB) {}
+    };
+
+    //! The round trip through GenericHub on both nodes, as messages went before the hub Com framer
+    class GenericHubRoundTrip : public HubRoundTrip {
+
+      public:
+
+        explicit GenericHubRoundTrip(U32 size) :
+            HubRoundTrip(size, "Hub/roundtrip_generic", defaultRadio(), HubNode::ComPath::HUB) {}
+    };
+
+    // ----------------------------------------------------------------------
+    // CoreLink
+    // ----------------------------------------------------------------------
+
+    //! Stand-in for the radio on the radio core: hands each frame straight back, and answers it with a Com call of a
+    //! given size if there is one
+    class RadioCoreMock : public Fw::PassiveComponentBase {
+
+      public:
+
+        explicit RadioCoreMock(Components::CoreLink& link) :
+            Fw::PassiveComponentBase("radioCore"), m_link(link), m_frames(0) {
+          Fw::PassiveComponentBase::init(0);
+          m_framedIn.init();
+          m_framedIn.addCallComp(this, framedIn);
+          m_framedIn.setPortNum(0);
+        }
+
+        Drv::InputByteStreamSendPort* framedPort() { return &m_framedIn; }
+
+        //! Frames sent so far; read from the main core
+        U64 frames() const { return m_frames.load(std::memory_order_acquire); }
+
+        //! Answer each frame with a Com call of this many bytes, none if zero
+        void answerWith(U32 size) {
+          U8 data[FW_COM_BUFFER_MAX_SIZE];
+          memset(data, 0x3C, sizeof(data));
+          m_answer.resetSer();
+          const Fw::SerializeStatus status = m_answer.serialize(data, size, true);
+          FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+        }
+
+      private:
+
+        static Drv::SendStatus framedIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum,
+                                        Fw::Buffer& frame) {
+          RadioCoreMock& radio = *static_cast<RadioCoreMock*>(callComp);
+          radio.m_link.get_framedReturn_InputPort(0)->invoke(frame);
+          if (radio.m_answer.getBuffLength() > 0) {
+            radio.m_link.get_comIn_InputPort(0)->invoke(radio.m_answer, 0);
+          }
+          radio.m_frames.store(radio.m_frames.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+          return Drv::SendStatus::SEND_OK;
+        }
+
+        Components::CoreLink& m_link;
+        Drv::InputByteStreamSendPort m_framedIn;
+        Fw::ComBuffer m_answer;
+        std::atomic<U64> m_frames;
+    };
+
+    //! A core link with its radio side serviced by a thread of its own, as core 1 does on the board. Frames come
+    //! from one fixed buffer, as no one reads them.
+    class CoreLinkFixture {
+
+      public:
+
+        CoreLinkFixture() : m_link("radioCoreLink"), m_radio(m_link), m_running(true) {
+          m_link.init(0);
+          m_link.set_framedOut_OutputPort(0, m_radio.framedPort());
+          m_link.set_framedDeallocate_OutputPort(0, m_pool.sendPort());
+          m_link.set_comOut_OutputPort(0, m_sink.comPort());
+          m_link.configure(true);
+          memset(m_frame, 0x5A, sizeof(m_frame));
+          m_radioCore = std::thread([this]() {
+            while (m_running.load()) {
+              m_link.serviceRadioCore();
+            }
+          });
+        }
+
+        ~CoreLinkFixture() {
+          m_running.store(false);
+          m_link.wake();
+          m_radioCore.join();
+        }
+
+      protected:
+
+        //! Hand one frame to the link
+        void sendFrame() {
+          Fw::Buffer frame(m_frame, sizeof(m_frame));
+          const Drv::SendStatus status = m_link.get_framedIn_InputPort(0)->invoke(frame);
+          FW_ASSERT(status == Drv::SendStatus::SEND_OK, status.e);
+        }
+
+        Components::CoreLink m_link;
+        BufferPool m_pool;
+        Sink m_sink;
+        RadioCoreMock m_radio;
+        U8 m_frame[RH_RF69_MAX_MESSAGE_LEN];
+
+      private:
+
+        std::atomic<bool> m_running;
+        std::thread m_radioCore;
+    };
+
+    //! Frames across to the radio core with up to a given number in flight: the link's throughput
+    class CoreLinkStream : public BenchmarkCase, private CoreLinkFixture {
+
+      public:
+
+        explicit CoreLinkStream(U32 depth) :
+            BenchmarkCase("CoreLink/stream/" + std::to_string(depth)), m_depth(depth), m_sent(0) {}
+
+        void iterate() override {
+          this->sendFrame();
+          m_sent++;
+          while (m_sent - m_radio.frames() >= m_depth) {
+            std::this_thread::yield();
+          }
+        }
+
+        // Handles cross, not data
+        U64 bufferGets() const override { return m_pool.gets(); }
+        U64 bytesStaged() const override { return m_pool.bytes(); }
+
+      private:
+
+        U64 m_depth;
+        U64 m_sent;
+    };
+
+    //! A frame across to the radio core and a Com call of a given size back: the link's round trip
+    class CoreLinkRoundTrip : public BenchmarkCase, private CoreLinkFixture {
+
+      public:
+
+        explicit CoreLinkRoundTrip(U32 size) : BenchmarkCase("CoreLink/roundtrip/" + std::to_string(size)) {
+          m_radio.answerWith(size);
+        }
+
+        void iterate() override {
+          const U64 before = m_sink.packets();
+          this->sendFrame();
+          // The main core polls, as it would if its loop had nothing else to do
+          while (m_sink.packets() == before) {
+            std::this_thread::yield();
+            m_link.serviceMainCore();
+          }
+        }
+
+        // The Com call is copied into its ring slot
+        U64 bufferGets() const override { return m_pool.gets(); }
+        U64 bytesStaged() const override { return m_sink.bytes(); }
+    };
+
+    template <typename Case>
+    void add(std::vector<BenchmarkFactory>& benchmarks, const char* name, U32 size) {
+      BenchmarkFactory factory;
+      factory.name = std::string(name) + "/" + std::to_string(size);
+      factory.create = [size]() -> BenchmarkCase* { return new Case(size); };
+      benchmarks.push_back(factory);
+    }
+  }
+
+  std::vector<BenchmarkFactory> hubBenchmarks()
+  {
+    std::vector<BenchmarkFactory> benchmarks;
+    // A frame that fits one radio packet, one that fills it, and one that is split in two
+    for (U32 size : {16, RH_RF69_MAX_MESSAGE_LEN, 2 * RH_RF69_MAX_MESSAGE_LEN}) {
+      add<RadioSend>(benchmarks, "RFM69/send", size);
+    }
+    for (U32 size : {16, RH_RF69_MAX_MESSAGE_LEN}) {
+      add<RadioRecv>(benchmarks, "RFM69/recv", size);
+    }
+    // The shortest message, a typical one and the longest command string
+    const U32 messageSizes[] = {8, 24, FW_CMD_STRING_MAX_SIZE};
+    for (U32 size : messageSizes) {
+      add<MessageSend>(benchmarks, "BroncoOreMessageHandler/MESSAGE_SEND", size);
+    }
+    for (U32 size : messageSizes) {
+      add<InboxInsert>(benchmarks, "BroncoOreMessageHandler/recv", size);
+    }
+    // One message, a page of them and the whole inbox
+    for (U32 matches : {1U, 16U, Components::MessageInboxCfg::CAPACITY}) {
+      add<InboxList>(benchmarks, "BroncoOreMessageHandler/INBOX_LIST", matches);
+    }
+    for (U32 matches : {1U, 16U, Components::MessageInboxCfg::CAPACITY}) {
+      add<InboxFetch>(benchmarks, "BroncoOreMessageHandler/INBOX_FETCH", matches);
+    }
+    for (U32 size : messageSizes) {
+      add<HubSend>(benchmarks, "Hub/send", size);
+    }
+    for (U32 size : messageSizes) {
+      add<GenericHubSend>(benchmarks, "Hub/send_generic", size);
+    }
+    for (U32 size : messageSizes) {
+      add<HubRoundTrip>(benchmarks, "Hub/roundtrip", size);
+    }
+    for (U32 size : messageSizes) {
+      add<GenericHubRoundTrip>(benchmarks, "Hub/roundtrip_generic", size);
+    }
+    for (U32 size : messageSizes) {
+      add<EncryptedHubRoundTrip>(benchmarks, "Hub/roundtrip_aes", size);
+    }
+    // One frame at a time, a burst and a full ring
+    for (U32 depth : {1U, 8U, Components::CoreLinkCfg::RING_SIZE}) {
+      add<CoreLinkStream>(benchmarks, "CoreLink/stream", depth);
+    }
+    for (U32 size : {16, FW_COM_BUFFER_MAX_SIZE}) {
+      add<CoreLinkRoundTrip>(benchmarks, "CoreLink/roundtrip", size);
+    }
+    return benchmarks;
+  }
+
+}
@@ -0,0 +1,20 @@
+// ======================================================================
+// \title  HubBenchmarks.hpp
+// \brief  Benchmarks of the radio, message handler and hub hot paths
+// ======================================================================
+
+#ifndef Simulation_Benchmark_HubBenchmarks_HPP
+#define Simulation_Benchmark_HubBenchmarks_HPP
+
+#include <Simulation/Benchmark/Harness.hpp>
+
+#include <vector>
+
+namespace Simulation {
+
+  //! The benchmarks of RFM69, BroncoOreMessageHandler and the hub stack between them
+  std::vector<BenchmarkFactory> hubBenchmarks();
+
+}
+
+#endif
@@ -0,0 +1,117 @@
+// ======================================================================
+// \title  Main.cpp
+// \brief  Runs the hot path benchmarks and writes their results as JSON
+// ======================================================================
+
+#include <Simulation/Benchmark/CrcBenchmarks.hpp>
+#include <Simulation/Benchmark/DataProductBenchmarks.hpp>
+#include <Simulation/Benchmark/DeframerBenchmarks.hpp>
+#include <Simulation/Benchmark/DispatchBenchmarks.hpp>
+#include <Simulation/Benchmark/Harness.hpp>
+#include <Simulation/Benchmark/HubBenchmarks.hpp>
+#include <Simulation/Benchmark/ParameterBenchmarks.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <memory>
+
+/**
+ * \brief print command line help message
+ *
+ * @param app: name of application
+ */
+static void print_usage(const char* app)
+{
+    (void) printf("Usage: ./%s [options]\n"
+                  "-o\tfile the JSON results are written to instead of stdout\n"
+                  "-f\trun only benchmarks whose name contains this text\n"
+                  "-t\tleast time each benchmark is timed for, in seconds (default 0.5)\n"
+                  "-l\tlist the benchmarks and exit\n",
+                  app);
+}
+
+/**
+ * \brief run the selected benchmarks
+ *
+ * Progress goes to stderr and the results to stdout or the -o file, so two runs can be compared with Google
+ * Benchmark's compare.py.
+ */
+int main(int argc, char* argv[])
+{
+    const char* outputPath = nullptr;
+    const char* filter = "";
+    F64 minTimeS = 0.5;
+    bool list = false;
+
+    int option = 0;
+    while ((option = getopt(argc, argv, "ho:f:t:l")) != -1) {
+        switch (option) {
+            case 'o':
+                outputPath = optarg;
+                break;
+            case 'f':
+                filter = optarg;
+                break;
+            case 't':
+                minTimeS = atof(optarg);
+                break;
+            case 'l':
+                list = true;
+                break;
+            case 'h':
+            case '?':
+            default:
+                print_usage(argv[0]);
+                return (option == 'h') ? 0 : 1;
+        }
+    }
+
+    std::vector<Simulation::BenchmarkFactory> factories = Simulation::hubBenchmarks();
+    for (const Simulation::BenchmarkFactory& factory : Simulation::dataProductBenchmarks()) {
+        factories.push_back(factory);
+    }
+    for (const Simulation::BenchmarkFactory& factory : Simulation::parameterBenchmarks()) {
+        factories.push_back(factory);
+    }
+    for (const Simulation::BenchmarkFactory& factory : Simulation::crcBenchmarks()) {
+        factories.push_back(factory);
+    }
+    for (const Simulation::BenchmarkFactory& factory : Simulation::deframerBenchmarks()) {
+        factories.push_back(factory);
+    }
+    for (const Simulation::BenchmarkFactory& factory : Simulation::dispatchBenchmarks()) {
+        factories.push_back(factory);
+    }
+
+    std::vector<Simulation::BenchmarkResult> results;
+    for (const Simulation::BenchmarkFactory& factory : factories) {
+        if (strstr(factory.name.c_str(), filter) == nullptr) {
+            continue;
+        }
+        if (list) {
+            (void) printf("%s\n", factory.name.c_str());
+            continue;
+        }
+        std::unique_ptr<Simulation::BenchmarkCase> benchmark(factory.create());
+        results.push_back(Simulation::measure(*benchmark, minTimeS));
+        const Simulation::BenchmarkResult& result = results.back();
+        (void) fprintf(stderr, "%-44s %10.1f ns %8.2f allocs %6.2f buffers %8.1f bytes\n", result.name.c_str(),
+                       result.realNs, result.heapAllocations, result.bufferGets, result.bytesStaged);
+    }
+    if (list) {
+        return 0;
+    }
+
+    FILE* out = (outputPath != nullptr) ? fopen(outputPath, "w") : stdout;
+    if (out == nullptr) {
+        (void) fprintf(stderr, "%s: cannot open\n", outputPath);
+        return 1;
+    }
+    Simulation::writeJson(out, argv[0], results);
+    if (out != stdout) {
+        (void) fclose(out);
+    }
+    return 0;
+}
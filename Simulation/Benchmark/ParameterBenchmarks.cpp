@@ -0,0 +1,289 @@
+// ======================================================================
+// \title  ParameterBenchmarks.cpp
+// \brief  Benchmarks of the flash parameter database
+// ======================================================================
+
+#include <Simulation/Benchmark/ParameterBenchmarks.hpp>
+#include <Components/FlashPrmDb/FlashPrmDb.hpp>
+#include <Components/FlashPrmDb/FlashStore.hpp>
+#include <Fw/Cmd/CmdArgBuffer.hpp>
+#include <Fw/Cmd/CmdResponsePortAc.hpp>
+#include <Fw/Prm/PrmBuffer.hpp>
+#include <Fw/Tlm/TlmPortAc.hpp>
+#include <Fw/Types/Assert.hpp>
+
+#include <cstdlib>
+#include <unistd.h>
+
+namespace Simulation {
+
+  namespace {
+
+    //! The parameter database's generated ids, which its component base keeps protected
+    struct PrmDbIds : Components::FlashPrmDbComponentBase {
+      enum : FwOpcodeType {
+        PRM_SAVE = OPCODE_PRM_SAVE
+      };
+      enum : FwChanIdType {
+        RECORDS_WRITTEN = CHANNELID_RECORDSWRITTEN,
+        LOG_BYTES_USED = CHANNELID_LOGBYTESUSED,
+        COMPACTIONS = CHANNELID_COMPACTIONS
+      };
+    };
+
+    //! Parameters the benchmarks save, as many as the deployment's radio has
+    const U32 PARAMETERS = 8;
+
+    //! Bytes of each parameter value
+    const U32 VALUE_SIZE = sizeof(U32);
+
+    //! Bytes of each record the database appends
+    const U32 RECORD_SIZE = Components::FlashPrmDb::RECORD_OVERHEAD + VALUE_SIZE;
+
+    // ----------------------------------------------------------------------
+    // Mocks
+    // ----------------------------------------------------------------------
+
+    //! Stand-in for the telemetry channelizer and the command dispatcher: keeps the database's latest counters and
+    //! its last command response
+    class CounterSink : public Fw::PassiveComponentBase {
+
+      public:
+
+        CounterSink() :
+            Fw::PassiveComponentBase("tlmSend"), m_idBase(0), m_recordsWritten(0), m_logBytes(0), m_compactions(0),
+            m_responses(0), m_response(Fw::CmdResponse::EXECUTION_ERROR) {
+          Fw::PassiveComponentBase::init(0);
+          m_tlmIn.init();
+          m_tlmIn.addCallComp(this, tlmIn);
+          m_tlmIn.setPortNum(0);
+          m_cmdResponseIn.init();
+          m_cmdResponseIn.addCallComp(this, cmdResponseIn);
+          m_cmdResponseIn.setPortNum(0);
+        }
+
+        Fw::InputTlmPort* tlmPort(FwChanIdType idBase) {
+          m_idBase = idBase;
+          return &m_tlmIn;
+        }
+
+        Fw::InputCmdResponsePort* cmdResponsePort() { return &m_cmdResponseIn; }
+
+        U32 recordsWritten() const { return m_recordsWritten; }
+        U32 logBytes() const { return m_logBytes; }
+        U32 compactions() const { return m_compactions; }
+        U32 responses() const { return m_responses; }
+        Fw::CmdResponse::T response() const { return m_response; }
+
+      private:
+
+        static void cmdResponseIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwOpcodeType opCode,
+                                  U32 cmdSeq, const Fw::CmdResponse& response) {
+          CounterSink& sink = *static_cast<CounterSink*>(callComp);
+          sink.m_responses++;
+          sink.m_response = response.e;
+        }
+
+        static void tlmIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwChanIdType id,
+                          Fw::Time& timeTag, Fw::TlmBuffer& val) {
+          CounterSink& sink = *static_cast<CounterSink*>(callComp);
+          U32 value = 0;
+          val.resetDeser();
+          const Fw::SerializeStatus status = val.deserialize(value);
+          FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+          switch (id - sink.m_idBase) {
+            case PrmDbIds::RECORDS_WRITTEN:
+              sink.m_recordsWritten = value;
+              break;
+            case PrmDbIds::LOG_BYTES_USED:
+              sink.m_logBytes = value;
+              break;
+            case PrmDbIds::COMPACTIONS:
+              sink.m_compactions = value;
+              break;
+            default:
+              break;
+          }
+        }
+
+        Fw::InputTlmPort m_tlmIn;
+        Fw::InputCmdResponsePort m_cmdResponseIn;
+        FwChanIdType m_idBase;
+        U32 m_recordsWritten;
+        U32 m_logBytes;
+        U32 m_compactions;
+        U32 m_responses;
+        Fw::CmdResponse::T m_response;
+    };
+
+    //! Flash log in a temporary file, removed with the fixture
+    class TemporaryFlash {
+
+      public:
+
+        TemporaryFlash() {
+          char path[] = "/tmp/FlashPrmDbBenchmark.XXXXXX";
+          const int fd = ::mkstemp(path);
+          FW_ASSERT(fd >= 0, fd);
+          (void) ::close(fd);
+          m_path = path;
+          const bool opened = m_store.open(m_path.c_str());
+          FW_ASSERT(opened);
+        }
+
+        ~TemporaryFlash() { (void) ::unlink(m_path.c_str()); }
+
+        Components::FlashStore& store() { return m_store; }
+
+      private:
+
+        std::string m_path;
+        Components::FlashStore m_store;
+    };
+
+    // ----------------------------------------------------------------------
+    // Fixture
+    // ----------------------------------------------------------------------
+
+    //! A database on a blank flash file, with its telemetry counted
+    class PrmDbFixture {
+
+      public:
+
+        PrmDbFixture() : m_db("prmDb"), m_value(0) {
+          m_db.init(0);
+          m_db.set_tlmOut_OutputPort(0, m_counters.tlmPort(m_db.getIdBase()));
+          m_db.set_cmdResponseOut_OutputPort(0, m_counters.cmdResponsePort());
+          m_db.configure(m_flash.store());
+          m_db.load();
+        }
+
+        //! Set the next parameter in turn to a value it did not have, as a component's PRM_SAVE after a PRM_SET
+        //! does, and save it with the database's PRM_SAVE. If the log is full the save completes from the run calls
+        //! that compact it, which are made here until it responds.
+        void save() {
+          Fw::ParamBuffer value;
+          const Fw::SerializeStatus status = value.serialize(m_value);
+          FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+          m_db.get_setPrm_InputPort(0)->invoke(m_value % PARAMETERS, value);
+          Fw::CmdArgBuffer args;
+          const U32 responses = m_counters.responses();
+          m_db.get_cmdIn_InputPort(0)->invoke(m_db.getIdBase() + PrmDbIds::PRM_SAVE, m_value, args);
+          while (m_counters.responses() == responses) {
+            this->run();
+          }
+          FW_ASSERT(m_counters.response() == Fw::CmdResponse::OK, m_counters.response());
+          m_value++;
+        }
+
+        //! The rate group's call, which advances compaction
+        void run() { m_db.get_run_InputPort(0)->invoke(0); }
+
+        Components::FlashPrmDb& db() { return m_db; }
+        const CounterSink& counters() const { return m_counters; }
+
+      private:
+
+        TemporaryFlash m_flash;
+        CounterSink m_counters;
+        Components::FlashPrmDb m_db;
+        U32 m_value;
+    };
+
+    // ----------------------------------------------------------------------
+    // Benchmarks
+    // ----------------------------------------------------------------------
+
+    //! The boot replay of a log built by a number of saves. Without compaction the log holds every save; with it the
+    //! run calls between saves keep it to the live records plus FlashPrmDbCfg::COMPACT_GARBAGE_BYTES.
+    class PrmDbLoad : public BenchmarkCase {
+
+      public:
+
+        PrmDbLoad(const std::string& name, U32 saves, bool compacted) : BenchmarkCase(name), m_loads(0) {
+          for (U32 i = 0; i < saves; i++) {
+            m_fixture.save();
+            if (compacted) {
+              m_fixture.run();
+            }
+          }
+          // Finish a compaction the last save started, so the log replayed is the one a reset would find. It takes
+          // an erase, a copy per COMPACT_ENTRIES_PER_RUN parameters and a header, fewer run calls than parameters.
+          for (U32 i = 0; compacted && (i < PARAMETERS); i++) {
+            m_fixture.run();
+          }
+          m_logBytes = m_fixture.counters().logBytes();
+        }
+
+        void iterate() override {
+          // The table already holds the values, so each replay finds its entry as the last records of a boot do
+          m_fixture.db().load();
+          m_loads++;
+        }
+
+        U64 bufferGets() const override { return 0; }
+        U64 bytesStaged() const override { return m_loads * m_logBytes; }
+
+      private:
+
+        PrmDbFixture m_fixture;
+        U64 m_loads;
+        U32 m_logBytes;
+    };
+
+    //! A save of a changed parameter, with a run call after each as the rate group makes
+    class PrmDbSave : public BenchmarkCase {
+
+      public:
+
+        explicit PrmDbSave(const std::string& name) : BenchmarkCase(name) {}
+
+        void iterate() override {
+          m_fixture.save();
+          m_fixture.run();
+        }
+
+        //! Sectors erased, one per compaction
+        U64 bufferGets() const override { return m_fixture.counters().compactions(); }
+
+        //! Bytes programmed: every record, including the copies compaction makes, and each new sector header
+        U64 bytesStaged() const override {
+          return static_cast<U64>(m_fixture.counters().recordsWritten()) * RECORD_SIZE +
+                 static_cast<U64>(m_fixture.counters().compactions()) * Components::FlashPrmDb::HEADER_SIZE;
+        }
+
+      private:
+
+        PrmDbFixture m_fixture;
+    };
+
+    void addLoad(std::vector<BenchmarkFactory>& benchmarks, const char* name, U32 saves, bool compacted) {
+      BenchmarkFactory factory;
+      factory.name = std::string(name) + "/" + std::to_string(saves);
+      const std::string fullName = factory.name;
+      factory.create = [fullName, saves, compacted]() -> BenchmarkCase* {
+        return new PrmDbLoad(fullName, saves, compacted);
+      };
+      benchmarks.push_back(factory);
+    }
+  }
+
+  std::vector<BenchmarkFactory> parameterBenchmarks()
+  {
+    std::vector<BenchmarkFactory> benchmarks;
+    // 256 saves of 14-byte records nearly fill a sector, the longest log a boot can find
+    for (U32 saves : {16U, 64U, 256U}) {
+      addLoad(benchmarks, "FlashPrmDb/load", saves, false);
+    }
+    for (U32 saves : {16U, 64U, 256U}) {
+      addLoad(benchmarks, "FlashPrmDb/load_compacted", saves, true);
+    }
+    BenchmarkFactory save;
+    save.name = "FlashPrmDb/save/" + std::to_string(VALUE_SIZE);
+    const std::string saveName = save.name;
+    save.create = [saveName]() -> BenchmarkCase* { return new PrmDbSave(saveName); };
+    benchmarks.push_back(save);
+    return benchmarks;
+  }
+
+}
@@ -0,0 +1,20 @@
+// ======================================================================
+// \title  ParameterBenchmarks.hpp
+// \brief  Benchmarks of the flash parameter database
+// ======================================================================
+
+#ifndef Simulation_Benchmark_ParameterBenchmarks_HPP
+#define Simulation_Benchmark_ParameterBenchmarks_HPP
+
+#include <Simulation/Benchmark/Harness.hpp>
+
+#include <vector>
+
+namespace Simulation {
+
+  //! The benchmarks of FlashPrmDb loading its log at boot and saving changed parameters to it
+  std::vector<BenchmarkFactory> parameterBenchmarks();
+
+}
+
+#endif
@@ -0,0 +1,265 @@
+// ======================================================================
+// \title  Constellation.cpp
+// \brief  Many BroncoDeployment hub stacks sharing one simulated RF medium
+// ======================================================================
+
+#include <Simulation/Constellation/Constellation.hpp>
+#include <Fw/Types/Assert.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+
+namespace Simulation {
+
+  namespace {
+    //! Characters of a message that carry its number
+    const U32 MESSAGE_NUMBER_DIGITS = 8;
+
+    //! Names of the address filters in the report, in AddressFilter order
+    const char* const FILTER_NAMES[] = {"off", "software", "hardware"};
+
+    //! Processor time of the calling thread in nanoseconds
+    U64 threadCpuNs() {
+      timespec now;
+      (void) clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+      return static_cast<U64>(now.tv_sec) * 1000000000 + static_cast<U64>(now.tv_nsec);
+    }
+  }
+
+  Constellation ::
+    Constellation(const Scenario& scenario, U32 nodes) :
+      m_scenario(scenario),
+      m_nodeCount(nodes),
+      m_medium(scenario.rf, scenario.seed),
+      // Kept apart from the channel's randomness so changing the channel model does not move the nodes
+      m_random(scenario.seed + 1),
+      m_nowUs(0),
+      m_received(0),
+      m_bytesReceived(0),
+      m_corrupt(0),
+      m_foreign(0),
+      m_runCpuNs(0),
+      m_converged(false),
+      m_convergedUs(0),
+      m_probeRuns(0),
+      m_nextProbeRunUs(static_cast<U64>(scenario.warmupS * 1.0e6))
+  {
+    std::uniform_real_distribution<F64> position(0.0, scenario.areaM);
+    std::uniform_real_distribution<F64> phase(0.0, scenario.messageIntervalMs * 1000.0);
+    const U64 warmupUs = static_cast<U64>(scenario.warmupS * 1.0e6);
+    for (U32 id = 0; id < nodes; id++) {
+      m_nodes.emplace_back(new HubNode(id, scenario.radio, m_medium, *this));
+      const F64 x = position(m_random);
+      const F64 y = position(m_random);
+      m_medium.place(id, x, y);
+      // Nodes start out of step, as satellites that booted at different times would be
+      m_nextSendUs.push_back(warmupUs + static_cast<U64>(phase(m_random)));
+    }
+    // Drawn after placement so the offsets do not move the nodes
+    std::uniform_int_distribution<U64> offset(0, static_cast<U64>(scenario.tickMs) * 1000 - 1);
+    for (U32 id = 0; id < nodes; id++) {
+      m_phaseUs.push_back(offset(m_random));
+      m_runOrder.push_back(id);
+    }
+    std::sort(m_runOrder.begin(), m_runOrder.end(), [this](U32 a, U32 b) { return m_phaseUs[a] < m_phaseUs[b]; });
+
+    // Clocks have randomness of their own, so turning clock error on does not move or retime the nodes
+    std::mt19937 clocks(scenario.seed + 2);
+    std::uniform_real_distribution<F64> skew(-scenario.clockSkewPpm, scenario.clockSkewPpm);
+    std::uniform_real_distribution<F64> clockOffset(0.0, scenario.clockOffsetMs * 1000.0);
+    for (U32 id = 0; id < nodes; id++) {
+      const F64 skewPpm = skew(clocks);
+      m_nodes[id]->setClockError(skewPpm, static_cast<U64>(clockOffset(clocks)));
+    }
+  }
+
+  Constellation ::
+    ~Constellation()
+  {
+
+  }
+
+  U64 Constellation ::
+    nextMessageUs(U64 afterUs)
+  {
+    const F64 meanUs = m_scenario.messageIntervalMs * 1000.0;
+    if (not m_scenario.poisson) {
+      return afterUs + static_cast<U64>(meanUs);
+    }
+    std::exponential_distribution<F64> interval(1.0 / meanUs);
+    return afterUs + static_cast<U64>(interval(m_random)) + 1;
+  }
+
+  void Constellation ::
+    run()
+  {
+    const U64 tickUs = static_cast<U64>(m_scenario.tickMs) * 1000;
+    const U64 trafficEndUs = static_cast<U64>((m_scenario.warmupS + m_scenario.durationS) * 1.0e6);
+    const U64 endUs = trafficEndUs + static_cast<U64>(m_scenario.drainS * 1.0e6);
+
+    char text[FW_CMD_STRING_MAX_SIZE + 1];
+    const U64 summaryStartUs = static_cast<U64>((m_scenario.warmupS + m_scenario.durationS / 2.0) * 1.0e6);
+    for (U64 tickStartUs = 0; tickStartUs <= endUs; tickStartUs += tickUs) {
+      this->measureClocks(tickStartUs, (tickStartUs >= summaryStartUs) && (tickStartUs < trafficEndUs));
+      for (U32 id : m_runOrder) {
+        m_nowUs = tickStartUs + m_phaseUs[id];
+        m_medium.advance(m_nowUs);
+        m_nodes[id]->setTime(m_nowUs);
+        const U64 startNs = threadCpuNs();
+        m_nodes[id]->run();
+        m_runCpuNs += threadCpuNs() - startNs;
+        if (id == 0) {
+          this->startProbeRun();
+        }
+        while ((m_nextSendUs[id] <= m_nowUs) && (m_nextSendUs[id] < trafficEndUs)) {
+          const U32 number = static_cast<U32>(m_sentUs.size());
+          m_sentUs.push_back(m_nowUs);
+          m_sender.push_back(id);
+          // The message number, padded to the scenario's message size
+          (void) snprintf(text, sizeof(text), "%0*x", static_cast<int>(MESSAGE_NUMBER_DIGITS), number);
+          memset(&text[MESSAGE_NUMBER_DIGITS], '.', m_scenario.messageSize - MESSAGE_NUMBER_DIGITS);
+          text[m_scenario.messageSize] = '\0';
+          m_nodes[id]->sendMessage(number, text);
+          m_nextSendUs[id] = this->nextMessageUs(m_nextSendUs[id]);
+        }
+      }
+    }
+    if (m_probeRuns > 0) {
+      m_probeResults.push_back(m_nodes[0]->probeResults());
+    }
+  }
+
+  void Constellation ::
+    startProbeRun()
+  {
+    if ((m_probeRuns >= m_scenario.probeSizes.size()) || (m_nowUs < m_nextProbeRunUs)) {
+      return;
+    }
+    // Runs are spaced so the one before has ended and reported by now
+    if (m_probeRuns > 0) {
+      m_probeResults.push_back(m_nodes[0]->probeResults());
+    }
+    const U16 intervalTicks = static_cast<U16>(m_scenario.probeIntervalMs / m_scenario.tickMs);
+    m_nodes[0]->startProbes(m_probeRuns, 1, m_scenario.probeCount, m_scenario.probeSizes[m_probeRuns], intervalTicks);
+    m_probeRuns++;
+    m_nextProbeRunUs += m_scenario.probeRunUs();
+  }
+
+  void Constellation ::
+    measureClocks(U64 tickStartUs, bool summarize)
+  {
+    bool within = true;
+    m_nodes[0]->setTime(tickStartUs);
+    const I64 referenceUs = static_cast<I64>(m_nodes[0]->disciplinedTimeUs());
+    for (U32 id = 1; id < m_nodeCount; id++) {
+      m_nodes[id]->setTime(tickStartUs);
+      const I64 errorUs = static_cast<I64>(m_nodes[id]->disciplinedTimeUs()) - referenceUs;
+      const U64 magnitudeUs = static_cast<U64>((errorUs < 0) ? -errorUs : errorUs);
+      within = within && (magnitudeUs <= m_scenario.timeToleranceUs);
+      if (summarize) {
+        m_clockErrorsUs.push_back(magnitudeUs);
+      }
+    }
+    if (within && not m_converged) {
+      m_convergedUs = tickStartUs;
+    }
+    m_converged = within;
+  }
+
+  void Constellation ::
+    messageReceived(U32 node, const U8* data, U32 size)
+  {
+    char digits[MESSAGE_NUMBER_DIGITS + 1] = {};
+    memcpy(digits, data, FW_MIN(size, MESSAGE_NUMBER_DIGITS));
+    char* end = nullptr;
+    const unsigned long number = strtoul(digits, &end, 16);
+    if ((end != &digits[MESSAGE_NUMBER_DIGITS]) || (number >= m_sentUs.size()) || (m_sender[number] == node)) {
+      m_corrupt++;
+      return;
+    }
+    if (m_scenario.radio.unicast && (node != HubNode::partner(m_sender[number]))) {
+      m_foreign++;
+      return;
+    }
+    m_received++;
+    m_bytesReceived += size;
+    m_latenciesUs.push_back(m_nowUs - m_sentUs[number]);
+  }
+
+  void Constellation ::
+    report(FILE* out) const
+  {
+    // Nearest-rank percentile of sorted samples
+    const auto rank = [](const std::vector<U64>& samples, F64 fraction) {
+      if (samples.empty()) {
+        return static_cast<U64>(0);
+      }
+      const size_t rank = static_cast<size_t>(std::ceil(fraction * samples.size()));
+      return samples[FW_MAX(rank, static_cast<size_t>(1)) - 1];
+    };
+    std::vector<U64> latencies(m_latenciesUs);
+    std::sort(latencies.begin(), latencies.end());
+    // In milliseconds
+    const auto percentile = [&latencies, &rank](F64 fraction) { return rank(latencies, fraction) / 1000.0; };
+    std::vector<U64> clockErrors(m_clockErrorsUs);
+    std::sort(clockErrors.begin(), clockErrors.end());
+    char converged[32] = "null";
+    if (m_converged) {
+      (void) snprintf(converged, sizeof(converged), "%.1f", m_convergedUs / 1.0e6);
+    }
+
+    U64 expected = 0;
+    for (U32 sender : m_sender) {
+      expected += m_scenario.radio.unicast ? ((HubNode::partner(sender) < m_nodeCount) ? 1 : 0) : (m_nodeCount - 1);
+    }
+    U64 bufferGets = 0;
+    for (const std::unique_ptr<HubNode>& node : m_nodes) {
+      bufferGets += node->bufferGets();
+    }
+    const F64 elapsedS = m_nowUs / 1.0e6;
+    (void) fprintf(out,
+                   "{\"nodes\": %u, \"links\": %u, \"csma\": %s, \"addressing\": \"%s\", \"address_filter\": \"%s\", \"seed\": %u, "
+                   "\"messages_sent\": %zu, \"receptions_expected\": %llu, "
+                   "\"receptions\": %llu, \"delivery_ratio\": %.4f, \"goodput_bps\": %.1f, "
+                   "\"latency_ms\": {\"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, \"max\": %.1f}, "
+                   "\"packets_sent\": %llu, \"packets_received\": %llu, "
+                   "\"drops\": {\"range\": %llu, \"collision\": %llu, \"half_duplex\": %llu, \"loss\": %llu, "
+                   "\"overrun\": %llu, \"corrupt\": %llu}, \"channel_load\": %.4f, \"foreign\": %llu, "
+                   "\"buffer_gets\": %llu, \"run_cpu_ms\": %.1f, \"time_sync\": %s, "
+                   "\"clock_error_us\": {\"p50\": %llu, \"p99\": %llu, \"max\": %llu}, \"converged_s\": %s, "
+                   "\"probes\": [",
+                   m_nodeCount, m_scenario.radio.links, m_scenario.radio.csmaEnabled ? "true" : "false",
+                   m_scenario.radio.unicast ? "unicast" : "broadcast", FILTER_NAMES[m_scenario.radio.addressFilter.e],
+                   m_scenario.seed, m_sentUs.size(), static_cast<unsigned long long>(expected),
+                   static_cast<unsigned long long>(m_received),
+                   (expected > 0) ? static_cast<F64>(m_received) / expected : 0.0,
+                   m_bytesReceived * 8.0 / m_scenario.durationS, percentile(0.50), percentile(0.90),
+                   percentile(0.99), percentile(1.0), static_cast<unsigned long long>(m_medium.transmitted()),
+                   static_cast<unsigned long long>(m_medium.delivered()),
+                   static_cast<unsigned long long>(m_medium.dropped(DROP_RANGE)),
+                   static_cast<unsigned long long>(m_medium.dropped(DROP_COLLISION)),
+                   static_cast<unsigned long long>(m_medium.dropped(DROP_HALF_DUPLEX)),
+                   static_cast<unsigned long long>(m_medium.dropped(DROP_LOSS)),
+                   static_cast<unsigned long long>(m_medium.dropped(DROP_OVERRUN)),
+                   static_cast<unsigned long long>(m_corrupt), m_medium.airtimeUsedUs() / (elapsedS * 1.0e6),
+                   static_cast<unsigned long long>(m_foreign), static_cast<unsigned long long>(bufferGets),
+                   m_runCpuNs / 1.0e6, m_scenario.radio.timeSync ? "true" : "false",
+                   static_cast<unsigned long long>(rank(clockErrors, 0.50)),
+                   static_cast<unsigned long long>(rank(clockErrors, 0.99)),
+                   static_cast<unsigned long long>(rank(clockErrors, 1.0)), converged);
+    for (size_t run = 0; run < m_probeResults.size(); run++) {
+      const ProbeResults& probes = m_probeResults[run];
+      (void) fprintf(out,
+                     "%s{\"size\": %u, \"sent\": %u, \"echoes\": %u, "
+                     "\"rtt_us\": {\"min\": %u, \"mean\": %u, \"p95\": %u, \"max\": %u}, \"jitter_us\": %u, "
+                     "\"forward_us\": %d, \"return_us\": %d}",
+                     (run == 0) ? "" : ", ", m_scenario.probeSizes[run], probes.sent, probes.echoes, probes.minUs,
+                     probes.meanUs, probes.p95Us, probes.maxUs, probes.jitterUs, probes.forwardUs, probes.returnUs);
+    }
+    (void) fprintf(out, "]}\n");
+  }
+
+}
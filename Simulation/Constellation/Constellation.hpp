@@ -0,0 +1,100 @@
+// ======================================================================
+// \title  Constellation.hpp
+// \brief  Many BroncoDeployment hub stacks sharing one simulated RF medium
+// ======================================================================
+
+#ifndef Simulation_Constellation_HPP
+#define Simulation_Constellation_HPP
+
+#include <Simulation/Constellation/RfMedium.hpp>
+#include <Simulation/Constellation/Scenario.hpp>
+#include <Simulation/HubNode/HubNode.hpp>
+
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace Simulation {
+
+  //! A constellation of nodes on one medium, run on a virtual clock
+  //!
+  //! Every tick each radio is run once, as rate group 1 runs it, and nodes whose next message is due send it with
+  //! MESSAGE_SEND. The rate groups of different satellites are not in step, so each node runs at its own fixed
+  //! offset into the tick. A broadcast message is counted once for each other node that receives it; in unicast a
+  //! message counts only at the sender's partner, and reaching any other node's handler is a foreign reception, work an
+  //! address filter exists to save. Latency is measured from the command to the message reaching the receiving
+  //! handler, so it includes waiting for the receiver's next poll and is quantized to the tick. At the start of every
+  //! tick each node's clock, as its components see it, is compared with node 0's, the time source when time
+  //! synchronization is on; errors are summarized over the second half of the traffic, when synchronization should
+  //! have settled, and the run has converged from the first tick after which every node stays within the scenario's
+  //! tolerance to the end. When the scenario has probe sizes, node 0 sends node 1 one PROBE_START run of each size in
+  //! turn from the start of the traffic, alongside the messages, and the handler's telemetry at the end of each run is
+  //! its result. The processor time spent
+  //! running the radios, which is where received packets are read out and passed up, is measured on the host; it is the
+  //! one result that does not reproduce exactly.
+  class Constellation : public MessageSink {
+
+    public:
+
+      Constellation(
+          const Scenario& scenario, //!< The scenario
+          U32 nodes //!< Number of nodes
+      );
+
+      ~Constellation();
+
+      //! Run the scenario to the end of its drain time
+      void run();
+
+      //! Write the results as one line of JSON
+      void report(FILE* out) const;
+
+      //! A node's message handler got a message
+      void messageReceived(U32 node, const U8* data, U32 size) override;
+
+    private:
+
+      //! Time of a node's next message after one sent at the given time
+      U64 nextMessageUs(U64 afterUs);
+
+      //! Collect the results of node 0's last probe run and start the next, when it is due
+      void startProbeRun();
+
+      //! Compare every node's clock with node 0's at the start of a tick
+      void measureClocks(
+          U64 tickStartUs, //!< Start of the tick
+          bool summarize //!< Whether the errors count toward the summary
+      );
+
+      const Scenario& m_scenario; //!< The scenario
+      U32 m_nodeCount; //!< Number of nodes
+      RfMedium m_medium; //!< Air between the nodes
+      std::mt19937 m_random; //!< Source of placement and traffic randomness
+      std::vector<std::unique_ptr<HubNode>> m_nodes; //!< The nodes
+      std::vector<U64> m_nextSendUs; //!< Time each node sends its next message
+      std::vector<U64> m_phaseUs; //!< Offset of each node's run into the tick
+      std::vector<U32> m_runOrder; //!< Nodes in the order they run within a tick
+      U64 m_nowUs; //!< Virtual time
+
+      std::vector<U64> m_sentUs; //!< Send time of each message, by message number
+      std::vector<U32> m_sender; //!< Sender of each message, by message number
+      std::vector<U64> m_latenciesUs; //!< Latency of each reception
+      U64 m_received; //!< Receptions of messages by nodes other than the sender
+      U64 m_bytesReceived; //!< Message bytes in those receptions
+      U64 m_corrupt; //!< Receptions that could not be matched to a message sent
+      U64 m_foreign; //!< Unicast messages that reached a node other than the one addressed
+      U64 m_runCpuNs; //!< Processor time spent running the radios
+
+      std::vector<U64> m_clockErrorsUs; //!< Clock error of each node other than 0 at each tick summarized
+      bool m_converged; //!< Whether every node has been within tolerance since m_convergedUs
+      U64 m_convergedUs; //!< Start of the tick from which every node has been within tolerance
+
+      U32 m_probeRuns; //!< Probe runs started by node 0
+      U64 m_nextProbeRunUs; //!< Time node 0 starts its next probe run
+      std::vector<ProbeResults> m_probeResults; //!< Results of each probe run that has ended, in order of size
+  };
+
+}
+
+#endif
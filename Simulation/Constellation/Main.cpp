@@ -0,0 +1,94 @@
+// ======================================================================
+// \title  Main.cpp
+// \brief  Runs constellation scenarios and reports one line of JSON per constellation size
+// ======================================================================
+
+#include <Simulation/Constellation/Constellation.hpp>
+#include <Simulation/Constellation/Scenario.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+
+/**
+ * \brief print command line help message
+ *
+ * @param app: name of application
+ */
+static void print_usage(const char* app)
+{
+    (void) printf("Usage: ./%s [options] scenario\n"
+                  "-o\tfile the report is written to instead of stdout\n"
+                  "-s\tseed, overriding the scenario's\n",
+                  app);
+}
+
+/**
+ * \brief run every constellation size of a scenario, in each CSMA mode, with each address filter and number of links
+ *
+ * Each run is independent from the same seed, so a report line can be reproduced on its own by running the
+ * scenario with only that size and mode. Placement and traffic are the same in every mode, so they compare directly.
+ */
+int main(int argc, char* argv[])
+{
+    const char* reportPath = nullptr;
+    const char* seed = nullptr;
+
+    int option = 0;
+    while ((option = getopt(argc, argv, "ho:s:")) != -1) {
+        switch (option) {
+            case 'o':
+                reportPath = optarg;
+                break;
+            case 's':
+                seed = optarg;
+                break;
+            case 'h':
+            case '?':
+            default:
+                print_usage(argv[0]);
+                return (option == 'h') ? 0 : 1;
+        }
+    }
+    if (optind != argc - 1) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    Simulation::Scenario scenario;
+    if (not scenario.load(argv[optind])) {
+        return 1;
+    }
+    if (seed != nullptr) {
+        scenario.seed = static_cast<U32>(strtoul(seed, nullptr, 0));
+    }
+
+    // The message handler prints every message it receives to stdout
+    FILE* report = (reportPath != nullptr) ? fopen(reportPath, "w") : stdout;
+    if (report == nullptr) {
+        (void) fprintf(stderr, "%s: cannot open\n", reportPath);
+        return 1;
+    }
+
+    for (U32 nodes : scenario.nodeCounts) {
+        for (bool csma : scenario.csmaModes) {
+            for (Radio::AddressFilter::T filter : scenario.addressFilters) {
+                for (U32 links : scenario.linkCounts) {
+                    Simulation::Scenario run(scenario);
+                    run.radio.csmaEnabled = csma;
+                    run.radio.addressFilter = filter;
+                    run.radio.links = links;
+                    Simulation::Constellation constellation(run, nodes);
+                    constellation.run();
+                    constellation.report(report);
+                    (void) fflush(report);
+                }
+            }
+        }
+    }
+
+    if (report != stdout) {
+        (void) fclose(report);
+    }
+    return 0;
+}
@@ -0,0 +1,202 @@
+// ======================================================================
+// \title  RfMedium.cpp
+// \brief  Simulated RF channel shared by the radios of a constellation
+// ======================================================================
+
+#include <Simulation/Constellation/RfMedium.hpp>
+#include <Fw/Types/Assert.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Simulation {
+
+  namespace {
+    //! Bit rate of each RH_RF69 modem configuration
+    const F64 BIT_RATE[] = {2000.0, 2400.0, 4800.0, 9600.0, 19200.0, 38400.0, 57600.0, 125000.0, 250000.0, 55555.0};
+
+    //! Approximate receiver sensitivity of each modem configuration in dBm, from the RFM69HCW datasheet curves
+    const F64 SENSITIVITY[] = {-115.0, -114.0, -112.0, -110.0, -108.0, -105.0, -102.0, -98.0, -94.0, -102.0};
+
+    //! Bytes the radio adds around a packet: preamble, sync word, length and CRC
+    const U32 FRAMING_BYTES = 4 + 2 + 1 + 2;
+  }
+
+  RfMedium ::
+    RfMedium(const RfParameters& parameters, U32 seed) :
+      m_parameters(parameters),
+      m_random(seed),
+      m_nowUs(0),
+      m_transmitted(0),
+      m_delivered(0),
+      m_airtimeUsed(0)
+  {
+    memset(m_dropped, 0, sizeof(m_dropped));
+  }
+
+  void RfMedium ::
+    place(U32 radio, F64 x, F64 y)
+  {
+    FW_ASSERT(radio < m_stations.size(), radio);
+    m_stations[radio].x = x;
+    m_stations[radio].y = y;
+  }
+
+  U64 RfMedium ::
+    airtimeUs(U8 modem, U32 length)
+  {
+    FW_ASSERT(modem < FW_NUM_ARRAY_ELEMENTS(BIT_RATE), modem);
+    return static_cast<U64>(std::ceil((FRAMING_BYTES + length) * 8 * 1.0e6 / BIT_RATE[modem]));
+  }
+
+  void RfMedium ::
+    attach(RH_RF69& radio)
+  {
+    Station station;
+    station.radio = &radio;
+    station.x = 0.0;
+    station.y = 0.0;
+    station.busyUntilUs = 0;
+    m_stations.push_back(station);
+  }
+
+  U64 RfMedium ::
+    transmit(RH_RF69& radio, const U8* data, U8 len)
+  {
+    const U32 source = this->stationOf(radio);
+    Station& station = m_stations[source];
+
+    // A radio sends its packets back to back, each after the previous one has left the air
+    Transmission transmission;
+    transmission.source = source;
+    transmission.startUs = FW_MAX(m_nowUs, station.busyUntilUs);
+    transmission.endUs = transmission.startUs + airtimeUs(radio.modem(), radio.airLength(len));
+    transmission.frequencyKhz = radio.frequencyKhz();
+    transmission.modem = radio.modem();
+    transmission.power = radio.txPower();
+    transmission.length = len;
+    memset(transmission.data, 0, sizeof(transmission.data));
+    memcpy(transmission.data, data, radio.airLength(len));
+    transmission.resolved = false;
+    station.busyUntilUs = transmission.endUs;
+
+    m_air.push_back(transmission);
+    m_transmitted++;
+    m_airtimeUsed += transmission.endUs - transmission.startUs;
+    return transmission.endUs;
+  }
+
+  I16 RfMedium ::
+    channelRssi(RH_RF69& radio)
+  {
+    const U32 listener = this->stationOf(radio);
+    F64 strongest = RH_RF69_RSSI_FLOOR;
+    for (const Transmission& transmission : m_air) {
+      if ((transmission.source != listener) && (transmission.frequencyKhz == radio.frequencyKhz()) &&
+          (transmission.startUs <= m_nowUs) && (m_nowUs < transmission.endUs)) {
+        strongest = FW_MAX(strongest, this->rssiAt(transmission, listener));
+      }
+    }
+    return static_cast<I16>(std::lround(strongest));
+  }
+
+  void RfMedium ::
+    advance(U64 nowUs)
+  {
+    m_nowUs = nowUs;
+
+    // Receivers hear packets in the order they finish
+    std::vector<U32> finished;
+    for (U32 i = 0; i < m_air.size(); i++) {
+      if (not m_air[i].resolved && (m_air[i].endUs <= nowUs)) {
+        finished.push_back(i);
+      }
+    }
+    std::sort(finished.begin(), finished.end(), [this](U32 a, U32 b) { return m_air[a].endUs < m_air[b].endUs; });
+    for (U32 i : finished) {
+      this->resolve(m_air[i]);
+      m_air[i].resolved = true;
+    }
+
+    // Keep finished packets only while they can still overlap one that is yet to be resolved
+    U64 horizon = nowUs;
+    for (const Transmission& transmission : m_air) {
+      if (not transmission.resolved) {
+        horizon = FW_MIN(horizon, transmission.startUs);
+      }
+    }
+    m_air.erase(std::remove_if(m_air.begin(), m_air.end(),
+                               [horizon](const Transmission& transmission) {
+                                 return transmission.resolved && (transmission.endUs <= horizon);
+                               }),
+                m_air.end());
+  }
+
+  U32 RfMedium ::
+    stationOf(const RH_RF69& radio) const
+  {
+    U32 station = 0;
+    while ((station < m_stations.size()) && (m_stations[station].radio != &radio)) {
+      station++;
+    }
+    FW_ASSERT(station < m_stations.size());
+    return station;
+  }
+
+  F64 RfMedium ::
+    rssiAt(const Transmission& transmission, U32 receiver) const
+  {
+    const Station& from = m_stations[transmission.source];
+    const Station& to = m_stations[receiver];
+    const F64 distance = FW_MAX(std::hypot(from.x - to.x, from.y - to.y), 1.0);
+    return transmission.power -
+           (m_parameters.referenceLossDb + 10.0 * m_parameters.pathLossExponent * std::log10(distance));
+  }
+
+  void RfMedium ::
+    resolve(const Transmission& transmission)
+  {
+    std::uniform_real_distribution<F64> uniform(0.0, 1.0);
+    for (U32 receiver = 0; receiver < m_stations.size(); receiver++) {
+      RH_RF69& radio = *m_stations[receiver].radio;
+      if ((receiver == transmission.source) || (radio.frequencyKhz() != transmission.frequencyKhz) ||
+          (radio.modem() != transmission.modem)) {
+        continue;
+      }
+
+      const F64 rssi = this->rssiAt(transmission, receiver);
+      DropCause cause = NUM_DROP_CAUSES;
+      if (rssi < SENSITIVITY[transmission.modem]) {
+        cause = DROP_RANGE;
+      }
+      for (const Transmission& other : m_air) {
+        if ((&other == &transmission) || (cause != NUM_DROP_CAUSES) ||
+            (other.frequencyKhz != transmission.frequencyKhz) || (other.startUs >= transmission.endUs) ||
+            (other.endUs <= transmission.startUs)) {
+          continue;
+        }
+        if (other.source == receiver) {
+          cause = DROP_HALF_DUPLEX;
+        } else if (this->rssiAt(other, receiver) > rssi - m_parameters.captureDb) {
+          cause = DROP_COLLISION;
+        }
+      }
+      if ((cause == NUM_DROP_CAUSES) && (uniform(m_random) < m_parameters.lossRate)) {
+        cause = DROP_LOSS;
+      }
+      if ((cause == NUM_DROP_CAUSES) &&
+          not radio.deliver(transmission.data, transmission.length, static_cast<I16>(std::lround(rssi)),
+                            transmission.endUs)) {
+        cause = DROP_OVERRUN;
+      }
+
+      if (cause == NUM_DROP_CAUSES) {
+        m_delivered++;
+      } else {
+        m_dropped[cause]++;
+      }
+    }
+  }
+
+}
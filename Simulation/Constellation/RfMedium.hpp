@@ -0,0 +1,126 @@
+// ======================================================================
+// \title  RfMedium.hpp
+// \brief  Simulated RF channel shared by the radios of a constellation
+// ======================================================================
+
+#ifndef Simulation_RfMedium_HPP
+#define Simulation_RfMedium_HPP
+
+#include <Components/Radio/RFM69/SimRH_RF69.hpp>
+#include <random>
+#include <vector>
+
+namespace Simulation {
+
+  //! Channel model parameters
+  struct RfParameters {
+    F64 pathLossExponent; //!< Log-distance path loss exponent
+    F64 referenceLossDb; //!< Path loss at 1 m
+    F64 captureDb; //!< Margin by which a packet must exceed an overlapping one to survive it
+    F64 lossRate; //!< Probability that a receivable packet is lost anyway (fading, interference)
+  };
+
+  //! Why a packet did not reach a radio
+  enum DropCause {
+    DROP_RANGE, //!< Below the receiver sensitivity
+    DROP_COLLISION, //!< Overlapped a packet too strong to capture over
+    DROP_HALF_DUPLEX, //!< The receiver was transmitting
+    DROP_LOSS, //!< Random loss
+    DROP_OVERRUN, //!< The receiver had not read its previous packet
+    NUM_DROP_CAUSES
+  };
+
+  //! Air between the radios of a constellation, on a virtual clock
+  //!
+  //! Each transmission occupies the air for its airtime at the bit rate of the sender's modem profile, and a radio
+  //! sends its packets one after another. When a transmission ends, every other radio tuned to the same frequency and
+  //! profile receives it unless it is out of range, was transmitting itself, heard an overlapping transmission within
+  //! the capture margin, or loses it at random. A radio sampling the channel hears the strongest transmission on the
+  //! air at that moment on its frequency, whatever its modem profile. All randomness comes from one seeded generator,
+  //! so a run is reproducible.
+  class RfMedium : public SimRadioMedium {
+
+    public:
+
+      RfMedium(const RfParameters& parameters, U32 seed);
+
+      //! Place a radio, in metres; radios are numbered in the order they attach
+      void place(U32 radio, F64 x, F64 y);
+
+      //! Deliver every transmission that has ended by the given time
+      void advance(U64 nowUs);
+
+      //! Airtime of a packet in microseconds
+      static U64 airtimeUs(U8 modem, U32 length);
+
+      //! Packets that reached a receiver
+      U64 delivered() const { return m_delivered; }
+
+      //! Packets that did not reach a receiver, by cause
+      U64 dropped(DropCause cause) const { return m_dropped[cause]; }
+
+      //! Packets transmitted
+      U64 transmitted() const { return m_transmitted; }
+
+      //! Microseconds of airtime used by all transmissions
+      U64 airtimeUsedUs() const { return m_airtimeUsed; }
+
+      // ----------------------------------------------------------------------
+      // SimRadioMedium
+      // ----------------------------------------------------------------------
+
+      void attach(RH_RF69& radio) override;
+
+      U64 transmit(RH_RF69& radio, const U8* data, U8 len) override;
+
+      U64 nowUs() override { return m_nowUs; }
+
+      I16 channelRssi(RH_RF69& radio) override;
+
+    private:
+
+      //! A packet on the air
+      struct Transmission {
+        U32 source; //!< Sending radio
+        U64 startUs; //!< Start of the packet on the air
+        U64 endUs; //!< End of the packet on the air
+        U32 frequencyKhz; //!< Channel
+        U8 modem; //!< Modem profile
+        I8 power; //!< Transmit power in dBm
+        U8 length; //!< Length byte of the packet
+        U8 data[RH_RF69_MAX_AIR_LEN]; //!< The packet, RadioHead header first, encrypted or not
+        bool resolved; //!< Whether receivers have been given the packet
+      };
+
+      //! A placed radio
+      struct Station {
+        RH_RF69* radio; //!< The radio
+        F64 x; //!< Position in metres
+        F64 y; //!< Position in metres
+        U64 busyUntilUs; //!< End of the last packet it queued for the air
+      };
+
+      //! Number of an attached radio
+      U32 stationOf(const RH_RF69& radio) const;
+
+      //! Signal strength of a transmission at a radio, in dBm
+      F64 rssiAt(const Transmission& transmission, U32 receiver) const;
+
+      //! Give a finished transmission to every radio that can receive it
+      void resolve(const Transmission& transmission);
+
+      RfParameters m_parameters; //!< Channel model
+      std::mt19937 m_random; //!< Source of all randomness
+      std::vector<Station> m_stations; //!< Radios, by number
+      std::vector<Transmission> m_air; //!< Transmissions that are or were recently on the air
+      U64 m_nowUs; //!< Virtual time
+
+      U64 m_transmitted; //!< Packets transmitted
+      U64 m_delivered; //!< Packets received
+      U64 m_dropped[NUM_DROP_CAUSES]; //!< Packets not received, by cause
+      U64 m_airtimeUsed; //!< Airtime of all transmissions
+  };
+
+}
+
+#endif
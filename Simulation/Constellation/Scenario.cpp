@@ -0,0 +1,266 @@
+// ======================================================================
+// \title  Scenario.cpp
+// \brief  Description of a constellation simulation run
+// ======================================================================
+
+#include <Simulation/Constellation/Scenario.hpp>
+#include <config/FppConstantsAc.hpp>
+#include <config/LatencyProbeCfg.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace Simulation {
+
+  namespace {
+    //! Modem profiles by their FPP names
+    const struct {
+      const char* name;
+      Radio::ModemProfile::T profile;
+    } PROFILES[] = {
+        {"GFSK_Rb2Fd5", Radio::ModemProfile::GFSK_Rb2Fd5},
+        {"GFSK_Rb9_6Fd19_2", Radio::ModemProfile::GFSK_Rb9_6Fd19_2},
+        {"GFSK_Rb38_4Fd76_8", Radio::ModemProfile::GFSK_Rb38_4Fd76_8},
+        {"GFSK_Rb57_6Fd120", Radio::ModemProfile::GFSK_Rb57_6Fd120},
+        {"GFSK_Rb125Fd125", Radio::ModemProfile::GFSK_Rb125Fd125},
+        {"GFSK_Rb250Fd250", Radio::ModemProfile::GFSK_Rb250Fd250},
+    };
+
+    //! Address filters by their scenario names
+    const struct {
+      const char* name;
+      Radio::AddressFilter::T filter;
+    } FILTERS[] = {
+        {"off", Radio::AddressFilter::OFF},
+        {"software", Radio::AddressFilter::SOFTWARE},
+        {"hardware", Radio::AddressFilter::HARDWARE},
+    };
+  }
+
+  Scenario ::
+    Scenario() :
+      seed(1),
+      durationS(60.0),
+      drainS(5.0),
+      warmupS(1.0),
+      tickMs(100),
+      messageIntervalMs(5000),
+      poisson(false),
+      messageSize(24),
+      areaM(1000.0),
+      clockSkewPpm(0.0),
+      clockOffsetMs(0.0),
+      timeToleranceUs(10),
+      probeCount(20),
+      probeIntervalMs(1000)
+  {
+    radio.frequencyMhz = 915.0f;
+    radio.txPowerDbm = 14;
+    radio.modem = Radio::ModemProfile::GFSK_Rb250Fd250;
+    radio.csmaEnabled = true;
+    radio.csmaThresholdDbm = -90;
+    radio.unicast = false;
+    radio.addressFilter = Radio::AddressFilter::HARDWARE;
+    radio.timeSync = false;
+    radio.links = 1;
+    radio.linkSpacingMhz = 1.0f;
+    nodeCounts.push_back(2);
+    csmaModes.push_back(true);
+    addressFilters.push_back(Radio::AddressFilter::HARDWARE);
+    linkCounts.push_back(1);
+    rf.pathLossExponent = 2.7;
+    // Free-space loss over the first metre at 915 MHz
+    rf.referenceLossDb = 31.7;
+    rf.captureDb = 6.0;
+    rf.lossRate = 0.0;
+  }
+
+  U64 Scenario ::
+    probeRunUs() const
+  {
+    // The run ends ECHO_WAIT_TICKS after its last probe, and the next starts a tick later
+    const U64 tickUs = static_cast<U64>(tickMs) * 1000;
+    return (static_cast<U64>(probeCount) * probeIntervalMs * 1000) +
+           (Components::LatencyProbeCfg::ECHO_WAIT_TICKS + 1) * tickUs;
+  }
+
+  bool Scenario ::
+    load(const char* path)
+  {
+    std::ifstream file(path);
+    if (not file) {
+      (void) fprintf(stderr, "%s: cannot open\n", path);
+      return false;
+    }
+
+    std::string line;
+    for (U32 number = 1; std::getline(file, line); number++) {
+      line = line.substr(0, line.find('#'));
+      std::istringstream fields(line);
+      std::string key;
+      if (not (fields >> key)) {
+        continue;
+      }
+
+      bool good = true;
+      if (key == "nodes") {
+        nodeCounts.clear();
+        U32 count = 0;
+        while (fields >> count) {
+          good = good && (count >= 2);
+          nodeCounts.push_back(count);
+        }
+        good = good && fields.eof() && not nodeCounts.empty();
+      } else if (key == "links") {
+        linkCounts.clear();
+        U32 count = 0;
+        while (fields >> count) {
+          good = good && (count >= 1) && (count <= ChannelBondLinks);
+          linkCounts.push_back(count);
+        }
+        good = good && fields.eof() && not linkCounts.empty();
+      } else if (key == "link_spacing_mhz") {
+        good = static_cast<bool>(fields >> radio.linkSpacingMhz) && (radio.linkSpacingMhz > 0.0f);
+      } else if (key == "csma") {
+        csmaModes.clear();
+        std::string mode;
+        while (fields >> mode) {
+          good = good && ((mode == "on") || (mode == "off"));
+          csmaModes.push_back(mode == "on");
+        }
+        good = good && not csmaModes.empty();
+      } else if (key == "address_filter") {
+        addressFilters.clear();
+        std::string name;
+        while (fields >> name) {
+          U32 i = 0;
+          while ((i < FW_NUM_ARRAY_ELEMENTS(FILTERS)) && (name != FILTERS[i].name)) {
+            i++;
+          }
+          good = good && (i < FW_NUM_ARRAY_ELEMENTS(FILTERS));
+          if (good) {
+            addressFilters.push_back(FILTERS[i].filter);
+          }
+        }
+        good = good && not addressFilters.empty();
+      } else if (key == "addressing") {
+        std::string kind;
+        good = static_cast<bool>(fields >> kind) && ((kind == "broadcast") || (kind == "unicast"));
+        radio.unicast = (kind == "unicast");
+      } else if (key == "time_sync") {
+        std::string mode;
+        good = static_cast<bool>(fields >> mode) && ((mode == "on") || (mode == "off"));
+        radio.timeSync = (mode == "on");
+      } else if (key == "clock_skew_ppm") {
+        good = static_cast<bool>(fields >> clockSkewPpm) && (clockSkewPpm >= 0.0) && (clockSkewPpm < 1000.0);
+      } else if (key == "clock_offset_ms") {
+        good = static_cast<bool>(fields >> clockOffsetMs) && (clockOffsetMs >= 0.0);
+      } else if (key == "time_tolerance_us") {
+        good = static_cast<bool>(fields >> timeToleranceUs) && (timeToleranceUs > 0);
+      } else if (key == "probe_sizes") {
+        probeSizes.clear();
+        U32 size = 0;
+        while (fields >> size) {
+          good = good && (size >= Components::BroncoOreMessageHandler::PROBE_HEADER_SIZE) &&
+                 (size <= FW_COM_BUFFER_MAX_SIZE);
+          probeSizes.push_back(static_cast<U16>(size));
+        }
+        good = good && fields.eof();
+      } else if (key == "probe_count") {
+        U32 count = 0;
+        good = static_cast<bool>(fields >> count) && (count > 0) && (count <= 0xFFFF);
+        probeCount = static_cast<U16>(count);
+      } else if (key == "probe_interval_ms") {
+        good = static_cast<bool>(fields >> probeIntervalMs) && (probeIntervalMs > 0);
+      } else if (key == "csma_threshold_dbm") {
+        good = static_cast<bool>(fields >> radio.csmaThresholdDbm);
+      } else if (key == "encryption_key") {
+        // 32 hex digits, or 0 to send in the clear
+        std::string hex;
+        good = static_cast<bool>(fields >> hex) && ((hex == "0") || (hex.size() == 2 * Radio::AesKey::SIZE));
+        for (U32 i = 0; good && (i < Radio::AesKey::SIZE); i++) {
+          const std::string digits = (hex == "0") ? "00" : hex.substr(2 * i, 2);
+          char* end = nullptr;
+          radio.encryptionKey[i] = static_cast<U8>(strtoul(digits.c_str(), &end, 16));
+          good = (*end == '\0');
+        }
+      } else if (key == "modem") {
+        std::string name;
+        good = static_cast<bool>(fields >> name);
+        U32 i = 0;
+        while ((i < FW_NUM_ARRAY_ELEMENTS(PROFILES)) && (name != PROFILES[i].name)) {
+          i++;
+        }
+        good = good && (i < FW_NUM_ARRAY_ELEMENTS(PROFILES));
+        if (good) {
+          radio.modem = PROFILES[i].profile;
+        }
+      } else if (key == "traffic") {
+        std::string kind;
+        good = static_cast<bool>(fields >> kind) && ((kind == "periodic") || (kind == "poisson"));
+        poisson = (kind == "poisson");
+      } else if (key == "tx_power_dbm") {
+        I32 power = 0;
+        good = static_cast<bool>(fields >> power) && (power >= -18) && (power <= 20);
+        radio.txPowerDbm = static_cast<I8>(power);
+      } else if (key == "area_km") {
+        good = static_cast<bool>(fields >> areaM) && (areaM >= 0.0);
+        areaM *= 1000.0;
+      } else if (key == "seed") {
+        good = static_cast<bool>(fields >> seed);
+      } else if (key == "duration_s") {
+        good = static_cast<bool>(fields >> durationS) && (durationS > 0.0);
+      } else if (key == "drain_s") {
+        good = static_cast<bool>(fields >> drainS) && (drainS >= 0.0);
+      } else if (key == "warmup_s") {
+        good = static_cast<bool>(fields >> warmupS) && (warmupS >= 0.0);
+      } else if (key == "tick_ms") {
+        good = static_cast<bool>(fields >> tickMs) && (tickMs > 0);
+      } else if (key == "message_interval_ms") {
+        good = static_cast<bool>(fields >> messageIntervalMs) && (messageIntervalMs > 0);
+      } else if (key == "message_size") {
+        // Messages are MESSAGE_SEND string arguments, so they are bounded by the command string size
+        good = static_cast<bool>(fields >> messageSize) && (messageSize >= 8) &&
+               (messageSize <= FW_CMD_STRING_MAX_SIZE);
+      } else if (key == "frequency_mhz") {
+        good = static_cast<bool>(fields >> radio.frequencyMhz);
+      } else if (key == "path_loss_exponent") {
+        good = static_cast<bool>(fields >> rf.pathLossExponent);
+      } else if (key == "reference_loss_db") {
+        good = static_cast<bool>(fields >> rf.referenceLossDb);
+      } else if (key == "capture_db") {
+        good = static_cast<bool>(fields >> rf.captureDb);
+      } else if (key == "loss") {
+        good = static_cast<bool>(fields >> rf.lossRate) && (rf.lossRate >= 0.0) && (rf.lossRate <= 1.0);
+      } else {
+        (void) fprintf(stderr, "%s:%u: unknown key %s\n", path, number, key.c_str());
+        return false;
+      }
+
+      if (not good) {
+        (void) fprintf(stderr, "%s:%u: bad value for %s\n", path, number, key.c_str());
+        return false;
+      }
+    }
+
+    // Probes are sent from the rate group, so their interval is counted in ticks, and every run must end while the
+    // traffic lasts
+    if (not probeSizes.empty()) {
+      if (((probeIntervalMs % tickMs) != 0) || ((probeIntervalMs / tickMs) > 0xFFFF)) {
+        (void) fprintf(stderr, "%s: probe_interval_ms must be a whole number of ticks of %u ms\n", path, tickMs);
+        return false;
+      }
+      if (static_cast<F64>(this->probeRunUs()) * probeSizes.size() > durationS * 1.0e6) {
+        (void) fprintf(stderr, "%s: %zu probe runs of %.1f s do not fit in duration_s\n", path, probeSizes.size(),
+                       this->probeRunUs() / 1.0e6);
+        return false;
+      }
+    }
+    return true;
+  }
+
+}
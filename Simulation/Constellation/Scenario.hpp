@@ -0,0 +1,54 @@
+// ======================================================================
+// \title  Scenario.hpp
+// \brief  Description of a constellation simulation run
+// ======================================================================
+
+#ifndef Simulation_Scenario_HPP
+#define Simulation_Scenario_HPP
+
+#include <Simulation/Constellation/RfMedium.hpp>
+#include <Simulation/HubNode/HubNode.hpp>
+#include <vector>
+
+namespace Simulation {
+
+  //! Everything that determines a simulation run; the same scenario and seed always give the same results
+  struct Scenario {
+
+    //! A scenario with the defaults for every key
+    Scenario();
+
+    //! Time from the start of one probe run to the start of the next, in microseconds
+    U64 probeRunUs() const;
+
+    //! Read a scenario file of "key value" lines; unlisted keys keep their defaults
+    //!
+    //! \return false if the file cannot be read or holds an unknown key or bad value, reported on stderr
+    bool load(const char* path);
+
+    std::vector<U32> nodeCounts; //!< Constellation sizes to run, one report line each
+    std::vector<bool> csmaModes; //!< Whether radios listen before talking, each mode run at every size
+    std::vector<Radio::AddressFilter::T> addressFilters; //!< Address filter of the radios, each run at every size
+    std::vector<U32> linkCounts; //!< Radios per node, each run at every size
+    U32 seed; //!< Seed of the placement, traffic and channel randomness
+    F64 durationS; //!< Virtual seconds of traffic
+    F64 drainS; //!< Virtual seconds run after the traffic stops so packets in flight can land
+    F64 warmupS; //!< Virtual seconds for the radios to come up before traffic starts
+    U32 tickMs; //!< Period of the rate group that runs the radios
+    U32 messageIntervalMs; //!< Mean time between messages sent by one node
+    bool poisson; //!< Whether message intervals are exponentially distributed rather than fixed
+    U32 messageSize; //!< Characters per message
+    F64 areaM; //!< Side of the square the nodes are placed in, in metres
+    F64 clockSkewPpm; //!< Largest rate error of a node's clock, either way; each node's is drawn up to it
+    F64 clockOffsetMs; //!< Largest offset of a node's clock at time 0; each node's is drawn up to it
+    U32 timeToleranceUs; //!< Clock error within which a node counts as synchronized
+    std::vector<U16> probeSizes; //!< Size of the probes of each run node 0 sends node 1; no runs if empty
+    U16 probeCount; //!< Probes sent in each run
+    U32 probeIntervalMs; //!< Time between probes, a whole number of ticks
+    RadioSettings radio; //!< Parameters of every radio
+    RfParameters rf; //!< Channel model
+  };
+
+}
+
+#endif
@@ -0,0 +1,339 @@
+// ======================================================================
+// \title  FuzzRig.cpp
+// \brief  Feeds the deframer a stream of frames with random damage and checks what comes out
+// ======================================================================
+
+#include <Simulation/DeframerFuzz/FuzzRig.hpp>
+#include <Simulation/Tool/Tool.hpp>
+#include <Fw/Com/ComPacket.hpp>
+#include <Fw/Types/Assert.hpp>
+
+#include <cstring>
+
+namespace Simulation {
+
+  namespace {
+    //! The deframer's generated channel ids, which its component base keeps protected
+    struct DeframerChannels : Framing::DeframerComponentBase {
+      enum : FwChanIdType {
+        RESYNC_EVENTS = CHANNELID_RESYNCEVENTS,
+        BYTES_DISCARDED = CHANNELID_BYTESDISCARDED,
+        CHECKSUM_ERRORS = CHANNELID_CHECKSUMERRORS
+      };
+    };
+
+    //! Bytes of a command packet ahead of its filler: the packet type and the sequence number
+    const U32 PACKET_HEADER_SIZE = sizeof(FwPacketDescriptorType) + sizeof(U32);
+
+    //! Most filler a packet carries, so the packet fits a Com buffer
+    const U32 MAX_FILLER = FW_COM_BUFFER_MAX_SIZE - PACKET_HEADER_SIZE;
+
+    //! Largest size a fake header claims, the most the deframer will wait for
+    const U32 MAX_FAKE_SIZE =
+        Svc::DeframerCfg::RING_BUFFER_SIZE - Svc::FpFrameHeader::SIZE - Framing::FRAME_CRC_SIZE;
+
+    F64 microsecondsBetween(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+      return std::chrono::duration<F64, std::micro>(end - start).count();
+    }
+  }
+
+  FuzzRig ::
+    FuzzRig(const FuzzOptions& options) :
+      Fw::PassiveComponentBase("rig"),
+      m_options(options),
+      m_random(options.seed),
+      m_damagedBytes(0),
+      m_lastSequence(0),
+      m_anyDelivered(false),
+      m_outOfOrder(false),
+      m_unknown(0),
+      m_fedTo(0),
+      m_nextStart(0),
+      m_nextRecovery(0),
+      m_recoveries(0),
+      m_recoveryTotalUs(0.0),
+      m_recoveryMaxUs(0.0),
+      m_recoveryTotalBytes(0),
+      m_recoveryMaxBytes(0),
+      m_feedUs(0.0),
+      m_resyncEvents(0),
+      m_bytesDiscarded(0),
+      m_checksumErrors(0),
+      m_deframer("deframer")
+  {
+    memset(m_damageCounts, 0, sizeof(m_damageCounts));
+
+    Fw::PassiveComponentBase::init(0);
+    m_deframer.init(0);
+
+    m_allocateIn.init();
+    m_allocateIn.addCallComp(this, allocateIn);
+    m_allocateIn.setPortNum(0);
+    m_deallocateIn.init();
+    m_deallocateIn.addCallComp(this, deallocateIn);
+    m_deallocateIn.setPortNum(0);
+    m_comIn.init();
+    m_comIn.addCallComp(this, comIn);
+    m_comIn.setPortNum(0);
+    m_tlmIn.init();
+    m_tlmIn.addCallComp(this, tlmIn);
+    m_tlmIn.setPortNum(0);
+
+    m_deframer.set_framedDeallocate_OutputPort(0, &m_deallocateIn);
+    m_deframer.set_bufferAllocate_OutputPort(0, &m_allocateIn);
+    m_deframer.set_bufferDeallocate_OutputPort(0, &m_deallocateIn);
+    m_deframer.set_comOut_OutputPort(0, &m_comIn);
+    m_deframer.set_tlmOut_OutputPort(0, &m_tlmIn);
+    m_deframer.setup(m_protocol);
+  }
+
+  void FuzzRig ::
+    run()
+  {
+    std::bernoulli_distribution damaged(m_options.damage);
+    std::vector<U8> frame;
+    U32 sequence = 0;
+    for (U32 i = 0; i < m_options.frames; i++) {
+      if (damaged(m_random)) {
+        this->appendDamage(sequence);
+      }
+      this->buildFrame(sequence, frame);
+      m_stream.insert(m_stream.end(), frame.begin(), frame.end());
+      m_intact.push_back(true);
+      sequence++;
+    }
+    m_stream.insert(m_stream.end(), TRAILER, 0);
+    m_delivered.assign(m_intact.size(), 0);
+
+    std::uniform_int_distribution<U32> chunkSize(1, MAX_CHUNK);
+    const U32 size = static_cast<U32>(m_stream.size());
+    U32 offset = 0;
+    while (offset < size) {
+      const U32 chunk = FW_MIN(chunkSize(m_random), size - offset);
+      m_fedTo = offset + chunk;
+      const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      while ((m_nextStart < m_damage.size()) && (m_damage[m_nextStart].offset < m_fedTo)) {
+        m_damage[m_nextStart].start = start;
+        m_damage[m_nextStart].started = true;
+        m_nextStart++;
+      }
+      Fw::Buffer buffer(&m_stream[offset], chunk);
+      m_deframer.get_framedIn_InputPort(0)->invoke(buffer, Drv::RecvStatus::RECV_OK);
+      m_feedUs += microsecondsBetween(start, std::chrono::steady_clock::now());
+      offset += chunk;
+    }
+  }
+
+  void FuzzRig ::
+    buildFrame(U32 sequence, std::vector<U8>& frame)
+  {
+    std::uniform_int_distribution<U32> fillerSize(0, MAX_FILLER);
+    const U32 packetSize = PACKET_HEADER_SIZE + fillerSize(m_random);
+    frame.resize(Svc::FpFrameHeader::SIZE + packetSize + Framing::FRAME_CRC_SIZE);
+
+    Fw::ExternalSerializeBuffer serial(frame.data(), static_cast<U32>(frame.size()));
+    Fw::SerializeStatus status = serial.serialize(Svc::FpFrameHeader::START_WORD);
+    status = (status == Fw::FW_SERIALIZE_OK) ? serial.serialize(packetSize) : status;
+    status = (status == Fw::FW_SERIALIZE_OK) ?
+        serial.serialize(static_cast<FwPacketDescriptorType>(Fw::ComPacket::FW_PACKET_COMMAND)) : status;
+    status = (status == Fw::FW_SERIALIZE_OK) ? serial.serialize(sequence) : status;
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    for (U32 i = PACKET_HEADER_SIZE; i < packetSize; i++) {
+      status = serial.serialize(static_cast<U8>(m_random()));
+      FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    }
+    status = serial.serialize(Framing::defaultCrc32Engine().compute(frame.data(), serial.getBuffLength()));
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+  }
+
+  void FuzzRig ::
+    appendDamage(U32& sequence)
+  {
+    const Damage kind = static_cast<Damage>(std::uniform_int_distribution<U32>(0, DAMAGE_KINDS - 1)(m_random));
+    DamageSpan span;
+    span.offset = static_cast<U32>(m_stream.size());
+    span.started = false;
+    std::vector<U8> bytes;
+    switch (kind) {
+      case DAMAGE_NOISE:
+        bytes.resize(std::uniform_int_distribution<U32>(1, MAX_NOISE)(m_random));
+        for (U8& byte : bytes) {
+          byte = static_cast<U8>(m_random());
+        }
+        break;
+      case DAMAGE_FLIP: {
+        // A damaged frame takes a sequence number of its own, which must never come out
+        this->buildFrame(sequence, bytes);
+        const U32 bit = std::uniform_int_distribution<U32>(0, static_cast<U32>(bytes.size()) * 8 - 1)(m_random);
+        bytes[bit / 8] ^= static_cast<U8>(1U << (bit % 8));
+        m_intact.push_back(false);
+        sequence++;
+        break;
+      }
+      case DAMAGE_TRUNCATE:
+        this->buildFrame(sequence, bytes);
+        bytes.resize(std::uniform_int_distribution<U32>(1, static_cast<U32>(bytes.size()) - 1)(m_random));
+        m_intact.push_back(false);
+        sequence++;
+        break;
+      case DAMAGE_FAKE_HEADER: {
+        bytes.resize(Svc::FpFrameHeader::SIZE);
+        Fw::ExternalSerializeBuffer serial(bytes.data(), static_cast<U32>(bytes.size()));
+        Fw::SerializeStatus status = serial.serialize(Svc::FpFrameHeader::START_WORD);
+        status = (status == Fw::FW_SERIALIZE_OK) ?
+            serial.serialize(std::uniform_int_distribution<U32>(0, MAX_FAKE_SIZE)(m_random)) : status;
+        FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+        break;
+      }
+      default:
+        FW_ASSERT(0, kind);
+        break;
+    }
+    span.target = sequence;
+    m_damage.push_back(span);
+    m_damageCounts[kind]++;
+    m_damagedBytes += bytes.size();
+    m_stream.insert(m_stream.end(), bytes.begin(), bytes.end());
+  }
+
+  void FuzzRig ::
+    recovered(U32 sequence)
+  {
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    while ((m_nextRecovery < m_damage.size()) && (m_damage[m_nextRecovery].target <= sequence)) {
+      const DamageSpan& span = m_damage[m_nextRecovery];
+      FW_ASSERT(span.started);
+      const F64 us = microsecondsBetween(span.start, now);
+      const U32 bytes = m_fedTo - span.offset;
+      m_recoveryTotalUs += us;
+      m_recoveryMaxUs = FW_MAX(m_recoveryMaxUs, us);
+      m_recoveryTotalBytes += bytes;
+      m_recoveryMaxBytes = FW_MAX(m_recoveryMaxBytes, bytes);
+      m_recoveries++;
+      m_nextRecovery++;
+    }
+  }
+
+  void FuzzRig ::
+    report(FILE* out) const
+  {
+    U32 intact = 0;
+    U32 delivered = 0;
+    U32 lost = 0;
+    U32 falseDeliveries = m_unknown;
+    U32 duplicates = 0;
+    for (U32 i = 0; i < m_intact.size(); i++) {
+      intact += m_intact[i] ? 1 : 0;
+      delivered += (m_delivered[i] > 0) ? 1 : 0;
+      lost += (m_intact[i] && (m_delivered[i] == 0)) ? 1 : 0;
+      falseDeliveries += (not m_intact[i] && (m_delivered[i] > 0)) ? 1 : 0;
+      duplicates += (m_delivered[i] > 1) ? m_delivered[i] - 1 : 0;
+    }
+    const F64 recoveries = (m_recoveries > 0) ? static_cast<F64>(m_recoveries) : 1.0;
+    const F64 feedSeconds = m_feedUs / 1e6;
+    JsonLine(out)
+        .field("seed", m_options.seed)
+        .field("frames", static_cast<U32>(m_intact.size()))
+        .field("intact", intact)
+        .field("noise", m_damageCounts[DAMAGE_NOISE])
+        .field("bit_flips", m_damageCounts[DAMAGE_FLIP])
+        .field("truncations", m_damageCounts[DAMAGE_TRUNCATE])
+        .field("fake_headers", m_damageCounts[DAMAGE_FAKE_HEADER])
+        .field("stream_bytes", static_cast<U64>(m_stream.size()))
+        .field("damaged_bytes", static_cast<U64>(m_damagedBytes))
+        .field("delivered", delivered)
+        .field("lost", lost)
+        .field("false_deliveries", falseDeliveries)
+        .field("duplicates", duplicates)
+        .field("in_order", not m_outOfOrder)
+        .field("resync_events", m_resyncEvents)
+        .field("bytes_discarded", m_bytesDiscarded)
+        .field("checksum_errors", m_checksumErrors)
+        .field("recoveries", m_recoveries)
+        .field("mean_recovery_us", m_recoveryTotalUs / recoveries, 2)
+        .field("max_recovery_us", m_recoveryMaxUs, 2)
+        .field("mean_recovery_bytes", static_cast<F64>(m_recoveryTotalBytes) / recoveries, 1)
+        .field("max_recovery_bytes", m_recoveryMaxBytes)
+        .field("bytes_per_second", (feedSeconds > 0.0) ? static_cast<F64>(m_stream.size()) / feedSeconds : 0.0, 0)
+        .field("passed", this->passed())
+        .end();
+  }
+
+  bool FuzzRig ::
+    passed() const
+  {
+    for (U32 i = 0; i < m_intact.size(); i++) {
+      if (m_delivered[i] != (m_intact[i] ? 1U : 0U)) {
+        return false;
+      }
+    }
+    return not m_outOfOrder && (m_unknown == 0) && (m_recoveries == m_damage.size());
+  }
+
+  // ----------------------------------------------------------------------
+  // Ports
+  // ----------------------------------------------------------------------
+
+  Fw::Buffer FuzzRig ::
+    allocateIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, U32 size)
+  {
+    FuzzRig& rig = *static_cast<FuzzRig*>(callComp);
+    FW_ASSERT(size <= sizeof(rig.m_packet), size);
+    return Fw::Buffer(rig.m_packet, size);
+  }
+
+  void FuzzRig ::
+    deallocateIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Buffer& buffer)
+  {
+    // Received chunks belong to the stream and packets to the rig's one buffer, so there is nothing to return
+  }
+
+  void FuzzRig ::
+    comIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::ComBuffer& data, U32 context)
+  {
+    FuzzRig& rig = *static_cast<FuzzRig*>(callComp);
+    FwPacketDescriptorType packetType = 0;
+    U32 sequence = 0;
+    data.resetDeser();
+    Fw::SerializeStatus status = data.deserialize(packetType);
+    status = (status == Fw::FW_SERIALIZE_OK) ? data.deserialize(sequence) : status;
+    if ((status != Fw::FW_SERIALIZE_OK) || (sequence >= rig.m_delivered.size())) {
+      rig.m_unknown++;
+      return;
+    }
+    if (rig.m_anyDelivered && (sequence <= rig.m_lastSequence)) {
+      rig.m_outOfOrder = true;
+    }
+    rig.m_delivered[sequence]++;
+    rig.m_lastSequence = sequence;
+    rig.m_anyDelivered = true;
+    if (rig.m_intact[sequence]) {
+      rig.recovered(sequence);
+    }
+  }
+
+  void FuzzRig ::
+    tlmIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwChanIdType id, Fw::Time& timeTag,
+          Fw::TlmBuffer& val)
+  {
+    FuzzRig& rig = *static_cast<FuzzRig*>(callComp);
+    U32 value = 0;
+    val.resetDeser();
+    const Fw::SerializeStatus status = val.deserialize(value);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    switch (id - rig.m_deframer.getIdBase()) {
+      case DeframerChannels::RESYNC_EVENTS:
+        rig.m_resyncEvents = value;
+        break;
+      case DeframerChannels::BYTES_DISCARDED:
+        rig.m_bytesDiscarded = value;
+        break;
+      case DeframerChannels::CHECKSUM_ERRORS:
+        rig.m_checksumErrors = value;
+        break;
+      default:
+        break;
+    }
+  }
+
+}
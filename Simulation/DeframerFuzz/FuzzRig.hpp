@@ -0,0 +1,143 @@
+// ======================================================================
+// \title  FuzzRig.hpp
+// \brief  Feeds the deframer a stream of frames with random damage and checks what comes out
+// ======================================================================
+
+#ifndef Simulation_FuzzRig_HPP
+#define Simulation_FuzzRig_HPP
+
+#include <Components/Framing/Deframer.hpp>
+#include <Components/Framing/FastFprimeProtocol.hpp>
+#include <config/DeframerCfg.hpp>
+#include <Fw/Buffer/BufferGetPortAc.hpp>
+#include <Fw/Buffer/BufferSendPortAc.hpp>
+#include <Fw/Com/ComPortAc.hpp>
+#include <Fw/Tlm/TlmPortAc.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace Simulation {
+
+  //! The stream fed to the deframer
+  struct FuzzOptions {
+    U32 seed; //!< Seed of the stream, so a failure can be replayed
+    U32 frames; //!< Command frames in the stream
+    F64 damage; //!< Chance that damage comes before a frame
+  };
+
+  //! Runs a Framing::Deframer on a stream of command frames, some of them damaged and some behind garbage, handed
+  //! over in chunks of random size as a UART delivers them
+  //!
+  //! Each frame carries its sequence number. Every intact frame must come out, once and in order, and no damaged one
+  //! may. For each damage the rig measures the recovery: the time from the call that takes its first byte to the one
+  //! that hands on the next intact frame, and the bytes fed in between.
+  class FuzzRig : public Fw::PassiveComponentBase {
+
+    public:
+
+      FuzzRig(
+          const FuzzOptions& options //!< The stream
+      );
+
+      //! Build the stream and feed it to the deframer
+      void run();
+
+      //! Write the results as one line of JSON
+      void report(FILE* out) const;
+
+      //! Whether every intact frame came out once and in order, and no damaged one did
+      bool passed() const;
+
+    private:
+
+      //! Kinds of damage
+      enum Damage {
+        DAMAGE_NOISE, //!< Random bytes before the frame
+        DAMAGE_FLIP, //!< A bit of the frame inverted
+        DAMAGE_TRUNCATE, //!< The frame cut short
+        DAMAGE_FAKE_HEADER, //!< A start word and a random size before the frame, as a frame cut after its header
+        DAMAGE_KINDS
+      };
+
+      //! Largest burst of noise
+      static const U32 MAX_NOISE = 1024;
+
+      //! Largest chunk handed to the deframer at once, BufferedUartDriverCfg::RX_CHUNK_SIZE
+      static const U32 MAX_CHUNK = 256;
+
+      //! Idle fill after the last frame, enough to settle a fake header the last intact frames sit inside
+      static const U32 TRAILER = Svc::DeframerCfg::RING_BUFFER_SIZE;
+
+      //! Damage in the stream
+      struct DamageSpan {
+        U32 offset; //!< Stream offset of the first damaged byte
+        U32 target; //!< Sequence number of the first intact frame after it
+        std::chrono::steady_clock::time_point start; //!< When the chunk holding the first damaged byte was fed
+        bool started; //!< Whether that chunk has been fed
+      };
+
+      //! Build a command frame carrying a sequence number and filler of random length
+      void buildFrame(U32 sequence, std::vector<U8>& frame);
+
+      //! Append damage of a random kind to the stream, ahead of the intact frame with the given sequence number
+      void appendDamage(U32& sequence);
+
+      //! Note the delivery of an intact frame, closing the recoveries it ends
+      void recovered(U32 sequence);
+
+      //! Buffers for deframed packets
+      static Fw::Buffer allocateIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, U32 size);
+
+      //! Returned buffers
+      static void deallocateIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Buffer& buffer);
+
+      //! Deframed commands
+      static void comIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::ComBuffer& data,
+                        U32 context);
+
+      //! The deframer's telemetry
+      static void tlmIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwChanIdType id,
+                        Fw::Time& timeTag, Fw::TlmBuffer& val);
+
+      FuzzOptions m_options; //!< The stream
+      std::mt19937 m_random; //!< Source of the stream and its chunking
+      std::vector<U8> m_stream; //!< Bytes fed to the deframer
+      std::vector<bool> m_intact; //!< Whether each frame went out undamaged
+      std::vector<U32> m_delivered; //!< Times each frame came out
+      std::vector<DamageSpan> m_damage; //!< Damage in stream order
+      U32 m_damageCounts[DAMAGE_KINDS]; //!< Damage of each kind in the stream
+      U64 m_damagedBytes; //!< Bytes of noise, fake headers and damaged frames in the stream
+      U32 m_lastSequence; //!< Sequence number of the last frame out
+      bool m_anyDelivered; //!< Whether a frame has come out yet
+      bool m_outOfOrder; //!< Whether a frame came out before one sent ahead of it
+      U32 m_unknown; //!< Packets out that the rig never framed
+
+      U32 m_fedTo; //!< Stream offset the deframer has been fed up to
+      U32 m_nextStart; //!< First damage whose first byte has not been fed
+      U32 m_nextRecovery; //!< First damage not yet recovered from
+      U32 m_recoveries; //!< Damage recovered from
+      F64 m_recoveryTotalUs; //!< Recovery times added up
+      F64 m_recoveryMaxUs; //!< Longest recovery in time
+      U64 m_recoveryTotalBytes; //!< Recovery bytes added up
+      U32 m_recoveryMaxBytes; //!< Longest recovery in bytes
+      F64 m_feedUs; //!< Time spent in the deframer
+
+      U32 m_resyncEvents; //!< Latest ResyncEvents
+      U32 m_bytesDiscarded; //!< Latest BytesDiscarded
+      U32 m_checksumErrors; //!< Latest ChecksumErrors
+
+      U8 m_packet[Svc::DeframerCfg::RING_BUFFER_SIZE]; //!< Buffer for deframed packets, as large as any frame the ring holds
+      Fw::InputBufferGetPort m_allocateIn; //!< Port behind the deframer's bufferAllocate
+      Fw::InputBufferSendPort m_deallocateIn; //!< Port behind the deframer's framedDeallocate and bufferDeallocate
+      Fw::InputComPort m_comIn; //!< Port behind the deframer's comOut
+      Fw::InputTlmPort m_tlmIn; //!< Port behind the deframer's tlmOut
+      Framing::FastFprimeDeframing m_protocol; //!< The protocol
+      Framing::Deframer m_deframer; //!< The deframer
+  };
+
+}
+
+#endif
@@ -0,0 +1,37 @@
+// ======================================================================
+// \title  Main.cpp
+// \brief  Feeds the deframer a stream of damaged frames and reports one line of JSON
+// ======================================================================
+
+#include <Simulation/DeframerFuzz/FuzzRig.hpp>
+#include <Simulation/Tool/Tool.hpp>
+
+/**
+ * \brief run the stream and exit with 1 if an intact frame was lost, repeated or reordered, or a damaged one came out
+ */
+int main(int argc, char* argv[])
+{
+    Simulation::FuzzOptions options = {
+        1,
+        10000,
+        0.2
+    };
+
+    Simulation::ToolOptions command;
+    command.addF64('c', "chance of damage before each frame", options.damage, 0.0, 1.0);
+    command.addU32('f', "intact frames in the stream", options.frames, 1);
+    command.addU32('s', "seed of the stream", options.seed);
+    if (not command.parse(argc, argv)) {
+        return command.exitStatus();
+    }
+
+    Simulation::ToolReport report;
+    if (not report.open(command.reportPath())) {
+        return 1;
+    }
+
+    Simulation::FuzzRig rig(options);
+    rig.run();
+    rig.report(report.file());
+    return report.finish(rig.passed());
+}
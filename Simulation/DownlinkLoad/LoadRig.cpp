@@ -0,0 +1,218 @@
+// ======================================================================
+// \title  LoadRig.cpp
+// \brief  Offers the downlink arbiter more traffic than the ground link carries and measures what each class gets
+// ======================================================================
+
+#include <Simulation/DownlinkLoad/LoadRig.hpp>
+#include <Simulation/Tool/Tool.hpp>
+#include <Fw/Types/Assert.hpp>
+
+#include <cmath>
+#include <cstring>
+
+namespace Simulation {
+
+  namespace {
+    //! Base id of the arbiter, the deployment's so its events read the same; parameters are looked up by getIdBase()
+    const U32 ARBITER_ID_BASE = 0x6200;
+
+    //! The arbiter's generated parameter ids, which its component base keeps protected
+    struct ArbiterIds : Components::DownlinkArbiterComponentBase {
+      enum : FwPrmIdType {
+        LINK_RATE = PARAMID_LINK_RATE,
+        SHARES = PARAMID_SHARES
+      };
+    };
+
+    //! Names of the classes, in DownlinkClass order
+    const char* const CLASS_NAMES[DownlinkClasses] = {"EVENTS", "TELEMETRY", "HUB"};
+  }
+
+  LoadRig ::
+    LoadRig(const LoadOptions& options) :
+      Fw::PassiveComponentBase("rig"),
+      m_options(options),
+      m_measuring(false),
+      m_arbiter("downlinkArbiter")
+  {
+    memset(m_offeredBytes, 0, sizeof(m_offeredBytes));
+    memset(m_sentBytes, 0, sizeof(m_sentBytes));
+    this->computeFairRates();
+
+    Fw::PassiveComponentBase::init(0);
+    m_arbiter.init(0);
+    m_arbiter.setIdBase(ARBITER_ID_BASE);
+
+    m_comIn.init();
+    m_comIn.addCallComp(this, comIn);
+    m_comIn.setPortNum(0);
+    m_prmGetIn.init();
+    m_prmGetIn.addCallComp(this, prmGetIn);
+    m_prmGetIn.setPortNum(0);
+
+    m_arbiter.set_comOut_OutputPort(0, &m_comIn);
+    m_arbiter.set_prmGetOut_OutputPort(0, &m_prmGetIn);
+    m_arbiter.loadParameters();
+  }
+
+  void LoadRig ::
+    run()
+  {
+    const U32 ticksPerSecond = Components::DownlinkArbiterCfg::TICKS_PER_SECOND;
+    // Offered bytes owed to each class, in bytes times the tick rate so a rate that does not divide is kept exactly
+    U64 owed[DownlinkClasses] = {};
+    const U32 ticks = (WARM_UP_SECONDS + m_options.seconds) * ticksPerSecond;
+    for (U32 tick = 0; tick < ticks; tick++) {
+      m_measuring = (tick >= WARM_UP_SECONDS * ticksPerSecond);
+      for (U32 cls = 0; cls < DownlinkClasses; cls++) {
+        const U32 framed = m_options.packetSize[cls] + Components::DownlinkArbiterCfg::FRAME_OVERHEAD_BYTES;
+        owed[cls] += m_options.offered[cls];
+        while (owed[cls] >= static_cast<U64>(framed) * ticksPerSecond) {
+          owed[cls] -= static_cast<U64>(framed) * ticksPerSecond;
+          Fw::ComBuffer packet;
+          for (U32 i = 0; i < m_options.packetSize[cls]; i++) {
+            const Fw::SerializeStatus status = packet.serialize(static_cast<U8>(i));
+            FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+          }
+          if (m_measuring) {
+            m_offeredBytes[cls] += framed;
+          }
+          m_arbiter.get_comIn_InputPort(cls)->invoke(packet, cls);
+        }
+      }
+      m_arbiter.get_schedIn_InputPort(0)->invoke(0);
+    }
+  }
+
+  void LoadRig ::
+    report(FILE* out) const
+  {
+    F64 sum = 0.0;
+    F64 sumSquares = 0.0;
+    U32 counted = 0;
+    U64 sent = 0;
+    JsonLine json(out);
+    json.field("link_rate", m_options.linkRate).field("seconds", m_options.seconds);
+    json.beginArray("classes");
+    for (U32 cls = 0; cls < DownlinkClasses; cls++) {
+      const F64 offeredRate = static_cast<F64>(m_offeredBytes[cls]) / m_options.seconds;
+      const F64 sentRate = static_cast<F64>(m_sentBytes[cls]) / m_options.seconds;
+      const F64 ratio = (m_fairRates[cls] > 0.0) ? (sentRate / m_fairRates[cls]) : 1.0;
+      if (m_fairRates[cls] > 0.0) {
+        sum += ratio;
+        sumSquares += ratio * ratio;
+        counted++;
+      }
+      sent += m_sentBytes[cls];
+      json.beginObject();
+      json.field("class", CLASS_NAMES[cls])
+          .field("share", m_options.shares[cls])
+          .field("packet_size", m_options.packetSize[cls])
+          .field("offered_Bps", offeredRate, 0)
+          .field("sent_Bps", sentRate, 0)
+          .field("fair_Bps", m_fairRates[cls], 0)
+          .field("sent_per_fair", ratio, 3);
+      json.endObject();
+    }
+    json.endArray();
+    // Jain's index of the sent-to-fair ratios: 1 when every class gets the same proportion of its fair rate
+    const F64 jain = (sumSquares > 0.0) ? (sum * sum / (counted * sumSquares)) : 1.0;
+    const F64 utilization =
+        (m_options.linkRate != 0) ? (static_cast<F64>(sent) / m_options.seconds / m_options.linkRate) : 0.0;
+    json.field("utilization", utilization, 3).field("jain_index", jain, 4).field("passed", this->passed());
+    json.end();
+  }
+
+  bool LoadRig ::
+    passed() const
+  {
+    for (U32 cls = 0; cls < DownlinkClasses; cls++) {
+      const F64 sentRate = static_cast<F64>(m_sentBytes[cls]) / m_options.seconds;
+      // A class of one packet a second is off by a packet's worth at the end of the run without being unfair
+      const F64 slack = static_cast<F64>(m_options.packetSize[cls] +
+                                         Components::DownlinkArbiterCfg::FRAME_OVERHEAD_BYTES) / m_options.seconds;
+      if (fabs(sentRate - m_fairRates[cls]) > m_options.tolerance * m_fairRates[cls] + slack) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void LoadRig ::
+    computeFairRates()
+  {
+    // Water filling: a class offering less than its part of what is left gets what it offers, and the rest is
+    // handed out again among the others, until every class left wants more than its part
+    bool settled[DownlinkClasses] = {};
+    F64 left = m_options.linkRate;
+    for (U32 cls = 0; cls < DownlinkClasses; cls++) {
+      m_fairRates[cls] = m_options.offered[cls];
+      settled[cls] = (m_options.linkRate == 0) || (m_options.offered[cls] == 0);
+      if (settled[cls]) {
+        left -= m_options.offered[cls];
+      }
+    }
+    for (bool changed = true; changed;) {
+      changed = false;
+      F64 weights = 0.0;
+      for (U32 cls = 0; cls < DownlinkClasses; cls++) {
+        // The arbiter takes a share of 0 as 1
+        weights += settled[cls] ? 0.0 : FW_MAX(m_options.shares[cls], static_cast<U32>(1));
+      }
+      if (weights == 0.0) {
+        break;
+      }
+      for (U32 cls = 0; cls < DownlinkClasses; cls++) {
+        const F64 part = left * FW_MAX(m_options.shares[cls], static_cast<U32>(1)) / weights;
+        if (not settled[cls] && (m_options.offered[cls] <= part)) {
+          settled[cls] = true;
+          left -= m_options.offered[cls];
+          changed = true;
+        }
+      }
+      if (not changed) {
+        for (U32 cls = 0; cls < DownlinkClasses; cls++) {
+          if (not settled[cls]) {
+            m_fairRates[cls] = left * FW_MAX(m_options.shares[cls], static_cast<U32>(1)) / weights;
+          }
+        }
+      }
+    }
+  }
+
+  void LoadRig ::
+    comIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::ComBuffer& data, U32 context)
+  {
+    LoadRig& rig = *static_cast<LoadRig*>(callComp);
+    FW_ASSERT(context < DownlinkClasses, context);
+    if (rig.m_measuring) {
+      rig.m_sentBytes[context] += data.getBuffLength() + Components::DownlinkArbiterCfg::FRAME_OVERHEAD_BYTES;
+    }
+  }
+
+  Fw::ParamValid LoadRig ::
+    prmGetIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwPrmIdType id, Fw::ParamBuffer& val)
+  {
+    const LoadRig& rig = *static_cast<LoadRig*>(callComp);
+    Fw::SerializeStatus status = Fw::FW_SERIALIZE_OK;
+    val.resetSer();
+    switch (id - rig.m_arbiter.getIdBase()) {
+      case ArbiterIds::LINK_RATE:
+        status = val.serialize(rig.m_options.linkRate);
+        break;
+      case ArbiterIds::SHARES: {
+        Components::DownlinkClassFigures shares;
+        for (U32 cls = 0; cls < DownlinkClasses; cls++) {
+          shares[cls] = rig.m_options.shares[cls];
+        }
+        status = val.serialize(shares);
+        break;
+      }
+      default:
+        return Fw::ParamValid::INVALID;
+    }
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    return Fw::ParamValid::VALID;
+  }
+
+}
@@ -0,0 +1,79 @@
+// ======================================================================
+// \title  LoadRig.hpp
+// \brief  Offers the downlink arbiter more traffic than the ground link carries and measures what each class gets
+// ======================================================================
+
+#ifndef Simulation_LoadRig_HPP
+#define Simulation_LoadRig_HPP
+
+#include <Components/DownlinkArbiter/DownlinkArbiter.hpp>
+#include <Fw/Com/ComPortAc.hpp>
+#include <Fw/Prm/PrmGetPortAc.hpp>
+
+#include <cstdio>
+
+namespace Simulation {
+
+  //! Traffic offered to the arbiter and how it is set up
+  struct LoadOptions {
+    U32 linkRate; //!< LINK_RATE in bytes per second
+    U32 shares[DownlinkClasses]; //!< SHARES in bytes per second
+    U32 offered[DownlinkClasses]; //!< Bytes per second offered in each class, framing included
+    U32 packetSize[DownlinkClasses]; //!< Bytes of each packet of a class, before framing
+    U32 seconds; //!< Seconds measured, after a second to fill the queues
+    F64 tolerance; //!< Largest difference from the fair rate a class may have, as a fraction of it
+  };
+
+  //! Runs a DownlinkArbiter as rate group 1 does, with every class offered a steady load, and compares the rate each
+  //! class gets with its weighted max-min fair rate
+  //!
+  //! Every tick each class offers the packets its load has accumulated, in arrival order, then schedIn is called.
+  //! Packets carry their class as their context, so what comes out of comOut is counted by class. The fair rates are
+  //! those of an ideal weighted fair link: classes offering less than their part are given what they offer, and the
+  //! rest is split among the others in proportion to their shares.
+  class LoadRig : public Fw::PassiveComponentBase {
+
+    public:
+
+      LoadRig(
+          const LoadOptions& options //!< The load
+      );
+
+      //! Run the load
+      void run();
+
+      //! Write the results as one line of JSON
+      void report(FILE* out) const;
+
+      //! Whether every class got its fair rate, within the tolerance
+      bool passed() const;
+
+    private:
+
+      //! Seconds run before measuring, for the queues to fill
+      static const U32 WARM_UP_SECONDS = 1;
+
+      //! Fill in the fair rate of every class
+      void computeFairRates();
+
+      //! Packets out of the arbiter, counted by the class in their context
+      static void comIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::ComBuffer& data, U32 context);
+
+      //! Arbiter parameters from the options
+      static Fw::ParamValid prmGetIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwPrmIdType id,
+                                     Fw::ParamBuffer& val);
+
+      LoadOptions m_options; //!< The load
+      bool m_measuring; //!< Whether the warm-up is over
+      U64 m_offeredBytes[DownlinkClasses]; //!< Bytes offered in each class while measuring, framing included
+      U64 m_sentBytes[DownlinkClasses]; //!< Bytes each class sent while measuring, framing included
+      F64 m_fairRates[DownlinkClasses]; //!< Fair rate of each class in bytes per second
+
+      Fw::InputComPort m_comIn; //!< Port behind the arbiter's comOut
+      Fw::InputPrmGetPort m_prmGetIn; //!< Port behind the arbiter's prmGetOut
+      Components::DownlinkArbiter m_arbiter; //!< The arbiter
+  };
+
+}
+
+#endif
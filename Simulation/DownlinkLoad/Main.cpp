@@ -0,0 +1,79 @@
+// ======================================================================
+// \title  Main.cpp
+// \brief  Overloads the downlink arbiter and reports what each class gets as one line of JSON
+// ======================================================================
+
+#include <Simulation/DownlinkLoad/LoadRig.hpp>
+#include <Simulation/Tool/Tool.hpp>
+
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+/**
+ * \brief read one figure per class from a comma-separated list
+ *
+ * @return false if the list does not have exactly one figure per class, each from min to max
+ */
+static bool parse_figures(const char* text, U32 figures[DownlinkClasses], U32 min, U32 max)
+{
+    const char* next = text;
+    for (U32 cls = 0; cls < DownlinkClasses; cls++) {
+        char* end = nullptr;
+        figures[cls] = static_cast<U32>(strtoul(next, &end, 0));
+        const char expected = (cls + 1 < DownlinkClasses) ? ',' : '\0';
+        if ((end == next) || (*end != expected) || (figures[cls] < min) || (figures[cls] > max)) {
+            return false;
+        }
+        next = end + 1;
+    }
+    return true;
+}
+
+/**
+ * \brief run the arbiter under the load and exit with 1 if a class was not given its fair rate
+ */
+int main(int argc, char* argv[])
+{
+    Simulation::LoadOptions options = {
+        11520,
+        {2304, 6912, 2304},
+        {20000, 8000, 1000},
+        {40, 100, 60},
+        60,
+        0.02
+    };
+
+    const U32 unlimited = std::numeric_limits<U32>::max();
+    const std::string figuresError = "expected " + std::to_string(DownlinkClasses) + " comma-separated figures";
+    const std::string sizesError = figuresError + " from 1 to " + std::to_string(FW_COM_BUFFER_MAX_SIZE);
+
+    Simulation::ToolOptions command;
+    command.addU32('d', "seconds measured", options.seconds, 1);
+    command.addU32('l', "LINK_RATE in bytes per second, 0 for no limit", options.linkRate);
+    command.add('p', "packet size of each class before framing, as events,telemetry,hub (default 40,100,60)",
+                sizesError.c_str(),
+                [&options](const char* text) {
+                    return parse_figures(text, options.packetSize, 1, FW_COM_BUFFER_MAX_SIZE);
+                });
+    command.add('r', "bytes per second offered in each class, framing included (default 20000,8000,1000)",
+                figuresError.c_str(),
+                [&options, unlimited](const char* text) { return parse_figures(text, options.offered, 0, unlimited); });
+    command.add('s', "SHARES in bytes per second (default 2304,6912,2304)", figuresError.c_str(),
+                [&options, unlimited](const char* text) { return parse_figures(text, options.shares, 0, unlimited); });
+    command.addF64('t', "largest difference from the fair rate allowed, as a fraction of it", options.tolerance, 0.0,
+                   1.0);
+    if (not command.parse(argc, argv)) {
+        return command.exitStatus();
+    }
+
+    Simulation::ToolReport report;
+    if (not report.open(command.reportPath())) {
+        return 1;
+    }
+
+    Simulation::LoadRig rig(options);
+    rig.run();
+    rig.report(report.file());
+    return report.finish(rig.passed());
+}
@@ -0,0 +1,80 @@
+// ======================================================================
+// \title  Main.cpp
+// \brief  Sends a file over a lossy simulated radio at each loss rate and reports one line of JSON per rate
+// ======================================================================
+
+#include <Simulation/FileTransferLink/TransferRig.hpp>
+#include <Simulation/Tool/Tool.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/**
+ * \brief parse a comma separated list of loss rates
+ *
+ * @return false if an entry is not a number from 0 up to but not including 1
+ */
+static bool parse_rates(const char* text, std::vector<F64>& rates)
+{
+    rates.clear();
+    while (*text != '\0') {
+        char* end = nullptr;
+        const F64 rate = strtod(text, &end);
+        if ((end == text) || (rate < 0.0) || (rate >= 1.0) || ((*end != ',') && (*end != '\0'))) {
+            return false;
+        }
+        rates.push_back(rate);
+        text = (*end == ',') ? (end + 1) : end;
+    }
+    return not rates.empty();
+}
+
+/**
+ * \brief send the file at every loss rate and exit with 1 if a transfer did not complete or arrived damaged
+ */
+int main(int argc, char* argv[])
+{
+    Simulation::TransferOptions options = {
+        32768,
+        250000,
+        100,
+        600,
+        1
+    };
+    std::vector<F64> rates = {0.0, 0.01, 0.02, 0.05, 0.1, 0.2, 0.3};
+
+    Simulation::ToolOptions command;
+    command.addU32('b', "bit rate of the radio", options.bitRate, 1);
+    command.addU32('f', "bytes of the file sent", options.fileBytes, 0,
+                   Components::HubFileTransferCfg::MAX_CHUNKS * Components::HubFileTransfer::CHUNK_SIZE);
+    command.add('l', "comma separated packet loss rates (default 0,0.01,0.02,0.05,0.1,0.2,0.3)",
+                "loss rates must be from 0 up to but not including 1",
+                [&rates](const char* text) { return parse_rates(text, rates); });
+    command.addU32('r', "milliseconds between run calls", options.runMs, 1);
+    command.addU32('s', "seed of the file and the losses", options.seed);
+    command.addU32('t', "simulated seconds a transfer may take", options.timeoutS);
+    if (not command.parse(argc, argv)) {
+        return command.exitStatus();
+    }
+
+    // Opened before the rigs move into their temporary directories, so a relative path is taken from here
+    Simulation::ToolReport report;
+    if (not report.open(command.reportPath())) {
+        return 1;
+    }
+
+    bool passed = true;
+    for (const F64 rate : rates) {
+        Simulation::TransferRig rig(options, rate);
+        if (not rig.open()) {
+            (void) fprintf(stderr, "cannot create the file to send\n");
+            passed = false;
+            break;
+        }
+        rig.run();
+        rig.report(report.file());
+        passed = passed && rig.passed();
+    }
+    return report.finish(passed);
+}
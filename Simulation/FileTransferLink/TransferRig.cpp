@@ -0,0 +1,421 @@
+// ======================================================================
+// \title  TransferRig.cpp
+// \brief  Sends a file between two hub file transfer instances over a lossy simulated radio
+// ======================================================================
+
+#include <Simulation/FileTransferLink/TransferRig.hpp>
+#include <Simulation/Tool/Tool.hpp>
+#include <Fw/Types/Assert.hpp>
+
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+namespace Simulation {
+
+  namespace {
+    //! The transfer's generated ids, which its component base keeps protected
+    struct TransferIds : Components::HubFileTransferComponentBase {
+      enum : FwOpcodeType {
+        SEND_FILE = OPCODE_SEND_FILE,
+        RESUME_SEND = OPCODE_RESUME_SEND
+      };
+      enum : FwEventIdType {
+        SEND_COMPLETED = EVENTID_SENDCOMPLETED,
+        SEND_SUSPENDED = EVENTID_SENDSUSPENDED
+      };
+      enum : FwChanIdType {
+        TX_PROGRESS = CHANNELID_TXPROGRESS,
+        TX_GOODPUT = CHANNELID_TXGOODPUT,
+        TX_RETRANSMITS = CHANNELID_TXRETRANSMITS,
+        RX_GOODPUT = CHANNELID_RXGOODPUT
+      };
+    };
+
+    //! The file sent, in the temporary directory
+    const char* const SOURCE_NAME = "source.bin";
+
+    //! The path the receiver writes, in the temporary directory
+    const char* const DEST_NAME = "received.bin";
+
+    //! Read a whole file
+    bool readFile(const char* path, std::vector<U8>& data) {
+      FILE* const file = fopen(path, "rb");
+      if (file == nullptr) {
+        return false;
+      }
+      U8 block[512];
+      size_t read = 0;
+      while ((read = fread(block, 1, sizeof(block), file)) > 0) {
+        data.insert(data.end(), block, block + read);
+      }
+      (void) fclose(file);
+      return true;
+    }
+  }
+
+  TransferRig ::
+    TransferRig(const TransferOptions& options, F64 lossRate) :
+      Fw::PassiveComponentBase("rig"),
+      m_options(options),
+      m_lossRate(lossRate),
+      m_random(options.seed),
+      m_opened(false),
+      m_nowUs(0),
+      m_airFreeUs(0),
+      m_packets(0),
+      m_lost(0),
+      m_airBytes(0),
+      m_airtimeUs(0),
+      m_incomingOut(false),
+      m_accepted(false),
+      m_refused(false),
+      m_completed(false),
+      m_suspended(false),
+      m_completedUs(0),
+      m_resumes(0),
+      m_txProgress(0),
+      m_txGoodput(0),
+      m_txRetransmits(0),
+      m_rxGoodput(0),
+      m_matches(false),
+      m_sender("sender"),
+      m_receiver("receiver")
+  {
+    m_nodes[SENDER] = &m_sender;
+    m_nodes[RECEIVER] = &m_receiver;
+
+    Fw::PassiveComponentBase::init(0);
+    m_cmdResponseIn.init();
+    m_cmdResponseIn.addCallComp(this, cmdResponseIn);
+    m_cmdResponseIn.setPortNum(0);
+    m_timeIn.init();
+    m_timeIn.addCallComp(this, timeIn);
+    m_timeIn.setPortNum(0);
+
+    for (U32 node = 0; node < NODES; node++) {
+      const NATIVE_INT_TYPE portNum = static_cast<NATIVE_INT_TYPE>(node);
+      m_outgoingOut[node] = false;
+      m_allocateIn[node].init();
+      m_allocateIn[node].addCallComp(this, allocateIn);
+      m_allocateIn[node].setPortNum(portNum);
+      m_sendIn[node].init();
+      m_sendIn[node].addCallComp(this, sendIn);
+      m_sendIn[node].setPortNum(portNum);
+      m_deallocateIn[node].init();
+      m_deallocateIn[node].addCallComp(this, deallocateIn);
+      m_deallocateIn[node].setPortNum(portNum);
+      m_linkLoadIn[node].init();
+      m_linkLoadIn[node].addCallComp(this, linkLoadIn);
+      m_linkLoadIn[node].setPortNum(portNum);
+      m_logIn[node].init();
+      m_logIn[node].addCallComp(this, logIn);
+      m_logIn[node].setPortNum(portNum);
+      m_tlmIn[node].init();
+      m_tlmIn[node].addCallComp(this, tlmIn);
+      m_tlmIn[node].setPortNum(portNum);
+
+      // As the deployment wires hubFileTransfer, with the rig standing in for the hub and the buffer manager
+      Components::HubFileTransfer& transfer = *m_nodes[node];
+      transfer.init(0);
+      transfer.set_allocate_OutputPort(0, &m_allocateIn[node]);
+      transfer.set_hubOut_OutputPort(0, &m_sendIn[node]);
+      transfer.set_deallocate_OutputPort(0, &m_deallocateIn[node]);
+      transfer.set_linkLoad_OutputPort(0, &m_linkLoadIn[node]);
+      transfer.set_logOut_OutputPort(0, &m_logIn[node]);
+      transfer.set_tlmOut_OutputPort(0, &m_tlmIn[node]);
+      transfer.set_timeCaller_OutputPort(0, &m_timeIn);
+      transfer.set_cmdResponseOut_OutputPort(0, &m_cmdResponseIn);
+    }
+  }
+
+  TransferRig ::
+    ~TransferRig()
+  {
+    if (m_opened) {
+      (void) ::unlink((m_directory + "/" + SOURCE_NAME).c_str());
+      (void) ::unlink((m_directory + "/" + DEST_NAME).c_str());
+      (void) ::chdir(m_home.c_str());
+      (void) ::rmdir(m_directory.c_str());
+    }
+  }
+
+  bool TransferRig ::
+    open()
+  {
+    char home[PATH_MAX];
+    if (::getcwd(home, sizeof(home)) == nullptr) {
+      return false;
+    }
+    m_home = home;
+    char directory[] = "/tmp/FileTransferLink.XXXXXX";
+    if (::mkdtemp(directory) == nullptr) {
+      return false;
+    }
+    m_directory = directory;
+    m_opened = true;
+    if (::chdir(directory) != 0) {
+      return false;
+    }
+
+    // Random contents, so a chunk written at the wrong offset shows in the comparison
+    std::vector<U8> data(m_options.fileBytes);
+    for (U32 i = 0; i < m_options.fileBytes; i++) {
+      data[i] = static_cast<U8>(m_random());
+    }
+    FILE* const file = fopen(SOURCE_NAME, "wb");
+    if (file == nullptr) {
+      return false;
+    }
+    const size_t written = fwrite(data.data(), 1, data.size(), file);
+    return (fclose(file) == 0) && (written == data.size());
+  }
+
+  void TransferRig ::
+    run()
+  {
+    Fw::CmdArgBuffer args;
+    Fw::SerializeStatus status = args.serialize(Fw::CmdStringArg(SOURCE_NAME));
+    status = (status == Fw::FW_SERIALIZE_OK) ? args.serialize(Fw::CmdStringArg(DEST_NAME)) : status;
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    this->command(TransferIds::SEND_FILE, 0, args);
+
+    const U64 runUs = static_cast<U64>(m_options.runMs) * 1000;
+    const U64 timeoutUs = static_cast<U64>(m_options.timeoutS) * 1000000;
+    FW_ASSERT(runUs > 0);
+    for (U64 runStartUs = 0; m_accepted && (runStartUs <= timeoutUs); runStartUs += runUs) {
+      this->deliverUntil(runStartUs);
+      if (m_completed) {
+        break;
+      }
+      m_nowUs = runStartUs;
+      if (m_suspended) {
+        m_suspended = false;
+        m_resumes++;
+        Fw::CmdArgBuffer none;
+        this->command(TransferIds::RESUME_SEND, m_resumes, none);
+      }
+      for (U32 node = 0; node < NODES; node++) {
+        m_nodes[node]->get_run_InputPort(0)->invoke(0);
+      }
+    }
+    m_matches = m_completed && this->compareFiles();
+  }
+
+  void TransferRig ::
+    deliverUntil(U64 nowUs)
+  {
+    while (not m_air.empty() && (m_air.front().endUs <= nowUs)) {
+      const Packet packet = m_air.front();
+      m_air.pop_front();
+      m_nowUs = packet.endUs;
+      if (packet.lost) {
+        continue;
+      }
+      FW_ASSERT(not m_incomingOut);
+      FW_ASSERT(packet.data.size() <= sizeof(m_incoming), static_cast<FwAssertArgType>(packet.data.size()));
+      memcpy(m_incoming, packet.data.data(), packet.data.size());
+      m_incomingOut = true;
+      Fw::Buffer buffer(m_incoming, static_cast<U32>(packet.data.size()));
+      m_nodes[packet.to]->get_hubIn_InputPort(0)->invoke(buffer);
+      // Each message is handled and returned before the next arrives
+      FW_ASSERT(not m_incomingOut);
+    }
+  }
+
+  void TransferRig ::
+    command(FwOpcodeType opCode, U32 cmdSeq, Fw::CmdArgBuffer& args)
+  {
+    args.resetDeser();
+    m_sender.get_cmdIn_InputPort(0)->invoke(m_sender.getIdBase() + opCode, cmdSeq, args);
+  }
+
+  bool TransferRig ::
+    compareFiles() const
+  {
+    std::vector<U8> sent;
+    std::vector<U8> received;
+    return readFile(SOURCE_NAME, sent) && readFile(DEST_NAME, received) &&
+           (sent.size() == m_options.fileBytes) && (sent == received);
+  }
+
+  void TransferRig ::
+    report(FILE* out) const
+  {
+    const F64 seconds = m_completed ? (m_completedUs / 1.0e6) : 0.0;
+    const F64 goodput = (seconds > 0.0) ? (m_options.fileBytes / seconds) : 0.0;
+    JsonLine(out)
+        .field("loss_rate", m_lossRate, 3)
+        .field("file_bytes", m_options.fileBytes)
+        .field("bit_rate", m_options.bitRate)
+        .field("run_ms", m_options.runMs)
+        .field("completed", m_completed)
+        .field("seconds", seconds, 2)
+        .field("goodput", goodput, 1)
+        .field("efficiency", goodput * 8.0 / m_options.bitRate, 3)
+        .field("tx_goodput", m_txGoodput)
+        .field("rx_goodput", m_rxGoodput)
+        .field("tx_progress", static_cast<U32>(m_txProgress))
+        .field("tx_retransmits", m_txRetransmits)
+        .field("packets", m_packets)
+        .field("lost", m_lost)
+        .field("air_bytes", m_airBytes)
+        .field("air_busy", (m_nowUs > 0) ? (static_cast<F64>(m_airtimeUs) / m_nowUs) : 0.0, 3)
+        .field("resumes", m_resumes)
+        .field("matches", m_matches)
+        .field("passed", this->passed())
+        .end();
+  }
+
+  bool TransferRig ::
+    passed() const
+  {
+    return m_accepted && not m_refused && m_completed && m_matches && not m_outgoingOut[SENDER] &&
+           not m_outgoingOut[RECEIVER] && not m_incomingOut;
+  }
+
+  // ----------------------------------------------------------------------
+  // Ports
+  // ----------------------------------------------------------------------
+
+  Fw::Buffer TransferRig ::
+    allocateIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, U32 size)
+  {
+    TransferRig& rig = *static_cast<TransferRig*>(callComp);
+    // An instance sends or returns each message before it builds the next
+    FW_ASSERT(not rig.m_outgoingOut[portNum], portNum);
+    FW_ASSERT(size <= sizeof(rig.m_outgoing[portNum]), size);
+    rig.m_outgoingOut[portNum] = true;
+    return Fw::Buffer(rig.m_outgoing[portNum], size);
+  }
+
+  void TransferRig ::
+    sendIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Buffer& buffer)
+  {
+    TransferRig& rig = *static_cast<TransferRig*>(callComp);
+    FW_ASSERT(rig.m_outgoingOut[portNum] && (buffer.getData() == rig.m_outgoing[portNum]), portNum);
+    const U32 size = buffer.getSize();
+    // Every message must fit one radio packet once the hub and the framer have wrapped it
+    const U32 framed = size + Components::HubFileTransfer::HUB_OVERHEAD + Components::HubFileTransfer::FRAME_OVERHEAD;
+    FW_ASSERT(framed <= Components::HubFileTransferCfg::RADIO_MTU, framed);
+    const U64 airBytes = Components::HubFileTransferCfg::RADIO_OVERHEAD_BYTES + framed;
+    const U64 airtimeUs = (airBytes * 8 * 1000000 + rig.m_options.bitRate - 1) / rig.m_options.bitRate;
+
+    Packet packet;
+    packet.to = (portNum == SENDER) ? RECEIVER : SENDER;
+    packet.startUs = FW_MAX(rig.m_nowUs, rig.m_airFreeUs);
+    packet.endUs = packet.startUs + airtimeUs;
+    packet.lost = std::uniform_real_distribution<F64>(0.0, 1.0)(rig.m_random) < rig.m_lossRate;
+    packet.data.assign(buffer.getData(), buffer.getData() + size);
+    rig.m_air.push_back(packet);
+    rig.m_airFreeUs = packet.endUs;
+    rig.m_packets++;
+    rig.m_lost += packet.lost ? 1 : 0;
+    rig.m_airBytes += airBytes;
+    rig.m_airtimeUs += airtimeUs;
+    // The hub returns the buffer once the message is framed
+    rig.m_outgoingOut[portNum] = false;
+  }
+
+  Radio::LinkLoad TransferRig ::
+    linkLoadIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum)
+  {
+    const TransferRig& rig = *static_cast<TransferRig*>(callComp);
+    U32 queued = 0;
+    for (const Packet& packet : rig.m_air) {
+      if ((packet.to != static_cast<U32>(portNum)) && (packet.startUs > rig.m_nowUs)) {
+        queued++;
+      }
+    }
+    return Radio::LinkLoad(true, queued, rig.m_options.bitRate, 0, 0);
+  }
+
+  void TransferRig ::
+    deallocateIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Buffer& buffer)
+  {
+    TransferRig& rig = *static_cast<TransferRig*>(callComp);
+    if (buffer.getData() == rig.m_incoming) {
+      FW_ASSERT(rig.m_incomingOut);
+      rig.m_incomingOut = false;
+    } else {
+      FW_ASSERT(rig.m_outgoingOut[portNum] && (buffer.getData() == rig.m_outgoing[portNum]), portNum);
+      rig.m_outgoingOut[portNum] = false;
+    }
+  }
+
+  void TransferRig ::
+    cmdResponseIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwOpcodeType opCode, U32 cmdSeq,
+                  const Fw::CmdResponse& response)
+  {
+    TransferRig& rig = *static_cast<TransferRig*>(callComp);
+    if (response.e != Fw::CmdResponse::OK) {
+      rig.m_refused = true;
+    } else if ((opCode - rig.m_sender.getIdBase()) == TransferIds::SEND_FILE) {
+      rig.m_accepted = true;
+    }
+  }
+
+  void TransferRig ::
+    logIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwEventIdType id, Fw::Time& timeTag,
+          const Fw::LogSeverity& severity, Fw::LogBuffer& args)
+  {
+    TransferRig& rig = *static_cast<TransferRig*>(callComp);
+    if (portNum != SENDER) {
+      return;
+    }
+    switch (id - rig.m_sender.getIdBase()) {
+      case TransferIds::SEND_COMPLETED:
+        rig.m_completed = true;
+        rig.m_completedUs = rig.m_nowUs;
+        break;
+      case TransferIds::SEND_SUSPENDED:
+        rig.m_suspended = true;
+        break;
+      default:
+        break;
+    }
+  }
+
+  void TransferRig ::
+    tlmIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwChanIdType id, Fw::Time& timeTag,
+          Fw::TlmBuffer& val)
+  {
+    TransferRig& rig = *static_cast<TransferRig*>(callComp);
+    Fw::SerializeStatus status = Fw::FW_SERIALIZE_OK;
+    val.resetDeser();
+    switch (id - rig.m_nodes[portNum]->getIdBase()) {
+      case TransferIds::TX_PROGRESS:
+        if (portNum == SENDER) {
+          status = val.deserialize(rig.m_txProgress);
+        }
+        break;
+      case TransferIds::TX_GOODPUT:
+        if (portNum == SENDER) {
+          status = val.deserialize(rig.m_txGoodput);
+        }
+        break;
+      case TransferIds::TX_RETRANSMITS:
+        if (portNum == SENDER) {
+          status = val.deserialize(rig.m_txRetransmits);
+        }
+        break;
+      case TransferIds::RX_GOODPUT:
+        if (portNum == RECEIVER) {
+          status = val.deserialize(rig.m_rxGoodput);
+        }
+        break;
+      default:
+        break;
+    }
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+  }
+
+  void TransferRig ::
+    timeIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Time& time)
+  {
+    const TransferRig& rig = *static_cast<TransferRig*>(callComp);
+    time.set(TB_NONE, static_cast<U32>(rig.m_nowUs / 1000000), static_cast<U32>(rig.m_nowUs % 1000000));
+  }
+
+}
@@ -0,0 +1,173 @@
+// ======================================================================
+// \title  TransferRig.hpp
+// \brief  Sends a file between two hub file transfer instances over a lossy simulated radio
+// ======================================================================
+
+#ifndef Simulation_TransferRig_HPP
+#define Simulation_TransferRig_HPP
+
+#include <Components/HubFileTransfer/HubFileTransfer.hpp>
+#include <Components/Radio/RFM69/LinkLoadGetPortAc.hpp>
+#include <Fw/Buffer/BufferGetPortAc.hpp>
+#include <Fw/Buffer/BufferSendPortAc.hpp>
+#include <Fw/Cmd/CmdArgBuffer.hpp>
+#include <Fw/Cmd/CmdResponsePortAc.hpp>
+#include <Fw/Log/LogPortAc.hpp>
+#include <Fw/Time/TimePortAc.hpp>
+#include <Fw/Tlm/TlmPortAc.hpp>
+
+#include <cstdio>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Simulation {
+
+  //! The file sent and the link it crosses
+  struct TransferOptions {
+    U32 fileBytes; //!< Size of the file sent
+    U32 bitRate; //!< Bit rate of the radio, as the modem profile sets it
+    U32 runMs; //!< Milliseconds between run calls, as rate group 1 makes them
+    U32 timeoutS; //!< Simulated seconds after which a transfer that has not completed counts as failed
+    U32 seed; //!< Seed of the file contents and of the losses
+  };
+
+  //! Runs the hub file transfer of two satellites, one sending a file with SEND_FILE and the other receiving it, over
+  //! a radio that loses each packet at random with a given probability
+  //!
+  //! Everything runs on a simulated clock. Each run period both instances are run once, as rate group 1 runs them.
+  //! Every message is one radio packet on a half-duplex channel shared by both directions: it goes on the air when
+  //! the channel is free, for its airtime at the bit rate with its hub header, frame and radio framing, and reaches
+  //! the peer's hubIn when its airtime ends unless it is lost. A lost packet still occupies the air. Each instance's
+  //! linkLoad sees its messages not yet on the air as the radio's queue. When the sender
+  //! suspends the transfer the rig sends RESUME_SEND on the next run, as an operator would. The instances read the
+  //! simulated clock, so their goodput telemetry is in simulated time. The files live in a temporary directory, which
+  //! is the working directory while the rig runs, since the receiver only writes below it.
+  class TransferRig : public Fw::PassiveComponentBase {
+
+    public:
+
+      TransferRig(
+          const TransferOptions& options, //!< The file and the link
+          F64 lossRate //!< Probability that a packet is lost
+      );
+
+      ~TransferRig();
+
+      //! Create the temporary directory, move into it and write the file to send
+      //!
+      //! \return false if the directory or the file could not be created
+      bool open();
+
+      //! Send the file and run until it completes or the timeout passes
+      void run();
+
+      //! Write the results as one line of JSON
+      void report(FILE* out) const;
+
+      //! Whether the transfer completed in time and the received file matches the one sent
+      bool passed() const;
+
+    private:
+
+      //! The sender, node 0, and the receiver, node 1
+      enum {
+        SENDER = 0,
+        RECEIVER = 1,
+        NODES = 2
+      };
+
+      //! A message on the air
+      struct Packet {
+        U32 to; //!< Node the message is for
+        U64 startUs; //!< Start of its airtime
+        U64 endUs; //!< End of its airtime
+        bool lost; //!< Whether the peer misses it
+        std::vector<U8> data; //!< The message
+      };
+
+      //! Deliver every message whose airtime has ended by a time, advancing the clock to each
+      void deliverUntil(U64 nowUs);
+
+      //! Send a command to the sender instance
+      void command(FwOpcodeType opCode, U32 cmdSeq, Fw::CmdArgBuffer& args);
+
+      //! Whether the received file has the contents of the one sent
+      bool compareFiles() const;
+
+      //! Buffers for outgoing messages, one per instance
+      static Fw::Buffer allocateIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, U32 size);
+
+      //! Outgoing messages, put on the air and their buffer returned as the hub does
+      static void sendIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Buffer& buffer);
+
+      //! Load on each instance's radio: its messages waiting for the channel, at the bit rate of the run
+      static Radio::LinkLoad linkLoadIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum);
+
+      //! Unsent and delivered buffers returned by the instances
+      static void deallocateIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Buffer& buffer);
+
+      //! Responses to the rig's commands
+      static void cmdResponseIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwOpcodeType opCode,
+                                U32 cmdSeq, const Fw::CmdResponse& response);
+
+      //! Events of the instances, of which completion and suspension of the outgoing transfer are acted on
+      static void logIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwEventIdType id,
+                        Fw::Time& timeTag, const Fw::LogSeverity& severity, Fw::LogBuffer& args);
+
+      //! Telemetry of the instances
+      static void tlmIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwChanIdType id,
+                        Fw::Time& timeTag, Fw::TlmBuffer& val);
+
+      //! The simulated clock
+      static void timeIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Time& time);
+
+      TransferOptions m_options; //!< The file and the link
+      F64 m_lossRate; //!< Probability that a packet is lost
+      std::mt19937 m_random; //!< Source of the file contents and the losses
+      std::string m_home; //!< Working directory before open
+      std::string m_directory; //!< The temporary directory
+      bool m_opened; //!< Whether open created the directory
+
+      U64 m_nowUs; //!< The simulated clock
+      U64 m_airFreeUs; //!< Time the channel is next free
+      std::deque<Packet> m_air; //!< Messages on the air, in the order their airtime ends
+      U64 m_packets; //!< Messages sent
+      U64 m_lost; //!< Messages lost
+      U64 m_airBytes; //!< Bytes on the air, radio framing included
+      U64 m_airtimeUs; //!< Time the channel was in use
+
+      U8 m_outgoing[NODES][Components::HubFileTransferCfg::RADIO_MTU]; //!< Each instance's buffer for a message
+      bool m_outgoingOut[NODES]; //!< Whether each instance holds its buffer
+      U8 m_incoming[Components::HubFileTransferCfg::RADIO_MTU]; //!< Buffer a delivered message is handed over in
+      bool m_incomingOut; //!< Whether an instance holds the delivered message
+
+      bool m_accepted; //!< Whether SEND_FILE was answered with OK
+      bool m_refused; //!< Whether a command was answered with anything but OK
+      bool m_completed; //!< Whether the sender reported the transfer completed
+      bool m_suspended; //!< Whether the sender suspended the transfer and has not been resumed
+      U64 m_completedUs; //!< Time the sender reported the transfer completed
+      U32 m_resumes; //!< RESUME_SEND commands sent
+      U8 m_txProgress; //!< Latest TxProgress
+      U32 m_txGoodput; //!< Latest TxGoodput
+      U32 m_txRetransmits; //!< Latest TxRetransmits
+      U32 m_rxGoodput; //!< Latest RxGoodput
+      bool m_matches; //!< Whether the received file matches the one sent
+
+      Fw::InputBufferGetPort m_allocateIn[NODES]; //!< Ports behind each instance's allocate
+      Fw::InputBufferSendPort m_sendIn[NODES]; //!< Ports behind each instance's hubOut
+      Fw::InputBufferSendPort m_deallocateIn[NODES]; //!< Ports behind each instance's deallocate
+      Radio::InputLinkLoadGetPort m_linkLoadIn[NODES]; //!< Ports behind each instance's linkLoad
+      Fw::InputCmdResponsePort m_cmdResponseIn; //!< Port behind each instance's cmdResponseOut
+      Fw::InputLogPort m_logIn[NODES]; //!< Ports behind each instance's logOut
+      Fw::InputTlmPort m_tlmIn[NODES]; //!< Ports behind each instance's tlmOut
+      Fw::InputTimePort m_timeIn; //!< Port behind each instance's timeCaller
+      Components::HubFileTransfer m_sender; //!< The sending instance
+      Components::HubFileTransfer m_receiver; //!< The receiving instance
+      Components::HubFileTransfer* m_nodes[NODES]; //!< Both instances, by node
+  };
+
+}
+
+#endif
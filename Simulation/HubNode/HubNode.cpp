@@ -0,0 +1,433 @@
+// ======================================================================
+// \title  HubNode.cpp
+// \brief  The hub side of BroncoDeployment as a standalone host fixture
+// ======================================================================
+
+#include <Simulation/HubNode/HubNode.hpp>
+#include <Fw/Cmd/CmdArgBuffer.hpp>
+#include <Fw/Types/Assert.hpp>
+
+#include <cstring>
+
+namespace Simulation {
+
+  namespace {
+    //! Base ids of the node's components. They need only be apart: every id the node looks up is taken from the
+    //! component's getIdBase(). Those the deployment has are at its base ids, so a node's events read the same, and
+    //! the bond follows the last radio's.
+    const U32 RADIO_ID_BASE = 0x5300;
+    const U32 HANDLER_ID_BASE = 0x6000;
+    const U32 TIME_ID_BASE = 0x4F00;
+    const U32 BOND_ID_BASE = 0x5700;
+
+    //! The message handler's generated ids, which its component base keeps protected
+    struct HandlerIds : Components::BroncoOreMessageHandlerComponentBase {
+      enum : FwOpcodeType {
+        MESSAGE_SEND = OPCODE_MESSAGE_SEND,
+        PROBE_START = OPCODE_PROBE_START
+      };
+      enum : FwChanIdType {
+        PROBES_SENT = CHANNELID_PROBESSENT,
+        PROBE_ECHOES = CHANNELID_PROBEECHOES,
+        PROBE_RTT_MIN = CHANNELID_PROBERTTMIN,
+        PROBE_RTT_MEAN = CHANNELID_PROBERTTMEAN,
+        PROBE_RTT_P95 = CHANNELID_PROBERTTP95,
+        PROBE_RTT_MAX = CHANNELID_PROBERTTMAX,
+        PROBE_JITTER = CHANNELID_PROBEJITTER,
+        PROBE_FORWARD_LATENCY = CHANNELID_PROBEFORWARDLATENCY,
+        PROBE_RETURN_LATENCY = CHANNELID_PROBERETURNLATENCY
+      };
+      enum : FwPrmIdType {
+        NODE_ADDRESS_PARAM = PARAMID_NODE_ADDRESS
+      };
+    };
+
+    //! The radio's generated parameter ids, which its component base keeps protected
+    struct RadioIds : Radio::RFM69ComponentBase {
+      enum : FwPrmIdType {
+        FREQUENCY = PARAMID_FREQUENCY,
+        TX_POWER = PARAMID_TX_POWER,
+        MODEM_PROFILE = PARAMID_MODEM_PROFILE,
+        NODE_ADDRESS = PARAMID_NODE_ADDRESS,
+        CSMA_ENABLED = PARAMID_CSMA_ENABLED,
+        CSMA_THRESHOLD = PARAMID_CSMA_THRESHOLD,
+        ENCRYPTION_KEY = PARAMID_ENCRYPTION_KEY,
+        PEER_ADDRESS = PARAMID_PEER_ADDRESS,
+        ADDRESS_FILTER = PARAMID_ADDRESS_FILTER,
+        TIME_SOURCE = PARAMID_TIME_SOURCE
+      };
+    };
+
+    //! Names of the radio instances, as they would be in a topology with several
+    const char* const RADIO_NAMES[] = {"hubComDriver", "hubComDriver2", "hubComDriver3", "hubComDriver4"};
+  }
+
+  HubNode ::
+    HubNode(U32 id, const RadioSettings& settings, SimRadioMedium& medium, MessageSink& sink, ComPath comPath) :
+      Fw::PassiveComponentBase("node"),
+      m_id(id),
+      m_settings(settings),
+      m_sink(sink),
+      m_bufferGets(0),
+      m_bufferBytes(0),
+      m_nowUs(0),
+      m_clockSkewPpm(0.0),
+      m_clockOffsetUs(0),
+      m_probeResults(),
+      m_handler("broncoOreMessageHandler"),
+      m_hub("hub"),
+      m_framer("hubFramer"),
+      m_comFramer("hubComFramer"),
+      m_deframer("hubDeframer"),
+      m_bond("hubBond"),
+      m_time("disciplinedTime"),
+      m_bufferManager("bufferManager")
+  {
+    const NATIVE_INT_TYPE instance = static_cast<NATIVE_INT_TYPE>(id);
+    Fw::PassiveComponentBase::init(instance);
+    m_handler.init(instance);
+    m_hub.init(instance);
+    m_framer.init(instance);
+    m_comFramer.init(instance);
+    m_deframer.init(instance);
+    FW_ASSERT((settings.links >= 1) && (settings.links <= FW_NUM_ARRAY_ELEMENTS(RADIO_NAMES)), settings.links);
+    for (U32 link = 0; link < settings.links; link++) {
+      m_radios.emplace_back(new Radio::RFM69(RADIO_NAMES[link]));
+      m_radios[link]->init(instance);
+      m_radios[link]->setIdBase(RADIO_ID_BASE + link * RADIO_ID_STRIDE);
+    }
+    m_bond.init(instance);
+    m_time.init(instance);
+    m_bufferManager.init(instance);
+    m_handler.setIdBase(HANDLER_ID_BASE);
+    m_bond.setIdBase(BOND_ID_BASE);
+    m_time.setIdBase(TIME_ID_BASE);
+
+    m_bufferGetIn.init();
+    m_bufferGetIn.addCallComp(this, bufferGetIn);
+    m_bufferGetIn.setPortNum(0);
+    m_messageIn.init();
+    m_messageIn.addCallComp(this, messageIn);
+    m_messageIn.setPortNum(0);
+    m_bufferDropIn.init();
+    m_bufferDropIn.addCallComp(this, bufferDropIn);
+    m_bufferDropIn.setPortNum(0);
+    m_prmGetIn.init();
+    m_prmGetIn.addCallComp(this, prmGetIn);
+    m_prmGetIn.setPortNum(0);
+    m_timeIn.init();
+    m_timeIn.addCallComp(this, timeIn);
+    m_timeIn.setPortNum(0);
+    m_dpGetIn.init();
+    m_dpGetIn.addCallComp(this, dpGetIn);
+    m_dpGetIn.setPortNum(0);
+    m_cmdResponseIn.init();
+    m_cmdResponseIn.addCallComp(this, cmdResponseIn);
+    m_cmdResponseIn.setPortNum(0);
+    m_tlmIn.init();
+    m_tlmIn.addCallComp(this, tlmIn);
+    m_tlmIn.setPortNum(0);
+
+    // Message handler, as in the BroncoDeployment connections
+    if (comPath == ComPath::FRAMED) {
+      m_handler.set_send_message_OutputPort(0, m_comFramer.get_comIn_InputPort(0));
+      m_deframer.set_hubComOut_OutputPort(0, &m_messageIn);
+    } else {
+      m_handler.set_send_message_OutputPort(0, m_hub.get_portIn_InputPort(0));
+    }
+    // The hub passes on port traffic the deframer does not route itself, on either path
+    m_hub.set_portOut_OutputPort(0, &m_messageIn);
+    m_handler.set_productGetOut_OutputPort(0, &m_dpGetIn);
+    m_handler.set_cmdResponseOut_OutputPort(0, &m_cmdResponseIn);
+    m_handler.set_tlmOut_OutputPort(0, &m_tlmIn);
+    m_handler.set_prmGetOut_OutputPort(0, &m_prmGetIn);
+    m_handler.set_timeCaller_OutputPort(0, m_time.get_timeGetPort_InputPort(0));
+
+    // Hub, as in the HubConnections connections
+    m_hub.set_dataOut_OutputPort(0, m_framer.get_bufferIn_InputPort(0));
+    m_hub.set_dataOutAllocate_OutputPort(0, &m_bufferGetIn);
+    m_framer.set_bufferDeallocate_OutputPort(0, m_bufferManager.get_bufferSendIn_InputPort(0));
+    m_framer.set_framedAllocate_OutputPort(0, &m_bufferGetIn);
+    m_comFramer.set_framedAllocate_OutputPort(0, &m_bufferGetIn);
+    if (settings.links == 1) {
+      m_framer.set_framedOut_OutputPort(0, m_radios[0]->get_comDataIn_InputPort(0));
+      m_comFramer.set_framedOut_OutputPort(0, m_radios[0]->get_comDataIn_InputPort(0));
+      m_radios[0]->set_comDataOut_OutputPort(0, m_deframer.get_framedIn_InputPort(0));
+    } else {
+      m_framer.set_framedOut_OutputPort(0, m_bond.get_comDataIn_InputPort(0));
+      m_comFramer.set_framedOut_OutputPort(0, m_bond.get_comDataIn_InputPort(0));
+      m_bond.set_comDataOut_OutputPort(0, m_deframer.get_framedIn_InputPort(0));
+      m_bond.set_allocate_OutputPort(0, &m_bufferGetIn);
+      m_bond.set_deallocate_OutputPort(0, m_bufferManager.get_bufferSendIn_InputPort(0));
+      m_bond.set_timeCaller_OutputPort(0, m_time.get_timeGetPort_InputPort(0));
+      for (U32 link = 0; link < settings.links; link++) {
+        m_bond.set_linkDataOut_OutputPort(link, m_radios[link]->get_comDataIn_InputPort(0));
+        m_bond.set_linkLoad_OutputPort(link, m_radios[link]->get_linkLoadGet_InputPort(0));
+        m_radios[link]->set_comDataOut_OutputPort(0, m_bond.get_linkDataIn_InputPort(link));
+      }
+    }
+    for (U32 link = 0; link < settings.links; link++) {
+      m_radios[link]->set_deallocate_OutputPort(0, m_bufferManager.get_bufferSendIn_InputPort(0));
+      m_radios[link]->set_allocate_OutputPort(0, &m_bufferGetIn);
+      m_radios[link]->set_prmGetOut_OutputPort(0, &m_prmGetIn);
+      m_radios[link]->set_timeCaller_OutputPort(0, m_time.get_timeGetPort_InputPort(0));
+    }
+    m_deframer.set_framedDeallocate_OutputPort(0, m_bufferManager.get_bufferSendIn_InputPort(0));
+    m_deframer.set_bufferAllocate_OutputPort(0, &m_bufferGetIn);
+    m_deframer.set_bufferDeallocate_OutputPort(0, m_bufferManager.get_bufferSendIn_InputPort(0));
+    m_deframer.set_bufferOut_OutputPort(0, m_hub.get_dataIn_InputPort(0));
+    m_hub.set_dataInDeallocate_OutputPort(0, m_bufferManager.get_bufferSendIn_InputPort(0));
+    m_hub.set_buffersOut_OutputPort(0, &m_bufferDropIn);
+
+    // Time, as in the time connections and the DisciplinedTime connections
+    m_radios[0]->set_clockExchange_OutputPort(0, m_time.get_exchangeIn_InputPort(0));
+    m_time.set_localTime_OutputPort(0, &m_timeIn);
+
+    Svc::BufferManagerComponentImpl::BufferBins bins;
+    memset(&bins, 0, sizeof(bins));
+    bins.bins[0].bufferSize = BUFFER_SIZE;
+    bins.bins[0].numBuffers = BUFFER_COUNT;
+    m_bufferManager.setup(id, 0, m_allocator, bins);
+    m_framer.setup(m_framing);
+    m_comFramer.setup(m_comFraming);
+    m_deframer.setup(m_deframing);
+
+    m_handler.loadParameters();
+    for (U32 link = 0; link < settings.links; link++) {
+      m_radios[link]->configureMedium(medium);
+      m_radios[link]->configureClock(*this);
+      m_radios[link]->loadParameters();
+    }
+  }
+
+  HubNode ::
+    ~HubNode()
+  {
+    m_bufferManager.cleanup();
+  }
+
+  void HubNode ::
+    setClockError(F64 skewPpm, U64 offsetUs)
+  {
+    m_clockSkewPpm = skewPpm;
+    m_clockOffsetUs = offsetUs;
+  }
+
+  U64 HubNode ::
+    localUs(U64 trueUs) const
+  {
+    const F64 skewUs = static_cast<F64>(trueUs) * m_clockSkewPpm / 1.0e6;
+    return static_cast<U64>(static_cast<I64>(trueUs + m_clockOffsetUs) + static_cast<I64>(skewUs));
+  }
+
+  U64 HubNode ::
+    disciplinedTimeUs()
+  {
+    Fw::Time time;
+    m_time.get_timeGetPort_InputPort(0)->invoke(time);
+    return static_cast<U64>(time.getSeconds()) * 1000000 + time.getUSeconds();
+  }
+
+  void HubNode ::
+    run()
+  {
+    for (const std::unique_ptr<Radio::RFM69>& radio : m_radios) {
+      radio->get_run_InputPort(0)->invoke(0);
+    }
+    if (m_radios.size() > 1) {
+      m_bond.get_run_InputPort(0)->invoke(0);
+    }
+    m_handler.get_run_InputPort(0)->invoke(0);
+  }
+
+  bool HubNode ::
+    radioUp()
+  {
+    return m_radios[0]->get_linkLoadGet_InputPort(0)->invoke().getup();
+  }
+
+  void HubNode ::
+    sendMessage(U32 seq, const char* text)
+  {
+    const Fw::CmdStringArg message(text);
+    Fw::CmdArgBuffer args;
+    const Fw::SerializeStatus status = args.serialize(message);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    m_handler.get_cmdIn_InputPort(0)->invoke(m_handler.getIdBase() + HandlerIds::MESSAGE_SEND, seq, args);
+  }
+
+  void HubNode ::
+    startProbes(U32 seq, U32 target, U16 count, U16 size, U16 interval)
+  {
+    Fw::CmdArgBuffer args;
+    Fw::SerializeStatus status = args.serialize(address(target));
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = args.serialize(count);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = args.serialize(size);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    status = args.serialize(interval);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    m_handler.get_cmdIn_InputPort(0)->invoke(m_handler.getIdBase() + HandlerIds::PROBE_START, seq, args);
+  }
+
+  ProbeResults HubNode ::
+    probeResults() const
+  {
+    return m_probeResults;
+  }
+
+  void HubNode ::
+    messageIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::ComBuffer& data, U32 context)
+  {
+    HubNode& node = *static_cast<HubNode*>(callComp);
+    // The sink sees the message text, after the sender and sequence number; probes carry no text
+    const bool probe =
+        (data.getBuffLength() > 0) && (data.getBuffAddr()[0] == Components::BroncoOreMessageHandler::PROBE_MARKER);
+    if (not probe) {
+      const U32 header = FW_MIN(data.getBuffLength(), Components::BroncoOreMessageHandler::MESSAGE_HEADER_SIZE);
+      node.m_sink.messageReceived(node.m_id, data.getBuffAddr() + header, data.getBuffLength() - header);
+    }
+    node.m_handler.get_recv_message_InputPort(0)->invoke(data, context);
+  }
+
+  Fw::Buffer HubNode ::
+    bufferGetIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, U32 size)
+  {
+    HubNode& node = *static_cast<HubNode*>(callComp);
+    node.m_bufferGets++;
+    node.m_bufferBytes += size;
+    return node.m_bufferManager.get_bufferGetCallee_InputPort(0)->invoke(size);
+  }
+
+  void HubNode ::
+    bufferDropIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Buffer& fwBuffer)
+  {
+    HubNode& node = *static_cast<HubNode*>(callComp);
+    node.m_bufferManager.get_bufferSendIn_InputPort(0)->invoke(fwBuffer);
+  }
+
+  Fw::ParamValid HubNode ::
+    prmGetIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwPrmIdType id, Fw::ParamBuffer& val)
+  {
+    const HubNode& node = *static_cast<HubNode*>(callComp);
+    Fw::SerializeStatus status = Fw::FW_SERIALIZE_OK;
+    val.resetSer();
+    if (id == node.m_handler.getIdBase() + HandlerIds::NODE_ADDRESS_PARAM) {
+      status = val.serialize(address(node.m_id));
+      FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+      return Fw::ParamValid::VALID;
+    }
+    const FwPrmIdType radioBase = node.m_radios[0]->getIdBase();
+    const FwPrmIdType offset = id - radioBase;
+    const U32 link = offset / RADIO_ID_STRIDE;
+    if ((id < radioBase) || (link >= node.m_radios.size())) {
+      return Fw::ParamValid::INVALID;
+    }
+    switch (offset % RADIO_ID_STRIDE) {
+      case RadioIds::FREQUENCY:
+        status = val.serialize(node.m_settings.frequencyMhz + static_cast<F32>(link) * node.m_settings.linkSpacingMhz);
+        break;
+      case RadioIds::TX_POWER:
+        status = val.serialize(node.m_settings.txPowerDbm);
+        break;
+      case RadioIds::MODEM_PROFILE:
+        status = val.serialize(node.m_settings.modem);
+        break;
+      case RadioIds::NODE_ADDRESS:
+        status = val.serialize(address(node.m_id));
+        break;
+      case RadioIds::CSMA_ENABLED:
+        status = val.serialize(node.m_settings.csmaEnabled);
+        break;
+      case RadioIds::CSMA_THRESHOLD:
+        status = val.serialize(node.m_settings.csmaThresholdDbm);
+        break;
+      case RadioIds::ENCRYPTION_KEY:
+        status = val.serialize(node.m_settings.encryptionKey);
+        break;
+      case RadioIds::PEER_ADDRESS:
+        status = val.serialize(node.m_settings.unicast ? address(partner(node.m_id))
+                                                       : static_cast<U8>(RH_BROADCAST_ADDRESS));
+        break;
+      case RadioIds::ADDRESS_FILTER:
+        status = val.serialize(node.m_settings.addressFilter);
+        break;
+      case RadioIds::TIME_SOURCE:
+        status = val.serialize((node.m_settings.timeSync && (link == 0)) ? address(0) : static_cast<U8>(0));
+        break;
+      default:
+        return Fw::ParamValid::INVALID;
+    }
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    return Fw::ParamValid::VALID;
+  }
+
+  void HubNode ::
+    tlmIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwChanIdType id, Fw::Time& timeTag,
+          Fw::TlmBuffer& val)
+  {
+    HubNode& node = *static_cast<HubNode*>(callComp);
+    ProbeResults& results = node.m_probeResults;
+    // Every channel of the message handler is 32 bits
+    U32 value = 0;
+    val.resetDeser();
+    const Fw::SerializeStatus status = val.deserialize(value);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    switch (id - node.m_handler.getIdBase()) {
+      case HandlerIds::PROBES_SENT:
+        results.sent = value;
+        break;
+      case HandlerIds::PROBE_ECHOES:
+        results.echoes = value;
+        break;
+      case HandlerIds::PROBE_RTT_MIN:
+        results.minUs = value;
+        break;
+      case HandlerIds::PROBE_RTT_MEAN:
+        results.meanUs = value;
+        break;
+      case HandlerIds::PROBE_RTT_P95:
+        results.p95Us = value;
+        break;
+      case HandlerIds::PROBE_RTT_MAX:
+        results.maxUs = value;
+        break;
+      case HandlerIds::PROBE_JITTER:
+        results.jitterUs = value;
+        break;
+      case HandlerIds::PROBE_FORWARD_LATENCY:
+        results.forwardUs = static_cast<I32>(value);
+        break;
+      case HandlerIds::PROBE_RETURN_LATENCY:
+        results.returnUs = static_cast<I32>(value);
+        break;
+      default:
+        // The inbox and message log channels
+        break;
+    }
+  }
+
+  void HubNode ::
+    timeIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Time& time)
+  {
+    const HubNode& node = *static_cast<HubNode*>(callComp);
+    const U64 localUs = node.localUs(node.m_nowUs);
+    time.set(TB_NONE, static_cast<U32>(localUs / 1000000), static_cast<U32>(localUs % 1000000));
+  }
+
+  Fw::Success HubNode ::
+    dpGetIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwDpIdType id, FwSizeType dataSize,
+            Fw::Buffer& buffer)
+  {
+    return Fw::Success::FAILURE;
+  }
+
+  void HubNode ::
+    cmdResponseIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwOpcodeType opCode, U32 cmdSeq,
+                  const Fw::CmdResponse& response)
+  {
+    // A message is sent whenever MESSAGE_SEND is given one, and a refused PROBE_START shows in the probe results
+  }
+
+}
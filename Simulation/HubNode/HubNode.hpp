@@ -0,0 +1,235 @@
+// ======================================================================
+// \title  HubNode.hpp
+// \brief  The hub side of BroncoDeployment as a standalone host fixture
+// ======================================================================
+
+#ifndef Simulation_HubNode_HPP
+#define Simulation_HubNode_HPP
+
+#include <Components/BroncoOreMessageHandler/BroncoOreMessageHandler.hpp>
+#include <Components/DisciplinedTime/DisciplinedTime.hpp>
+#include <Components/Framing/Deframer.hpp>
+#include <Components/Framing/FastFprimeProtocol.hpp>
+#include <Components/Framing/HubComFramer.hpp>
+#include <Components/Radio/ChannelBond/ChannelBond.hpp>
+#include <Components/Radio/RFM69/RFM69.hpp>
+#include <Fw/Buffer/BufferGetPortAc.hpp>
+#include <Fw/Buffer/BufferSendPortAc.hpp>
+#include <Fw/Cmd/CmdResponsePortAc.hpp>
+#include <Fw/Com/ComPortAc.hpp>
+#include <Fw/Dp/DpGetPortAc.hpp>
+#include <Fw/Prm/PrmGetPortAc.hpp>
+#include <Fw/Tlm/TlmPortAc.hpp>
+#include <Fw/Time/TimePortAc.hpp>
+#include <Fw/Types/MallocAllocator.hpp>
+#include <Svc/BufferManager/BufferManagerComponentImpl.hpp>
+#include <Svc/Framer/Framer.hpp>
+#include <Svc/GenericHub/GenericHubComponentImpl.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace Simulation {
+
+  //! Receiver of the messages that reach a node's message handler
+  class MessageSink {
+    public:
+      virtual ~MessageSink() {}
+
+      //! A message reached a node's message handler
+      virtual void messageReceived(U32 node, const U8* data, U32 size) = 0;
+  };
+
+  //! How messages travel between the message handler and the radio
+  enum class ComPath {
+    FRAMED, //!< Framed straight into radio buffers by a HubComFramer and decoded by the hub deframer, as deployed
+    HUB //!< Through GenericHub and Svc::Framer, the way they went before HubComFramer
+  };
+
+  //! Settings of a node's radio, served to it as its parameters
+  struct RadioSettings {
+    F32 frequencyMhz; //!< FREQUENCY
+    I8 txPowerDbm; //!< TX_POWER
+    Radio::ModemProfile modem; //!< MODEM_PROFILE
+    bool csmaEnabled; //!< CSMA_ENABLED
+    I16 csmaThresholdDbm; //!< CSMA_THRESHOLD
+    Radio::AesKey encryptionKey; //!< ENCRYPTION_KEY
+    bool unicast; //!< PEER_ADDRESS is the node's partner if set, otherwise broadcast
+    Radio::AddressFilter addressFilter; //!< ADDRESS_FILTER
+    bool timeSync; //!< TIME_SOURCE is node 0 if set, otherwise time synchronization is off
+    U32 links; //!< Radios per node, bonded when more than one
+    F32 linkSpacingMhz; //!< FREQUENCY of each radio after the first is this far above the one before
+  };
+
+  //! Results of a node's latency probes, from the message handler's telemetry
+  struct ProbeResults {
+    U32 sent; //!< ProbesSent
+    U32 echoes; //!< ProbeEchoes
+    U32 minUs; //!< ProbeRttMin
+    U32 meanUs; //!< ProbeRttMean
+    U32 p95Us; //!< ProbeRttP95
+    U32 maxUs; //!< ProbeRttMax
+    U32 jitterUs; //!< ProbeJitter
+    I32 forwardUs; //!< ProbeForwardLatency
+    I32 returnUs; //!< ProbeReturnLatency
+  };
+
+  //! One satellite: the hub side of BroncoDeployment, from the message handler down to the radio
+  //!
+  //! The components and connections are those of the HubConnections and BroncoOreMessageHandler groups of the
+  //! deployment topology. Parameters, data products and command responses are served by the node itself: the radio
+  //! gets its parameters from the settings, the message handler its node address, data product containers are never
+  //! available, and command responses are dropped.
+  //! Buffer requests pass through the node on their way to the buffer manager and are counted. The node's local clock
+  //! is the simulated time the caller last set, off by the node's clock offset and skew; the radio reads it through a
+  //! DisciplinedTime, as the deployment does, which steers it toward node 0 when time synchronization is on. Node n
+  //! has radio address n + 1. Nodes are paired, 0 with 1, 2 with 3 and so on, and in unicast each sends to its partner.
+  //! With more than one link the node has that many radios, each on its own frequency, behind a ChannelBond between
+  //! the hub framers and deframer; radio 0 keeps time. The deployment's radioCoreLink and radioBufferManager are left
+  //! out: the radio is wired to the framers and deframer directly and run by the caller, as the link does on one core.
+  //! Hub port traffic goes to the message handler on either path, and hub buffers, which carry file transfers in the
+  //! deployment, are dropped. Latency probes and their echoes reach the message handler but not the sink.
+  class HubNode : public Fw::PassiveComponentBase, public SimRadioClock {
+
+    public:
+
+      HubNode(
+          U32 id, //!< Node number, used as the instance number of its components
+          const RadioSettings& settings, //!< Radio parameters
+          SimRadioMedium& medium, //!< Medium the radio transmits on
+          MessageSink& sink, //!< Receiver of delivered messages
+          ComPath comPath = ComPath::FRAMED //!< How messages travel to and from the radio
+      );
+
+      ~HubNode();
+
+      //! Set the time the node's components see
+      void setTime(
+          U64 nowUs //!< Time in microseconds
+      ) { m_nowUs = nowUs; }
+
+      //! Set how far the node's local clock is off simulated time
+      void setClockError(
+          F64 skewPpm, //!< Rate error in parts per million
+          U64 offsetUs //!< Reading at simulated time 0, in microseconds
+      );
+
+      //! Reading of the node's local clock at a simulated time
+      U64 localUs(U64 trueUs) const override;
+
+      //! Time the node's components see now, in microseconds
+      U64 disciplinedTimeUs();
+
+      //! Run the radio and the message handler as rate group 1 does, bringing the radio up or polling it for a packet
+      void run();
+
+      //! Whether radio 0 is up
+      bool radioUp();
+
+      //! Send a message to the other satellites with the MESSAGE_SEND command
+      void sendMessage(
+          U32 seq, //!< Command sequence number
+          const char* text //!< Message text
+      );
+
+      //! Send latency probes to another node with the PROBE_START command
+      void startProbes(
+          U32 seq, //!< Command sequence number
+          U32 target, //!< Node number of the node to echo them
+          U16 count, //!< Probes to send
+          U16 size, //!< Bytes of each probe
+          U16 interval //!< Runs between probes
+      );
+
+      //! Results of the node's latency probes so far
+      ProbeResults probeResults() const;
+
+      //! Buffers requested from the buffer manager
+      U64 bufferGets() const { return m_bufferGets; }
+
+      //! Bytes in the buffers requested from the buffer manager
+      U64 bufferBytes() const { return m_bufferBytes; }
+
+      //! Node number of a node's partner in unicast
+      static U32 partner(U32 id) { return id ^ 1; }
+
+    private:
+
+      //! Spacing of the base ids of the radios of a bond
+      static const FwPrmIdType RADIO_ID_STRIDE = 0x100;
+
+      //! Radio address of a node: 0 is never a sender and 0xff is broadcast
+      static U8 address(U32 id) { return static_cast<U8>(id % (RH_BROADCAST_ADDRESS - 1) + 1); }
+
+      //! Bin of the node's buffer manager, sized for one radio packet's worth of hub traffic
+      enum {
+        BUFFER_SIZE = 256,
+        BUFFER_COUNT = 64
+      };
+
+      //! Messages coming out of the hub, on their way to the message handler
+      static void messageIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::ComBuffer& data, U32 context);
+
+      //! Buffer requests, counted and passed to the buffer manager
+      static Fw::Buffer bufferGetIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, U32 size);
+
+      //! Hub buffers, returned to the buffer manager
+      static void bufferDropIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Buffer& fwBuffer);
+
+      //! Radio and message handler parameters from the settings
+      static Fw::ParamValid prmGetIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwPrmIdType id,
+                                     Fw::ParamBuffer& val);
+
+      //! Message handler telemetry, of which the last value of each channel is kept
+      static void tlmIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwChanIdType id, Fw::Time& timeTag,
+                        Fw::TlmBuffer& val);
+
+      //! The local clock, at the time set by the caller
+      static void timeIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Time& time);
+
+      //! Data product containers, of which there are none
+      static Fw::Success dpGetIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwDpIdType id,
+                                 FwSizeType dataSize, Fw::Buffer& buffer);
+
+      //! Command responses, which are dropped
+      static void cmdResponseIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwOpcodeType opCode,
+                                U32 cmdSeq, const Fw::CmdResponse& response);
+
+      U32 m_id; //!< Node number
+      RadioSettings m_settings; //!< Radio parameters
+      MessageSink& m_sink; //!< Receiver of delivered messages
+      U64 m_bufferGets; //!< Buffers requested from the buffer manager
+      U64 m_bufferBytes; //!< Bytes in those buffers
+      U64 m_nowUs; //!< Simulated time
+      F64 m_clockSkewPpm; //!< Rate error of the local clock
+      U64 m_clockOffsetUs; //!< Local clock at simulated time 0
+      ProbeResults m_probeResults; //!< Last value of each of the message handler's probe channels
+
+      Fw::MallocAllocator m_allocator; //!< Memory of the buffer manager
+      Framing::FastFprimeFraming m_framing; //!< Hub framing protocol
+      Framing::FastFprimeFraming m_comFraming; //!< Hub Com framing protocol
+      Framing::FastFprimeDeframing m_deframing; //!< Hub deframing protocol
+
+      Components::BroncoOreMessageHandler m_handler; //!< Message handler
+      Svc::GenericHubComponentImpl m_hub; //!< Hub
+      Svc::Framer m_framer; //!< Hub framer
+      Framing::HubComFramer m_comFramer; //!< Hub Com framer
+      Framing::Deframer m_deframer; //!< Hub deframer
+      std::vector<std::unique_ptr<Radio::RFM69>> m_radios; //!< Hub radios
+      Radio::ChannelBond m_bond; //!< Stripes the hub link across the radios when there is more than one
+      Components::DisciplinedTime m_time; //!< Time served to the radio
+      Svc::BufferManagerComponentImpl m_bufferManager; //!< Buffers for all of the above
+
+      Fw::InputBufferGetPort m_bufferGetIn; //!< Port in front of the buffer manager's bufferGetCallee
+      Fw::InputComPort m_messageIn; //!< Port behind hub.portOut[0], and hubDeframer.hubComOut[0] on the framed path
+      Fw::InputBufferSendPort m_bufferDropIn; //!< Port behind hub.buffersOut[0]
+      Fw::InputPrmGetPort m_prmGetIn; //!< Port behind every radio's and the message handler's prmGetOut
+      Fw::InputTimePort m_timeIn; //!< Port behind the disciplined time's localTime
+      Fw::InputDpGetPort m_dpGetIn; //!< Port behind the message handler's productGetOut
+      Fw::InputCmdResponsePort m_cmdResponseIn; //!< Port behind the message handler's cmdResponseOut
+      Fw::InputTlmPort m_tlmIn; //!< Port behind the message handler's tlmOut
+  };
+
+}
+
+#endif
@@ -0,0 +1,179 @@
+// ======================================================================
+// \title  CaptureFile.cpp
+// \brief  Reads the packets of a hub radio capture from pcap files and Capture data product files
+// ======================================================================
+
+#include <Simulation/Replay/CaptureFile.hpp>
+#include <Fw/Buffer/Buffer.hpp>
+#include <Fw/Dp/DpContainer.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace Simulation {
+
+  namespace {
+    //! pcap magic number for nanosecond timestamps
+    const U32 PCAP_MAGIC_NANOSECONDS = 0xA1B23C4D;
+
+    //! Local ids of the Capture container and its records, from RFM69.fpp
+    const FwDpIdType CONTAINER_CAPTURE = 0;
+    const FwDpIdType RECORD_PCAP_HEADER = 0;
+    const FwDpIdType RECORD_PCAP_PACKET = 1;
+
+    //! Big-endian field of a data product record
+    U64 recordField(const U8* data, U32 size) {
+      U64 value = 0;
+      for (U32 i = 0; i < size; i++) {
+        value = (value << 8) | data[i];
+      }
+      return value;
+    }
+  }
+
+  bool CaptureFile ::
+    read(const char* path, std::vector<Radio::CapturedPacket>& packets)
+  {
+    std::ifstream file(path, std::ios::binary);
+    if (not file) {
+      (void) fprintf(stderr, "%s: cannot open\n", path);
+      return false;
+    }
+    std::vector<U8> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const U32 size = static_cast<U32>(data.size());
+    if (readPcap(data.data(), size, packets) || readContainer(data.data(), size, packets)) {
+      return true;
+    }
+    (void) fprintf(stderr, "%s: not a pcap file or Capture data product of a hub radio\n", path);
+    return false;
+  }
+
+  bool CaptureFile ::
+    readHeader(const U8* data, U32 size, Format& format)
+  {
+    if (size < Radio::PacketCapture::PCAP_HEADER_SIZE) {
+      return false;
+    }
+    bool known = false;
+    for (bool big : {true, false}) {
+      const U32 magic = field(data, big);
+      if ((magic == Radio::PacketCapture::PCAP_MAGIC) || (magic == PCAP_MAGIC_NANOSECONDS)) {
+        format.bigEndian = big;
+        format.nanoseconds = (magic == PCAP_MAGIC_NANOSECONDS);
+        known = true;
+      }
+    }
+    return known && (field(&data[20], format.bigEndian) == Radio::PacketCapture::PCAP_LINK_TYPE);
+  }
+
+  U32 CaptureFile ::
+    readRecord(const U8* data, U32 size, const Format& format, Radio::CapturedPacket& packet)
+  {
+    const U32 recordHeader = Radio::PacketCapture::PCAP_RECORD_HEADER_SIZE;
+    if (size < recordHeader) {
+      return 0;
+    }
+    const U32 captured = field(&data[8], format.bigEndian);
+    const U32 frameHeader = Radio::PacketCapture::PCAP_PSEUDO_HEADER_SIZE + Radio::CapturedPacket::HEADER_SIZE;
+    if ((captured > size - recordHeader) || (captured < frameHeader) ||
+        (captured - frameHeader > Radio::CapturedPacket::MAX_PAYLOAD)) {
+      return 0;
+    }
+    const U64 fraction = field(&data[4], format.bigEndian);
+    packet.timeUs = static_cast<U64>(field(&data[0], format.bigEndian)) * 1000000 +
+                    (format.nanoseconds ? fraction / 1000 : fraction);
+    const U8* const frame = &data[recordHeader];
+    packet.sent = (frame[0] != 0);
+    packet.rssi = static_cast<I8>(frame[1]);
+    memcpy(packet.header, &frame[Radio::PacketCapture::PCAP_PSEUDO_HEADER_SIZE], Radio::CapturedPacket::HEADER_SIZE);
+    packet.size = static_cast<U8>(captured - frameHeader);
+    memcpy(packet.payload, &frame[frameHeader], packet.size);
+    return recordHeader + captured;
+  }
+
+  bool CaptureFile ::
+    readPcap(const U8* data, U32 size, std::vector<Radio::CapturedPacket>& packets)
+  {
+    Format format;
+    if (not readHeader(data, size, format)) {
+      return false;
+    }
+    U32 offset = Radio::PacketCapture::PCAP_HEADER_SIZE;
+    while (offset < size) {
+      Radio::CapturedPacket packet;
+      const U32 used = readRecord(&data[offset], size - offset, format, packet);
+      if (used == 0) {
+        // A file cut short, as a dump interrupted while being written out would be, keeps what came before
+        (void) fprintf(stderr, "pcap record at byte %u is cut short or not a packet; the rest is skipped\n", offset);
+        break;
+      }
+      packets.push_back(packet);
+      offset += used;
+    }
+    return true;
+  }
+
+  bool CaptureFile ::
+    readContainer(U8* data, U32 size, std::vector<Radio::CapturedPacket>& packets)
+  {
+    if (size < Fw::DpContainer::DATA_OFFSET) {
+      return false;
+    }
+    Fw::Buffer buffer(data, size);
+    Fw::DpContainer container;
+    container.setBuffer(buffer);
+    if ((container.deserializeHeader() != Fw::FW_SERIALIZE_OK) ||
+        (container.getDataSize() > size - Fw::DpContainer::DATA_OFFSET)) {
+      return false;
+    }
+    const U8* const records = &data[Fw::DpContainer::DATA_OFFSET];
+    const U32 recordsSize = static_cast<U32>(container.getDataSize());
+    const FwDpIdType base = container.getId() - CONTAINER_CAPTURE;
+
+    // The size of an array record is as wide as the board's FwSizeType, which need not be the host's; the header
+    // record, of known size, tells which it is
+    const U32 idSize = sizeof(FwDpIdType);
+    U32 sizeSize = 0;
+    for (U32 width : {4u, 8u}) {
+      if ((recordsSize >= idSize + width) && (recordField(records, idSize) == base + RECORD_PCAP_HEADER) &&
+          (recordField(&records[idSize], width) == Radio::PacketCapture::PCAP_HEADER_SIZE)) {
+        sizeSize = width;
+      }
+    }
+    Format format;
+    if ((sizeSize == 0) || (recordsSize < idSize + sizeSize + Radio::PacketCapture::PCAP_HEADER_SIZE) ||
+        not readHeader(&records[idSize + sizeSize], Radio::PacketCapture::PCAP_HEADER_SIZE, format)) {
+      return false;
+    }
+
+    U32 offset = idSize + sizeSize + Radio::PacketCapture::PCAP_HEADER_SIZE;
+    while (offset + idSize + sizeSize <= recordsSize) {
+      const U64 id = recordField(&records[offset], idSize);
+      const U64 recordSize = recordField(&records[offset + idSize], sizeSize);
+      offset += idSize + sizeSize;
+      Radio::CapturedPacket packet;
+      if ((id != base + RECORD_PCAP_PACKET) || (recordSize > recordsSize - offset) ||
+          (readRecord(&records[offset], static_cast<U32>(recordSize), format, packet) != recordSize)) {
+        (void) fprintf(stderr, "container record at byte %u is not a pcap packet; the rest is skipped\n", offset);
+        break;
+      }
+      packets.push_back(packet);
+      offset += static_cast<U32>(recordSize);
+    }
+    return true;
+  }
+
+  U32 CaptureFile ::
+    field(const U8* data, bool bigEndian)
+  {
+    if (bigEndian) {
+      return (static_cast<U32>(data[0]) << 24) | (static_cast<U32>(data[1]) << 16) |
+             (static_cast<U32>(data[2]) << 8) | data[3];
+    }
+    return (static_cast<U32>(data[3]) << 24) | (static_cast<U32>(data[2]) << 16) |
+           (static_cast<U32>(data[1]) << 8) | data[0];
+  }
+
+}
@@ -0,0 +1,67 @@
+// ======================================================================
+// \title  CaptureFile.hpp
+// \brief  Reads the packets of a hub radio capture from pcap files and Capture data product files
+// ======================================================================
+
+#ifndef Simulation_CaptureFile_HPP
+#define Simulation_CaptureFile_HPP
+
+#include <Components/Radio/RFM69/PacketCapture.hpp>
+
+#include <vector>
+
+namespace Simulation {
+
+  //! Reads captures as RFM69's CAPTURE_DUMP sends them
+  //!
+  //! A file is either a pcap file, of link type LINKTYPE_USER0 in either byte order and with microsecond or
+  //! nanosecond timestamps, or a data product file as DpWriter writes a Capture container: a PcapHeader record, then a
+  //! PcapPacket record per packet. Packets are appended in the order they are in the file, so the containers of one
+  //! dump are read in the order they were sent.
+  class CaptureFile {
+
+    public:
+
+      //! Append the packets of a file
+      //!
+      //! \return false, with a message on stderr, if the file cannot be read or is neither format
+      static bool read(
+          const char* path, //!< The file
+          std::vector<Radio::CapturedPacket>& packets //!< Packets, appended to
+      );
+
+    private:
+
+      //! Byte order and timestamp resolution of a pcap file, from its magic number
+      struct Format {
+        bool bigEndian; //!< Whether fields are big-endian
+        bool nanoseconds; //!< Whether timestamps are in nanoseconds rather than microseconds
+      };
+
+      //! Read a pcap file header
+      //!
+      //! \return false if it is not the header of a capture
+      static bool readHeader(const U8* data, U32 size, Format& format);
+
+      //! Read one pcap record
+      //!
+      //! \return bytes the record takes, or 0 if it is cut short or its frame is not a packet
+      static U32 readRecord(const U8* data, U32 size, const Format& format, Radio::CapturedPacket& packet);
+
+      //! Append the packets of a pcap file
+      //!
+      //! \return false if it is not a capture
+      static bool readPcap(const U8* data, U32 size, std::vector<Radio::CapturedPacket>& packets);
+
+      //! Append the packets of a Capture container
+      //!
+      //! \return false if it is not a capture
+      static bool readContainer(U8* data, U32 size, std::vector<Radio::CapturedPacket>& packets);
+
+      //! Field of a pcap file in its byte order
+      static U32 field(const U8* data, bool bigEndian);
+  };
+
+}
+
+#endif
@@ -0,0 +1,103 @@
+// ======================================================================
+// \title  Main.cpp
+// \brief  Plays hub radio captures back through the hub stack and reports one line of JSON
+// ======================================================================
+
+#include <Simulation/Replay/CaptureFile.hpp>
+#include <Simulation/Replay/Replayer.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+
+/**
+ * \brief print command line help message
+ *
+ * @param app: name of application
+ */
+static void print_usage(const char* app)
+{
+    (void) printf("Usage: ./%s [options] capture...\n"
+                  "-a\taddress of the replaying node, turning the software address filter on\n"
+                  "-o\tfile the report is written to instead of stdout\n"
+                  "-s\tspeed as a multiple of the original pace, 0 (the default) for as fast as possible\n"
+                  "-t\tplay the packets the capturing node sent instead of those it received\n",
+                  app);
+}
+
+/**
+ * \brief play the captures, one after another, into one node
+ *
+ * Each capture is a pcap file or a Capture data product file; the containers of a dump are given in the order they
+ * were sent.
+ */
+int main(int argc, char* argv[])
+{
+    const char* reportPath = nullptr;
+    Simulation::ReplayOptions options;
+    options.speed = 0.0;
+    options.address = 0;
+    options.sent = false;
+
+    int option = 0;
+    while ((option = getopt(argc, argv, "a:ho:s:t")) != -1) {
+        switch (option) {
+            case 'a': {
+                const unsigned long address = strtoul(optarg, nullptr, 0);
+                if ((address == 0) || (address >= RH_BROADCAST_ADDRESS)) {
+                    (void) fprintf(stderr, "%s: address must be 1 to %u\n", optarg, RH_BROADCAST_ADDRESS - 1);
+                    return 1;
+                }
+                options.address = static_cast<U8>(address);
+                break;
+            }
+            case 'o':
+                reportPath = optarg;
+                break;
+            case 's':
+                options.speed = strtod(optarg, nullptr);
+                if (options.speed < 0.0) {
+                    (void) fprintf(stderr, "%s: speed must not be negative\n", optarg);
+                    return 1;
+                }
+                break;
+            case 't':
+                options.sent = true;
+                break;
+            case 'h':
+            case '?':
+            default:
+                print_usage(argv[0]);
+                return (option == 'h') ? 0 : 1;
+        }
+    }
+    if (optind == argc) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<Radio::CapturedPacket> packets;
+    for (int i = optind; i < argc; i++) {
+        if (not Simulation::CaptureFile::read(argv[i], packets)) {
+            return 1;
+        }
+    }
+
+    // The message handler prints every message it receives to stdout
+    FILE* report = (reportPath != nullptr) ? fopen(reportPath, "w") : stdout;
+    if (report == nullptr) {
+        (void) fprintf(stderr, "%s: cannot open\n", reportPath);
+        return 1;
+    }
+
+    Simulation::Replayer replayer(packets, options);
+    const bool played = replayer.run();
+    if (played) {
+        replayer.report(report);
+    }
+
+    if (report != stdout) {
+        (void) fclose(report);
+    }
+    return played ? 0 : 1;
+}
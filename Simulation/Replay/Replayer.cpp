@@ -0,0 +1,151 @@
+// ======================================================================
+// \title  Replayer.cpp
+// \brief  Plays a hub radio capture back into a BroncoDeployment hub stack
+// ======================================================================
+
+#include <Simulation/Replay/Replayer.hpp>
+#include <Components/Framing/Crc32.hpp>
+#include <Fw/Types/Assert.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <time.h>
+
+namespace Simulation {
+
+  namespace {
+    //! Processor time of the calling thread in nanoseconds
+    U64 threadCpuNs() {
+      timespec now;
+      (void) clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+      return static_cast<U64>(now.tv_sec) * 1000000000 + static_cast<U64>(now.tv_nsec);
+    }
+
+    //! Radio settings of the replaying node: the parameter defaults, without a key
+    RadioSettings replayRadio(const ReplayOptions& options) {
+      RadioSettings settings;
+      settings.frequencyMhz = 915.0f;
+      settings.txPowerDbm = 14;
+      settings.modem = Radio::ModemProfile::GFSK_Rb250Fd250;
+      settings.csmaEnabled = true;
+      settings.csmaThresholdDbm = -90;
+      settings.unicast = false;
+      // In software, so packets for other nodes are read out and dropped by the component rather than the stand-in
+      settings.addressFilter = (options.address != 0) ? Radio::AddressFilter::SOFTWARE : Radio::AddressFilter::OFF;
+      settings.timeSync = false;
+      settings.links = 1;
+      settings.linkSpacingMhz = 0.0f;
+      return settings;
+    }
+  }
+
+  Replayer ::
+    Replayer(const std::vector<Radio::CapturedPacket>& packets, const ReplayOptions& options) :
+      m_packets(packets),
+      m_options(options),
+      m_played(0),
+      m_bytes(0),
+      m_messages(0),
+      m_messageBytes(0),
+      m_messageCrc(Framing::Crc32Engine::INITIAL),
+      m_stackCpuNs(0),
+      m_wallS(0.0),
+      m_bufferGets(0),
+      m_captureUs(0)
+  {
+
+  }
+
+  bool Replayer ::
+    run()
+  {
+    ReplayMedium medium;
+    // Node n has address n + 1
+    const U32 id = (m_options.address != 0) ? (m_options.address - 1) : 0;
+    HubNode node(id, replayRadio(m_options), medium, *this);
+
+    const U64 startUs = m_packets.empty() ? 0 : m_packets.front().timeUs;
+    node.setTime(startUs);
+    medium.setTime(startUs);
+    for (U32 i = 0; (i < BRING_UP_RUNS) && not node.radioUp(); i++) {
+      node.run();
+    }
+    if (not node.radioUp()) {
+      (void) fprintf(stderr, "The replaying node's radio did not come up\n");
+      return false;
+    }
+
+    const auto wallStart = std::chrono::steady_clock::now();
+    bool first = true;
+    U64 firstUs = 0;
+    for (const Radio::CapturedPacket& packet : m_packets) {
+      // A packet longer than the radio carries cannot have come from one
+      if ((packet.sent != m_options.sent) || (packet.size > RH_RF69_MAX_MESSAGE_LEN)) {
+        continue;
+      }
+      if (first) {
+        firstUs = packet.timeUs;
+        first = false;
+      }
+      // A clock stepped back by time synchronization plays its packets at once
+      const I64 sinceFirstUs = static_cast<I64>(packet.timeUs - firstUs);
+      if ((m_options.speed > 0.0) && (sinceFirstUs > 0)) {
+        std::this_thread::sleep_until(
+            wallStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            std::chrono::duration<F64, std::micro>(static_cast<F64>(sinceFirstUs) / m_options.speed)));
+      }
+      m_captureUs = FW_MAX(m_captureUs, static_cast<U64>(FW_MAX(sinceFirstUs, static_cast<I64>(0))));
+
+      node.setTime(packet.timeUs);
+      medium.setTime(packet.timeUs);
+      const U64 startNs = threadCpuNs();
+      medium.deliver(packet);
+      node.run();
+      m_stackCpuNs += threadCpuNs() - startNs;
+      m_played++;
+      m_bytes += packet.size;
+    }
+    m_wallS = std::chrono::duration<F64>(std::chrono::steady_clock::now() - wallStart).count();
+    m_bufferGets = node.bufferGets();
+    return true;
+  }
+
+  void Replayer ::
+    report(FILE* out) const
+  {
+    const F64 stackS = m_stackCpuNs / 1.0e9;
+    (void) fprintf(out,
+                   "{\"packets\": %zu, \"direction\": \"%s\", \"address\": %u, \"speed\": %.2f, \"played\": %llu, "
+                   "\"bytes\": %llu, \"messages\": %llu, \"message_bytes\": %llu, \"message_crc\": \"0x%08x\", "
+                   "\"capture_s\": %.3f, \"wall_s\": %.3f, \"stack_cpu_ms\": %.1f, \"packets_per_s\": %.0f, "
+                   "\"buffer_gets\": %llu}\n",
+                   m_packets.size(), m_options.sent ? "sent" : "received", m_options.address, m_options.speed,
+                   static_cast<unsigned long long>(m_played), static_cast<unsigned long long>(m_bytes),
+                   static_cast<unsigned long long>(m_messages), static_cast<unsigned long long>(m_messageBytes),
+                   Framing::Crc32Engine::finalize(m_messageCrc), m_captureUs / 1.0e6, m_wallS, stackS * 1000.0,
+                   (stackS > 0.0) ? (m_played / stackS) : 0.0, static_cast<unsigned long long>(m_bufferGets));
+  }
+
+  void Replayer ::
+    messageReceived(U32 node, const U8* data, U32 size)
+  {
+    m_messages++;
+    m_messageBytes += size;
+    m_messageCrc = Framing::defaultCrc32Engine().update(m_messageCrc, data, size);
+  }
+
+  void Replayer::ReplayMedium ::
+    deliver(const Radio::CapturedPacket& packet)
+  {
+    FW_ASSERT(m_radio != nullptr);
+    U8 data[Radio::CapturedPacket::HEADER_SIZE + Radio::CapturedPacket::MAX_PAYLOAD];
+    memcpy(data, packet.header, Radio::CapturedPacket::HEADER_SIZE);
+    memcpy(&data[Radio::CapturedPacket::HEADER_SIZE], packet.payload, packet.size);
+    // The radio was run since the last packet, so it has read that one out and takes this one
+    const bool taken = m_radio->deliver(data, static_cast<U8>(Radio::CapturedPacket::HEADER_SIZE + packet.size),
+                                        packet.sent ? RH_RF69_RSSI_FLOOR : packet.rssi, m_nowUs);
+    FW_ASSERT(taken);
+  }
+
+}
@@ -0,0 +1,98 @@
+// ======================================================================
+// \title  Replayer.hpp
+// \brief  Plays a hub radio capture back into a BroncoDeployment hub stack
+// ======================================================================
+
+#ifndef Simulation_Replayer_HPP
+#define Simulation_Replayer_HPP
+
+#include <Components/Radio/RFM69/PacketCapture.hpp>
+#include <Simulation/HubNode/HubNode.hpp>
+
+#include <cstdio>
+#include <vector>
+
+namespace Simulation {
+
+  //! How a capture is played back
+  struct ReplayOptions {
+    F64 speed; //!< Multiple of the original pace, 0 for as fast as the stack takes them
+    U8 address; //!< Address of the receiving node with the software address filter on, 0 for no filter
+    bool sent; //!< Play the packets the capturing node sent, as its peer would hear them, instead of those it received
+  };
+
+  //! Plays the packets of a capture into the radio of one HubNode, through to its message handler
+  //!
+  //! Each packet is handed to the node's RFM69 as the simulated medium would hand it over, then the radio is run
+  //! once, as rate group 1 runs it, so it goes through the radio's checks, the hub deframer and the hub to the message
+  //! handler exactly as on the board. The node's clock is set to each packet's captured time as it is played, so
+  //! timestamps downstream match the original. Packets are decrypted in a capture, so the node runs without a key.
+  //!
+  //! The messages delivered are counted and checksummed, so two builds that play the same capture can be compared
+  //! for the same result, and the processor time spent in the stack is measured, for throughput. With a speed the
+  //! gaps between packets are kept, divided by it, against the wall clock; at 0 they are dropped.
+  class Replayer : public MessageSink {
+
+    public:
+
+      Replayer(
+          const std::vector<Radio::CapturedPacket>& packets, //!< The capture
+          const ReplayOptions& options //!< How to play it
+      );
+
+      //! Play the capture
+      //!
+      //! \return false if the radio did not come up
+      bool run();
+
+      //! Write the results as one line of JSON
+      void report(FILE* out) const;
+
+      //! A message reached the node's message handler
+      void messageReceived(U32 node, const U8* data, U32 size) override;
+
+    private:
+
+      //! Runs to wait for the radio to come up; bring-up takes two without a reset line
+      static const U32 BRING_UP_RUNS = 8;
+
+      //! Stand-in for the air: hands the node's radio the packets of the capture and drops what it sends
+      class ReplayMedium : public SimRadioMedium {
+        public:
+          ReplayMedium() : m_radio(nullptr), m_nowUs(0) {}
+
+          void attach(RH_RF69& radio) override { m_radio = &radio; }
+
+          U64 transmit(RH_RF69& radio, const U8* data, U8 len) override { return m_nowUs; }
+
+          U64 nowUs() override { return m_nowUs; }
+
+          I16 channelRssi(RH_RF69& radio) override { return RH_RF69_RSSI_FLOOR; }
+
+          //! Set the time now
+          void setTime(U64 nowUs) { m_nowUs = nowUs; }
+
+          //! Hand the radio a packet
+          void deliver(const Radio::CapturedPacket& packet);
+
+        private:
+          RH_RF69* m_radio; //!< The node's radio
+          U64 m_nowUs; //!< Time now
+      };
+
+      const std::vector<Radio::CapturedPacket>& m_packets; //!< The capture
+      ReplayOptions m_options; //!< How to play it
+      U64 m_played; //!< Packets played
+      U64 m_bytes; //!< Payload bytes played
+      U64 m_messages; //!< Messages that reached the message handler
+      U64 m_messageBytes; //!< Bytes of those messages
+      U32 m_messageCrc; //!< Running CRC-32 of those messages in order
+      U64 m_stackCpuNs; //!< Processor time spent in the stack
+      F64 m_wallS; //!< Wall time of the playback
+      U64 m_bufferGets; //!< Buffers the node requested
+      U64 m_captureUs; //!< Span of the packets played on the capture's clock
+  };
+
+}
+
+#endif
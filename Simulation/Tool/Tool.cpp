@@ -0,0 +1,314 @@
+// ======================================================================
+// \title  Tool.cpp
+// \brief  Command line, report file and JSON report shared by the simulation tools
+// ======================================================================
+
+#include <Simulation/Tool/Tool.hpp>
+#include <Fw/Types/Assert.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <getopt.h>
+
+namespace Simulation {
+
+  // ----------------------------------------------------------------------
+  // ToolOptions
+  // ----------------------------------------------------------------------
+
+  ToolOptions ::
+    ToolOptions() :
+      m_reportPath(nullptr),
+      m_exitStatus(0)
+  {
+    this->add('o', "file the report is written to instead of stdout", "", [this](const char* text) {
+      m_reportPath = text;
+      return true;
+    });
+  }
+
+  void ToolOptions ::
+    addU32(char letter, const char* help, U32& value, U32 min, U32 max)
+  {
+    char line[256];
+    (void) snprintf(line, sizeof(line), "%s (default %u)", help, value);
+    U32* target = &value;
+    m_options.push_back({letter, line, [letter, target, min, max](const char* text) {
+      char* end = nullptr;
+      const unsigned long long parsed = strtoull(text, &end, 0);
+      if ((end == text) || (*end != '\0') || (text[0] == '-')) {
+        (void) fprintf(stderr, "%s: -%c must be a whole number\n", text, letter);
+        return false;
+      }
+      if ((parsed < min) || (parsed > max)) {
+        if (max == std::numeric_limits<U32>::max()) {
+          (void) fprintf(stderr, "%s: -%c must be at least %u\n", text, letter, min);
+        } else {
+          (void) fprintf(stderr, "%s: -%c must be from %u to %u\n", text, letter, min, max);
+        }
+        return false;
+      }
+      *target = static_cast<U32>(parsed);
+      return true;
+    }});
+  }
+
+  void ToolOptions ::
+    addF64(char letter, const char* help, F64& value, F64 min, F64 max)
+  {
+    char line[256];
+    (void) snprintf(line, sizeof(line), "%s (default %g)", help, value);
+    F64* target = &value;
+    m_options.push_back({letter, line, [letter, target, min, max](const char* text) {
+      char* end = nullptr;
+      const F64 parsed = strtod(text, &end);
+      if ((end == text) || (*end != '\0')) {
+        (void) fprintf(stderr, "%s: -%c must be a number\n", text, letter);
+        return false;
+      }
+      if ((parsed < min) || (parsed > max)) {
+        (void) fprintf(stderr, "%s: -%c must be from %g to %g\n", text, letter, min, max);
+        return false;
+      }
+      *target = parsed;
+      return true;
+    }});
+  }
+
+  void ToolOptions ::
+    add(char letter, const char* help, const char* error, const std::function<bool(const char* text)>& parse)
+  {
+    const std::string message(error);
+    m_options.push_back({letter, help, [parse, message](const char* text) {
+      if (not parse(text)) {
+        (void) fprintf(stderr, "%s: %s\n", text, message.c_str());
+        return false;
+      }
+      return true;
+    }});
+  }
+
+  bool ToolOptions ::
+    parse(int argc, char* argv[])
+  {
+    std::sort(m_options.begin(), m_options.end(),
+              [](const Option& a, const Option& b) { return a.letter < b.letter; });
+    std::string letters = "h";
+    for (const Option& option : m_options) {
+      // Each letter once; 'h' is the usage
+      FW_ASSERT(option.letter != 'h');
+      FW_ASSERT(letters.find(option.letter) == std::string::npos, option.letter);
+      letters += option.letter;
+      letters += ':';
+    }
+
+    int letter = 0;
+    while ((letter = getopt(argc, argv, letters.c_str())) != -1) {
+      const auto found = std::find_if(m_options.begin(), m_options.end(),
+                                      [letter](const Option& option) { return option.letter == letter; });
+      if (found == m_options.end()) {
+        this->printUsage(argv[0]);
+        m_exitStatus = (letter == 'h') ? 0 : 1;
+        return false;
+      }
+      if (not found->parse(optarg)) {
+        m_exitStatus = 1;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  int ToolOptions ::
+    exitStatus() const
+  {
+    return m_exitStatus;
+  }
+
+  const char* ToolOptions ::
+    reportPath() const
+  {
+    return m_reportPath;
+  }
+
+  void ToolOptions ::
+    printUsage(const char* app) const
+  {
+    (void) printf("Usage: ./%s [options]\n", app);
+    for (const Option& option : m_options) {
+      (void) printf("-%c\t%s\n", option.letter, option.help.c_str());
+    }
+  }
+
+  // ----------------------------------------------------------------------
+  // ToolReport
+  // ----------------------------------------------------------------------
+
+  ToolReport ::
+    ToolReport() :
+      m_file(nullptr)
+  {
+  }
+
+  ToolReport ::
+    ~ToolReport()
+  {
+    if ((m_file != nullptr) && (m_file != stdout)) {
+      (void) fclose(m_file);
+    }
+  }
+
+  bool ToolReport ::
+    open(const char* path)
+  {
+    FW_ASSERT(m_file == nullptr);
+    m_file = (path != nullptr) ? fopen(path, "w") : stdout;
+    if (m_file == nullptr) {
+      (void) fprintf(stderr, "%s: cannot open\n", path);
+      return false;
+    }
+    return true;
+  }
+
+  FILE* ToolReport ::
+    file() const
+  {
+    FW_ASSERT(m_file != nullptr);
+    return m_file;
+  }
+
+  int ToolReport ::
+    finish(bool passed)
+  {
+    FW_ASSERT(m_file != nullptr);
+    // A report cut short by a full disk is not one a script can check
+    bool written = (fflush(m_file) == 0) && (ferror(m_file) == 0);
+    if (m_file != stdout) {
+      written = (fclose(m_file) == 0) && written;
+    }
+    m_file = nullptr;
+    if (not written) {
+      (void) fprintf(stderr, "cannot write the report\n");
+    }
+    return (passed && written) ? 0 : 1;
+  }
+
+  // ----------------------------------------------------------------------
+  // JsonLine
+  // ----------------------------------------------------------------------
+
+  JsonLine ::
+    JsonLine(FILE* out) :
+      m_out(out),
+      m_depth(0)
+  {
+    FW_ASSERT(out != nullptr);
+    this->open('{');
+  }
+
+  JsonLine& JsonLine ::
+    field(const char* name, U32 value)
+  {
+    this->next(name);
+    (void) fprintf(m_out, "%u", value);
+    return *this;
+  }
+
+  JsonLine& JsonLine ::
+    field(const char* name, U64 value)
+  {
+    this->next(name);
+    (void) fprintf(m_out, "%llu", static_cast<unsigned long long>(value));
+    return *this;
+  }
+
+  JsonLine& JsonLine ::
+    field(const char* name, F64 value, U32 decimals)
+  {
+    this->next(name);
+    (void) fprintf(m_out, "%.*f", static_cast<int>(decimals), value);
+    return *this;
+  }
+
+  JsonLine& JsonLine ::
+    field(const char* name, bool value)
+  {
+    this->next(name);
+    (void) fputs(value ? "true" : "false", m_out);
+    return *this;
+  }
+
+  JsonLine& JsonLine ::
+    field(const char* name, const char* value)
+  {
+    // Values are names the tools choose, with nothing to escape
+    this->next(name);
+    (void) fprintf(m_out, "\"%s\"", value);
+    return *this;
+  }
+
+  void JsonLine ::
+    beginArray(const char* name)
+  {
+    this->next(name);
+    this->open('[');
+  }
+
+  void JsonLine ::
+    beginObject()
+  {
+    this->next(nullptr);
+    this->open('{');
+  }
+
+  void JsonLine ::
+    endObject()
+  {
+    this->close('}');
+  }
+
+  void JsonLine ::
+    endArray()
+  {
+    this->close(']');
+  }
+
+  void JsonLine ::
+    end()
+  {
+    FW_ASSERT(m_depth == 1, m_depth);
+    this->close('}');
+    (void) fputc('\n', m_out);
+  }
+
+  void JsonLine ::
+    next(const char* name)
+  {
+    FW_ASSERT(m_depth > 0);
+    if (not m_empty[m_depth - 1]) {
+      (void) fputs(", ", m_out);
+    }
+    m_empty[m_depth - 1] = false;
+    if (name != nullptr) {
+      (void) fprintf(m_out, "\"%s\": ", name);
+    }
+  }
+
+  void JsonLine ::
+    open(char bracket)
+  {
+    FW_ASSERT(m_depth < MAX_DEPTH, m_depth);
+    (void) fputc(bracket, m_out);
+    m_empty[m_depth] = true;
+    m_depth++;
+  }
+
+  void JsonLine ::
+    close(char bracket)
+  {
+    FW_ASSERT(m_depth > 0);
+    (void) fputc(bracket, m_out);
+    m_depth--;
+  }
+
+}
@@ -0,0 +1,164 @@
+// ======================================================================
+// \title  Tool.hpp
+// \brief  Command line, report file and JSON report shared by the simulation tools
+// ======================================================================
+
+#ifndef Simulation_Tool_HPP
+#define Simulation_Tool_HPP
+
+#include <FpConfig.hpp>
+
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace Simulation {
+
+  //! The options of a tool, parsed with getopt
+  //!
+  //! Every tool takes -o, the file the report is written to instead of stdout, and -h, which prints the usage. Each
+  //! option a tool adds takes an argument; the usage lists them by letter.
+  class ToolOptions {
+
+    public:
+
+      ToolOptions();
+
+      //! Add an option setting a whole number, whose current value is its default
+      void addU32(
+          char letter, //!< The option
+          const char* help, //!< What it sets, for the usage
+          U32& value, //!< Where the value goes
+          U32 min = 0, //!< Smallest value taken
+          U32 max = std::numeric_limits<U32>::max() //!< Largest value taken
+      );
+
+      //! Add an option setting a number, whose current value is its default
+      void addF64(
+          char letter, //!< The option
+          const char* help, //!< What it sets, for the usage
+          F64& value, //!< Where the value goes
+          F64 min = -std::numeric_limits<F64>::max(), //!< Smallest value taken
+          F64 max = std::numeric_limits<F64>::max() //!< Largest value taken
+      );
+
+      //! Add an option read by the tool itself
+      void add(
+          char letter, //!< The option
+          const char* help, //!< What it sets and its default, for the usage
+          const char* error, //!< Printed after the argument when parse refuses it
+          const std::function<bool(const char* text)>& parse //!< Reads the argument, false if it is not valid
+      );
+
+      //! Parse the command line
+      //!
+      //! \return true if the tool should run, false if it should exit with exitStatus()
+      bool parse(int argc, char* argv[]);
+
+      //! Status to exit with when parse returned false: 0 after -h, 1 after a bad option
+      int exitStatus() const;
+
+      //! The file given with -o, or nullptr for stdout
+      const char* reportPath() const;
+
+    private:
+
+      //! An option a tool added
+      struct Option {
+        char letter; //!< The option
+        std::string help; //!< Its line in the usage
+        std::function<bool(const char* text)> parse; //!< Reads the argument, printing why it refused it
+      };
+
+      //! Print the usage to stdout
+      void printUsage(const char* app) const;
+
+      std::vector<Option> m_options; //!< The options, -o included
+      const char* m_reportPath; //!< The file given with -o
+      int m_exitStatus; //!< Status to exit with when parse returned false
+  };
+
+  //! The file a tool writes its report to
+  class ToolReport {
+
+    public:
+
+      ToolReport();
+
+      //! Closes the file if finish was not called
+      ~ToolReport();
+
+      //! Open the file, or take stdout if there is none
+      //!
+      //! \return false if the file could not be opened, which is printed to stderr
+      bool open(const char* path);
+
+      //! The open file
+      FILE* file() const;
+
+      //! Close the file and give the status the tool exits with
+      //!
+      //! \return 0 if the run passed and the report was written, 1 otherwise
+      int finish(bool passed);
+
+    private:
+
+      FILE* m_file; //!< The open file, nullptr before open and after finish
+  };
+
+  //! A report written as one line of JSON, one field at a time
+  //!
+  //! The constructor opens the outer object and end closes it. Fields are separated as they are written, also inside
+  //! arrays and nested objects.
+  class JsonLine {
+
+    public:
+
+      explicit JsonLine(FILE* out);
+
+      JsonLine& field(const char* name, U32 value);
+      JsonLine& field(const char* name, U64 value);
+      JsonLine& field(const char* name, F64 value, U32 decimals);
+      JsonLine& field(const char* name, bool value);
+      JsonLine& field(const char* name, const char* value);
+
+      //! Open an array field
+      void beginArray(const char* name);
+
+      //! Open an object, as an element of the open array
+      void beginObject();
+
+      //! Close the open object
+      void endObject();
+
+      //! Close the open array
+      void endArray();
+
+      //! Close the outer object and end the line
+      void end();
+
+    private:
+
+      //! Separate what comes next from what came before at this depth, and write its name if it has one
+      void next(const char* name);
+
+      //! Open an array or object
+      void open(char bracket);
+
+      //! Close the open array or object
+      void close(char bracket);
+
+      enum {
+        MAX_DEPTH = 4 //!< Arrays and objects open at once, the outer object included
+      };
+
+      FILE* m_out; //!< The report
+      U32 m_depth; //!< Arrays and objects open
+      bool m_empty[MAX_DEPTH]; //!< Whether nothing was written yet in each open array or object
+  };
+
+}
+
+#endif
@@ -0,0 +1,52 @@
+// ======================================================================
+// \title  Main.cpp
+// \brief  Streams the ground link through the buffered UART driver over a pseudo-terminal and reports one line of JSON
+// ======================================================================
+
+#include <Simulation/Tool/Tool.hpp>
+#include <Simulation/UartLink/UartRig.hpp>
+
+#include <cstdio>
+
+/**
+ * \brief run the streams and exit with 1 if a byte was lost, reordered or copied, or a rate fell short
+ */
+int main(int argc, char* argv[])
+{
+    Simulation::UartOptions options = {
+        115200,
+        4000,
+        100,
+        4,
+        0,
+        10,
+        0.02
+    };
+
+    Simulation::ToolOptions command;
+    command.addU32('b', "line rate in baud; the uplink is offered a tenth of it in bytes per second", options.baud);
+    command.addU32('d', "seconds simulated", options.seconds, 1);
+    command.addU32('k', "polls the consumer keeps each received buffer", options.holdPolls);
+    command.addU32('n', "receive buffers the driver may have out at once", options.rxBuffers, 1, 16);
+    command.addU32('p', "milliseconds between polls, rate group 1's period", options.pollMs, 1);
+    command.addU32('t', "downlink bytes per second", options.downlinkRate);
+    command.addF64('x', "largest shortfall from the offered rates allowed, as a fraction of them", options.tolerance,
+                   0.0, 1.0);
+    if (not command.parse(argc, argv)) {
+        return command.exitStatus();
+    }
+
+    Simulation::ToolReport report;
+    if (not report.open(command.reportPath())) {
+        return 1;
+    }
+
+    Simulation::UartRig rig(options);
+    if (not rig.open()) {
+        (void) fprintf(stderr, "cannot set up a pseudo-terminal\n");
+        return report.finish(false);
+    }
+    rig.run();
+    rig.report(report.file());
+    return report.finish(rig.passed());
+}
@@ -0,0 +1,376 @@
+// ======================================================================
+// \title  UartRig.cpp
+// \brief  Streams data both ways through the buffered UART driver over a pseudo-terminal and checks what arrives
+// ======================================================================
+
+#include <Simulation/UartLink/UartRig.hpp>
+#include <Simulation/Tool/Tool.hpp>
+#include <Fw/Types/Assert.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace Simulation {
+
+  namespace {
+    //! The driver's generated channel ids, which its component base keeps protected
+    struct UartChannels : Components::BufferedUartDriverComponentBase {
+      enum : FwChanIdType {
+        RX_OVERRUNS = CHANNELID_RXOVERRUNS,
+        TX_OVERRUNS = CHANNELID_TXOVERRUNS,
+        RX_BYTES_PER_SECOND = CHANNELID_RXBYTESPERSECOND,
+        TX_BYTES_PER_SECOND = CHANNELID_TXBYTESPERSECOND
+      };
+    };
+
+    //! Byte of a stream at a position: a count that wraps at a prime, so a slip by a buffer's length shows
+    U8 patternAt(U64 position) {
+      return static_cast<U8>(position % 251);
+    }
+  }
+
+  UartRig ::
+    UartRig(const UartOptions& options) :
+      Fw::PassiveComponentBase("rig"),
+      m_options(options),
+      m_master(-1),
+      m_polls(0),
+      m_rxOut(0),
+      m_heldCount(0),
+      m_uplinkOwed(0),
+      m_uplinkOffered(0),
+      m_uplinkWritten(0),
+      m_uplinkReceived(0),
+      m_uplinkMeasured(0),
+      m_maxBacklog(0),
+      m_chunks(0),
+      m_fullChunks(0),
+      m_copied(false),
+      m_downlinkOwed(0),
+      m_downlinkQueued(0),
+      m_downlinkRead(0),
+      m_downlinkMeasured(0),
+      m_downlinkRefused(0),
+      m_inOrder(true),
+      m_rxOverruns(0),
+      m_txOverruns(0),
+      m_rxRate(0),
+      m_txRate(0),
+      m_driver("commDriver")
+  {
+    FW_ASSERT(m_options.pollMs > 0);
+    FW_ASSERT(m_options.rxBuffers <= POOL_SLOTS, m_options.rxBuffers);
+    memset(m_slots, 0, sizeof(m_slots));
+    memset(m_heldUntil, 0, sizeof(m_heldUntil));
+
+    Fw::PassiveComponentBase::init(0);
+    m_driver.init(0);
+
+    m_allocateIn.init();
+    m_allocateIn.addCallComp(this, allocateIn);
+    m_allocateIn.setPortNum(0);
+    m_deallocateIn.init();
+    m_deallocateIn.addCallComp(this, deallocateIn);
+    m_deallocateIn.setPortNum(0);
+    m_recvIn.init();
+    m_recvIn.addCallComp(this, recvIn);
+    m_recvIn.setPortNum(0);
+    m_timeIn.init();
+    m_timeIn.addCallComp(this, timeIn);
+    m_timeIn.setPortNum(0);
+    m_tlmIn.init();
+    m_tlmIn.addCallComp(this, tlmIn);
+    m_tlmIn.setPortNum(0);
+
+    m_driver.set_allocate_OutputPort(0, &m_allocateIn);
+    m_driver.set_deallocate_OutputPort(0, &m_deallocateIn);
+    m_driver.set_recv_OutputPort(0, &m_recvIn);
+    m_driver.set_timeCaller_OutputPort(0, &m_timeIn);
+    m_driver.set_tlmOut_OutputPort(0, &m_tlmIn);
+  }
+
+  UartRig ::
+    ~UartRig()
+  {
+    if (m_master >= 0) {
+      (void) ::close(m_master);
+    }
+  }
+
+  bool UartRig ::
+    open()
+  {
+    m_master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if ((m_master < 0) || (grantpt(m_master) != 0) || (unlockpt(m_master) != 0)) {
+      return false;
+    }
+    // The driver puts the slave side in raw mode, so neither stream is translated
+    return m_driver.open(ptsname(m_master), m_options.baud);
+  }
+
+  void UartRig ::
+    run()
+  {
+    const U64 polls = static_cast<U64>(m_options.seconds) * 1000 / m_options.pollMs;
+    for (U64 poll = 0; poll < polls; poll++) {
+      this->poll(true);
+    }
+    m_uplinkMeasured = m_uplinkReceived;
+    m_downlinkMeasured = m_downlinkRead;
+    for (U32 poll = 0; poll < DRAIN_POLLS + m_options.holdPolls; poll++) {
+      this->poll(false);
+    }
+  }
+
+  void UartRig ::
+    report(FILE* out) const
+  {
+    JsonLine(out)
+        .field("baud", m_options.baud)
+        .field("poll_ms", m_options.pollMs)
+        .field("rx_buffers", m_options.rxBuffers)
+        .field("hold_polls", m_options.holdPolls)
+        .field("seconds", m_options.seconds)
+        .field("offered_rx_Bps", m_options.baud / 10)
+        .field("rx_Bps", static_cast<F64>(m_uplinkMeasured) / m_options.seconds, 0)
+        .field("tlm_rx_Bps", m_rxRate)
+        .field("offered_tx_Bps", m_options.downlinkRate)
+        .field("tx_Bps", static_cast<F64>(m_downlinkMeasured) / m_options.seconds, 0)
+        .field("tlm_tx_Bps", m_txRate)
+        .field("rx_overruns", m_rxOverruns)
+        .field("tx_overruns", m_txOverruns)
+        .field("tx_refused", m_downlinkRefused)
+        .field("chunks", m_chunks)
+        .field("full_chunks", m_fullChunks)
+        .field("max_backlog", m_maxBacklog)
+        .field("lost_rx", static_cast<U64>(m_uplinkOffered - m_uplinkReceived))
+        .field("lost_tx", static_cast<U64>(m_downlinkQueued - m_downlinkRead))
+        .field("in_order", m_inOrder)
+        .field("zero_copy", not m_copied)
+        .field("passed", this->passed())
+        .end();
+  }
+
+  bool UartRig ::
+    passed() const
+  {
+    const F64 rxRate = static_cast<F64>(m_uplinkMeasured) / m_options.seconds;
+    const F64 txRate = static_cast<F64>(m_downlinkMeasured) / m_options.seconds;
+    // A poll's worth of each stream is still in flight when the measurement ends
+    const F64 rxSlack = static_cast<F64>(m_options.baud / 10) * m_options.pollMs / 1000 / m_options.seconds;
+    const F64 txSlack = static_cast<F64>(DOWNLINK_SIZE) / m_options.seconds;
+    return m_inOrder && not m_copied && (m_uplinkReceived == m_uplinkOffered) &&
+           (m_downlinkRead == m_downlinkQueued) &&
+           (rxRate + rxSlack >= (1.0 - m_options.tolerance) * (m_options.baud / 10)) &&
+           (txRate + txSlack >= (1.0 - m_options.tolerance) * m_options.downlinkRate);
+  }
+
+  void UartRig ::
+    poll(bool offering)
+  {
+    if (offering) {
+      // Rates are kept in bytes per thousand polls of a millisecond, so one that does not divide is kept exactly
+      m_uplinkOwed += static_cast<U64>(m_options.baud / 10) * m_options.pollMs;
+      m_uplinkOffered += m_uplinkOwed / 1000;
+      m_uplinkOwed %= 1000;
+      m_downlinkOwed += static_cast<U64>(m_options.downlinkRate) * m_options.pollMs;
+      while ((m_downlinkOwed >= static_cast<U64>(DOWNLINK_SIZE) * 1000) && this->queueDownlink()) {
+        m_downlinkOwed -= static_cast<U64>(DOWNLINK_SIZE) * 1000;
+      }
+    }
+    this->writeUplink();
+    (void) usleep(SETTLE_US);
+
+    m_polls++;
+    m_driver.get_schedIn_InputPort(0)->invoke(0);
+    this->readDownlink();
+
+    // The consumer returns the buffers it is done with, in the order it took them
+    U32 kept = 0;
+    for (U32 i = 0; i < m_heldCount; i++) {
+      if (m_heldUntil[i] <= m_polls) {
+        this->release(m_held[i]);
+      } else {
+        m_held[kept] = m_held[i];
+        m_heldUntil[kept] = m_heldUntil[i];
+        kept++;
+      }
+    }
+    m_heldCount = kept;
+  }
+
+  void UartRig ::
+    writeUplink()
+  {
+    U8 chunk[256];
+    while (m_uplinkWritten < m_uplinkOffered) {
+      const U32 size = static_cast<U32>(FW_MIN(m_uplinkOffered - m_uplinkWritten, static_cast<U64>(sizeof(chunk))));
+      for (U32 i = 0; i < size; i++) {
+        chunk[i] = patternAt(m_uplinkWritten + i);
+      }
+      const ssize_t written = ::write(m_master, chunk, size);
+      if (written <= 0) {
+        break;
+      }
+      m_uplinkWritten += static_cast<U64>(written);
+    }
+    m_maxBacklog = FW_MAX(m_maxBacklog, static_cast<U32>(m_uplinkOffered - m_uplinkWritten));
+  }
+
+  void UartRig ::
+    readDownlink()
+  {
+    U8 chunk[512];
+    while (true) {
+      const ssize_t count = ::read(m_master, chunk, sizeof(chunk));
+      if (count <= 0) {
+        return;
+      }
+      for (ssize_t i = 0; i < count; i++) {
+        m_inOrder = m_inOrder && (chunk[i] == patternAt(m_downlinkRead + i));
+      }
+      m_downlinkRead += static_cast<U64>(count);
+    }
+  }
+
+  bool UartRig ::
+    queueDownlink()
+  {
+    U32 slot = 0;
+    while ((slot < POOL_SLOTS) && m_slots[slot].inUse) {
+      slot++;
+    }
+    if (slot == POOL_SLOTS) {
+      return false;
+    }
+    m_slots[slot].inUse = true;
+    m_slots[slot].receive = false;
+    for (U32 i = 0; i < DOWNLINK_SIZE; i++) {
+      m_slots[slot].data[i] = patternAt(m_downlinkQueued + i);
+    }
+    Fw::Buffer buffer(m_slots[slot].data, DOWNLINK_SIZE);
+    // A refused buffer is deallocated by the driver, and its bytes are offered again in the next one
+    if (m_driver.get_send_InputPort(0)->invoke(buffer) != Drv::SendStatus::SEND_OK) {
+      m_downlinkRefused++;
+      return false;
+    }
+    m_downlinkQueued += DOWNLINK_SIZE;
+    return true;
+  }
+
+  U32 UartRig ::
+    slotOf(const Fw::Buffer& buffer) const
+  {
+    for (U32 slot = 0; slot < POOL_SLOTS; slot++) {
+      if (buffer.getData() == m_slots[slot].data) {
+        return slot;
+      }
+    }
+    return POOL_SLOTS;
+  }
+
+  void UartRig ::
+    release(const Fw::Buffer& buffer)
+  {
+    const U32 slot = this->slotOf(buffer);
+    FW_ASSERT(slot < POOL_SLOTS);
+    FW_ASSERT(m_slots[slot].inUse, slot);
+    if (m_slots[slot].receive) {
+      m_rxOut--;
+    }
+    m_slots[slot].inUse = false;
+  }
+
+  Fw::Buffer UartRig ::
+    allocateIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, U32 size)
+  {
+    UartRig& rig = *static_cast<UartRig*>(callComp);
+    if (rig.m_rxOut == rig.m_options.rxBuffers) {
+      // The buffer manager is out of buffers
+      return Fw::Buffer();
+    }
+    for (U32 slot = 0; slot < POOL_SLOTS; slot++) {
+      if (not rig.m_slots[slot].inUse) {
+        rig.m_slots[slot].inUse = true;
+        rig.m_slots[slot].receive = true;
+        rig.m_rxOut++;
+        return Fw::Buffer(rig.m_slots[slot].data, FW_MIN(size, static_cast<U32>(sizeof(rig.m_slots[slot].data))));
+      }
+    }
+    return Fw::Buffer();
+  }
+
+  void UartRig ::
+    deallocateIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Buffer& buffer)
+  {
+    static_cast<UartRig*>(callComp)->release(buffer);
+  }
+
+  void UartRig ::
+    recvIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Buffer& buffer,
+           const Drv::RecvStatus& status)
+  {
+    UartRig& rig = *static_cast<UartRig*>(callComp);
+    FW_ASSERT(status == Drv::RecvStatus::RECV_OK, status);
+    const U32 slot = rig.slotOf(buffer);
+    if ((slot == POOL_SLOTS) || not rig.m_slots[slot].inUse || not rig.m_slots[slot].receive) {
+      // Not a buffer the driver was given: the chunk was copied on its way here
+      rig.m_copied = true;
+      return;
+    }
+    const U8* data = buffer.getData();
+    for (U32 i = 0; i < buffer.getSize(); i++) {
+      rig.m_inOrder = rig.m_inOrder && (data[i] == patternAt(rig.m_uplinkReceived + i));
+    }
+    rig.m_uplinkReceived += buffer.getSize();
+    rig.m_chunks++;
+    rig.m_fullChunks += (buffer.getSize() == Components::BufferedUartDriverCfg::RX_CHUNK_SIZE) ? 1 : 0;
+
+    if (rig.m_options.holdPolls == 0) {
+      rig.release(buffer);
+      return;
+    }
+    FW_ASSERT(rig.m_heldCount < POOL_SLOTS, rig.m_heldCount);
+    rig.m_held[rig.m_heldCount] = buffer;
+    rig.m_heldUntil[rig.m_heldCount] = rig.m_polls + rig.m_options.holdPolls;
+    rig.m_heldCount++;
+  }
+
+  void UartRig ::
+    timeIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Time& time)
+  {
+    const UartRig& rig = *static_cast<UartRig*>(callComp);
+    const U64 elapsedUs = rig.m_polls * rig.m_options.pollMs * 1000;
+    time.set(TB_NONE, static_cast<U32>(elapsedUs / 1000000), static_cast<U32>(elapsedUs % 1000000));
+  }
+
+  void UartRig ::
+    tlmIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwChanIdType id, Fw::Time& timeTag,
+          Fw::TlmBuffer& val)
+  {
+    UartRig& rig = *static_cast<UartRig*>(callComp);
+    U32 value = 0;
+    val.resetDeser();
+    const Fw::SerializeStatus status = val.deserialize(value);
+    FW_ASSERT(status == Fw::FW_SERIALIZE_OK, status);
+    switch (id - rig.m_driver.getIdBase()) {
+      case UartChannels::RX_OVERRUNS:
+        rig.m_rxOverruns = value;
+        break;
+      case UartChannels::TX_OVERRUNS:
+        rig.m_txOverruns = value;
+        break;
+      case UartChannels::RX_BYTES_PER_SECOND:
+        rig.m_rxRate = value;
+        break;
+      case UartChannels::TX_BYTES_PER_SECOND:
+        rig.m_txRate = value;
+        break;
+      default:
+        break;
+    }
+  }
+
+}
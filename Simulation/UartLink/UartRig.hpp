@@ -0,0 +1,161 @@
+// ======================================================================
+// \title  UartRig.hpp
+// \brief  Streams data both ways through the buffered UART driver over a pseudo-terminal and checks what arrives
+// ======================================================================
+
+#ifndef Simulation_UartRig_HPP
+#define Simulation_UartRig_HPP
+
+#include <Components/BufferedUartDriver/BufferedUartDriver.hpp>
+#include <Drv/ByteStreamDriverModel/ByteStreamRecvPortAc.hpp>
+#include <Fw/Buffer/BufferGetPortAc.hpp>
+#include <Fw/Buffer/BufferSendPortAc.hpp>
+#include <Fw/Time/TimePortAc.hpp>
+#include <Fw/Tlm/TlmPortAc.hpp>
+
+#include <cstdio>
+
+namespace Simulation {
+
+  //! Traffic through the driver and how it is polled
+  struct UartOptions {
+    U32 baud; //!< Line rate; the uplink is offered a tenth of it in bytes per second, as 8N1 carries
+    U32 downlinkRate; //!< Bytes per second sent through the driver
+    U32 pollMs; //!< Milliseconds between schedIn calls, as rate group 1 calls it
+    U32 rxBuffers; //!< Receive buffers the driver may hold or have out at once
+    U32 holdPolls; //!< Polls the consumer keeps each received buffer before returning it
+    U32 seconds; //!< Seconds measured
+    F64 tolerance; //!< Largest shortfall from the offered rates allowed, as a fraction of them
+  };
+
+  //! Runs a BufferedUartDriver on the slave side of a pseudo-terminal, as commDriver runs on the ground link, with
+  //! the rig on the master side standing in for the ground station
+  //!
+  //! Every poll the rig writes the uplink bytes its rate has accumulated into the master side and queues the downlink
+  //! buffers its rate has accumulated on the driver's send port, then calls schedIn. Both streams are a counting
+  //! pattern, so a byte lost, repeated or reordered anywhere is found. Received buffers must be ones the rig's pool
+  //! handed to the driver, which shows they reached the consumer without a copy. Time is simulated: the driver's
+  //! rates are computed from the poll count, and a run takes far less than the seconds it simulates.
+  class UartRig : public Fw::PassiveComponentBase {
+
+    public:
+
+      UartRig(
+          const UartOptions& options //!< The traffic
+      );
+
+      ~UartRig();
+
+      //! Create the pseudo-terminal and open the driver on its slave side
+      //!
+      //! \return false if the pseudo-terminal could not be set up
+      bool open();
+
+      //! Run the traffic, then poll until what was sent has arrived
+      void run();
+
+      //! Write the results as one line of JSON
+      void report(FILE* out) const;
+
+      //! Whether every byte arrived in order, without a copy, at the offered rates
+      bool passed() const;
+
+    private:
+
+      //! Downlink buffer size, a frame of the ground framer's usual telemetry packet
+      static const U32 DOWNLINK_SIZE = 128;
+
+      //! Receive and downlink buffers the pool holds
+      static const U32 POOL_SLOTS = 32;
+
+      //! Polls after the measured run in which what is still in flight must arrive
+      static const U32 DRAIN_POLLS = 20;
+
+      //! Microseconds the kernel is given to carry bytes across the pseudo-terminal each poll
+      static const U32 SETTLE_US = 1000;
+
+      //! A pool buffer
+      struct Slot {
+        U8 data[FW_MAX(static_cast<U32>(Components::BufferedUartDriverCfg::RX_CHUNK_SIZE), DOWNLINK_SIZE)];
+        bool inUse; //!< Whether the buffer is out of the pool
+        bool receive; //!< Whether the buffer was allocated by the driver for receiving
+      };
+
+      //! Poll once: offer the bytes due, call schedIn, read what the driver sent and return held buffers
+      void poll(bool offering);
+
+      //! Write the uplink backlog into the master side, keeping what the pseudo-terminal does not take
+      void writeUplink();
+
+      //! Read the master side and check the downlink pattern
+      void readDownlink();
+
+      //! Queue a downlink buffer on the driver
+      bool queueDownlink();
+
+      //! The pool slot holding a buffer, or POOL_SLOTS
+      U32 slotOf(const Fw::Buffer& buffer) const;
+
+      //! Give a buffer back to the pool
+      void release(const Fw::Buffer& buffer);
+
+      //! Receive buffers, as commDriver.allocate -> bufferManager.bufferGetCallee
+      static Fw::Buffer allocateIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, U32 size);
+
+      //! Sent buffers, as commDriver.deallocate -> bufferManager.bufferSendIn
+      static void deallocateIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Buffer& buffer);
+
+      //! Received chunks, as commDriver.recv -> deframer.framedIn
+      static void recvIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Buffer& buffer,
+                         const Drv::RecvStatus& status);
+
+      //! Simulated time
+      static void timeIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, Fw::Time& time);
+
+      //! The driver's telemetry
+      static void tlmIn(Fw::PassiveComponentBase* callComp, NATIVE_INT_TYPE portNum, FwChanIdType id,
+                        Fw::Time& timeTag, Fw::TlmBuffer& val);
+
+      UartOptions m_options; //!< The traffic
+      NATIVE_INT_TYPE m_master; //!< Master side of the pseudo-terminal
+      U64 m_polls; //!< Polls so far, the simulated clock
+
+      Slot m_slots[POOL_SLOTS]; //!< The pool
+      U32 m_rxOut; //!< Receive buffers out of the pool
+      Fw::Buffer m_held[POOL_SLOTS]; //!< Received buffers the consumer has not returned
+      U64 m_heldUntil[POOL_SLOTS]; //!< Poll at which each held buffer is returned
+      U32 m_heldCount; //!< Buffers held
+
+      U64 m_uplinkOwed; //!< Uplink bytes owed, times the polls per second
+      U64 m_uplinkOffered; //!< Uplink bytes generated
+      U64 m_uplinkWritten; //!< Uplink bytes the pseudo-terminal took
+      U64 m_uplinkReceived; //!< Uplink bytes that came out of the driver in order
+      U64 m_uplinkMeasured; //!< Uplink bytes received while measuring
+      U32 m_maxBacklog; //!< Most uplink bytes waiting for the pseudo-terminal to take them
+      U32 m_chunks; //!< Received buffers
+      U32 m_fullChunks; //!< Received buffers handed off full
+      bool m_copied; //!< Whether a received buffer was not one the pool handed out
+
+      U64 m_downlinkOwed; //!< Downlink bytes owed, times the polls per second
+      U64 m_downlinkQueued; //!< Downlink bytes queued on the driver
+      U64 m_downlinkRead; //!< Downlink bytes read from the master side in order
+      U64 m_downlinkMeasured; //!< Downlink bytes read while measuring
+      U32 m_downlinkRefused; //!< Downlink buffers the driver refused
+
+      bool m_inOrder; //!< Whether both streams have matched their pattern so far
+      U32 m_rxOverruns; //!< Latest RxOverruns
+      U32 m_txOverruns; //!< Latest TxOverruns
+      U32 m_rxRate; //!< Latest RxBytesPerSecond
+      U32 m_txRate; //!< Latest TxBytesPerSecond
+
+      Fw::InputBufferGetPort m_allocateIn; //!< Port behind the driver's allocate
+      Fw::InputBufferSendPort m_deallocateIn; //!< Port behind the driver's deallocate
+      Drv::InputByteStreamRecvPort m_recvIn; //!< Port behind the driver's recv
+      Fw::InputTimePort m_timeIn; //!< Port behind the driver's timeCaller
+      Fw::InputTlmPort m_tlmIn; //!< Port behind the driver's tlmOut
+      Components::BufferedUartDriver m_driver; //!< The driver
+  };
+
+}
+
+#endif
@@ -0,0 +1,28 @@
+/*
+ * BufferedUartDriverCfg.hpp:
+ *
+ * Configuration settings for the buffered UART driver of the ground link.
+ */
+
+#ifndef COMPONENTS_BUFFEREDUARTDRIVERCFG_HPP_
+#define COMPONENTS_BUFFEREDUARTDRIVERCFG_HPP_
+#include <FpConfig.hpp>
+
+namespace Components {
+    namespace BufferedUartDriverCfg {
+        // Size of each receive buffer. A buffer is handed off when full or when the line goes idle.
+        static const U32 RX_CHUNK_SIZE = 256;
+        // Consecutive polls without new bytes before a partial buffer is handed off
+        static const U32 RX_IDLE_POLLS = 1;
+        // Framed buffers that may wait for the UART
+        static const U32 TX_QUEUE_DEPTH = 8;
+        // Length of the throughput measurement window in microseconds
+        static const U32 RATE_WINDOW_US = 1000000;
+        // Receive FIFO of a hardware UART, in bytes. The driver is polled by rate group 1 every 100 ms, so the FIFO
+        // holds what arrives in between: 1152 bytes at 115200 baud, with room for a late poll. arduino-pico's default
+        // of 32 bytes would overflow within 3 ms.
+        static const U32 RX_FIFO_SIZE = 2048;
+    }
+}
+
+#endif
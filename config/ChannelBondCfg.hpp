@@ -0,0 +1,28 @@
+/*
+ * ChannelBondCfg.hpp:
+ *
+ * Configuration settings for the channel bond component.
+ */
+
+#ifndef RADIO_CHANNELBONDCFG_HPP_
+#define RADIO_CHANNELBONDCFG_HPP_
+#include <FpConfig.hpp>
+
+namespace Radio {
+    namespace ChannelBondCfg {
+        // Stream bytes per chunk: one 60-byte RFM69 packet less the chunk's sequence number
+        static const U32 CHUNK_BYTES = 58;
+        // Bytes a radio sends around each packet, for the airtime of a chunk: preamble, sync word, length, RadioHead
+        // header and CRC
+        static const U32 PACKET_OVERHEAD_BYTES = 13;
+        // Chunks held on the receiving side while an earlier one is missing. A chunk further ahead than this gives up
+        // on the missing ones at once.
+        static const U16 REORDER_WINDOW = 16;
+        // Run calls a missing chunk is waited for before the chunks after it are passed on without it
+        static const U32 REORDER_TIMEOUT_TICKS = 3;
+        // Run calls between telemetry updates: 1 s at rate group 1
+        static const U32 TELEMETRY_PERIOD_TICKS = 10;
+    }
+}
+
+#endif
@@ -0,0 +1,19 @@
+/*
+ * CommandBatcherCfg.hpp:
+ *
+ * Configuration settings for the command batcher component.
+ */
+
+#ifndef COMPONENTS_COMMANDBATCHERCFG_HPP_
+#define COMPONENTS_COMMANDBATCHERCFG_HPP_
+#include <FpConfig.hpp>
+
+namespace Components {
+    namespace CommandBatcherCfg {
+        // run calls a dispatched command has to report its status before it counts as failed and the batch moves
+        // on: 5 s at rate group 1, well past any command that completes in its handler
+        static const U32 COMMAND_TIMEOUT_TICKS = 50;
+    }
+}
+
+#endif /* COMPONENTS_COMMANDBATCHERCFG_HPP_ */
@@ -13,6 +13,7 @@
 enum {
     CMD_DISPATCHER_DISPATCH_TABLE_SIZE = 100, // !< The size of the table holding opcodes to dispatch
     CMD_DISPATCHER_SEQUENCER_TABLE_SIZE = 25, // !< The size of the table holding commands in progress
+    CMD_DISPATCHER_INDEX_PAGE_COUNT = 16, // !< Pages of 256 opcodes in the indexed dispatch table; one per component base ID with commands
 };
 
 
@@ -0,0 +1,32 @@
+/*
+ * CoreLinkCfg.hpp:
+ *
+ * Configuration settings for the link between the main core and the radio core.
+ */
+
+#ifndef COMPONENTS_CORELINKCFG_HPP_
+#define COMPONENTS_CORELINKCFG_HPP_
+#include <FpConfig.hpp>
+
+namespace Components {
+    namespace CoreLinkCfg {
+        // Buffers waiting to cross to the other core, each way. A buffer arriving when its ring is full is dropped
+        // and released on the core that holds it. The frame ring holds the hub file transfer's queue
+        // (HubFileTransferCfg::MAX_QUEUED_CHUNKS) with room for the other hub traffic. A power of two.
+        static const U32 RING_SIZE = 64;
+        // Buffers on their way back to the core that allocated them. These are never dropped, so the ring must hold
+        // every buffer the other core can have at once: a full ring of them, the frames the radio queues for a
+        // clear channel (RFM69Cfg::TX_QUEUE_DEPTH) and the data product container it fills. A power of two.
+        static const U32 RETURN_RING_SIZE = 128;
+        // Com calls waiting to cross from the radio core to the main core. A power of two.
+        static const U32 COM_RING_SIZE = 8;
+        // Telemetry writes and events waiting to cross from the radio core to the main core, which takes them each
+        // tick. The radio writes its link report, a dozen channels, at once. Powers of two.
+        static const U32 TLM_RING_SIZE = 32;
+        static const U32 LOG_RING_SIZE = 16;
+        // Ticks between telemetry updates: 1 s at rate group 1
+        static const U32 TELEMETRY_PERIOD_TICKS = 10;
+    }
+}
+
+#endif
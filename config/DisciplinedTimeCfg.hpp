@@ -0,0 +1,30 @@
+/*
+ * DisciplinedTimeCfg.hpp:
+ *
+ * Configuration settings for the disciplined time component.
+ */
+
+#ifndef COMPONENTS_DISCIPLINEDTIMECFG_HPP_
+#define COMPONENTS_DISCIPLINEDTIMECFG_HPP_
+#include <FpConfig.hpp>
+
+namespace Components {
+    namespace DisciplinedTimeCfg {
+        // Longest round trip accepted, less the time source's turnaround. Both ends timestamp in the radio interrupt,
+        // so a longer one means a timestamp was taken late and the exchange is discarded.
+        static const U32 MAX_ROUND_TRIP_US = 2000;
+        // Offset ahead of the clock beyond which it is stepped to the time source instead of slewed toward it
+        static const U32 STEP_THRESHOLD_US = 1000;
+        // Local time over which an offset is slewed in: the time between exchanges, RFM69Cfg::TIME_SYNC_PERIOD_TICKS
+        // at rate group 1, so each is taken out by the next. An offset of STEP_THRESHOLD_US changes the rate by
+        // 200 ppm.
+        static const U32 SLEW_PERIOD_US = 5000000;
+        // Weight of each exchange's frequency error in the drift estimate, as a power of two: each exchange moves
+        // the estimate 1/2 of the way
+        static const U32 DRIFT_GAIN_SHIFT = 1;
+        // Largest drift correction, in parts per billion. Crystals are good to tens of ppm, so more is a bad exchange.
+        static const I32 MAX_DRIFT_PPB = 500000;
+    }
+}
+
+#endif /* COMPONENTS_DISCIPLINEDTIMECFG_HPP_ */
@@ -0,0 +1,25 @@
+/*
+ * DownlinkArbiterCfg.hpp:
+ *
+ * Configuration settings for the downlink arbiter component.
+ */
+
+#ifndef COMPONENTS_DOWNLINKARBITERCFG_HPP_
+#define COMPONENTS_DOWNLINKARBITERCFG_HPP_
+#include <FpConfig.hpp>
+
+namespace Components {
+    namespace DownlinkArbiterCfg {
+        // Packets held for each class while it waits for its share of the link; a packet arriving to a full queue
+        // is dropped. Telemetry comes in a burst of packets on every rate group tick, so this holds more than one.
+        static const U32 QUEUE_DEPTH = 16;
+        // Rate of the schedIn calls, which refill the link budget: rate group 1
+        static const U32 TICKS_PER_SECOND = 10;
+        // Bytes the framer adds to each packet, charged against the link with it: the F Prime frame header and CRC
+        static const U32 FRAME_OVERHEAD_BYTES = 12;
+        // schedIn calls between telemetry updates: 1 s at rate group 1
+        static const U32 TELEMETRY_PERIOD_TICKS = 10;
+    }
+}
+
+#endif /* COMPONENTS_DOWNLINKARBITERCFG_HPP_ */
@@ -0,0 +1,28 @@
+/*
+ * FlashPrmDbCfg.hpp:
+ *
+ * Configuration settings for the flash-backed parameter database.
+ */
+
+#ifndef COMPONENTS_FLASHPRMDBCFG_HPP_
+#define COMPONENTS_FLASHPRMDBCFG_HPP_
+#include <FpConfig.hpp>
+
+namespace Components {
+    namespace FlashPrmDbCfg {
+        // Erase unit of the flash
+        static const U32 SECTOR_SIZE = 4096;
+        // Sectors holding the log. One is active; compaction writes a fresh copy into the next.
+        static const U32 SECTOR_COUNT = 2;
+        // Bytes of superseded records in the active sector that start a background compaction. This also bounds
+        // how much of the log has to be replayed at boot.
+        static const U32 COMPACT_GARBAGE_BYTES = SECTOR_SIZE / 8;
+        // Free bytes in the active sector below which any superseded record starts a background compaction, so
+        // that a PRM_SAVE seldom finds the sector full and has to wait for one
+        static const U32 COMPACT_FREE_BYTES = SECTOR_SIZE / 4;
+        // Entries copied into the new sector per run call while compacting
+        static const U32 COMPACT_ENTRIES_PER_RUN = 4;
+    }
+}
+
+#endif /* COMPONENTS_FLASHPRMDBCFG_HPP_ */
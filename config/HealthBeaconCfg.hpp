@@ -0,0 +1,27 @@
+/*
+ * HealthBeaconCfg.hpp:
+ *
+ * Configuration settings for the health beacon component.
+ */
+
+#ifndef COMPONENTS_HEALTHBEACONCFG_HPP_
+#define COMPONENTS_HEALTHBEACONCFG_HPP_
+#include <FpConfig.hpp>
+
+namespace Components {
+    namespace HealthBeaconCfg {
+        // Rate of the run calls, which count down to the next beacon: rate group 1
+        static const U32 TICKS_PER_SECOND = 10;
+        // Largest beacon, so it goes out as one radio packet: RadioHead's RH_RF69_MAX_MESSAGE_LEN less the radio's key
+        // check
+        static const U32 MAX_BEACON_SIZE = 58;
+        // First byte of every beacon. F Prime frames start with 0xDE, so a beacon is never taken for the start of one.
+        static const U8 BEACON_MARKER = 0xBC;
+        // Base ids of the instances whose channels go in the beacon, from instances.fpp; the topology checks them
+        static const U32 RADIO_ID_BASE = 0x5300;
+        static const U32 SYSTEM_RESOURCES_ID_BASE = 0x4900;
+        static const U32 TIME_ID_BASE = 0x4F00;
+    }
+}
+
+#endif /* COMPONENTS_HEALTHBEACONCFG_HPP_ */
@@ -0,0 +1,45 @@
+/*
+ * HubFileTransferCfg.hpp:
+ *
+ * Configuration settings for the hub file transfer component.
+ */
+
+#ifndef COMPONENTS_HUBFILETRANSFERCFG_HPP_
+#define COMPONENTS_HUBFILETRANSFERCFG_HPP_
+#include <FpConfig.hpp>
+
+namespace Components {
+    namespace HubFileTransferCfg {
+        // Largest payload the hub radio sends as a single packet: RH_RF69_MAX_MESSAGE_LEN less the key check
+        // (RFM69Cfg::KEY_CHECK_SIZE) it carries while encryption is on. Data chunks are sized so a framed chunk never
+        // fragments.
+        static const U32 RADIO_MTU = 58;
+        // Chunks the sender may have in flight beyond the first chunk the receiver is missing
+        static const U32 WINDOW_CHUNKS = 64;
+        // Bytes the radio adds around each packet on the air: preamble, sync word, length byte, RadioHead header, key
+        // check and CRC
+        static const U32 RADIO_OVERHEAD_BYTES = 4 + 2 + 1 + 4 + 2 + 2;
+        // Period of the run calls, which top up the radio's queue: rate group 1
+        static const U32 RUN_PERIOD_US = 100000;
+        // Most chunks waiting for the radio at once. Each run call tops the queue up to a run period of airtime and
+        // one chunk more, so the radio does not go idle before the next call; 48 covers that at 250 kbit/s. Each
+        // waiting chunk holds a framer buffer and a slot in the CoreLink frame ring.
+        static const U32 MAX_QUEUED_CHUNKS = 48;
+        // Longest a run call spends reading and queueing chunks. The radio sends them from its own run call, within
+        // RFM69Cfg::SEND_TIME_LIMIT_US, so this only bounds the file reads.
+        static const U32 SEND_TIME_LIMIT_US = 40000;
+        // File bytes read for the start message's checksum on each run call, which bounds the time taken from the
+        // rate group before a transfer starts
+        static const U32 CHECKSUM_BYTES_PER_RUN = 16384;
+        // Largest file, in chunks. The receiver keeps one bit per chunk.
+        static const U32 MAX_CHUNKS = 8192;
+        // Chunks received between unsolicited status reports from the receiver
+        static const U32 STATUS_INTERVAL_CHUNKS = 16;
+        // Run calls without a status report before the sender polls the receiver
+        static const U32 STATUS_TIMEOUT_RUNS = 10;
+        // Unanswered polls before the sender suspends the transfer
+        static const U32 MAX_POLLS = 5;
+    }
+}
+
+#endif /* COMPONENTS_HUBFILETRANSFERCFG_HPP_ */
@@ -0,0 +1,28 @@
+/*
+ * LatencyProbeCfg.hpp:
+ *
+ * Configuration settings for the latency probes of the message handler.
+ */
+
+#ifndef COMPONENTS_LATENCYPROBECFG_HPP_
+#define COMPONENTS_LATENCYPROBECFG_HPP_
+#include <FpConfig.hpp>
+
+namespace Components {
+    namespace LatencyProbeCfg {
+        // Width of each bin of the round trip histogram. Messages are read out of the radio and passed up on rate
+        // group ticks, so round trips come in steps of the tick and finer bins would add nothing.
+        static const U32 HISTOGRAM_BIN_US = 2000;
+        // Bins of the round trip histogram; longer round trips are counted in the last one
+        static const U32 HISTOGRAM_BINS = 256;
+        // Weight of each new round trip's change in the jitter estimate, as a power of two: 1/16, as in RFC 3550
+        static const U32 JITTER_GAIN_SHIFT = 4;
+        // Rate group calls to wait for echoes after the last probe is sent before the run is reported: 3 s at rate
+        // group 1
+        static const U32 ECHO_WAIT_TICKS = 30;
+        // Echoes a node holds for its next rate group call; probes arriving while it is full are not echoed
+        static const U32 ECHO_QUEUE_DEPTH = 4;
+    }
+}
+
+#endif /* COMPONENTS_LATENCYPROBECFG_HPP_ */
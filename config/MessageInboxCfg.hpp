@@ -0,0 +1,21 @@
+/*
+ * MessageInboxCfg.hpp:
+ *
+ * Configuration settings for the message inbox of the message handler.
+ */
+
+#ifndef COMPONENTS_MESSAGEINBOXCFG_HPP_
+#define COMPONENTS_MESSAGEINBOXCFG_HPP_
+#include <FpConfig.hpp>
+
+namespace Components {
+    namespace MessageInboxCfg {
+        // Bytes of message text the inbox holds. Messages are stored whole, one after another, so the oldest ones
+        // are evicted to make room and the arena never fragments.
+        static const U32 ARENA_BYTES = 4096;
+        // Most messages the inbox holds, whatever their size. Less than 255, since entries are indexed by a U8.
+        static const U32 CAPACITY = 128;
+    }
+}
+
+#endif /* COMPONENTS_MESSAGEINBOXCFG_HPP_ */
@@ -0,0 +1,55 @@
+/*
+ * RFM69Cfg.hpp:
+ *
+ * Configuration settings for the RFM69 radio component.
+ */
+
+#ifndef RADIO_RFM69CFG_HPP_
+#define RADIO_RFM69CFG_HPP_
+#include <FpConfig.hpp>
+
+namespace Radio {
+    namespace RFM69Cfg {
+        // Length of a link quality window. A report is published when each window closes.
+        static const U32 LINK_WINDOW_US = 10000000;
+        // Weight of a new sample in a peer's smoothed RSSI, as a power of two: each sample moves it 1/8 of the way
+        static const U32 RSSI_SMOOTHING_SHIFT = 3;
+        // Largest jump in a peer's packet sequence numbers counted as loss. A larger one is taken to be the peer
+        // restarting, or a duplicate, and is not counted.
+        static const U8 MAX_SEQUENCE_GAP = 32;
+        // Frames held for the run call, which samples the channel and sends them. It holds what the hub file transfer
+        // queues for a run period at the fastest profile (HubFileTransferCfg::MAX_QUEUED_CHUNKS). A frame arriving
+        // when all are held is dropped.
+        static const U32 TX_QUEUE_DEPTH = 48;
+        // Longest a run call keeps sending queued frames once the channel is clear; the rest wait for the next call.
+        // With the radio on the main core this leaves rate group 1 time for everything else.
+        static const U32 SEND_TIME_LIMIT_US = 40000;
+        // Busy samples before a frame goes out regardless, as a channel that stays busy is more likely interference
+        // than another node
+        static const U32 CSMA_MAX_ATTEMPTS = 6;
+        // Largest backoff window as a power of two of run calls: 2^4 calls is 1.6 s at rate group 1. The backoff slot
+        // is one 100 ms run call, about 40 times the 2.3 ms a full packet takes on the air at 250 kbit/s (and 1.6
+        // times its 61 ms at 9600 bit/s), so a busy sample costs far more time than the packet it waited for.
+        static const U32 CSMA_MAX_BACKOFF_EXPONENT = 4;
+        // Known plaintext at the front of the payload of every packet while a key is installed, big-endian. It is
+        // encrypted with the payload, so a packet decrypted with the wrong key, or encrypted at one end only, misses it
+        // all but once in 65536. It takes KEY_CHECK_SIZE bytes from the largest payload.
+        static const U16 KEY_CHECK_VALUE = 0x5AC3;
+        static const U8 KEY_CHECK_SIZE = sizeof(U16);
+        // First payload byte of time synchronization packets, which the radio component handles itself. F Prime
+        // frames start with 0xDE and health beacons with HealthBeaconCfg::BEACON_MARKER, so neither is taken for one.
+        static const U8 TIME_SYNC_MARKER = 0x75;
+        // Run calls between exchanges with the time source: 5 s at rate group 1
+        static const U32 TIME_SYNC_PERIOD_TICKS = 50;
+        // Bytes of the ring holding the packets sent and received, 11 bytes of header each and their payload: 4 KiB
+        // holds the last 55 or so full packets
+        static const U32 CAPTURE_BUFFER_SIZE = 4096;
+        // Data bytes in each capture dump container. It must fit the data product buffers of the deployment's buffer
+        // manager.
+        static const FwSizeType CAPTURE_CONTAINER_DATA_SIZE = 1024;
+        // Run calls a capture dump waits for a container before giving up: 1 s at rate group 1
+        static const U32 CAPTURE_DUMP_MAX_WAITS = 10;
+    }
+}
+
+#endif
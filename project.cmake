@@ -3,3 +3,18 @@
 
 add_fprime_subdirectory("${CMAKE_CURRENT_LIST_DIR}/Components")
 add_fprime_subdirectory("${CMAKE_CURRENT_LIST_DIR}/BroncoDeployment/")
+
+# The simulation tools run the hub stack in a host process and have no place on the board
+if (NOT FPRIME_PLATFORM STREQUAL "ArduinoFw")
+  add_fprime_subdirectory("${CMAKE_CURRENT_LIST_DIR}/Simulation/HubNode/")
+  add_fprime_subdirectory("${CMAKE_CURRENT_LIST_DIR}/Simulation/Tool/")
+  add_fprime_subdirectory("${CMAKE_CURRENT_LIST_DIR}/Simulation/Constellation/")
+  add_fprime_subdirectory("${CMAKE_CURRENT_LIST_DIR}/Simulation/Benchmark/")
+  add_fprime_subdirectory("${CMAKE_CURRENT_LIST_DIR}/Simulation/Replay/")
+  add_fprime_subdirectory("${CMAKE_CURRENT_LIST_DIR}/Simulation/DownlinkLoad/")
+  add_fprime_subdirectory("${CMAKE_CURRENT_LIST_DIR}/Simulation/BeaconDecoder/")
+  add_fprime_subdirectory("${CMAKE_CURRENT_LIST_DIR}/Simulation/UartLink/")
+  add_fprime_subdirectory("${CMAKE_CURRENT_LIST_DIR}/Simulation/DeframerFuzz/")
+  add_fprime_subdirectory("${CMAKE_CURRENT_LIST_DIR}/Simulation/BatchUplink/")
+  add_fprime_subdirectory("${CMAKE_CURRENT_LIST_DIR}/Simulation/FileTransferLink/")
+endif()